@@ -0,0 +1,435 @@
+#include "assemblyview.h"
+#include "buildcache.h"
+#include "sanitizerreport.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QScrollBar>
+#include <QRegularExpression>
+#include <QFontDatabase>
+#include <QSet>
+#include <cstdlib>
+#include <cxxabi.h>
+
+AssemblyView::AssemblyView(QWidget *parent)
+    : QWidget(parent)
+    , idleTimer(new QTimer(this))
+    , compileProcess(new QProcess(this))
+    , recompilePending(false)
+    , active(false)
+    , syncingCursor(false)
+    , selectedSourceLine(0)
+    , generation(0)
+    , runningGeneration(0)
+{
+    QSettings settings("LionCPP", "IDE");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *optionLayout = new QHBoxLayout();
+    profileCombo = new QComboBox(this);
+    profileCombo->addItem("默认 (-O2)", QString());
+    profileCombo->addItem("调试 (-O0)", QString("-O0"));
+    const SanitizerKind sanitizerKinds[] = {
+        SanitizerKind::Address, SanitizerKind::Undefined, SanitizerKind::Thread, SanitizerKind::Leak
+    };
+    for (SanitizerKind kind : sanitizerKinds) {
+        profileCombo->addItem(SanitizerReport::displayName(kind), SanitizerReport::compileFlags(kind).join(' '));
+    }
+    profileCombo->setCurrentIndex(qBound(0, settings.value("asm/profile", 0).toInt(), profileCombo->count() - 1));
+
+    flagsEdit = new QLineEdit(this);
+    flagsEdit->setPlaceholderText("额外编译参数，如 -O3 -march=native");
+    flagsEdit->setText(settings.value("asm/flags").toString());
+    intelCheck = new QCheckBox("Intel 语法", this);
+    intelCheck->setChecked(settings.value("asm/intel", true).toBool());
+    verboseCheck = new QCheckBox("详细注释", this);
+    verboseCheck->setToolTip("-fverbose-asm：在指令后标注对应的变量名");
+    verboseCheck->setChecked(settings.value("asm/verbose", false).toBool());
+    statusLabel = new QLabel(this);
+
+    optionLayout->addWidget(profileCombo);
+    optionLayout->addWidget(flagsEdit, 1);
+    optionLayout->addWidget(intelCheck);
+    optionLayout->addWidget(verboseCheck);
+    layout->addLayout(optionLayout);
+    layout->addWidget(statusLabel);
+
+    asmEdit = new QPlainTextEdit(this);
+    asmEdit->setReadOnly(true);
+    asmEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    asmEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(asmEdit, 1);
+
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(IdleDelayMs);
+    connect(idleTimer, &QTimer::timeout, this, &AssemblyView::recompile);
+
+    connect(profileCombo, &QComboBox::currentIndexChanged, this, [this]() { saveOptions(); recompile(); });
+    connect(flagsEdit, &QLineEdit::editingFinished, this, [this]() { saveOptions(); recompile(); });
+    connect(intelCheck, &QCheckBox::toggled, this, [this]() { saveOptions(); recompile(); });
+    connect(verboseCheck, &QCheckBox::toggled, this, [this]() { saveOptions(); recompile(); });
+
+    connect(compileProcess, &QProcess::finished, this, &AssemblyView::onCompileFinished);
+    connect(compileProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            statusLabel->setText("无法启动编译器: " + BuildCache::compilerPath());
+        }
+    });
+    connect(asmEdit, &QPlainTextEdit::cursorPositionChanged, this, &AssemblyView::onAsmCursorMoved);
+}
+
+AssemblyView::~AssemblyView()
+{
+    if (compileProcess->state() != QProcess::NotRunning) {
+        compileProcess->disconnect(this);
+        compileProcess->kill();
+        compileProcess->waitForFinished(1000);
+    }
+    if (editor) {
+        editor->clearLineHighlights();
+    }
+}
+
+void AssemblyView::saveOptions()
+{
+    QSettings settings("LionCPP", "IDE");
+    settings.setValue("asm/profile", profileCombo->currentIndex());
+    settings.setValue("asm/flags", flagsEdit->text());
+    settings.setValue("asm/intel", intelCheck->isChecked());
+    settings.setValue("asm/verbose", verboseCheck->isChecked());
+}
+
+void AssemblyView::setEditor(CodeEditor *newEditor)
+{
+    if (editor == newEditor) return;
+
+    if (editor) {
+        editor->clearLineHighlights();
+        disconnect(editor, nullptr, this, nullptr);
+        disconnect(editor->document(), nullptr, this, nullptr);
+    }
+
+    editor = newEditor;
+    ++generation;
+    asmLines.clear();
+    firstAsmRow.clear();
+    asmEdit->clear();
+    statusLabel->clear();
+    selectedSourceLine = 0;
+
+    if (editor) {
+        connect(editor->document(), &QTextDocument::contentsChanged, this, &AssemblyView::scheduleRecompile);
+        connect(editor, &QPlainTextEdit::cursorPositionChanged, this, &AssemblyView::onEditorCursorMoved);
+        recompile();
+    }
+}
+
+void AssemblyView::setActive(bool value)
+{
+    if (active == value) return;
+    active = value;
+
+    if (active) {
+        recompile();
+    } else {
+        idleTimer->stop();
+        if (editor) editor->clearLineHighlights();
+    }
+}
+
+void AssemblyView::scheduleRecompile()
+{
+    if (active) idleTimer->start();
+}
+
+QStringList AssemblyView::compileFlags() const
+{
+    QStringList flags = profileCombo->currentData().toString().split(' ', Qt::SkipEmptyParts);
+    flags << QProcess::splitCommand(flagsEdit->text());
+    // -g 产生 .loc 行号信息，用于把指令关联到源码行
+    flags << "-S" << "-g";
+    if (intelCheck->isChecked()) flags << "-masm=intel";
+    if (verboseCheck->isChecked()) flags << "-fverbose-asm";
+    flags << "-x" << "c++";
+    return flags;
+}
+
+void AssemblyView::recompile()
+{
+    idleTimer->stop();
+    if (!editor || !active) return;
+
+    // 上一次编译还没结束时只做标记，结束后再编译一次最新内容
+    if (compileProcess->state() != QProcess::NotRunning) {
+        recompilePending = true;
+        return;
+    }
+    recompilePending = false;
+
+    // 从标准输入编译编辑器中的内容，未保存的修改也能立即看到效果
+    QString filePath = editor->property("filePath").toString();
+    QString directory = filePath.isEmpty() ? QDir::currentPath() : QFileInfo(filePath).absolutePath();
+    QStringList flags = compileFlags();
+    flags << "-iquote" << directory;
+
+    runningGeneration = generation;
+    statusLabel->setText("编译中...");
+    compileProcess->setWorkingDirectory(directory);
+    compileProcess->start(BuildCache::compilerPath(), BuildCache::compileArguments("-", "-", flags));
+    compileProcess->write(editor->toPlainText().toUtf8());
+    compileProcess->closeWriteChannel();
+}
+
+void AssemblyView::onCompileFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QString assembly = QString::fromUtf8(compileProcess->readAllStandardOutput());
+    QString errors = QString::fromUtf8(compileProcess->readAllStandardError());
+
+    // 编译期间切换了编辑器，结果作废
+    if (runningGeneration != generation) {
+        recompile();
+        return;
+    }
+
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        statusLabel->setText("编译失败");
+        asmLines.clear();
+        firstAsmRow.clear();
+        asmEdit->setPlainText(errors.trimmed());
+        updateHighlights();
+    } else {
+        asmLines = parseAssembly(assembly);
+        demangle(asmLines);
+        showAssembly();
+    }
+
+    if (recompilePending) {
+        recompile();
+    }
+}
+
+QList<AssemblyView::AsmLine> AssemblyView::parseAssembly(const QString &assembly)
+{
+    static const QRegularExpression fileDirective(
+        QStringLiteral("^\\s*\\.file\\s+(\\d+)\\s+\"([^\"]*)\"(?:\\s+\"([^\"]*)\")?"));
+    static const QRegularExpression locDirective(QStringLiteral("^\\s*\\.loc\\s+(\\d+)\\s+(\\d+)"));
+    static const QRegularExpression sectionDirective(
+        QStringLiteral("^\\s*\\.(section|text|data|bss)\\b\\s*([^,\\s]*)"));
+    static const QRegularExpression labelPattern(QStringLiteral("^([^\\s:#]+):"));
+    static const QRegularExpression jumpLabel(QStringLiteral("^\\.L\\d+$"));
+
+    QList<AsmLine> lines;
+    QSet<int> mainFiles;        // 指向 <stdin>（即编辑器内容）的文件编号
+    bool inCode = true;
+    int currentLine = 0;
+
+    const QStringList rawLines = assembly.split('\n');
+    for (const QString &raw : rawLines) {
+        QRegularExpressionMatch match = fileDirective.match(raw);
+        if (match.hasMatch()) {
+            QString name = match.captured(3).isEmpty() ? match.captured(2) : match.captured(3);
+            if (name == "<stdin>") mainFiles.insert(match.captured(1).toInt());
+            continue;
+        }
+
+        match = locDirective.match(raw);
+        if (match.hasMatch()) {
+            // 内联进来的头文件代码仍归到调用它的源码行
+            if (mainFiles.contains(match.captured(1).toInt())) {
+                currentLine = match.captured(2).toInt();
+            }
+            continue;
+        }
+
+        match = sectionDirective.match(raw);
+        if (match.hasMatch()) {
+            QString directive = match.captured(1);
+            if (directive == "text") {
+                inCode = true;
+            } else if (directive == "section") {
+                inCode = match.captured(2).startsWith(".text");
+            } else {
+                inCode = false;
+            }
+            continue;
+        }
+
+        if (!inCode) continue;
+
+        QString trimmed = raw.trimmed();
+        if (trimmed.isEmpty() || trimmed.startsWith('#')) continue;
+
+        match = labelPattern.match(raw);
+        if (match.hasMatch()) {
+            // 保留函数名和跳转目标，去掉调试信息等内部标签
+            QString name = match.captured(1);
+            if (name.startsWith('.') && !jumpLabel.match(name).hasMatch()) continue;
+            if (!name.startsWith('.')) currentLine = 0;
+
+            AsmLine line;
+            line.text = name + ":";
+            lines.append(line);
+            continue;
+        }
+
+        // 其余伪指令
+        if (trimmed.startsWith('.')) continue;
+
+        int tab = trimmed.indexOf('\t');
+        if (tab > 0) {
+            trimmed = trimmed.left(tab).leftJustified(7) + ' ' + trimmed.mid(tab + 1).trimmed().replace('\t', ' ');
+        }
+
+        AsmLine line;
+        line.text = "    " + trimmed;
+        line.sourceLine = currentLine;
+        lines.append(line);
+    }
+
+    return lines;
+}
+
+void AssemblyView::demangle(QList<AsmLine> &lines)
+{
+    static const QRegularExpression symbolPattern(QStringLiteral("_Z[A-Za-z0-9_.$]+"));
+
+    QStringList symbols;
+    QSet<QString> seen;
+    for (const AsmLine &line : lines) {
+        QRegularExpressionMatchIterator it = symbolPattern.globalMatch(line.text);
+        while (it.hasNext()) {
+            QString symbol = it.next().captured();
+            if (!seen.contains(symbol)) {
+                seen.insert(symbol);
+                symbols << symbol;
+            }
+        }
+    }
+    if (symbols.isEmpty()) return;
+
+    // 进程内解码，不在界面线程中等待 c++filt；解码失败的符号保持原样
+    QHash<QString, QString> names;
+    for (const QString &symbol : std::as_const(symbols)) {
+        int status = 0;
+        char *name = abi::__cxa_demangle(symbol.toLatin1().constData(), nullptr, nullptr, &status);
+        names.insert(symbol, status == 0 && name ? QString::fromUtf8(name) : symbol);
+        std::free(name);
+    }
+
+    for (AsmLine &line : lines) {
+        QRegularExpressionMatchIterator it = symbolPattern.globalMatch(line.text);
+        QList<QRegularExpressionMatch> matches;
+        while (it.hasNext()) matches.append(it.next());
+        // 从后往前替换，前面匹配的位置不受影响
+        for (int i = matches.size() - 1; i >= 0; --i) {
+            const QRegularExpressionMatch &match = matches.at(i);
+            line.text.replace(match.capturedStart(), match.capturedLength(), names.value(match.captured()));
+        }
+    }
+}
+
+QColor AssemblyView::lineColor(int sourceLine, bool selected)
+{
+    static const QColor palette[] = {
+        QColor(86, 156, 214), QColor(78, 201, 176), QColor(220, 220, 170),
+        QColor(197, 134, 192), QColor(206, 145, 120), QColor(181, 206, 168)
+    };
+    QColor color = palette[sourceLine % 6];
+    color.setAlpha(selected ? 110 : 40);
+    return color;
+}
+
+void AssemblyView::showAssembly()
+{
+    int scrollValue = asmEdit->verticalScrollBar()->value();
+
+    QStringList texts;
+    firstAsmRow.clear();
+    int instructionCount = 0;
+    for (int row = 0; row < asmLines.size(); ++row) {
+        const AsmLine &line = asmLines.at(row);
+        texts << line.text;
+        if (line.sourceLine > 0) {
+            ++instructionCount;
+            if (!firstAsmRow.contains(line.sourceLine)) {
+                firstAsmRow.insert(line.sourceLine, row);
+            }
+        }
+    }
+
+    syncingCursor = true;
+    asmEdit->setPlainText(texts.join('\n'));
+    asmEdit->verticalScrollBar()->setValue(scrollValue);
+    syncingCursor = false;
+
+    statusLabel->setText(QString("%1 条指令，对应 %2 行源码").arg(instructionCount).arg(firstAsmRow.size()));
+    updateHighlights();
+}
+
+void AssemblyView::updateHighlights()
+{
+    QList<QTextEdit::ExtraSelection> selections;
+    QTextBlock block = asmEdit->document()->firstBlock();
+    for (int row = 0; row < asmLines.size() && block.isValid(); ++row, block = block.next()) {
+        int line = asmLines.at(row).sourceLine;
+        if (line <= 0) continue;
+
+        QTextEdit::ExtraSelection selection;
+        selection.format.setBackground(lineColor(line, line == selectedSourceLine));
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selection.cursor = QTextCursor(block);
+        selections.append(selection);
+    }
+    asmEdit->setExtraSelections(selections);
+
+    if (editor && active) {
+        QMap<int, QColor> highlights;
+        for (auto it = firstAsmRow.constBegin(); it != firstAsmRow.constEnd(); ++it) {
+            highlights.insert(it.key(), lineColor(it.key(), it.key() == selectedSourceLine));
+        }
+        editor->setLineHighlights(highlights);
+    }
+}
+
+void AssemblyView::onEditorCursorMoved()
+{
+    if (syncingCursor || !editor) return;
+
+    int line = editor->textCursor().blockNumber() + 1;
+    if (line == selectedSourceLine) return;
+    selectedSourceLine = line;
+    updateHighlights();
+
+    // 汇编视图滚动到该行对应的第一条指令
+    auto it = firstAsmRow.constFind(line);
+    if (it != firstAsmRow.constEnd()) {
+        syncingCursor = true;
+        asmEdit->setTextCursor(QTextCursor(asmEdit->document()->findBlockByNumber(it.value())));
+        asmEdit->centerCursor();
+        syncingCursor = false;
+    }
+}
+
+void AssemblyView::onAsmCursorMoved()
+{
+    if (syncingCursor || !editor) return;
+
+    int row = asmEdit->textCursor().blockNumber();
+    if (row < 0 || row >= asmLines.size()) return;
+    int line = asmLines.at(row).sourceLine;
+    if (line <= 0 || line == selectedSourceLine) return;
+
+    selectedSourceLine = line;
+    QTextBlock block = editor->document()->findBlockByNumber(line - 1);
+    if (block.isValid()) {
+        syncingCursor = true;
+        editor->setTextCursor(QTextCursor(block));
+        editor->centerCursor();
+        syncingCursor = false;
+    }
+    updateHighlights();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QWidget>
+#include <QPlainTextEdit>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QLabel>
+#include <QTimer>
+#include <QProcess>
+#include <QPointer>
+#include <QHash>
+
+#include "codeeditor.h"
+
+// 汇编视图（本地版 Compiler Explorer）
+// 把当前编辑器的内容（包括未保存的修改）编译为汇编，过滤掉伪指令和
+// 内部标签，并按 .loc 调试信息把每条指令关联到源码行，两边用相同颜色标出。
+// 编辑停顿后自动在后台重新编译。
+class AssemblyView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct AsmLine
+    {
+        QString text;
+        int sourceLine = 0;     // 0 表示没有对应的源码行（标签等）
+    };
+
+    explicit AssemblyView(QWidget *parent = nullptr);
+    ~AssemblyView();
+
+    void setEditor(CodeEditor *editor);
+    // 窗口不可见时不做后台编译
+    void setActive(bool active);
+
+    static QList<AsmLine> parseAssembly(const QString &assembly);
+
+private slots:
+    void scheduleRecompile();
+    void recompile();
+    void onCompileFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onEditorCursorMoved();
+    void onAsmCursorMoved();
+
+private:
+    QStringList compileFlags() const;
+    void saveOptions();
+    void showAssembly();
+    void updateHighlights();
+    static void demangle(QList<AsmLine> &lines);
+    static QColor lineColor(int sourceLine, bool selected);
+
+    static const int IdleDelayMs = 800;
+
+    QPointer<CodeEditor> editor;
+    QTimer *idleTimer;
+    QProcess *compileProcess;
+    bool recompilePending;
+    bool active;
+    bool syncingCursor;
+    int selectedSourceLine;
+    int generation;             // 每次切换编辑器加一，丢弃旧编辑器的编译结果
+    int runningGeneration;
+
+    QComboBox *profileCombo;
+    QLineEdit *flagsEdit;
+    QCheckBox *intelCheck;
+    QCheckBox *verboseCheck;
+    QLabel *statusLabel;
+    QPlainTextEdit *asmEdit;
+
+    QList<AsmLine> asmLines;
+    QHash<int, int> firstAsmRow;    // 源码行 -> 第一条对应指令所在行
+};
@@ -0,0 +1,222 @@
+#include "benchmarkpanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileInfo>
+#include <QDir>
+#include <QHash>
+#include <QSettings>
+
+namespace {
+// 显示格式化文本，按 UserRole 中的数值排序
+class NumericItem : public QTableWidgetItem
+{
+public:
+    NumericItem(const QString &text, double value)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+enum Column
+{
+    NameColumn,
+    RealTimeColumn,
+    CpuTimeColumn,
+    IterationsColumn,
+    RateColumn,
+    PreviousColumn,
+    ChangeColumn,
+    ColumnCount
+};
+
+// 变化小于该比例时视为噪声，不标颜色
+const double NoiseThreshold = 0.02;
+}
+
+BenchmarkPanel::BenchmarkPanel(QWidget *parent)
+    : QWidget(parent)
+    , runner(new BenchmarkRunner(this))
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *toolLayout = new QHBoxLayout();
+    runButton = new QPushButton("运行基准测试", this);
+    filterEdit = new QLineEdit(this);
+    filterEdit->setPlaceholderText("过滤（正则表达式，传给 --benchmark_filter）");
+    filterEdit->setText(QSettings("LionCPP", "IDE").value("benchmark/filter").toString());
+    projectLabel = new QLabel(this);
+    statusLabel = new QLabel(this);
+
+    toolLayout->addWidget(runButton);
+    toolLayout->addWidget(filterEdit, 1);
+    toolLayout->addWidget(projectLabel);
+    toolLayout->addWidget(statusLabel);
+    layout->addLayout(toolLayout);
+
+    table = new QTableWidget(0, ColumnCount, this);
+    table->setHorizontalHeaderLabels(QStringList() << "名称" << "时间" << "CPU 时间" << "迭代次数"
+                                                   << "吞吐量" << "上次 CPU 时间" << "变化");
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSortingEnabled(true);
+    layout->addWidget(table);
+
+    conditionsLabel = new QLabel(this);
+    layout->addWidget(conditionsLabel);
+
+    connect(runButton, &QPushButton::clicked, this, [this]() {
+        if (runner->isRunning()) {
+            stop();
+        } else {
+            runBenchmarks();
+        }
+    });
+    connect(runner, &BenchmarkRunner::output, this, &BenchmarkPanel::output);
+    connect(runner, &BenchmarkRunner::configured, this, &BenchmarkPanel::configured);
+    connect(runner, &BenchmarkRunner::stageChanged, statusLabel, &QLabel::setText);
+    connect(runner, &BenchmarkRunner::finished, this, &BenchmarkPanel::onFinished);
+
+    updateButtons();
+}
+
+void BenchmarkPanel::setProjectDirectory(const QString &directory)
+{
+    if (runner->isRunning() || directory == currentProject) return;
+    currentProject = directory;
+    projectLabel->setText(directory.isEmpty() ? QString() : "项目: " + QFileInfo(directory).fileName());
+
+    // 打开项目时显示最近一次的结果
+    QString resultsDir = BenchmarkRunner::resultsDirectory(directory);
+    showResults(BenchmarkRunner::loadResults(QDir(resultsDir).filePath("latest.json")),
+                BenchmarkRunner::loadResults(QDir(resultsDir).filePath("previous.json")));
+    showConditions(BenchmarkRunner::loadConditions(QDir(resultsDir).filePath("latest.json")));
+    updateButtons();
+}
+
+void BenchmarkPanel::runBenchmarks()
+{
+    if (currentProject.isEmpty() || runner->isRunning()) return;
+
+    QSettings("LionCPP", "IDE").setValue("benchmark/filter", filterEdit->text());
+    MeasurementConditions conditions = MeasurementEnvironment::check();
+    for (const QString &warning : std::as_const(conditions.warnings)) {
+        emit output("测量环境警告: " + warning + "\n");
+    }
+    if (!runner->start(currentProject, filterEdit->text().trimmed(), conditions)) {
+        statusLabel->setText("无法创建结果目录");
+        return;
+    }
+    updateButtons();
+}
+
+void BenchmarkPanel::stop()
+{
+    runner->stop();
+}
+
+void BenchmarkPanel::updateButtons()
+{
+    runButton->setText(runner->isRunning() ? "停止" : "运行基准测试");
+    runButton->setEnabled(runner->isRunning() || !currentProject.isEmpty());
+}
+
+void BenchmarkPanel::onFinished(bool success, const QList<BenchmarkResult> &results,
+                                const QList<BenchmarkResult> &previous)
+{
+    updateButtons();
+    if (!success) {
+        statusLabel->setText("运行失败");
+        return;
+    }
+    statusLabel->setText(QString("完成：%1 项").arg(results.size()));
+    showResults(results, previous);
+    showConditions(BenchmarkRunner::loadConditions(
+        QDir(BenchmarkRunner::resultsDirectory(currentProject)).filePath("latest.json")));
+}
+
+void BenchmarkPanel::showConditions(const MeasurementConditions &conditions)
+{
+    if (!conditions.timestamp.isValid()) {
+        conditionsLabel->clear();
+        conditionsLabel->setToolTip(QString());
+        return;
+    }
+    conditionsLabel->setText("测量条件：" + MeasurementEnvironment::summary(conditions)
+                             + (conditions.warnings.isEmpty() ? QString()
+                                : QString("（%1 条警告）").arg(conditions.warnings.size())));
+    conditionsLabel->setStyleSheet(conditions.warnings.isEmpty() ? QString() : "color: #d7ba7d;");
+    conditionsLabel->setToolTip(conditions.warnings.join('\n'));
+}
+
+void BenchmarkPanel::showResults(const QList<BenchmarkResult> &results, const QList<BenchmarkResult> &previous)
+{
+    QHash<QString, const BenchmarkResult*> previousByName;
+    for (const BenchmarkResult &result : previous) {
+        previousByName.insert(result.name, &result);
+    }
+
+    // 填充期间关闭排序，否则每插入一格行号都会变化
+    table->setSortingEnabled(false);
+    table->setRowCount(0);
+    for (const BenchmarkResult &result : results) {
+        int row = table->rowCount();
+        table->insertRow(row);
+
+        table->setItem(row, NameColumn, new QTableWidgetItem(result.name));
+        table->setItem(row, RealTimeColumn, new NumericItem(formatTime(result.realTimeNs), result.realTimeNs));
+        table->setItem(row, CpuTimeColumn, new NumericItem(formatTime(result.cpuTimeNs), result.cpuTimeNs));
+        table->setItem(row, IterationsColumn,
+                       new NumericItem(result.aggregate.isEmpty() ? QString::number(result.iterations) : QString(),
+                                       result.iterations));
+
+        double rate = result.bytesPerSecond > 0 ? result.bytesPerSecond : result.itemsPerSecond;
+        QString rateText;
+        if (result.bytesPerSecond > 0) rateText = formatRate(result.bytesPerSecond) + "B/s";
+        else if (result.itemsPerSecond > 0) rateText = formatRate(result.itemsPerSecond) + " 项/s";
+        table->setItem(row, RateColumn, new NumericItem(rateText, rate));
+
+        const BenchmarkResult *old = previousByName.value(result.name);
+        if (old && old->cpuTimeNs > 0) {
+            double change = (result.cpuTimeNs - old->cpuTimeNs) / old->cpuTimeNs;
+            table->setItem(row, PreviousColumn, new NumericItem(formatTime(old->cpuTimeNs), old->cpuTimeNs));
+            NumericItem *changeItem = new NumericItem(QString("%1%2%").arg(change >= 0 ? "+" : "")
+                                                      .arg(change * 100, 0, 'f', 1), change);
+            if (change <= -NoiseThreshold) changeItem->setForeground(QColor("#4ec9b0"));
+            else if (change >= NoiseThreshold) changeItem->setForeground(QColor("#f44747"));
+            table->setItem(row, ChangeColumn, changeItem);
+        } else {
+            table->setItem(row, PreviousColumn, new NumericItem(QString(), 0));
+            table->setItem(row, ChangeColumn, new NumericItem(QString(), 0));
+        }
+    }
+    table->setSortingEnabled(true);
+    table->resizeColumnsToContents();
+    table->horizontalHeader()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+}
+
+QString BenchmarkPanel::formatTime(double nanoseconds)
+{
+    if (nanoseconds < 1e3) return QString("%1 ns").arg(nanoseconds, 0, 'f', 1);
+    if (nanoseconds < 1e6) return QString("%1 us").arg(nanoseconds / 1e3, 0, 'f', 2);
+    if (nanoseconds < 1e9) return QString("%1 ms").arg(nanoseconds / 1e6, 0, 'f', 2);
+    return QString("%1 s").arg(nanoseconds / 1e9, 0, 'f', 3);
+}
+
+QString BenchmarkPanel::formatRate(double perSecond)
+{
+    if (perSecond >= 1e9) return QString("%1 G").arg(perSecond / 1e9, 0, 'f', 2);
+    if (perSecond >= 1e6) return QString("%1 M").arg(perSecond / 1e6, 0, 'f', 2);
+    if (perSecond >= 1e3) return QString("%1 k").arg(perSecond / 1e3, 0, 'f', 2);
+    return QString::number(perSecond, 'f', 1) + " ";
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QLineEdit>
+#include <QLabel>
+
+#include "benchmarkrunner.h"
+
+// 基准测试窗口
+// 运行当前基准测试项目，结果表格可按任意列排序，并与上一次运行对比
+class BenchmarkPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BenchmarkPanel(QWidget *parent = nullptr);
+
+    void setProjectDirectory(const QString &directory);
+    QString projectDirectory() const { return currentProject; }
+    void runBenchmarks();
+    void stop();
+    bool isRunning() const { return runner->isRunning(); }
+
+    static QString formatTime(double nanoseconds);
+    static QString formatRate(double perSecond);
+
+signals:
+    void output(const QString &text);
+    void configured(const QString &buildDirectory);
+
+private slots:
+    void onFinished(bool success, const QList<BenchmarkResult> &results, const QList<BenchmarkResult> &previous);
+
+private:
+    void showResults(const QList<BenchmarkResult> &results, const QList<BenchmarkResult> &previous);
+    void showConditions(const MeasurementConditions &conditions);
+    void updateButtons();
+
+    BenchmarkRunner *runner;
+    QTableWidget *table;
+    QPushButton *runButton;
+    QLineEdit *filterEdit;
+    QLabel *projectLabel;
+    QLabel *statusLabel;
+    QLabel *conditionsLabel;
+    QString currentProject;
+};
@@ -0,0 +1,287 @@
+#include "benchmarkrunner.h"
+#include "compilationdatabase.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRegularExpression>
+
+namespace {
+// 结果文件中保存测量条件的字段
+const char ConditionsKey[] = "lioncpp_conditions";
+
+double toNanoseconds(double value, const QString &unit)
+{
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s") return value * 1e9;
+    return value;
+}
+}
+
+BenchmarkRunner::BenchmarkRunner(QObject *parent)
+    : QObject(parent)
+    , process(new QProcess(this))
+    , stage(Stage::Idle)
+{
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        emit output(QString::fromUtf8(process->readAllStandardOutput()));
+    });
+    connect(process, &QProcess::finished, this, &BenchmarkRunner::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart && stage != Stage::Idle) {
+            emit output("无法启动: " + process->program() + "\n");
+            finish(false);
+        }
+    });
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+    if (process->state() != QProcess::NotRunning) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+QString BenchmarkRunner::findProjectDirectory(const QString &sourcePath)
+{
+    QDir dir = QFileInfo(sourcePath).absoluteDir();
+    for (int depth = 0; depth < 5; ++depth) {
+        QFile cmakeFile(dir.filePath("CMakeLists.txt"));
+        if (cmakeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            if (QString::fromUtf8(cmakeFile.readAll()).contains("benchmark::benchmark")) {
+                return dir.absolutePath();
+            }
+        }
+        if (!dir.cdUp()) break;
+    }
+    return QString();
+}
+
+QString BenchmarkRunner::resultsDirectory(const QString &projectDirectory)
+{
+    return QDir(projectDirectory).filePath(".lioncpp/benchmarks");
+}
+
+bool BenchmarkRunner::start(const QString &projectDirectory, const QString &filter,
+                            const MeasurementConditions &conditions)
+{
+    if (isRunning()) return false;
+
+    this->projectDirectory = projectDirectory;
+    this->filter = filter;
+    this->conditions = conditions;
+    // 只有基准程序本身按测量条件运行，配置和构建不受影响
+    MeasurementEnvironment::applyTo(process, MeasurementConditions());
+    buildDirectory = QDir(projectDirectory).filePath("build-release");
+
+    QString results = resultsDirectory(projectDirectory);
+    if (!QDir().mkpath(results)) return false;
+    outputFile = QDir(results).filePath("current.json");
+
+    // 没有开启编译数据库导出的旧构建目录重新配置一次
+    if (CompilationDatabase::isExportEnabled(buildDirectory)) {
+        build();
+    } else {
+        configure();
+    }
+    return true;
+}
+
+void BenchmarkRunner::stop()
+{
+    if (!isRunning()) return;
+    // 先回到空闲状态，被终止的进程结束时不再继续后面的步骤
+    stage = Stage::Idle;
+    process->kill();
+    process->waitForFinished(1000);
+    emit output("--- 已停止 ---\n");
+    emit finished(false, QList<BenchmarkResult>(), QList<BenchmarkResult>());
+}
+
+void BenchmarkRunner::configure()
+{
+    stage = Stage::Configuring;
+    emit stageChanged("正在配置 (Release)...");
+
+    QStringList arguments;
+    arguments << "-S" << projectDirectory;
+    arguments << "-B" << buildDirectory;
+    arguments << "-DCMAKE_BUILD_TYPE=Release";
+    arguments << "-DCMAKE_EXPORT_COMPILE_COMMANDS=ON";
+    process->setWorkingDirectory(projectDirectory);
+    process->start("cmake", arguments);
+}
+
+void BenchmarkRunner::build()
+{
+    stage = Stage::Building;
+    emit stageChanged("正在构建...");
+
+    QStringList arguments;
+    arguments << "--build" << buildDirectory << "--config" << "Release" << "--parallel";
+    process->setWorkingDirectory(projectDirectory);
+    process->start("cmake", arguments);
+}
+
+QString BenchmarkRunner::executablePath() const
+{
+    // 可执行文件名取 CMakeLists.txt 中第一个 add_executable 的目标名
+    static const QRegularExpression targetPattern(QStringLiteral("add_executable\\s*\\(\\s*([^\\s)]+)"));
+
+    QFile cmakeFile(QDir(projectDirectory).filePath("CMakeLists.txt"));
+    QString target = QFileInfo(projectDirectory).fileName();
+    if (cmakeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QRegularExpressionMatch match = targetPattern.match(QString::fromUtf8(cmakeFile.readAll()));
+        if (match.hasMatch() && !match.captured(1).contains("${")) {
+            target = match.captured(1);
+        }
+    }
+    return QDir(buildDirectory).filePath(target);
+}
+
+void BenchmarkRunner::runBenchmark()
+{
+    stage = Stage::Running;
+    emit stageChanged("正在运行基准测试...");
+
+    // 控制台格式的进度照常输出，JSON 结果单独写入文件，避免与程序自己的输出混在一起
+    QFile::remove(outputFile);
+    QStringList arguments;
+    arguments << "--benchmark_out=" + outputFile << "--benchmark_out_format=json";
+    if (!filter.isEmpty()) {
+        arguments << "--benchmark_filter=" + filter;
+    }
+    process->setWorkingDirectory(projectDirectory);
+    MeasurementEnvironment::applyTo(process, conditions);
+    process->start(executablePath(), arguments);
+}
+
+void BenchmarkRunner::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (stage == Stage::Idle) return;
+
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        switch (stage) {
+        case Stage::Configuring: emit output("CMake 配置失败\n"); break;
+        case Stage::Building:    emit output("构建失败\n"); break;
+        case Stage::Running:     emit output(QString("基准程序异常退出，返回值 %1\n").arg(exitCode)); break;
+        case Stage::Idle:        break;
+        }
+        finish(false);
+        return;
+    }
+
+    switch (stage) {
+    case Stage::Configuring:
+        emit configured(buildDirectory);
+        build();
+        break;
+    case Stage::Building:
+        runBenchmark();
+        break;
+    case Stage::Running:
+        finish(true);
+        break;
+    case Stage::Idle:
+        break;
+    }
+}
+
+void BenchmarkRunner::finish(bool success)
+{
+    stage = Stage::Idle;
+    if (!success) {
+        emit finished(false, QList<BenchmarkResult>(), QList<BenchmarkResult>());
+        return;
+    }
+
+    QFile file(outputFile);
+    QString errorMessage;
+    QList<BenchmarkResult> results;
+    if (file.open(QIODevice::ReadWrite)) {
+        QByteArray json = file.readAll();
+        results = parseJson(json, &errorMessage);
+        // 把测量条件写进结果文件，之后查看历史结果时也能知道运行环境
+        QJsonObject root = QJsonDocument::fromJson(json).object();
+        if (errorMessage.isEmpty() && !root.isEmpty()) {
+            root.insert(ConditionsKey, MeasurementEnvironment::toJson(conditions));
+            file.resize(0);
+            file.write(QJsonDocument(root).toJson());
+        }
+        file.close();
+    } else {
+        errorMessage = "没有找到结果文件 " + outputFile;
+    }
+    if (!errorMessage.isEmpty()) {
+        emit output("无法读取基准测试结果: " + errorMessage + "\n");
+        emit finished(false, QList<BenchmarkResult>(), QList<BenchmarkResult>());
+        return;
+    }
+
+    // 轮换结果文件：latest -> previous，current -> latest
+    QDir resultsDir(resultsDirectory(projectDirectory));
+    QString latestFile = resultsDir.filePath("latest.json");
+    QString previousFile = resultsDir.filePath("previous.json");
+    QList<BenchmarkResult> previous = loadResults(latestFile);
+    if (QFile::exists(latestFile)) {
+        QFile::remove(previousFile);
+        QFile::rename(latestFile, previousFile);
+    }
+    QFile::rename(outputFile, latestFile);
+
+    emit finished(true, results, previous);
+}
+
+QList<BenchmarkResult> BenchmarkRunner::loadResults(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return QList<BenchmarkResult>();
+    return parseJson(file.readAll());
+}
+
+MeasurementConditions BenchmarkRunner::loadConditions(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return MeasurementConditions();
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (!root.contains(ConditionsKey)) return MeasurementConditions();
+    return MeasurementEnvironment::fromJson(root.value(ConditionsKey).toObject());
+}
+
+QList<BenchmarkResult> BenchmarkRunner::parseJson(const QByteArray &json, QString *errorMessage)
+{
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        if (errorMessage) *errorMessage = parseError.errorString();
+        return QList<BenchmarkResult>();
+    }
+
+    QList<BenchmarkResult> results;
+    const QJsonArray benchmarks = doc.object().value("benchmarks").toArray();
+    for (const QJsonValue &value : benchmarks) {
+        QJsonObject obj = value.toObject();
+        // 出错的基准（SkipWithError）没有计时数据
+        if (obj.value("error_occurred").toBool()) continue;
+
+        BenchmarkResult result;
+        result.name = obj.value("name").toString();
+        if (obj.value("run_type").toString() == "aggregate") {
+            result.aggregate = obj.value("aggregate_name").toString();
+        }
+        QString unit = obj.value("time_unit").toString("ns");
+        result.realTimeNs = toNanoseconds(obj.value("real_time").toDouble(), unit);
+        result.cpuTimeNs = toNanoseconds(obj.value("cpu_time").toDouble(), unit);
+        result.iterations = obj.value("iterations").toVariant().toLongLong();
+        result.itemsPerSecond = obj.value("items_per_second").toDouble();
+        result.bytesPerSecond = obj.value("bytes_per_second").toDouble();
+        results.append(result);
+    }
+    return results;
+}
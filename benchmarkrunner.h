@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QProcess>
+
+#include "measurementenvironment.h"
+
+// 一条 Google Benchmark 结果，时间统一换算为纳秒
+struct BenchmarkResult
+{
+    QString name;
+    QString aggregate;          // mean / median / stddev，普通结果为空
+    double realTimeNs = 0;
+    double cpuTimeNs = 0;
+    qint64 iterations = 0;
+    double itemsPerSecond = 0;
+    double bytesPerSecond = 0;
+};
+
+// 基准测试项目运行器
+// 以 Release 配置 CMake 项目、构建，然后运行基准程序并以 JSON 格式收集结果。
+// 每次运行的结果保存在项目的 .lioncpp/benchmarks 目录，上一次的结果用于对比。
+// 结果文件中附带运行时的测量条件（核心绑定、调频策略等）。
+class BenchmarkRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BenchmarkRunner(QObject *parent = nullptr);
+    ~BenchmarkRunner();
+
+    bool start(const QString &projectDirectory, const QString &filter = QString(),
+               const MeasurementConditions &conditions = MeasurementConditions());
+    void stop();
+    bool isRunning() const { return stage != Stage::Idle; }
+
+    // 从源文件所在目录向上查找链接了 benchmark::benchmark 的 CMake 项目
+    static QString findProjectDirectory(const QString &sourcePath);
+    static QString resultsDirectory(const QString &projectDirectory);
+    static QList<BenchmarkResult> parseJson(const QByteArray &json, QString *errorMessage = nullptr);
+    static QList<BenchmarkResult> loadResults(const QString &filePath);
+    // 没有记录测量条件时 timestamp 无效
+    static MeasurementConditions loadConditions(const QString &filePath);
+
+signals:
+    void output(const QString &text);
+    void stageChanged(const QString &description);
+    // CMake 配置成功，构建目录中已经生成编译数据库
+    void configured(const QString &buildDirectory);
+    void finished(bool success, const QList<BenchmarkResult> &results, const QList<BenchmarkResult> &previous);
+
+private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    enum class Stage { Idle, Configuring, Building, Running };
+
+    void configure();
+    void build();
+    void runBenchmark();
+    void finish(bool success);
+    QString executablePath() const;
+
+    QProcess *process;
+    Stage stage;
+    QString projectDirectory;
+    QString buildDirectory;
+    QString filter;
+    QString outputFile;
+    MeasurementConditions conditions;
+};
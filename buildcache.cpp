@@ -0,0 +1,212 @@
+#include "buildcache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSettings>
+#include <QStandardPaths>
+#include <algorithm>
+
+// 递归收集源文件及其引用的本地头文件（#include "..."），用于计算缓存键
+static void hashSourceTree(const QString &filePath, QCryptographicHash &hash, QSet<QString> &visited)
+{
+    QString canonical = QFileInfo(filePath).canonicalFilePath();
+    if (canonical.isEmpty() || visited.contains(canonical)) return;
+    visited.insert(canonical);
+
+    QFile file(canonical);
+    if (!file.open(QIODevice::ReadOnly)) return;
+    QByteArray content = file.readAll();
+    hash.addData(canonical.toUtf8());
+    hash.addData(content);
+
+    static const QRegularExpression includeRegex(QStringLiteral("^\\s*#\\s*include\\s*\"([^\"]+)\""),
+                                                 QRegularExpression::MultilineOption);
+    QDir dir = QFileInfo(canonical).absoluteDir();
+    QRegularExpressionMatchIterator it = includeRegex.globalMatch(QString::fromUtf8(content));
+    while (it.hasNext()) {
+        QString header = dir.filePath(it.next().captured(1));
+        if (QFile::exists(header)) {
+            hashSourceTree(header, hash, visited);
+        }
+    }
+}
+
+BuildCache::BuildCache(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BuildCache::~BuildCache()
+{
+    cancelAll();
+}
+
+QString BuildCache::compilerPath()
+{
+    QSettings settings("LionCPP", "IDE");
+    QString compiler = settings.value("compiler/path", "g++").toString();
+    return compiler.isEmpty() ? QString("g++") : compiler;
+}
+
+QStringList BuildCache::compileArguments(const QString &sourcePath, const QString &outputPath,
+                                         const QStringList &extraFlags)
+{
+    // 与编译菜单一致的基础参数，额外参数放在后面以便覆盖优化级别等选项
+    QStringList arguments;
+    arguments << "-std=c++17" << "-Wall" << "-O2";
+    arguments << extraFlags;
+    arguments << "-o" << outputPath << sourcePath;
+    return arguments;
+}
+
+QString BuildCache::cacheRoot() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/builds";
+}
+
+QString BuildCache::cacheKey(const QString &sourcePath, const QStringList &extraFlags) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QSet<QString> visited;
+    hashSourceTree(sourcePath, hash, visited);
+    hash.addData(compilerPath().toUtf8());
+    hash.addData(compileArguments(QString(), QString(), extraFlags).join('\n').toUtf8());
+    return QString::fromLatin1(hash.result().toHex().left(16));
+}
+
+QString BuildCache::cachedExecutablePath(const QString &sourcePath, const QString &profile,
+                                         const QStringList &extraFlags) const
+{
+    QFileInfo sourceInfo(sourcePath);
+    return QString("%1/%2/%3/%4")
+        .arg(cacheRoot(), profile, cacheKey(sourcePath, extraFlags), sourceInfo.completeBaseName());
+}
+
+bool BuildCache::isCached(const QString &sourcePath, const QString &profile,
+                          const QStringList &extraFlags) const
+{
+    return QFile::exists(cachedExecutablePath(sourcePath, profile, extraFlags));
+}
+
+void BuildCache::build(const QString &sourcePath, const QString &profile,
+                       const QStringList &extraFlags, Callback callback)
+{
+    Result result;
+    result.executablePath = cachedExecutablePath(sourcePath, profile, extraFlags);
+
+    if (QFile::exists(result.executablePath)) {
+        // 修改时间记为最近使用时间，淘汰时据此排序
+        QFile executable(result.executablePath);
+        if (executable.open(QIODevice::ReadOnly)) {
+            executable.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        }
+        result.success = true;
+        result.cached = true;
+        callback(result);
+        return;
+    }
+
+    QFileInfo outputInfo(result.executablePath);
+    QDir().mkpath(outputInfo.absolutePath());
+
+    // 先输出到临时文件名，编译成功后再改名，避免中断的编译留下不完整的缓存
+    QString partialPath = result.executablePath + ".partial";
+
+    QProcess *process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    process->setWorkingDirectory(QFileInfo(sourcePath).absolutePath());
+    activeProcesses.append(process);
+
+    connect(process, &QProcess::finished, this,
+        [this, process, result, partialPath, callback](int exitCode, QProcess::ExitStatus exitStatus) mutable {
+            activeProcesses.removeAll(process);
+            result.output = QString::fromUtf8(process->readAll());
+            result.success = exitStatus == QProcess::NormalExit && exitCode == 0
+                             && QFile::rename(partialPath, result.executablePath);
+            if (!result.success) {
+                QFile::remove(partialPath);
+            }
+            process->deleteLater();
+            if (result.success) prune(result.executablePath);
+            callback(result);
+        });
+    connect(process, &QProcess::errorOccurred, this,
+        [this, process, result, callback](QProcess::ProcessError error) mutable {
+            if (error != QProcess::FailedToStart) return;
+            activeProcesses.removeAll(process);
+            result.output = "无法启动编译器: " + compilerPath();
+            process->deleteLater();
+            callback(result);
+        });
+
+    process->start(compilerPath(), compileArguments(sourcePath, partialPath, extraFlags));
+}
+
+void BuildCache::cancelAll()
+{
+    const QList<QProcess*> processes = activeProcesses;
+    activeProcesses.clear();
+    for (QProcess *process : processes) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+        process->deleteLater();
+    }
+}
+
+void BuildCache::clear(const QString &profile)
+{
+    QDir dir(profile.isEmpty() ? cacheRoot() : cacheRoot() + "/" + profile);
+    if (dir.exists()) {
+        dir.removeRecursively();
+    }
+}
+
+void BuildCache::prune(const QString &keep)
+{
+    QSettings settings("LionCPP", "IDE");
+    const qint64 maxSize = settings.value("buildCache/maxSizeMB", DefaultMaxSizeMB).toLongLong() * 1024 * 1024;
+    const QDateTime oldest = QDateTime::currentDateTime().addDays(-settings.value("buildCache/maxAgeDays", DefaultMaxAgeDays).toInt());
+    const QString keepDirectory = QFileInfo(keep).absolutePath();
+
+    // 缓存目录结构为 <配置>/<缓存键>/<可执行文件>，以缓存键目录为淘汰单位
+    struct Entry
+    {
+        QString directory;
+        QDateTime lastUsed;
+        qint64 size = 0;
+    };
+    QList<Entry> entries;
+    qint64 totalSize = 0;
+
+    const QFileInfoList profiles = QDir(cacheRoot()).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &profile : profiles) {
+        const QFileInfoList keys = QDir(profile.absoluteFilePath()).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo &key : keys) {
+            Entry entry;
+            entry.directory = key.absoluteFilePath();
+            entry.lastUsed = key.lastModified();
+            const QFileInfoList files = QDir(entry.directory).entryInfoList(QDir::Files);
+            for (const QFileInfo &file : files) {
+                entry.size += file.size();
+                entry.lastUsed = qMax(entry.lastUsed, file.lastModified());
+            }
+            totalSize += entry.size;
+            if (entry.directory != keepDirectory) entries.append(entry);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (const Entry &entry : std::as_const(entries)) {
+        if (totalSize <= maxSize && entry.lastUsed >= oldest) break;
+        // 正在编译的产物还是 .partial，删除目录会让编译失败，跳过
+        if (!QDir(entry.directory).entryList({"*.partial"}, QDir::Files).isEmpty()) continue;
+        if (QDir(entry.directory).removeRecursively()) totalSize -= entry.size;
+    }
+}
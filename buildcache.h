@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QProcess>
+#include <QList>
+#include <functional>
+
+// 单文件构建缓存
+// 每个构建配置（普通、ASan、TSan……）使用独立的缓存目录，
+// 源码内容、编译器和参数都未变化时直接复用上一次的产物。
+// 每次成功编译后按最近使用时间淘汰：超过保留天数的产物删除，总大小超过上限时从最久未用的开始删除
+class BuildCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        bool success = false;
+        bool cached = false;
+        QString executablePath;
+        QString output;
+    };
+    using Callback = std::function<void(const Result &result)>;
+
+    explicit BuildCache(QObject *parent = nullptr);
+    ~BuildCache();
+
+    // 编译参数构造（普通编译与各种运行模式共用）
+    static QString compilerPath();
+    static QStringList compileArguments(const QString &sourcePath, const QString &outputPath,
+                                        const QStringList &extraFlags = QStringList());
+
+    QString cachedExecutablePath(const QString &sourcePath, const QString &profile,
+                                 const QStringList &extraFlags) const;
+    bool isCached(const QString &sourcePath, const QString &profile,
+                  const QStringList &extraFlags) const;
+    void build(const QString &sourcePath, const QString &profile,
+               const QStringList &extraFlags, Callback callback);
+    void cancelAll();
+    void clear(const QString &profile = QString());
+    QString cacheRoot() const;
+
+private:
+    static const int DefaultMaxSizeMB = 1024;
+    static const int DefaultMaxAgeDays = 30;
+
+    // keep 为刚生成的产物，不会被淘汰
+    void prune(const QString &keep);
+    QString cacheKey(const QString &sourcePath, const QStringList &extraFlags) const;
+
+    QList<QProcess*> activeProcesses;
+};
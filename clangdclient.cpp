@@ -0,0 +1,569 @@
+#include "clangdclient.h"
+#include <QThread>
+#include <QProcess>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QFileInfo>
+#include <QUrl>
+#include <QStandardPaths>
+#include <QCoreApplication>
+
+namespace {
+const int ShutdownTimeout = 1000;
+const int IncrementalSync = 2;
+const qsizetype CompactThreshold = 64 * 1024;
+
+// Content-Length 分帧的非阻塞解析器：只处理已经到达的字节，不完整的消息留到下次数据到达时继续
+class MessageParser
+{
+public:
+    void append(const QByteArray &data) { buffer.append(data); }
+    bool next(QByteArray *body);
+
+private:
+    QByteArray buffer;
+    qsizetype offset = 0;
+    qsizetype contentLength = -1;   // -1 表示还在等待消息头
+};
+
+bool MessageParser::next(QByteArray *body)
+{
+    while (contentLength < 0) {
+        const qsizetype headerEnd = buffer.indexOf("\r\n\r\n", offset);
+        if (headerEnd < 0) return false;
+        for (const QByteArray &line : buffer.mid(offset, headerEnd - offset).split('\n')) {
+            const qsizetype colon = line.indexOf(':');
+            if (colon > 0 && line.left(colon).trimmed().toLower() == "content-length") {
+                contentLength = line.mid(colon + 1).trimmed().toLongLong();
+            }
+        }
+        // 没有长度的消息头无法分帧，跳过
+        offset = headerEnd + 4;
+    }
+    if (buffer.size() - offset < contentLength) return false;
+
+    *body = buffer.mid(offset, contentLength);
+    offset += contentLength;
+    contentLength = -1;
+
+    // 已处理的数据积累到一定量再一次性移除，避免每条消息都搬动缓冲区
+    if (offset == buffer.size()) {
+        buffer.clear();
+        offset = 0;
+    } else if (offset > CompactThreshold) {
+        buffer.remove(0, offset);
+        offset = 0;
+    }
+    return true;
+}
+
+QJsonObject makeRequest(int id, const QString &method, const QJsonObject &params)
+{
+    return QJsonObject{{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", params}};
+}
+
+QJsonObject makeNotification(const QString &method, const QJsonObject &params)
+{
+    return QJsonObject{{"jsonrpc", "2.0"}, {"method", method}, {"params", params}};
+}
+
+QJsonObject lspPosition(int line, int character)
+{
+    return QJsonObject{{"line", line}, {"character", character}};
+}
+
+// 与 QTextDocument::toPlainText 的转换一致
+QString plainText(QString text)
+{
+    for (QChar &ch : text) {
+        if (ch == QChar::ParagraphSeparator || ch == QChar::LineSeparator) ch = '\n';
+        else if (ch == QChar::Nbsp) ch = ' ';
+    }
+    return text;
+}
+
+QString languageId(const QString &filePath)
+{
+    return QFileInfo(filePath).suffix() == "c" ? "c" : "cpp";
+}
+
+// MarkupContent、MarkedString 或它们的数组
+QString hoverText(const QJsonValue &contents)
+{
+    if (contents.isString()) return contents.toString();
+    if (contents.isObject()) return contents.toObject().value("value").toString();
+
+    QStringList parts;
+    for (const QJsonValue &part : contents.toArray()) {
+        const QString text = hoverText(part);
+        if (!text.isEmpty()) parts.append(text);
+    }
+    return parts.join("\n\n");
+}
+}
+
+// 在 I/O 线程中运行：启动 clangd、写入消息、解析输出。
+// 两个回调在 I/O 线程中调用，由客户端投递回界面线程
+class ClangdConnection : public QObject
+{
+public:
+    std::function<void(const QJsonObject &message)> messageReceived;
+    std::function<void(const QString &message)> finished;
+
+    void start(const QString &program, const QStringList &arguments);
+    void write(const QJsonObject &message);
+    // 按协议请求 clangd 退出，超时后强制结束，然后删除自己
+    void shutdown();
+
+private:
+    void readOutput();
+
+    QProcess *process = nullptr;
+    MessageParser parser;
+};
+
+void ClangdConnection::start(const QString &program, const QStringList &arguments)
+{
+    process = new QProcess(this);
+    process->setStandardErrorFile(QProcess::nullDevice());
+    connect(process, &QProcess::readyReadStandardOutput, this, &ClangdConnection::readOutput);
+    connect(process, &QProcess::finished, this, [this](int exitCode, QProcess::ExitStatus exitStatus) {
+        if (!finished) return;
+        finished(exitStatus == QProcess::CrashExit ? QString("clangd 异常退出")
+                                                   : QString("clangd 已退出，返回值 %1").arg(exitCode));
+    });
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart && finished) finished("无法启动 clangd: " + process->errorString());
+    });
+
+    // 这是专用线程，等待进程启动不会影响界面
+    process->start(program, arguments);
+    process->waitForStarted();
+}
+
+void ClangdConnection::write(const QJsonObject &message)
+{
+    if (!process || process->state() != QProcess::Running) return;
+    const QByteArray body = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    process->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+}
+
+void ClangdConnection::readOutput()
+{
+    parser.append(process->readAllStandardOutput());
+    QByteArray body;
+    while (parser.next(&body)) {
+        const QJsonDocument document = QJsonDocument::fromJson(body);
+        if (document.isObject() && messageReceived) messageReceived(document.object());
+    }
+}
+
+void ClangdConnection::shutdown()
+{
+    messageReceived = nullptr;
+    finished = nullptr;
+    if (process && process->state() == QProcess::Running) {
+        write(QJsonObject{{"jsonrpc", "2.0"}, {"id", 0}, {"method", "shutdown"}});
+        write(makeNotification("exit", QJsonObject()));
+        process->closeWriteChannel();
+        if (!process->waitForFinished(ShutdownTimeout)) {
+            process->kill();
+            process->waitForFinished(ShutdownTimeout);
+        }
+    }
+    deleteLater();
+}
+
+ClangdClient::ClangdClient(QObject *parent)
+    : QObject(parent)
+    , ioThread(new QThread(this))
+    , connection(nullptr)
+    , generation(0)
+    , initialized(false)
+    , incrementalSync(true)
+    , nextRequestId(1)
+    , hoverRequest(0)
+{
+    ioThread->setObjectName("clangd I/O");
+}
+
+ClangdClient::~ClangdClient()
+{
+    if (connection) {
+        ClangdConnection *target = connection;
+        connection = nullptr;
+        QMetaObject::invokeMethod(target, [target]() { target->shutdown(); }, Qt::BlockingQueuedConnection);
+    }
+    ioThread->quit();
+    ioThread->wait();
+}
+
+QString ClangdClient::findClangd()
+{
+    // 发行版常以带版本号的名字安装
+    QStringList names{"clangd"};
+    for (int version = 20; version >= 12; --version) names.append(QString("clangd-%1").arg(version));
+
+    for (const QString &name : std::as_const(names)) {
+        const QString path = QStandardPaths::findExecutable(name);
+        if (!path.isEmpty()) return path;
+    }
+    return QString();
+}
+
+bool ClangdClient::start(const QString &program, const QString &rootPath, const QString &compileCommandsDir,
+                         QString *errorMessage)
+{
+    stop();
+    if (!QFileInfo(program).isExecutable()) {
+        if (errorMessage) *errorMessage = "clangd 不可执行: " + program;
+        return false;
+    }
+
+    QStringList arguments{"--log=error", "--header-insertion=never", "--pch-storage=memory"};
+    if (!compileCommandsDir.isEmpty()) arguments.append("--compile-commands-dir=" + compileCommandsDir);
+
+    if (!ioThread->isRunning()) ioThread->start();
+    const int serverGeneration = ++generation;
+    connection = new ClangdConnection;
+    connection->moveToThread(ioThread);
+
+    // 投递到界面线程处理；generation 用来丢弃已经停止的服务器发来的消息
+    connection->messageReceived = [this, serverGeneration](const QJsonObject &message) {
+        QMetaObject::invokeMethod(this, [this, serverGeneration, message]() {
+            handleMessage(serverGeneration, message);
+        }, Qt::QueuedConnection);
+    };
+    connection->finished = [this, serverGeneration](const QString &message) {
+        QMetaObject::invokeMethod(this, [this, serverGeneration, message]() {
+            handleStopped(serverGeneration, message);
+        }, Qt::QueuedConnection);
+    };
+    ClangdConnection *target = connection;
+    QMetaObject::invokeMethod(target, [target, program, arguments]() { target->start(program, arguments); },
+                              Qt::QueuedConnection);
+
+    const QJsonObject capabilities{
+        {"textDocument", QJsonObject{
+            {"synchronization", QJsonObject{{"didSave", true}}},
+            {"completion", QJsonObject{{"completionItem", QJsonObject{{"snippetSupport", false}}}}},
+            {"hover", QJsonObject{{"contentFormat", QJsonArray{"plaintext"}}}},
+            {"publishDiagnostics", QJsonObject{{"versionSupport", true}}},
+        }},
+        {"general", QJsonObject{{"positionEncodings", QJsonArray{"utf-16"}}}},
+    };
+    const QJsonObject params{
+        {"processId", QCoreApplication::applicationPid()},
+        {"rootUri", rootPath.isEmpty() ? QJsonValue(QJsonValue::Null) : QJsonValue(QUrl::fromLocalFile(rootPath).toString())},
+        {"capabilities", capabilities},
+        {"clientInfo", QJsonObject{{"name", QCoreApplication::applicationName()}}},
+    };
+
+    // initialize 是唯一不等待初始化完成就发出的请求
+    const int id = nextRequestId++;
+    pending.insert(id, PendingRequest{this, [this](const QJsonValue &result) { handleInitialized(result); }});
+    QMetaObject::invokeMethod(target, [target, id, params]() { target->write(makeRequest(id, "initialize", params)); },
+                              Qt::QueuedConnection);
+
+    // 停止期间的编辑没有同步，重新读取全文
+    for (auto it = documents.begin(); it != documents.end(); ++it) {
+        it->text = it.key()->toPlainText();
+        it->version = 0;
+        sendDidOpen(*it);
+    }
+    return true;
+}
+
+void ClangdClient::stop()
+{
+    if (!connection) return;
+
+    ++generation;
+    ClangdConnection *target = connection;
+    connection = nullptr;
+    QMetaObject::invokeMethod(target, [target]() { target->shutdown(); }, Qt::QueuedConnection);
+
+    initialized = false;
+    pending.clear();
+    backlog.clear();
+    hoverRequest = 0;
+    for (auto it = documents.begin(); it != documents.end(); ++it) {
+        it->completionRequest = 0;
+        emit diagnosticsPublished(it.key(), QList<Diagnostic>());
+    }
+}
+
+void ClangdClient::openDocument(QTextDocument *document, const QString &filePath)
+{
+    if (filePath.isEmpty()) {
+        closeDocument(document);
+        return;
+    }
+
+    const QString path = QFileInfo(filePath).absoluteFilePath();
+    auto it = documents.find(document);
+    if (it != documents.end()) {
+        if (it->filePath == path) {
+            sendNotification("textDocument/didSave", QJsonObject{{"textDocument", QJsonObject{{"uri", it->uri}}}});
+            return;
+        }
+        closeDocument(document);
+    }
+
+    Document state;
+    state.filePath = path;
+    state.uri = QUrl::fromLocalFile(path).toString();
+    state.text = document->toPlainText();
+    state.changeConnection = connect(document, &QTextDocument::contentsChange, this,
+                                     [this, document](int position, int charsRemoved, int charsAdded) {
+        onContentsChange(document, position, charsRemoved, charsAdded);
+    });
+    state.destroyedConnection = connect(document, &QObject::destroyed, this, [this, document]() {
+        closeDocument(document);
+    });
+    it = documents.insert(document, state);
+    sendDidOpen(*it);
+}
+
+void ClangdClient::closeDocument(QTextDocument *document)
+{
+    auto it = documents.find(document);
+    if (it == documents.end()) return;
+
+    disconnect(it->changeConnection);
+    disconnect(it->destroyedConnection);
+    cancelRequest(it->completionRequest);
+    sendNotification("textDocument/didClose", QJsonObject{{"textDocument", QJsonObject{{"uri", it->uri}}}});
+    documents.erase(it);
+}
+
+void ClangdClient::sendDidOpen(const Document &document)
+{
+    sendNotification("textDocument/didOpen", QJsonObject{{"textDocument", QJsonObject{
+        {"uri", document.uri},
+        {"languageId", languageId(document.filePath)},
+        {"version", document.version},
+        {"text", document.text},
+    }}});
+}
+
+void ClangdClient::onContentsChange(QTextDocument *document, int position, int charsRemoved, int charsAdded)
+{
+    // 未运行时不维护副本，启动时重新读取全文
+    auto it = documents.find(document);
+    if (it == documents.end() || !connection) return;
+
+    Document &state = *it;
+    ++state.version;
+    const int length = document->characterCount() - 1;     // 不含末尾的段落分隔符
+
+    // 整篇替换时 Qt 报告的范围包含末尾的段落分隔符，对不上副本；这种情况和服务器不支持增量时发送全文
+    QJsonObject change;
+    if (incrementalSync && position + charsRemoved <= state.text.size()
+        && state.text.size() - charsRemoved + charsAdded == length) {
+        // 改动之前的文本没有变化，起点可以直接在新文档中定位；终点按副本中被删除的文本推算
+        const QTextBlock block = document->findBlock(position);
+        const int line = block.blockNumber();
+        const int character = position - block.position();
+        const QString removed = state.text.mid(position, charsRemoved);
+        const int newlines = int(removed.count('\n'));
+        const int endCharacter = newlines == 0 ? character + charsRemoved
+                                               : charsRemoved - int(removed.lastIndexOf('\n')) - 1;
+
+        QTextCursor cursor(document);
+        cursor.setPosition(position);
+        cursor.setPosition(position + charsAdded, QTextCursor::KeepAnchor);
+        const QString inserted = plainText(cursor.selectedText());
+        state.text.replace(position, charsRemoved, inserted);
+
+        change = QJsonObject{
+            {"range", QJsonObject{{"start", lspPosition(line, character)},
+                                  {"end", lspPosition(line + newlines, endCharacter)}}},
+            {"text", inserted},
+        };
+    } else {
+        state.text = document->toPlainText();
+        change = QJsonObject{{"text", state.text}};
+    }
+
+    sendNotification("textDocument/didChange", QJsonObject{
+        {"textDocument", QJsonObject{{"uri", state.uri}, {"version", state.version}}},
+        {"contentChanges", QJsonArray{change}},
+    });
+}
+
+QJsonObject ClangdClient::positionParams(QTextDocument *document, const Document &state, int position) const
+{
+    const QTextBlock block = document->findBlock(position);
+    return QJsonObject{
+        {"textDocument", QJsonObject{{"uri", state.uri}}},
+        {"position", lspPosition(block.blockNumber(), position - block.position())},
+    };
+}
+
+void ClangdClient::requestCompletion(QTextDocument *document, int position, QObject *context,
+                                     const CompletionCallback &callback)
+{
+    auto it = documents.find(document);
+    if (it == documents.end() || !connection) return;
+
+    // 每个文档只保留最新的补全请求
+    cancelRequest(it->completionRequest);
+    it->completionRequest = sendRequest("textDocument/completion", positionParams(document, *it, position), context,
+                                        [callback](const QJsonValue &result) {
+        // 结果可以是 CompletionList，也可以直接是数组
+        const QJsonArray items = result.isArray() ? result.toArray() : result.toObject().value("items").toArray();
+        QList<CompletionItem> completions;
+        completions.reserve(items.size());
+        for (const QJsonValue &value : items) {
+            const QJsonObject item = value.toObject();
+            CompletionItem completion;
+            completion.label = item.value("label").toString().trimmed();
+            completion.detail = item.value("detail").toString();
+            completion.insertText = item.value("textEdit").toObject().value("newText").toString();
+            if (completion.insertText.isEmpty()) completion.insertText = item.value("insertText").toString();
+            if (completion.insertText.isEmpty()) completion.insertText = completion.label;
+            completions.append(completion);
+        }
+        callback(completions);
+    });
+}
+
+void ClangdClient::cancelCompletion(QTextDocument *document)
+{
+    auto it = documents.find(document);
+    if (it == documents.end()) return;
+    cancelRequest(it->completionRequest);
+    it->completionRequest = 0;
+}
+
+void ClangdClient::requestHover(QTextDocument *document, int position, QObject *context, const HoverCallback &callback)
+{
+    auto it = documents.find(document);
+    if (it == documents.end() || !connection) return;
+
+    cancelRequest(hoverRequest);
+    hoverRequest = sendRequest("textDocument/hover", positionParams(document, *it, position), context,
+                               [callback](const QJsonValue &result) {
+        callback(hoverText(result.toObject().value("contents")).trimmed());
+    });
+}
+
+void ClangdClient::send(const QJsonObject &message)
+{
+    if (!connection) return;
+    if (!initialized) {
+        backlog.append(message);
+        return;
+    }
+    ClangdConnection *target = connection;
+    QMetaObject::invokeMethod(target, [target, message]() { target->write(message); }, Qt::QueuedConnection);
+}
+
+int ClangdClient::sendRequest(const QString &method, const QJsonObject &params, QObject *context,
+                              const std::function<void(const QJsonValue &result)> &handler)
+{
+    if (!connection) return 0;
+    const int id = nextRequestId++;
+    pending.insert(id, PendingRequest{context, handler});
+    send(makeRequest(id, method, params));
+    return id;
+}
+
+void ClangdClient::sendNotification(const QString &method, const QJsonObject &params)
+{
+    send(makeNotification(method, params));
+}
+
+void ClangdClient::cancelRequest(int id)
+{
+    // 已经有结果或者已经取消的请求不再处理
+    if (id == 0 || !pending.remove(id)) return;
+
+    // 还没发出的请求直接从队列中去掉
+    if (!initialized) {
+        backlog.removeIf([id](const QJsonObject &message) { return message.value("id") == QJsonValue(id); });
+        return;
+    }
+    sendNotification("$/cancelRequest", QJsonObject{{"id", id}});
+}
+
+void ClangdClient::handleMessage(int serverGeneration, const QJsonObject &message)
+{
+    if (serverGeneration != generation) return;
+
+    const QString method = message.value("method").toString();
+    const QJsonValue id = message.value("id");
+    if (method.isEmpty()) {
+        // 响应；已取消的请求不在 pending 中，结果直接丢弃
+        const PendingRequest request = pending.take(id.toInt());
+        if (!request.handler || !request.context || message.contains("error")) return;
+        request.handler(message.value("result"));
+        return;
+    }
+
+    if (!id.isUndefined()) {
+        // 服务器发来的请求（注册能力、创建进度等）都回复空结果
+        send(QJsonObject{{"jsonrpc", "2.0"}, {"id", id}, {"result", QJsonValue(QJsonValue::Null)}});
+        return;
+    }
+    if (method == "textDocument/publishDiagnostics") {
+        handleDiagnostics(message.value("params").toObject());
+    }
+}
+
+void ClangdClient::handleInitialized(const QJsonValue &result)
+{
+    // textDocumentSync 可以是数字，也可以是带 change 的对象
+    const QJsonValue sync = result.toObject().value("capabilities").toObject().value("textDocumentSync");
+    const int change = sync.isObject() ? sync.toObject().value("change").toInt(IncrementalSync)
+                                       : sync.toInt(IncrementalSync);
+    incrementalSync = change == IncrementalSync;
+
+    initialized = true;
+    send(makeNotification("initialized", QJsonObject()));
+    const QList<QJsonObject> queued = backlog;
+    backlog.clear();
+    for (const QJsonObject &message : queued) send(message);
+}
+
+void ClangdClient::handleDiagnostics(const QJsonObject &params)
+{
+    const QString filePath = QFileInfo(QUrl(params.value("uri").toString()).toLocalFile()).absoluteFilePath();
+    for (auto it = documents.constBegin(); it != documents.constEnd(); ++it) {
+        if (it->filePath != filePath) continue;
+
+        // 旧版本的诊断位置可能已经对不上，等服务器发布最新版本的结果
+        const QJsonValue version = params.value("version");
+        if (version.isDouble() && version.toInt() != it->version) return;
+
+        QList<Diagnostic> diagnostics;
+        for (const QJsonValue &value : params.value("diagnostics").toArray()) {
+            const QJsonObject item = value.toObject();
+            const QJsonObject range = item.value("range").toObject();
+            const QJsonObject start = range.value("start").toObject();
+            const QJsonObject end = range.value("end").toObject();
+
+            Diagnostic diagnostic;
+            diagnostic.startLine = start.value("line").toInt();
+            diagnostic.startCharacter = start.value("character").toInt();
+            diagnostic.endLine = end.value("line").toInt();
+            diagnostic.endCharacter = end.value("character").toInt();
+            diagnostic.severity = item.value("severity").toInt(1);
+            diagnostic.message = item.value("message").toString();
+            diagnostics.append(diagnostic);
+        }
+        emit diagnosticsPublished(it.key(), diagnostics);
+        return;
+    }
+}
+
+void ClangdClient::handleStopped(int serverGeneration, const QString &message)
+{
+    if (serverGeneration != generation) return;
+    stop();
+    emit serverStopped(message);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QPointer>
+#include <functional>
+
+class QTextDocument;
+class QThread;
+class ClangdConnection;
+
+// clangd 语言服务客户端
+// clangd 进程由专用的 I/O 线程启动和读写：消息在该线程中序列化、按 Content-Length 分帧，
+// 读到的数据只解析已经完整到达的部分，解析好的消息再投递回界面线程。文档按
+// QTextDocument::contentsChange 的增量发送 didChange；补全和悬停请求只保留最新的一个，
+// 发出新请求时取消旧请求并丢弃它的结果，编辑器从不等待服务器。
+class ClangdClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Diagnostic
+    {
+        // 从 0 开始，列以 UTF-16 计，与 QString 下标一致
+        int startLine = 0;
+        int startCharacter = 0;
+        int endLine = 0;
+        int endCharacter = 0;
+        int severity = 1;       // 1 错误 2 警告 3 信息 4 提示
+        QString message;
+    };
+
+    struct CompletionItem
+    {
+        QString label;          // 显示用，函数带参数列表
+        QString insertText;
+        QString detail;         // 类型或返回值
+    };
+
+    using CompletionCallback = std::function<void(const QList<CompletionItem> &items)>;
+    using HoverCallback = std::function<void(const QString &text)>;
+
+    explicit ClangdClient(QObject *parent = nullptr);
+    ~ClangdClient();
+
+    // 在 PATH 中查找 clangd，找不到时返回空
+    static QString findClangd();
+
+    // compileCommandsDir 为空时由 clangd 从源文件所在目录向上查找 compile_commands.json。
+    // 已登记的文档在初始化完成后重新打开
+    bool start(const QString &program, const QString &rootPath, const QString &compileCommandsDir,
+               QString *errorMessage = nullptr);
+    void stop();
+    bool isRunning() const { return connection != nullptr; }
+
+    // 再次登记同一文档时：路径相同视为保存，路径不同视为另存为；filePath 为空等同于 closeDocument
+    void openDocument(QTextDocument *document, const QString &filePath);
+    void closeDocument(QTextDocument *document);
+
+    // position 为文档中的字符位置；context 销毁后不再回调，请求被取消或出错时也不回调
+    void requestCompletion(QTextDocument *document, int position, QObject *context, const CompletionCallback &callback);
+    void cancelCompletion(QTextDocument *document);
+    void requestHover(QTextDocument *document, int position, QObject *context, const HoverCallback &callback);
+
+signals:
+    void diagnosticsPublished(QTextDocument *document, const QList<ClangdClient::Diagnostic> &diagnostics);
+    void serverStopped(const QString &message);
+
+private:
+    struct Document
+    {
+        QString filePath;
+        QString uri;
+        int version = 0;
+        QString text;           // 服务器看到的内容，用来计算被删除部分的范围
+        int completionRequest = 0;
+        QMetaObject::Connection changeConnection;
+        QMetaObject::Connection destroyedConnection;
+    };
+
+    struct PendingRequest
+    {
+        QPointer<QObject> context;
+        std::function<void(const QJsonValue &result)> handler;
+    };
+
+    void send(const QJsonObject &message);
+    int sendRequest(const QString &method, const QJsonObject &params, QObject *context,
+                    const std::function<void(const QJsonValue &result)> &handler);
+    void sendNotification(const QString &method, const QJsonObject &params);
+    void cancelRequest(int id);
+    void sendDidOpen(const Document &document);
+    void onContentsChange(QTextDocument *document, int position, int charsRemoved, int charsAdded);
+    QJsonObject positionParams(QTextDocument *document, const Document &state, int position) const;
+    void handleMessage(int serverGeneration, const QJsonObject &message);
+    void handleInitialized(const QJsonValue &result);
+    void handleDiagnostics(const QJsonObject &params);
+    void handleStopped(int serverGeneration, const QString &message);
+
+    QThread *ioThread;
+    ClangdConnection *connection;
+    int generation;
+    bool initialized;
+    bool incrementalSync;
+    int nextRequestId;
+    int hoverRequest;
+
+    QHash<QTextDocument*, Document> documents;
+    QHash<int, PendingRequest> pending;
+    QList<QJsonObject> backlog;         // 初始化完成前要发送的消息
+};
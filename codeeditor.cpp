@@ -1,5 +1,6 @@
 #include "codeeditor.h"
 #include "line_number_area.h"
+#include "symbolindex.h"
 #include <QPainter>
 #include <QTextBlock>
 #include <QTextCursor>
@@ -8,10 +9,29 @@
 #include <QScrollBar>
 #include <QAbstractItemView>
 #include <QKeyEvent>
+#include <QMouseEvent>
 #include <QApplication>
 #include <QCompleter>
 #include <QStringListModel>
+#include <QStandardItemModel>
 #include <QPainterPath>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QCursor>
+
+namespace {
+// 附加在文本块上的优化提示，插入或删除行时随文本块一起移动
+class RemarkBlockData : public QTextBlockUserData
+{
+public:
+    explicit RemarkBlockData(const QList<OptimizationRemark> &remarks)
+        : remarks(remarks)
+    {
+    }
+
+    QList<OptimizationRemark> remarks;
+};
+}
 
 CodeEditor::CodeEditor(QWidget *parent)
     : QPlainTextEdit(parent)
@@ -132,12 +152,22 @@ int CodeEditor::lineNumberAreaWidth() const
     int rightMargin = 6; // 右侧边距，确保与编辑器内容有足够间隙
     int digitWidth = fontMetrics().horizontalAdvance(QLatin1Char('9')) * digits;
     
-    return leftMargin + digitWidth + rightMargin;
+    // 显示优化提示时在行号左侧留出图标位置
+    int iconWidth = showRemarks ? remarkIconWidth() : 0;
+    
+    return leftMargin + iconWidth + digitWidth + rightMargin;
+}
+
+int CodeEditor::remarkIconWidth() const
+{
+    return fontMetrics().height();
 }
 
 void CodeEditor::updateLineNumberAreaWidth(int /* newBlockCount */)
 {
-    setViewportMargins(lineNumberAreaWidth(), 0, 0, 0);
+    int width = lineNumberAreaWidth();
+    setViewportMargins(width, 0, 0, 0);
+    lineNumberArea->setFixedWidth(width);
 }
 
 void CodeEditor::updateLineNumberArea(const QRect &rect, int dy)
@@ -161,10 +191,133 @@ void CodeEditor::resizeEvent(QResizeEvent *e)
     lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineAreaWidth, cr.height()));
 }
 
+void CodeEditor::setLineHighlights(const QMap<int, QColor> &highlights)
+{
+    lineHighlights = highlights;
+    highlightCurrentLine();
+}
+
+void CodeEditor::clearLineHighlights()
+{
+    if (lineHighlights.isEmpty()) return;
+    lineHighlights.clear();
+    highlightCurrentLine();
+}
+
+void CodeEditor::setOptimizationRemarks(const QMap<int, QList<OptimizationRemark>> &remarks)
+{
+    for (QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
+        auto it = remarks.constFind(block.blockNumber() + 1);
+        block.setUserData(it == remarks.constEnd() ? nullptr : new RemarkBlockData(it.value()));
+    }
+    showRemarks = true;
+    updateLineNumberAreaWidth(0);
+    lineNumberArea->update();
+}
+
+void CodeEditor::clearOptimizationRemarks()
+{
+    if (!showRemarks) return;
+    for (QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
+        block.setUserData(nullptr);
+    }
+    showRemarks = false;
+    updateLineNumberAreaWidth(0);
+    lineNumberArea->update();
+}
+
+QList<OptimizationRemark> CodeEditor::optimizationRemarks(const QTextBlock &block) const
+{
+    RemarkBlockData *data = dynamic_cast<RemarkBlockData*>(block.userData());
+    return data ? data->remarks : QList<OptimizationRemark>();
+}
+
+void CodeEditor::setLanguageClient(ClangdClient *client, const QString &filePath)
+{
+    if (languageClient && languageClient != client) {
+        languageClient->closeDocument(document());
+        disconnect(diagnosticsConnection);
+        diagnosticsConnection = QMetaObject::Connection();
+        setDiagnostics(QList<ClangdClient::Diagnostic>());
+    }
+    languageClient = client;
+    if (!client) return;
+
+    if (!diagnosticsConnection) {
+        diagnosticsConnection = connect(client, &ClangdClient::diagnosticsPublished, this,
+                                        [this](QTextDocument *target, const QList<ClangdClient::Diagnostic> &diagnostics) {
+            if (target == document()) setDiagnostics(diagnostics);
+        });
+    }
+    client->openDocument(document(), filePath);
+}
+
+void CodeEditor::setDiagnostics(const QList<ClangdClient::Diagnostic> &diagnostics)
+{
+    if (diagnostics.isEmpty() && diagnosticMarks.isEmpty()) return;
+
+    diagnosticMarks.clear();
+    for (const ClangdClient::Diagnostic &diagnostic : diagnostics) {
+        DiagnosticMark mark;
+        mark.cursor = QTextCursor(document());
+        mark.cursor.setPosition(documentPosition(diagnostic.startLine, diagnostic.startCharacter));
+        mark.cursor.setPosition(documentPosition(diagnostic.endLine, diagnostic.endCharacter), QTextCursor::KeepAnchor);
+        // 空范围（如缺少分号）至少标出一个字符
+        if (!mark.cursor.hasSelection()) {
+            mark.cursor.movePosition(mark.cursor.atBlockEnd() ? QTextCursor::Left : QTextCursor::Right,
+                                     QTextCursor::KeepAnchor);
+        }
+        mark.severity = diagnostic.severity;
+        mark.message = diagnostic.message;
+        diagnosticMarks.append(mark);
+    }
+    highlightCurrentLine();
+}
+
+int CodeEditor::documentPosition(int line, int character) const
+{
+    QTextBlock block = document()->findBlockByNumber(line);
+    if (!block.isValid()) return qMax(0, document()->characterCount() - 1);
+    return block.position() + qBound(0, character, block.length() - 1);
+}
+
+QString CodeEditor::diagnosticsAt(int position) const
+{
+    static const char *const severityNames[] = {"错误", "警告", "信息", "提示"};
+    QStringList lines;
+    for (const DiagnosticMark &mark : diagnosticMarks) {
+        if (position < mark.cursor.selectionStart() || position > mark.cursor.selectionEnd()) continue;
+        lines.append(QString("%1: %2").arg(severityNames[qBound(1, mark.severity, 4) - 1], mark.message));
+    }
+    return lines.isEmpty() ? QString() : Qt::convertFromPlainText(lines.join('\n'));
+}
+
 void CodeEditor::highlightCurrentLine()
 {
     QList<QTextEdit::ExtraSelection> extraSelections;
 
+    // 外部设置的整行标记，当前行高亮在其之上绘制
+    for (auto it = lineHighlights.constBegin(); it != lineHighlights.constEnd(); ++it) {
+        QTextBlock block = document()->findBlockByNumber(it.key() - 1);
+        if (!block.isValid()) continue;
+        
+        QTextEdit::ExtraSelection selection;
+        selection.format.setBackground(it.value());
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selection.cursor = QTextCursor(block);
+        extraSelections.append(selection);
+    }
+
+    // clangd 诊断
+    for (const DiagnosticMark &mark : std::as_const(diagnosticMarks)) {
+        QTextEdit::ExtraSelection selection;
+        selection.format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+        selection.format.setUnderlineColor(mark.severity == 1 ? QColor("#f44747")
+                                           : mark.severity == 2 ? QColor("#cca700") : QColor("#3794ff"));
+        selection.cursor = mark.cursor;
+        extraSelections.append(selection);
+    }
+
     if (!isReadOnly()) {
         QTextEdit::ExtraSelection selection;
 
@@ -211,10 +364,16 @@ void CodeEditor::insertCompletion(const QString &completion)
     if (c->widget() != this)
         return;
     QTextCursor tc = textCursor();
-    int extra = completion.length() - c->completionPrefix().length();
-    tc.movePosition(QTextCursor::Left);
-    tc.movePosition(QTextCursor::EndOfWord);
-    tc.insertText(completion.right(extra));
+    if (c->completionRole() == Qt::UserRole) {
+        // clangd 的结果：前缀是光标前的标识符（成员访问之后为空），整体替换
+        tc.movePosition(QTextCursor::Left, QTextCursor::KeepAnchor, c->completionPrefix().length());
+        tc.insertText(completion);
+    } else {
+        int extra = completion.length() - c->completionPrefix().length();
+        tc.movePosition(QTextCursor::Left);
+        tc.movePosition(QTextCursor::EndOfWord);
+        tc.insertText(completion.right(extra));
+    }
     setTextCursor(tc);
 }
 
@@ -225,6 +384,44 @@ QString CodeEditor::textUnderCursor() const
     return tc.selectedText();
 }
 
+QString CodeEditor::identifierAt(const QTextCursor &cursor, QString *qualifier) const
+{
+    const QString text = cursor.block().text();
+    const int position = cursor.positionInBlock();
+    auto isIdentifierChar = [](QChar ch) { return ch.isLetterOrNumber() || ch == '_'; };
+
+    int start = position;
+    while (start > 0 && isIdentifierChar(text[start - 1])) --start;
+    int end = position;
+    while (end < text.size() && isIdentifierChar(text[end])) ++end;
+    if (start == end || text[start].isDigit()) return QString();
+
+    if (qualifier) {
+        QStringList parts;
+        int scopeEnd = start;
+        while (scopeEnd >= 2 && text.mid(scopeEnd - 2, 2) == "::") {
+            int partStart = scopeEnd - 2;
+            while (partStart > 0 && isIdentifierChar(text[partStart - 1])) --partStart;
+            if (partStart == scopeEnd - 2) break;
+            parts.prepend(text.mid(partStart, scopeEnd - 2 - partStart));
+            scopeEnd = partStart;
+        }
+        *qualifier = parts.join("::");
+    }
+    return text.mid(start, end - start);
+}
+
+void CodeEditor::mousePressEvent(QMouseEvent *e)
+{
+    if (e->button() == Qt::LeftButton && (e->modifiers() & Qt::ControlModifier)) {
+        setTextCursor(cursorForPosition(e->position().toPoint()));
+        e->accept();
+        emit definitionRequested();
+        return;
+    }
+    QPlainTextEdit::mousePressEvent(e);
+}
+
 void CodeEditor::focusInEvent(QFocusEvent *e)
 {
     if (c)
@@ -348,6 +545,12 @@ void CodeEditor::keyPressEvent(QKeyEvent *e)
             wordSet.insert(match.captured());
         }
     }
+    // 项目中其他文件声明的符号，二分查找只取前缀相同的一段
+    if (symbolIndex && completionPrefix.length() >= 3) {
+        for (const SymbolIndex::Symbol &symbol : symbolIndex->findPrefix(completionPrefix, 200)) {
+            wordSet.insert(symbol.name);
+        }
+    }
     QStringList words = wordSet.values();
     words.sort(Qt::CaseInsensitive);
     qDebug() << "[CodeEditor] before deleteLater";
@@ -355,12 +558,21 @@ void CodeEditor::keyPressEvent(QKeyEvent *e)
     qDebug() << "[CodeEditor] after deleteLater";
     qDebug() << "[CodeEditor] before setModel";
     c->setModel(new QStringListModel(words, c));
+    c->setCompletionRole(Qt::EditRole);
     qDebug() << "[CodeEditor] after setModel";
     // --- END 动态补全 ---
 
+    // . -> :: 之后的成员只有 clangd 知道，本地词表不弹出
+    if (!hasModifier && !e->text().isEmpty() && isMemberAccess()) {
+        c->popup()->hide();
+        requestLanguageCompletion();
+        return;
+    }
+
     if (!isShortcut && (hasModifier || e->text().isEmpty()|| completionPrefix.length() < 3
                       || eow.contains(e->text().right(1)))) {
         c->popup()->hide();
+        if (languageClient) languageClient->cancelCompletion(document());
         return;
     }
 
@@ -372,6 +584,61 @@ void CodeEditor::keyPressEvent(QKeyEvent *e)
     cr.setWidth(c->popup()->sizeHintForColumn(0)
                 + c->popup()->verticalScrollBar()->sizeHint().width());
     c->complete(cr); // popup it up!
+
+    // 先显示本地词表，clangd 的结果到达后替换
+    requestLanguageCompletion();
+}
+
+bool CodeEditor::isMemberAccess() const
+{
+    const QString text = textCursor().block().text().left(textCursor().positionInBlock());
+    return text.endsWith('.') || text.endsWith("->") || text.endsWith("::");
+}
+
+void CodeEditor::requestLanguageCompletion()
+{
+    if (!languageClient || !languageClient->isRunning()) return;
+
+    // 新的请求会取消旧的；等待期间又有输入或者光标移动时结果作废
+    const int revision = document()->revision();
+    const int position = textCursor().position();
+    languageClient->requestCompletion(document(), position, this,
+                                      [this, revision, position](const QList<ClangdClient::CompletionItem> &items) {
+        if (document()->revision() != revision || textCursor().position() != position) return;
+        showLanguageCompletions(items);
+    });
+}
+
+void CodeEditor::showLanguageCompletions(const QList<ClangdClient::CompletionItem> &items)
+{
+    if (items.isEmpty()) return;
+
+    // 列表显示带参数的名字，匹配和插入用 insertText（UserRole）
+    QStandardItemModel *model = new QStandardItemModel(c);
+    for (const ClangdClient::CompletionItem &item : items) {
+        QStandardItem *row = new QStandardItem(item.label);
+        row->setData(item.insertText, Qt::UserRole);
+        row->setToolTip(item.detail);
+        row->setEditable(false);
+        model->appendRow(row);
+    }
+    static_cast<QAbstractItemModel*>(c->model())->deleteLater();
+    c->setModel(model);
+    c->setCompletionRole(Qt::UserRole);
+
+    const QString text = textCursor().block().text().left(textCursor().positionInBlock());
+    int start = text.size();
+    while (start > 0 && (text[start - 1].isLetterOrNumber() || text[start - 1] == '_')) --start;
+    c->setCompletionPrefix(text.mid(start));
+    if (c->completionCount() == 0) {
+        c->popup()->hide();
+        return;
+    }
+    c->popup()->setCurrentIndex(c->completionModel()->index(0, 0));
+    QRect cr = cursorRect();
+    cr.setWidth(c->popup()->sizeHintForColumn(0)
+                + c->popup()->verticalScrollBar()->sizeHint().width());
+    c->complete(cr);
 }
 
 void CodeEditor::onReplace(const QString &findText, const QString &replaceText, QTextDocument::FindFlags flags)
@@ -587,6 +854,37 @@ bool CodeEditor::event(QEvent *e)
     return QPlainTextEdit::event(e);
 }
 
+bool CodeEditor::viewportEvent(QEvent *e)
+{
+    // 鼠标停留处有诊断时显示诊断，其次是所在行的优化提示，都没有时向 clangd 请求悬停信息
+    if (e->type() == QEvent::ToolTip) {
+        QHelpEvent *helpEvent = static_cast<QHelpEvent*>(e);
+        const QTextCursor cursor = cursorForPosition(helpEvent->pos());
+        QString text = diagnosticsAt(cursor.position());
+        if (text.isEmpty() && showRemarks) {
+            QList<OptimizationRemark> remarks = optimizationRemarks(cursor.block());
+            if (!remarks.isEmpty()) text = OptimizationRemarks::toolTip(remarks);
+        }
+        if (!text.isEmpty()) {
+            QToolTip::showText(helpEvent->globalPos(), text, viewport());
+            return true;
+        }
+        QToolTip::hideText();
+
+        if (languageClient && languageClient->isRunning() && !identifierAt(cursor).isEmpty()) {
+            const QPoint globalPos = helpEvent->globalPos();
+            languageClient->requestHover(document(), cursor.position(), this, [this, globalPos](const QString &hover) {
+                // 鼠标已经移开就不再显示
+                if (hover.isEmpty() || (QCursor::pos() - globalPos).manhattanLength() > fontMetrics().height()) return;
+                QToolTip::showText(globalPos, Qt::convertFromPlainText(hover), viewport());
+            });
+            return true;
+        }
+        if (showRemarks) return true;
+    }
+    return QPlainTextEdit::viewportEvent(e);
+}
+
 void CodeEditor::paintEvent(QPaintEvent *event)
 {
     QPlainTextEdit::paintEvent(event);
@@ -9,9 +9,15 @@
 #include <QRegularExpression>
 #include <QPainter>
 #include <QTextBlock>
+#include <QMap>
+#include <QPointer>
+
+#include "optimizationremarks.h"
+#include "clangdclient.h"
 
 // 前向声明
 class LineNumberArea;
+class SymbolIndex;
 
 class CodeEditor : public QPlainTextEdit
 {
@@ -29,6 +35,17 @@ public:
     // 代码补全相关
     void setCompleter(QCompleter *completer);
     QCompleter *completer() const;
+    // 跨文件补全：项目符号索引中以当前前缀开头的名字也加入补全词表
+    void setSymbolIndex(const SymbolIndex *index) { symbolIndex = index; }
+
+    // clangd 语言服务：补全、诊断和悬停提示都来自 client，client 为空时断开。
+    // filePath 变化（另存为）时重新登记，未保存的新文件等保存后再登记
+    void setLanguageClient(ClangdClient *client, const QString &filePath);
+    // 诊断显示为波浪下划线，附加在文本上，编辑时随文本移动
+    void setDiagnostics(const QList<ClangdClient::Diagnostic> &diagnostics);
+
+    // 光标处的 C++ 标识符；qualifier 返回名字前面的 A::B 限定部分
+    QString identifierAt(const QTextCursor &cursor, QString *qualifier = nullptr) const;
     
     // 访问器方法 - 用于LineNumberArea访问受保护的QPlainTextEdit成员
     QTextBlock getFirstVisibleBlock() const;
@@ -36,13 +53,30 @@ public:
     QPointF getContentOffset() const;
     QRectF getBlockBoundingRect(const QTextBlock &block) const;
     QTextCursor getCursorForPosition(const QPoint &pos) const;
+    
+    // 整行背景标记（汇编视图等使用），行号从 1 开始
+    void setLineHighlights(const QMap<int, QColor> &highlights);
+    void clearLineHighlights();
+
+    // 编译器优化提示，行号从 1 开始。提示附加在文本块上，编辑时随所在行移动
+    void setOptimizationRemarks(const QMap<int, QList<OptimizationRemark>> &remarks);
+    void clearOptimizationRemarks();
+    bool hasOptimizationRemarks() const { return showRemarks; }
+    QList<OptimizationRemark> optimizationRemarks(const QTextBlock &block) const;
+    int remarkIconWidth() const;
+
+signals:
+    // Ctrl+单击标识符
+    void definitionRequested();
 
 protected:
     // 事件处理
     void resizeEvent(QResizeEvent *event) override;
     void keyPressEvent(QKeyEvent *e) override;
+    void mousePressEvent(QMouseEvent *e) override;
     void focusInEvent(QFocusEvent *e) override;
     bool event(QEvent *e) override;
+    bool viewportEvent(QEvent *e) override;
     void paintEvent(QPaintEvent *e) override;
     void wheelEvent(QWheelEvent *event) override;
 
@@ -76,8 +110,26 @@ private:
     // UI组件
     LineNumberArea *lineNumberArea;
     QCompleter *c = nullptr;
+    const SymbolIndex *symbolIndex = nullptr;
+    QMap<int, QColor> lineHighlights;
+    bool showRemarks = false;
     QString textUnderCursor() const;
     void changeFontSize(int delta);
+
+    struct DiagnosticMark
+    {
+        QTextCursor cursor;
+        int severity;
+        QString message;
+    };
+    QPointer<ClangdClient> languageClient;
+    QMetaObject::Connection diagnosticsConnection;
+    QList<DiagnosticMark> diagnosticMarks;
+    int documentPosition(int line, int character) const;
+    QString diagnosticsAt(int position) const;
+    bool isMemberAccess() const;
+    void requestLanguageCompletion();
+    void showLanguageCompletions(const QList<ClangdClient::CompletionItem> &items);
     
 
 };
@@ -0,0 +1,92 @@
+#include "compilationdatabase.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+
+bool CompilationDatabase::update(const QString &sourcePath, const QString &outputPath, const QStringList &command,
+                                 QString *errorMessage)
+{
+    const QFileInfo sourceInfo(sourcePath);
+    const QString directory = sourceInfo.absolutePath();
+    const QString databasePath = QDir(directory).filePath(FileName);
+    const QString filePath = QDir::cleanPath(sourceInfo.absoluteFilePath());
+
+    QJsonArray entries;
+    QFile existing(databasePath);
+    if (existing.exists()) {
+        if (!existing.open(QIODevice::ReadOnly)) {
+            if (errorMessage) *errorMessage = "无法读取 " + databasePath;
+            return false;
+        }
+        const QJsonDocument document = QJsonDocument::fromJson(existing.readAll());
+        if (!document.isArray()) {
+            if (errorMessage) *errorMessage = databasePath + " 不是编译数据库，没有覆盖";
+            return false;
+        }
+        entries = document.array();
+    }
+
+    // 工作目录与编译时一致，相对路径按它解析
+    const QJsonObject entry{
+        {"directory", directory},
+        {"file", filePath},
+        {"arguments", QJsonArray::fromStringList(command)},
+        {"output", QFileInfo(outputPath).absoluteFilePath()},
+    };
+
+    QJsonArray updated;
+    bool replaced = false;
+    for (const QJsonValue &value : std::as_const(entries)) {
+        const QJsonObject other = value.toObject();
+        const QString file = QDir(other.value("directory").toString()).absoluteFilePath(other.value("file").toString());
+        if (QDir::cleanPath(file) != filePath) {
+            updated.append(value);
+        } else if (!replaced) {
+            updated.append(entry);
+            replaced = true;
+        }
+    }
+    if (!replaced) updated.append(entry);
+
+    // 没有变化时保持文件不动，避免 clangd 等工具重新加载
+    if (updated == entries) return true;
+
+    QSaveFile file(databasePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = "无法写入 " + databasePath;
+        return false;
+    }
+    file.write(QJsonDocument(updated).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = "无法写入 " + databasePath;
+        return false;
+    }
+    return true;
+}
+
+QString CompilationDatabase::findDirectory(const QString &projectRoot)
+{
+    if (projectRoot.isEmpty()) return QString();
+    for (const QString &directory : {projectRoot, projectRoot + "/build", projectRoot + "/build-release"}) {
+        if (QFileInfo::exists(QDir(directory).filePath(FileName))) return directory;
+    }
+    return QString();
+}
+
+bool CompilationDatabase::isExportEnabled(const QString &buildDirectory)
+{
+    QFile cache(QDir(buildDirectory).filePath("CMakeCache.txt"));
+    if (!cache.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    while (!cache.atEnd()) {
+        const QByteArray line = cache.readLine().trimmed();
+        // 用 -D 传入时类型可能是 BOOL，也可能是 UNINITIALIZED
+        if (!line.startsWith("CMAKE_EXPORT_COMPILE_COMMANDS:")) continue;
+        const QByteArray value = line.mid(line.indexOf('=') + 1).toUpper();
+        return value == "ON" || value == "TRUE" || value == "YES" || value == "1";
+    }
+    return false;
+}
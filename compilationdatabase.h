@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+// 编译数据库（compile_commands.json）
+// 单文件编译时把实际执行的命令写入源文件所在目录的数据库：同一文件的旧条目被替换，其他条目保留；
+// CMake 项目由 CMake 导出到构建目录。clangd、clang-tidy 等工具据此使用与编译完全相同的参数。
+class CompilationDatabase
+{
+public:
+    static constexpr const char *FileName = "compile_commands.json";
+
+    // command 第一项为编译器。内容没有变化时不重写文件；已有的同名文件不是编译数据库时不覆盖
+    static bool update(const QString &sourcePath, const QString &outputPath, const QStringList &command,
+                       QString *errorMessage = nullptr);
+
+    // 项目根目录或 CMake 构建目录（build、基准测试的 build-release）中已有的数据库所在目录，都没有时返回空
+    static QString findDirectory(const QString &projectRoot);
+
+    // 构建目录的 CMakeCache.txt 是否已开启 CMAKE_EXPORT_COMPILE_COMMANDS。
+    // 只看缓存而不看 compile_commands.json：Visual Studio、Xcode 生成器不会生成该文件
+    static bool isExportEnabled(const QString &buildDirectory);
+};
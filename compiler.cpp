@@ -1,4 +1,5 @@
 #include "compiler.h"
+#include "compilationdatabase.h"
 #include <QDebug>
 #include <QStandardPaths>
 #include <QApplication>
@@ -146,11 +147,13 @@ void Compiler::build()
 
 void Compiler::setupCMake()
 {
-    if (!QFile::exists(buildPath + "/CMakeCache.txt")) {
+    // 旧的构建目录没有开启编译数据库导出时也重新配置一次
+    if (!CompilationDatabase::isExportEnabled(buildPath)) {
         QStringList arguments;
         arguments << "-S" << projectPath;
         arguments << "-B" << buildPath;
         arguments << "-DCMAKE_BUILD_TYPE=Debug";
+        arguments << "-DCMAKE_EXPORT_COMPILE_COMMANDS=ON";
         
         QProcess cmakeProcess;
         cmakeProcess.setWorkingDirectory(projectPath);
@@ -161,6 +164,7 @@ void Compiler::setupCMake()
             appendOutput("CMake配置失败: " + cmakeProcess.readAllStandardError() + "\n");
         } else {
             appendOutput("CMake配置成功\n");
+            emit cmakeConfigured(buildPath);
         }
     }
 }
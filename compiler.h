@@ -35,6 +35,7 @@ signals:
     void runFinished(int exitCode, const QString &output);
     void buildStarted();
     void buildFinished(bool success, const QString &output);
+    void cmakeConfigured(const QString &buildDirectory);
 
 private slots:
     void onCompilationFinished(int exitCode, QProcess::ExitStatus exitStatus);
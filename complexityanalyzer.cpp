@@ -0,0 +1,253 @@
+#include "complexityanalyzer.h"
+#include "processrunner.h"
+#include "statistics.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const ComplexityClass AllModels[] = {
+    ComplexityClass::Constant, ComplexityClass::Logarithmic, ComplexityClass::Linear,
+    ComplexityClass::Linearithmic, ComplexityClass::Quadratic, ComplexityClass::Cubic
+};
+
+// 误差在最优模型的 (1 + RelativeTolerance) 倍加 AbsoluteTolerance 以内时视为同样好
+const double RelativeTolerance = 0.1;
+const double AbsoluteTolerance = 0.005;
+
+const qint64 GeneratorTimeLimitMs = 60000;
+}
+
+ComplexityAnalyzer::ComplexityAnalyzer(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , cancelFlag(std::make_shared<std::atomic<bool>>(false))
+    , running(false)
+{
+    // 计时串行进行，避免多个进程争抢同一组核心和缓存
+    pool->setMaxThreadCount(1);
+}
+
+ComplexityAnalyzer::~ComplexityAnalyzer()
+{
+    cancelFlag->store(true);
+    pool->waitForDone();
+}
+
+QString ComplexityAnalyzer::workDirectory(const QString &solutionSource)
+{
+    QFileInfo sourceInfo(solutionSource);
+    return sourceInfo.absolutePath() + "/" + sourceInfo.completeBaseName() + ".complexity";
+}
+
+QString ComplexityAnalyzer::className(ComplexityClass model)
+{
+    switch (model) {
+    case ComplexityClass::Constant:     return "O(1)";
+    case ComplexityClass::Logarithmic:  return "O(log n)";
+    case ComplexityClass::Linear:       return "O(n)";
+    case ComplexityClass::Linearithmic: return "O(n log n)";
+    case ComplexityClass::Quadratic:    return "O(n²)";
+    case ComplexityClass::Cubic:        return "O(n³)";
+    }
+    return QString();
+}
+
+double ComplexityAnalyzer::evaluate(ComplexityClass model, double n)
+{
+    switch (model) {
+    case ComplexityClass::Constant:     return 0;
+    case ComplexityClass::Logarithmic:  return std::log2(n);
+    case ComplexityClass::Linear:       return n;
+    case ComplexityClass::Linearithmic: return n * std::log2(n);
+    case ComplexityClass::Quadratic:    return n * n;
+    case ComplexityClass::Cubic:        return n * n * n;
+    }
+    return 0;
+}
+
+double ComplexityAnalyzer::predict(const ModelFit &fit, double n)
+{
+    return fit.constant + fit.coefficient * evaluate(fit.model, n);
+}
+
+QList<ComplexityAnalyzer::ModelFit> ComplexityAnalyzer::fit(const QList<Sample> &samples)
+{
+    QList<ModelFit> fits;
+    QList<Sample> valid;
+    for (const Sample &sample : samples) {
+        if (sample.medianMs > 0) valid.append(sample);
+    }
+    if (valid.isEmpty()) return fits;
+
+    for (ComplexityClass model : AllModels) {
+        // 加权最小二乘，权重 1/t² 使目标函数变为相对误差的平方和
+        double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (const Sample &sample : valid) {
+            double t = sample.medianMs;
+            double w = 1 / (t * t);
+            double x = evaluate(model, sample.size);
+            sw += w;
+            sx += w * x;
+            sy += w * t;
+            sxx += w * x * x;
+            sxy += w * x * t;
+        }
+
+        ModelFit result;
+        result.model = model;
+        double determinant = sw * sxx - sx * sx;
+        if (model == ComplexityClass::Constant || determinant <= 0) {
+            result.constant = sy / sw;
+        } else {
+            result.coefficient = (sw * sxy - sx * sy) / determinant;
+            result.constant = (sy - result.coefficient * sx) / sw;
+            // 时间不会随规模减少，固定开销也不能为负
+            if (result.coefficient < 0) {
+                result.coefficient = 0;
+                result.constant = sy / sw;
+            } else if (result.constant < 0) {
+                result.constant = 0;
+                result.coefficient = sxy / sxx;
+            }
+        }
+
+        double sum = 0;
+        for (const Sample &sample : valid) {
+            double relative = (sample.medianMs - predict(result, sample.size)) / sample.medianMs;
+            sum += relative * relative;
+        }
+        result.error = std::sqrt(sum / valid.size());
+        fits.append(result);
+    }
+
+    std::stable_sort(fits.begin(), fits.end(), [](const ModelFit &x, const ModelFit &y) {
+        return x.error < y.error;
+    });
+    return fits;
+}
+
+ComplexityAnalyzer::ModelFit ComplexityAnalyzer::selectBest(const QList<ModelFit> &fits)
+{
+    if (fits.isEmpty()) return ModelFit();
+
+    double threshold = fits.first().error * (1 + RelativeTolerance) + AbsoluteTolerance;
+    ModelFit best = fits.first();
+    for (const ModelFit &candidate : fits) {
+        if (candidate.error <= threshold && static_cast<int>(candidate.model) < static_cast<int>(best.model)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+bool ComplexityAnalyzer::start(const Config &config)
+{
+    if (running) return false;
+    if (!QDir().mkpath(config.workDirectory)) return false;
+
+    cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    running = true;
+
+    std::shared_ptr<std::atomic<bool>> flag = cancelFlag;
+    pool->start(QRunnable::create([this, config, flag]() {
+        runSweep(config, flag);
+    }));
+    return true;
+}
+
+void ComplexityAnalyzer::stop()
+{
+    cancelFlag->store(true);
+}
+
+void ComplexityAnalyzer::postFailure(const QString &message)
+{
+    QMetaObject::invokeMethod(this, [this, message]() {
+        running = false;
+        emit failed(message);
+    }, Qt::QueuedConnection);
+}
+
+void ComplexityAnalyzer::runSweep(const Config &config, const std::shared_ptr<std::atomic<bool>> &cancelFlag)
+{
+    QDir workDir(config.workDirectory);
+    QString stopReason;
+    double factor = qMax(1.1, config.growthFactor);
+    qint64 lastSize = -1;
+
+    for (double size = config.minSize; size <= config.maxSize * 1.0001; size *= factor) {
+        qint64 n = qRound64(size);
+        if (n == lastSize) continue;
+        lastSize = n;
+        QMetaObject::invokeMethod(this, [this, n]() {
+            emit stageChanged(QString("正在测量 N = %1 ...").arg(n));
+        }, Qt::QueuedConnection);
+
+        // 生成该规模的输入，生成器本身不计时
+        QString inputFile = workDir.filePath(QString("%1.in").arg(n));
+        ProcessRunner::Spec generatorSpec;
+        generatorSpec.program = config.generator;
+        generatorSpec.arguments << QString::number(n) << "1";
+        generatorSpec.workingDirectory = config.workDirectory;
+        generatorSpec.stdoutFile = inputFile;
+        generatorSpec.wallTimeLimitMs = GeneratorTimeLimitMs;
+        generatorSpec.cancelFlag = cancelFlag.get();
+        ProcessRunner::Result generatorResult = ProcessRunner::run(generatorSpec);
+        if (generatorResult.cancelled) {
+            stopReason = "已停止";
+            break;
+        }
+        if (!generatorResult.started || generatorResult.crashed() || generatorResult.wallTimeExceeded) {
+            postFailure(QString("生成器在 N = %1 时运行失败：%2").arg(n).arg(
+                generatorResult.started ? QString::fromUtf8(generatorResult.stderrOutput) : generatorResult.error));
+            return;
+        }
+
+        Sample sample;
+        sample.size = n;
+        bool exceeded = false;
+        for (int rep = 0; rep < config.repetitions; ++rep) {
+            ProcessRunner::Spec spec;
+            spec.program = config.solution;
+            spec.workingDirectory = config.workDirectory;
+            spec.stdinFile = inputFile;
+            spec.wallTimeLimitMs = config.timeLimitMs;
+            spec.cancelFlag = cancelFlag.get();
+            MeasurementEnvironment::applyTo(spec, config.conditions);
+            ProcessRunner::Result result = ProcessRunner::run(spec);
+            if (result.cancelled) {
+                stopReason = "已停止";
+                break;
+            }
+            if (result.wallTimeExceeded) {
+                exceeded = true;
+                break;
+            }
+            if (!result.started || result.crashed()) {
+                postFailure(QString("待测程序在 N = %1 时运行失败：%2").arg(n).arg(
+                    result.started ? QString::fromUtf8(result.stderrOutput) : result.error));
+                return;
+            }
+            sample.timesMs.append(result.wallTimeUs / 1000.0);
+        }
+        QFile::remove(inputFile);
+
+        if (!stopReason.isEmpty()) break;
+        if (exceeded) {
+            stopReason = QString("N = %1 时超过时间限制 %2 ms，停止扫描").arg(n).arg(config.timeLimitMs);
+            break;
+        }
+
+        sample.medianMs = Statistics::median(sample.timesMs);
+        QMetaObject::invokeMethod(this, [this, sample]() { emit sampleMeasured(sample); }, Qt::QueuedConnection);
+    }
+
+    QMetaObject::invokeMethod(this, [this, stopReason]() {
+        running = false;
+        emit finished(stopReason);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+#include "measurementenvironment.h"
+
+enum class ComplexityClass
+{
+    Constant,
+    Logarithmic,
+    Linear,
+    Linearithmic,
+    Quadratic,
+    Cubic
+};
+
+// 经验复杂度分析
+// 生成器通过命令行参数接收规模 N（第一个参数）和随机种子（第二个参数），
+// N 按等比数列增长，每个规模重复运行待测程序取中位数，再拟合 t = a + b·f(N)。
+// 拟合使用相对误差加权，各个规模的点同等重要。
+class ComplexityAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        QString generator;
+        QString solution;
+        QString workDirectory;
+        qint64 minSize = 1000;
+        qint64 maxSize = 1000000;
+        double growthFactor = 2;
+        int repetitions = 5;
+        qint64 timeLimitMs = 5000;      // 某个规模超过该时间后停止扫描
+        MeasurementConditions conditions;
+    };
+
+    struct Sample
+    {
+        qint64 size = 0;
+        double medianMs = 0;
+        QList<double> timesMs;
+    };
+
+    struct ModelFit
+    {
+        ComplexityClass model = ComplexityClass::Constant;
+        double constant = 0;        // a，主要是进程启动等固定开销
+        double coefficient = 0;     // b
+        double error = 0;           // 相对误差的均方根
+    };
+
+    explicit ComplexityAnalyzer(QObject *parent = nullptr);
+    ~ComplexityAnalyzer();
+
+    bool start(const Config &config);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static QString workDirectory(const QString &solutionSource);
+    static QString className(ComplexityClass model);
+    static double evaluate(ComplexityClass model, double n);
+    static double predict(const ModelFit &fit, double n);
+    // 按误差从小到大排序
+    static QList<ModelFit> fit(const QList<Sample> &samples);
+    // 误差接近时选择更简单的模型，避免高阶模型靠常数项“凑”出结果
+    static ModelFit selectBest(const QList<ModelFit> &fits);
+
+signals:
+    void stageChanged(const QString &description);
+    void sampleMeasured(const ComplexityAnalyzer::Sample &sample);
+    void failed(const QString &message);
+    void finished(const QString &stopReason);
+
+private:
+    void runSweep(const Config &config, const std::shared_ptr<std::atomic<bool>> &cancelFlag);
+    void postFailure(const QString &message);
+
+    QThreadPool *pool;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+    bool running;
+};
@@ -0,0 +1,238 @@
+#include "complexitypanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QSettings>
+
+namespace {
+// 拟合曲线的采样点数
+const int CurvePoints = 60;
+// 至少需要这么多个规模才进行拟合
+const int MinSamplesForFit = 3;
+}
+
+ComplexityPanel::ComplexityPanel(QWidget *parent)
+    : QWidget(parent)
+    , analyzer(new ComplexityAnalyzer(this))
+    , building(false)
+{
+    QSettings settings("LionCPP", "IDE");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QGridLayout *sourceLayout = new QGridLayout();
+    generatorEdit = createSourceRow(sourceLayout, 0, "生成器:", "complexity/generator");
+    solutionEdit = createSourceRow(sourceLayout, 1, "待测程序:", QString());
+    generatorEdit->setToolTip("生成器通过命令行第一个参数接收规模 N，第二个参数接收随机种子，并把输入数据写到标准输出");
+    layout->addLayout(sourceLayout);
+
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+    minSizeSpinBox = new QSpinBox(this);
+    minSizeSpinBox->setRange(1, 1000000000);
+    minSizeSpinBox->setValue(settings.value("complexity/minSize", 1000).toInt());
+    maxSizeSpinBox = new QSpinBox(this);
+    maxSizeSpinBox->setRange(1, 1000000000);
+    maxSizeSpinBox->setValue(settings.value("complexity/maxSize", 1000000).toInt());
+    factorSpinBox = new QDoubleSpinBox(this);
+    factorSpinBox->setRange(1.1, 10);
+    factorSpinBox->setSingleStep(0.5);
+    factorSpinBox->setValue(settings.value("complexity/growthFactor", 2.0).toDouble());
+    repetitionsSpinBox = new QSpinBox(this);
+    repetitionsSpinBox->setRange(1, 100);
+    repetitionsSpinBox->setValue(settings.value("complexity/repetitions", 5).toInt());
+    timeLimitSpinBox = new QSpinBox(this);
+    timeLimitSpinBox->setRange(100, 600000);
+    timeLimitSpinBox->setSingleStep(1000);
+    timeLimitSpinBox->setSuffix(" ms");
+    timeLimitSpinBox->setValue(settings.value("complexity/timeLimitMs", 5000).toInt());
+    startButton = new QPushButton("开始分析", this);
+
+    controlLayout->addWidget(new QLabel("N 从", this));
+    controlLayout->addWidget(minSizeSpinBox);
+    controlLayout->addWidget(new QLabel("到", this));
+    controlLayout->addWidget(maxSizeSpinBox);
+    controlLayout->addWidget(new QLabel("每次乘以", this));
+    controlLayout->addWidget(factorSpinBox);
+    controlLayout->addWidget(new QLabel("重复:", this));
+    controlLayout->addWidget(repetitionsSpinBox);
+    controlLayout->addWidget(new QLabel("时间上限:", this));
+    controlLayout->addWidget(timeLimitSpinBox);
+    controlLayout->addWidget(startButton);
+    controlLayout->addStretch();
+    layout->addLayout(controlLayout);
+
+    statusLabel = new QLabel(this);
+    resultLabel = new QLabel(this);
+    resultLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(statusLabel);
+    layout->addWidget(resultLabel);
+    conditionsLabel = new QLabel(this);
+    layout->addWidget(conditionsLabel);
+
+    plot = new PlotWidget(this);
+    plot->setAxisLabels("N", "时间 (ms)");
+    layout->addWidget(plot, 1);
+
+    connect(startButton, &QPushButton::clicked, this, [this]() {
+        if (analyzer->isRunning()) {
+            stop();
+            return;
+        }
+        saveOptions();
+        emit startRequested();
+    });
+
+    connect(analyzer, &ComplexityAnalyzer::stageChanged, statusLabel, &QLabel::setText);
+    connect(analyzer, &ComplexityAnalyzer::sampleMeasured, this, &ComplexityPanel::onSampleMeasured);
+    connect(analyzer, &ComplexityAnalyzer::failed, this, &ComplexityPanel::onFailed);
+    connect(analyzer, &ComplexityAnalyzer::finished, this, &ComplexityPanel::onFinished);
+
+    updateButtons();
+}
+
+QLineEdit *ComplexityPanel::createSourceRow(QGridLayout *layout, int row, const QString &label, const QString &settingsKey)
+{
+    QLineEdit *edit = new QLineEdit(this);
+    if (!settingsKey.isEmpty()) {
+        edit->setText(QSettings("LionCPP", "IDE").value(settingsKey).toString());
+    }
+    QPushButton *browseButton = new QPushButton("浏览...", this);
+    connect(browseButton, &QPushButton::clicked, this, [this, edit]() {
+        QString filePath = QFileDialog::getOpenFileName(this, "选择源文件", QFileInfo(edit->text()).absolutePath(),
+                                                        "C++ Files (*.cpp *.cc *.cxx);;All Files (*)");
+        if (!filePath.isEmpty()) edit->setText(filePath);
+    });
+
+    layout->addWidget(new QLabel(label, this), row, 0);
+    layout->addWidget(edit, row, 1);
+    layout->addWidget(browseButton, row, 2);
+    return edit;
+}
+
+void ComplexityPanel::saveOptions()
+{
+    QSettings settings("LionCPP", "IDE");
+    settings.setValue("complexity/generator", generatorEdit->text());
+    settings.setValue("complexity/minSize", minSizeSpinBox->value());
+    settings.setValue("complexity/maxSize", maxSizeSpinBox->value());
+    settings.setValue("complexity/growthFactor", factorSpinBox->value());
+    settings.setValue("complexity/repetitions", repetitionsSpinBox->value());
+    settings.setValue("complexity/timeLimitMs", timeLimitSpinBox->value());
+}
+
+void ComplexityPanel::setSolutionSource(const QString &sourcePath)
+{
+    if (!analyzer->isRunning() && !building) {
+        solutionEdit->setText(sourcePath);
+    }
+}
+
+void ComplexityPanel::setBuilding(bool value)
+{
+    building = value;
+    statusLabel->setText(building ? "正在编译..." : QString());
+    updateButtons();
+}
+
+void ComplexityPanel::updateButtons()
+{
+    startButton->setText(analyzer->isRunning() ? "停止" : "开始分析");
+    startButton->setEnabled(!building);
+}
+
+void ComplexityPanel::startAnalysis(const QString &generatorExecutable, const QString &solutionExecutable)
+{
+    ComplexityAnalyzer::Config config;
+    config.generator = generatorExecutable;
+    config.solution = solutionExecutable;
+    config.workDirectory = ComplexityAnalyzer::workDirectory(solutionEdit->text());
+    config.minSize = minSizeSpinBox->value();
+    config.maxSize = qMax(minSizeSpinBox->value(), maxSizeSpinBox->value());
+    config.growthFactor = factorSpinBox->value();
+    config.repetitions = repetitionsSpinBox->value();
+    config.timeLimitMs = timeLimitSpinBox->value();
+    config.conditions = MeasurementEnvironment::check();
+
+    samples.clear();
+    plot->clear();
+    resultLabel->clear();
+    if (!analyzer->start(config)) {
+        statusLabel->setText("无法创建工作目录: " + config.workDirectory);
+        return;
+    }
+    conditionsLabel->setText("测量条件：" + MeasurementEnvironment::summary(config.conditions));
+    conditionsLabel->setStyleSheet(config.conditions.warnings.isEmpty() ? QString() : "color: #d7ba7d;");
+    conditionsLabel->setToolTip(config.conditions.warnings.join('\n'));
+    updateButtons();
+}
+
+void ComplexityPanel::stop()
+{
+    analyzer->stop();
+}
+
+void ComplexityPanel::onSampleMeasured(const ComplexityAnalyzer::Sample &sample)
+{
+    samples.append(sample);
+    updatePlot();
+}
+
+void ComplexityPanel::updatePlot()
+{
+    PlotWidget::Series measured;
+    measured.name = "实测（中位数）";
+    measured.color = QColor("#569cd6");
+    measured.showLine = false;
+    for (const ComplexityAnalyzer::Sample &sample : std::as_const(samples)) {
+        measured.points.append(QPointF(sample.size, sample.medianMs));
+    }
+
+    QList<PlotWidget::Series> series;
+    series.append(measured);
+
+    if (samples.size() >= MinSamplesForFit) {
+        QList<ComplexityAnalyzer::ModelFit> fits = ComplexityAnalyzer::fit(samples);
+        ComplexityAnalyzer::ModelFit best = ComplexityAnalyzer::selectBest(fits);
+
+        PlotWidget::Series curve;
+        curve.name = "拟合 " + ComplexityAnalyzer::className(best.model);
+        curve.color = QColor("#4ec9b0");
+        curve.showPoints = false;
+        curve.penStyle = Qt::DashLine;
+        double minN = samples.first().size;
+        double maxN = samples.last().size;
+        for (int i = 0; i <= CurvePoints; ++i) {
+            double n = minN + (maxN - minN) * i / CurvePoints;
+            curve.points.append(QPointF(n, ComplexityAnalyzer::predict(best, n)));
+        }
+        series.append(curve);
+
+        QStringList others;
+        for (const ComplexityAnalyzer::ModelFit &fit : fits) {
+            others << QString("%1 %2%").arg(ComplexityAnalyzer::className(fit.model)).arg(fit.error * 100, 0, 'f', 1);
+        }
+        resultLabel->setText(QString("最佳拟合：%1（固定开销 %2 ms，相对误差 %3%）    各模型误差：%4")
+                             .arg(ComplexityAnalyzer::className(best.model))
+                             .arg(best.constant, 0, 'f', 2)
+                             .arg(best.error * 100, 0, 'f', 1)
+                             .arg(others.join("，")));
+    } else {
+        resultLabel->setText(QString("已测量 %1 个规模，至少需要 %2 个才能拟合").arg(samples.size()).arg(MinSamplesForFit));
+    }
+
+    plot->setSeries(series);
+}
+
+void ComplexityPanel::onFailed(const QString &message)
+{
+    statusLabel->setText(message.trimmed());
+    updateButtons();
+}
+
+void ComplexityPanel::onFinished(const QString &stopReason)
+{
+    statusLabel->setText(stopReason.isEmpty() ? QString("扫描完成，共 %1 个规模").arg(samples.size()) : stopReason);
+    updateButtons();
+}
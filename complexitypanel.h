@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QWidget>
+#include <QLineEdit>
+#include <QGridLayout>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+
+#include "complexityanalyzer.h"
+#include "plotwidget.h"
+
+// 复杂度分析窗口
+// 选择带规模参数的生成器，待测程序默认为当前文件，编译由主窗口通过构建缓存完成
+class ComplexityPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ComplexityPanel(QWidget *parent = nullptr);
+
+    QString generatorSource() const { return generatorEdit->text(); }
+    QString solutionSource() const { return solutionEdit->text(); }
+    void setSolutionSource(const QString &sourcePath);
+
+    void startAnalysis(const QString &generatorExecutable, const QString &solutionExecutable);
+    void stop();
+    bool isRunning() const { return analyzer->isRunning(); }
+    void setBuilding(bool building);
+
+signals:
+    void startRequested();
+
+private slots:
+    void onSampleMeasured(const ComplexityAnalyzer::Sample &sample);
+    void onFailed(const QString &message);
+    void onFinished(const QString &stopReason);
+
+private:
+    QLineEdit *createSourceRow(QGridLayout *layout, int row, const QString &label, const QString &settingsKey);
+    void saveOptions();
+    void updatePlot();
+    void updateButtons();
+
+    ComplexityAnalyzer *analyzer;
+    QLineEdit *generatorEdit;
+    QLineEdit *solutionEdit;
+    QSpinBox *minSizeSpinBox;
+    QSpinBox *maxSizeSpinBox;
+    QDoubleSpinBox *factorSpinBox;
+    QSpinBox *repetitionsSpinBox;
+    QSpinBox *timeLimitSpinBox;
+    QPushButton *startButton;
+    QLabel *statusLabel;
+    QLabel *resultLabel;
+    QLabel *conditionsLabel;
+    PlotWidget *plot;
+    QList<ComplexityAnalyzer::Sample> samples;
+    bool building;
+};
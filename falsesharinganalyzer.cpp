@@ -0,0 +1,423 @@
+#include "falsesharinganalyzer.h"
+#include "structlayout.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPointer>
+#include <QRunnable>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <algorithm>
+
+namespace {
+// perf_mem_data_src 的位域（include/uapi/linux/perf_event.h）
+const int MemOpShift = 0;
+const quint64 MemOpStore = 0x04;
+const int MemSnoopShift = 19;
+const quint64 MemSnoopHitm = 0x10;
+const int MemSnoopxShift = 38;
+const quint64 MemSnoopxPeer = 0x02;    // AMD 上从其他核心转发的已修改数据
+
+// 报告中最多列出的缓存行
+const int MaxLines = 50;
+
+// 统计一个偏移上的访问时顺带记录各条指令的次数，最后取最多的那条
+struct AccessBuilder
+{
+    FalseSharingAnalyzer::Access access;
+    QHash<quint64, int> ipCounts;
+    QHash<quint64, QString> ipSymbols;
+    QHash<quint64, QString> ipModules;
+};
+
+QList<StructLayout::Variable> loadVariables(const QString &executable)
+{
+    QString readelf = QStandardPaths::findExecutable("readelf");
+    if (readelf.isEmpty()) return QList<StructLayout::Variable>();
+
+    QProcess process;
+    process.start(readelf, QStringList() << "--debug-dump=info" << executable);
+    if (!process.waitForFinished(30000)) {
+        process.kill();
+        return QList<StructLayout::Variable>();
+    }
+    return StructLayout::parseVariables(QString::fromUtf8(process.readAllStandardOutput()));
+}
+
+// 存在 writers 中的线程 A 和 threads 中的线程 B，且 A ≠ B
+bool hasOtherThread(const QSet<int> &writers, const QSet<int> &threads)
+{
+    if (writers.isEmpty() || threads.isEmpty()) return false;
+    return writers.size() > 1 || threads.size() > 1 || writers != threads;
+}
+
+quint64 parseHex(const QString &text)
+{
+    QString value = text.trimmed();
+    if (value.startsWith("0x")) value = value.mid(2);
+    return value.toULongLong(nullptr, 16);
+}
+}
+
+bool FalseSharingAnalyzer::Sample::isStore() const
+{
+    return ((dataSource >> MemOpShift) & 0x1f) & MemOpStore;
+}
+
+bool FalseSharingAnalyzer::Sample::isHitm() const
+{
+    return (((dataSource >> MemSnoopShift) & 0x1f) & MemSnoopHitm)
+        || (((dataSource >> MemSnoopxShift) & 0x3) & MemSnoopxPeer);
+}
+
+FalseSharingAnalyzer::FalseSharingAnalyzer(QObject *parent)
+    : QObject(parent)
+    , process(new QProcess(this))
+    , stage(Idle)
+    , programExitCode(0)
+    , programExitStatus(QProcess::NormalExit)
+    , generation(0)
+{
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        QByteArray data = process->readAllStandardOutput();
+        if (stage == Reporting) {
+            reportOutput.append(data);
+        } else {
+            emit output(QString::fromUtf8(data));
+        }
+    });
+    connect(process, &QProcess::readyReadStandardError, this, [this]() {
+        QByteArray data = process->readAllStandardError();
+        if (stage == Reporting) {
+            reportErrors.append(data);
+        } else {
+            emit output(QString::fromUtf8(data));
+        }
+    });
+    connect(process, &QProcess::finished, this, &FalseSharingAnalyzer::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart && stage != Idle) {
+            programExitCode = -1;
+            programExitStatus = QProcess::CrashExit;
+            Report report;
+            report.error = "无法启动 perf: " + process->program();
+            finish(report);
+        }
+    });
+}
+
+FalseSharingAnalyzer::~FalseSharingAnalyzer()
+{
+    if (process->state() != QProcess::NotRunning) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+QString FalseSharingAnalyzer::perfPath()
+{
+    return QStandardPaths::findExecutable("perf");
+}
+
+QStringList FalseSharingAnalyzer::compileFlags()
+{
+    // -no-pie：样本中的指令地址和全局变量地址与可执行文件中的地址一致，不需要换算加载基址
+    return QStringList() << "-g" << "-no-pie" << "-fno-omit-frame-pointer" << "-pthread";
+}
+
+QString FalseSharingAnalyzer::dataPath() const
+{
+    return QDir(dataDirectory.path()).filePath("perf.data");
+}
+
+bool FalseSharingAnalyzer::start(const QString &executable, const QString &workingDirectory,
+                                 QString *errorMessage)
+{
+    if (isRunning()) return false;
+    if (perfPath().isEmpty()) {
+        if (errorMessage) *errorMessage = "找不到 perf（通常在 linux-tools 或 linux-perf 软件包中）";
+        return false;
+    }
+    if (!dataDirectory.isValid()) {
+        if (errorMessage) *errorMessage = "无法创建临时目录";
+        return false;
+    }
+
+    QFile::remove(dataPath());
+    this->executable = executable;
+    ++generation;
+    reportOutput.clear();
+    reportErrors.clear();
+    programExitCode = 0;
+    programExitStatus = QProcess::NormalExit;
+
+    stage = Recording;
+    process->setWorkingDirectory(workingDirectory);
+    process->start(perfPath(), QStringList() << "c2c" << "record" << "-o" << dataPath() << "--" << executable);
+    // 分析运行不提供交互输入，关闭标准输入避免程序等待 cin
+    process->closeWriteChannel();
+    return true;
+}
+
+void FalseSharingAnalyzer::stop()
+{
+    if (stage == Recording) {
+        // perf 收到 SIGTERM 后结束被测程序并写完数据文件
+        process->terminate();
+    } else if (stage == Reporting) {
+        process->kill();
+    }
+}
+
+void FalseSharingAnalyzer::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (stage == Recording) {
+        programExitCode = exitCode;
+        programExitStatus = exitStatus;
+        if (!QFileInfo::exists(dataPath())) {
+            Report report;
+            report.error = "perf 没有生成采样数据。请确认 CPU 支持访存采样，"
+                           "并检查 /proc/sys/kernel/perf_event_paranoid 的设置";
+            finish(report);
+            return;
+        }
+
+        stage = Reporting;
+        process->setWorkingDirectory(dataDirectory.path());
+        process->start(perfPath(), QStringList() << "mem" << "report" << "-D" << "-x" << ","
+                                                 << "-i" << dataPath());
+        return;
+    }
+
+    if (stage == Reporting) {
+        reportOutput.append(process->readAllStandardOutput());
+        reportErrors.append(process->readAllStandardError());
+        if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+            Report report;
+            report.error = "perf mem report 执行失败: " + QString::fromUtf8(reportErrors).trimmed();
+            reportOutput.clear();
+            finish(report);
+            return;
+        }
+
+        // 解析上百 MB 的样本、readelf 和 addr2line 都放到工作线程中；this 只在界面线程中检查
+        stage = Analyzing;
+        QPointer<FalseSharingAnalyzer> guard(this);
+        const int run = generation;
+        const QByteArray dump = reportOutput;
+        reportOutput.clear();
+        QThreadPool::globalInstance()->start(QRunnable::create(
+            [guard, run, dump, executable = executable]() {
+                const Report report = analyze(parseSamples(QString::fromUtf8(dump)), executable);
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, run, report]() {
+                    if (guard && guard->generation == run) guard->finish(report);
+                }, Qt::QueuedConnection);
+            }));
+    }
+}
+
+void FalseSharingAnalyzer::finish(const Report &report)
+{
+    stage = Idle;
+    emit finished(report, programExitCode, programExitStatus);
+}
+
+QList<FalseSharingAnalyzer::Sample> FalseSharingAnalyzer::parseSamples(const QString &dump)
+{
+    // 默认列：PID, TID, IP, ADDR, LOCAL WEIGHT, DSRC, SYMBOL；
+    // 不同版本的 perf 可能多出物理地址、页大小等列，以表头为准
+    int columnCount = 7;
+    int tidColumn = 1;
+    int ipColumn = 2;
+    int addressColumn = 3;
+    int weightColumn = 4;
+    int sourceColumn = 5;
+
+    QList<Sample> samples;
+    const QStringList lines = dump.split('\n');
+    for (const QString &line : lines) {
+        if (line.startsWith('#')) {
+            QStringList names = line.mid(1).split(',');
+            for (QString &name : names) name = name.trimmed();
+            if (!names.contains("TID") || !names.contains("DSRC")) continue;
+            columnCount = names.size();
+            tidColumn = names.indexOf("TID");
+            ipColumn = names.indexOf("IP");
+            addressColumn = names.indexOf("ADDR");
+            sourceColumn = names.indexOf("DSRC");
+            weightColumn = -1;
+            for (int i = 0; i < names.size(); ++i) {
+                if (names[i].contains("WEIGHT")) weightColumn = i;
+            }
+            continue;
+        }
+
+        QStringList fields = line.split(',');
+        if (fields.size() < columnCount) continue;
+        // 最后一列是 "模块:函数"，函数名里可能有逗号
+        QString symbolField = fields.mid(columnCount - 1).join(',').trimmed();
+        fields = fields.mid(0, columnCount - 1);
+
+        Sample sample;
+        bool ok = false;
+        sample.tid = fields.value(tidColumn).trimmed().toInt(&ok);
+        if (!ok) continue;
+        sample.ip = parseHex(fields.value(ipColumn));
+        sample.address = parseHex(fields.value(addressColumn));
+        sample.dataSource = parseHex(fields.value(sourceColumn));
+        if (weightColumn >= 0) sample.weight = fields.value(weightColumn).trimmed().toULongLong();
+        int colon = symbolField.indexOf(':');
+        sample.module = colon >= 0 ? symbolField.left(colon) : symbolField;
+        sample.symbol = colon >= 0 ? symbolField.mid(colon + 1) : QString();
+        if (sample.address == 0) continue;
+        samples.append(sample);
+    }
+    return samples;
+}
+
+FalseSharingAnalyzer::Report FalseSharingAnalyzer::analyze(const QList<Sample> &samples,
+                                                           const QString &executable)
+{
+    Report report;
+    report.samples = samples.size();
+
+    // 只分析出现过 HITM 的缓存行
+    QSet<quint64> contended;
+    for (const Sample &sample : samples) {
+        if (sample.isHitm()) {
+            ++report.hitmSamples;
+            contended.insert(sample.address / CacheLineSize);
+        }
+    }
+    if (contended.isEmpty()) return report;
+
+    QHash<quint64, CacheLine> lines;
+    QHash<quint64, QHash<quint64, AccessBuilder>> builders;
+    for (const Sample &sample : samples) {
+        quint64 lineIndex = sample.address / CacheLineSize;
+        if (!contended.contains(lineIndex)) continue;
+
+        CacheLine &line = lines[lineIndex];
+        line.address = lineIndex * CacheLineSize;
+        AccessBuilder &builder = builders[lineIndex][sample.address - line.address];
+        Access &access = builder.access;
+        access.offset = sample.address - line.address;
+
+        if (sample.isStore()) {
+            ++line.stores;
+            ++access.stores;
+            line.writers.insert(sample.tid);
+            access.writers.insert(sample.tid);
+        } else {
+            ++line.loads;
+            ++access.loads;
+        }
+        if (sample.isHitm()) {
+            ++line.hitm;
+            ++access.hitm;
+        }
+        line.threads.insert(sample.tid);
+        access.threads.insert(sample.tid);
+        builder.ipCounts[sample.ip] += 1;
+        builder.ipSymbols.insert(sample.ip, sample.symbol);
+        builder.ipModules.insert(sample.ip, sample.module);
+    }
+
+    // 访问最多的指令对应到源码行；-no-pie 构建的主程序地址可以直接交给 addr2line
+    const QString canonicalExecutable = QFileInfo(executable).canonicalFilePath();
+    QList<quint64> executableIps;
+    QHash<quint64, QHash<quint64, quint64>> topIps;
+    for (auto lineIt = builders.begin(); lineIt != builders.end(); ++lineIt) {
+        for (auto it = lineIt->begin(); it != lineIt->end(); ++it) {
+            AccessBuilder &builder = it.value();
+            quint64 topIp = 0;
+            int topCount = -1;
+            for (auto ipIt = builder.ipCounts.constBegin(); ipIt != builder.ipCounts.constEnd(); ++ipIt) {
+                if (ipIt.value() > topCount) {
+                    topIp = ipIt.key();
+                    topCount = ipIt.value();
+                }
+            }
+            builder.access.symbol = builder.ipSymbols.value(topIp);
+            topIps[lineIt.key()].insert(it.key(), topIp);
+            if (QFileInfo(builder.ipModules.value(topIp)).canonicalFilePath() == canonicalExecutable
+                && !executableIps.contains(topIp)) {
+                executableIps.append(topIp);
+            }
+        }
+    }
+    QHash<QString, QList<quint64>> offsetsByModule;
+    if (!executableIps.isEmpty()) offsetsByModule.insert(executable, executableIps);
+    const QHash<quint64, Symbolizer::Location> locations =
+        Symbolizer::symbolizeAll(offsetsByModule).value(executable);
+
+    const QList<StructLayout::Variable> variables = loadVariables(executable);
+
+    for (auto lineIt = lines.begin(); lineIt != lines.end(); ++lineIt) {
+        CacheLine &line = lineIt.value();
+        const QHash<quint64, AccessBuilder> &lineBuilders = builders[lineIt.key()];
+        for (auto it = lineBuilders.constBegin(); it != lineBuilders.constEnd(); ++it) {
+            Access access = it->access;
+            access.field = StructLayout::describeAddress(variables, line.address + access.offset);
+            access.location = locations.value(topIps[lineIt.key()].value(it.key()));
+            line.accesses.append(access);
+        }
+        std::sort(line.accesses.begin(), line.accesses.end(), [](const Access &a, const Access &b) {
+            return a.offset < b.offset;
+        });
+
+        // 同一个成员的不同字节算作同一份数据
+        QList<const Access*> ranked;
+        QHash<QString, QSet<int>> itemThreads;
+        QHash<QString, QSet<int>> itemWriters;
+        for (const Access &access : line.accesses) {
+            ranked.append(&access);
+            const QString item = access.field.isEmpty() ? QString::number(access.offset) : access.field;
+            itemThreads[item].unite(access.threads);
+            itemWriters[item].unite(access.writers);
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const Access *a, const Access *b) {
+            return a->hitm + a->stores > b->hitm + b->stores;
+        });
+        QStringList names;
+        for (const Access *access : ranked) {
+            QString name = access->field.isEmpty() ? QString("偏移 0x%1").arg(access->offset, 2, 16, QChar('0'))
+                                                   : access->field;
+            if (!names.contains(name)) names << name;
+            if (names.size() == 3) break;
+        }
+        QString subject = names.join("、");
+        if (itemThreads.size() > names.size()) subject += " 等";
+
+        // 线程 A 写的数据和线程 B 访问的另一份数据挤在同一行才是伪共享；
+        // 多个线程都只访问同一份数据是真共享，拆分缓存行没有用
+        for (auto written = itemWriters.constBegin(); written != itemWriters.constEnd(); ++written) {
+            for (auto other = itemThreads.constBegin(); other != itemThreads.constEnd(); ++other) {
+                if (other.key() != written.key() && hasOtherThread(written.value(), other.value())) {
+                    line.falseSharing = true;
+                }
+            }
+        }
+        if (line.falseSharing) {
+            line.advice = QString("%1 共享同一条 %2 字节缓存行，由 %3 个线程写入、%4 个线程访问；"
+                                  "把各线程写入的数据用 alignas(%2) 分到不同缓存行")
+                              .arg(subject).arg(CacheLineSize).arg(line.writers.size()).arg(line.threads.size());
+        } else if (line.writers.size() > 1) {
+            line.advice = QString("%1 被 %2 个线程同时写入（真共享）；可改为线程局部累加后再合并")
+                              .arg(subject).arg(line.writers.size());
+        } else {
+            line.advice = QString("%1 所在缓存行在线程间反复失效（HITM %2 次），%3 个线程访问")
+                              .arg(subject).arg(line.hitm).arg(line.threads.size());
+        }
+        report.lines.append(line);
+    }
+
+    std::sort(report.lines.begin(), report.lines.end(), [](const CacheLine &a, const CacheLine &b) {
+        return a.hitm != b.hitm ? a.hitm > b.hitm : a.stores > b.stores;
+    });
+    if (report.lines.size() > MaxLines) report.lines = report.lines.mid(0, MaxLines);
+    return report;
+}
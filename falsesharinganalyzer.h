@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QSet>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include "symbolizer.h"
+
+// 伪共享检测
+// 用 perf c2c record 运行程序，采集带数据地址和数据来源（data_src）的访存样本，
+// 再用 perf mem report -D 导出原始样本，按 64 字节缓存行汇总。命中其他核心修改过的
+// 缓存行（HITM）的访问说明存在核间争用；同一缓存行上被多个线程写入的不同成员即为伪共享。
+// 程序用 -no-pie 构建，指令地址和全局变量地址可以直接对应到源码行和结构体成员。
+class FalseSharingAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int CacheLineSize = 64;
+
+    struct Sample
+    {
+        int tid = 0;
+        quint64 ip = 0;
+        quint64 address = 0;
+        quint64 weight = 0;         // 访存延迟（周期）
+        quint64 dataSource = 0;     // perf_mem_data_src
+        QString module;
+        QString symbol;
+
+        bool isStore() const;
+        bool isHitm() const;        // 命中其他核心中已修改的缓存行
+    };
+
+    // 缓存行中一个偏移上的访问
+    struct Access
+    {
+        quint64 offset = 0;         // 缓存行内的字节偏移
+        QString field;              // 对应的变量和成员，堆上的数据为空
+        quint64 loads = 0;
+        quint64 stores = 0;
+        quint64 hitm = 0;
+        QSet<int> threads;
+        QSet<int> writers;
+        QString symbol;             // 访问最多的指令所在函数
+        Symbolizer::Location location;
+    };
+
+    struct CacheLine
+    {
+        quint64 address = 0;
+        quint64 loads = 0;
+        quint64 stores = 0;
+        quint64 hitm = 0;
+        QSet<int> threads;
+        QSet<int> writers;
+        QList<Access> accesses;     // 按偏移排序
+        bool falseSharing = false;  // 一个线程写入的数据与另一个线程访问的其他数据同在这一行
+        QString advice;
+    };
+
+    struct Report
+    {
+        QList<CacheLine> lines;     // 只包含出现 HITM 的缓存行，按 HITM 次数从大到小
+        int samples = 0;
+        int hitmSamples = 0;
+        QString error;
+    };
+
+    explicit FalseSharingAnalyzer(QObject *parent = nullptr);
+    ~FalseSharingAnalyzer();
+
+    static QString perfPath();
+    static QStringList compileFlags();
+
+    bool start(const QString &executable, const QString &workingDirectory, QString *errorMessage = nullptr);
+    // 录制阶段停止时仍然分析已采集的数据
+    void stop();
+    bool isRunning() const { return stage != Idle; }
+
+    static QList<Sample> parseSamples(const QString &dump);
+    static Report analyze(const QList<Sample> &samples, const QString &executable);
+
+signals:
+    void output(const QString &text);
+    void finished(const FalseSharingAnalyzer::Report &report, int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    enum Stage { Idle, Recording, Reporting, Analyzing };
+
+    QString dataPath() const;
+    void finish(const Report &report);
+
+    QProcess *process;
+    QTemporaryDir dataDirectory;
+    QByteArray reportOutput;
+    QByteArray reportErrors;
+    Stage stage;
+    QString executable;
+    int programExitCode;
+    QProcess::ExitStatus programExitStatus;
+    int generation;                 // 每次启动递增，丢弃上一次运行的分析结果
+};
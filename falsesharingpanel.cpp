@@ -0,0 +1,122 @@
+#include "falsesharingpanel.h"
+#include <QVBoxLayout>
+#include <QHeaderView>
+#include <QFileInfo>
+
+namespace {
+enum Column { DescriptionColumn, HitmColumn, LoadsColumn, StoresColumn, ThreadsColumn, LocationColumn, ColumnCount };
+
+const int FileRole = Qt::UserRole;
+const int LineRole = Qt::UserRole + 1;
+}
+
+FalseSharingPanel::FalseSharingPanel(QWidget *parent)
+    : QWidget(parent)
+    , analyzer(new FalseSharingAnalyzer(this))
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    summaryLabel = new QLabel("通过“运行 > 伪共享检测运行”启动（需要 perf 和支持访存采样的 CPU）", this);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    lineTree = new QTreeWidget(this);
+    lineTree->setColumnCount(ColumnCount);
+    lineTree->setHeaderLabels(QStringList() << "缓存行 / 数据" << "HITM" << "读" << "写" << "线程（写/全部）" << "源码位置");
+    lineTree->header()->setSectionResizeMode(DescriptionColumn, QHeaderView::Stretch);
+    layout->addWidget(lineTree, 1);
+
+    connect(analyzer, &FalseSharingAnalyzer::output, this, &FalseSharingPanel::output);
+    connect(analyzer, &FalseSharingAnalyzer::finished, this, &FalseSharingPanel::onFinished);
+    connect(lineTree, &QTreeWidget::itemActivated, this, &FalseSharingPanel::onItemActivated);
+}
+
+bool FalseSharingPanel::startAnalysis(const QString &executable, const QString &workingDirectory,
+                                      QString *errorMessage)
+{
+    lineTree->clear();
+    if (!analyzer->start(executable, workingDirectory, errorMessage)) {
+        return false;
+    }
+    summaryLabel->setText("运行中（perf c2c record）...");
+    return true;
+}
+
+void FalseSharingPanel::stop()
+{
+    analyzer->stop();
+}
+
+void FalseSharingPanel::onFinished(const FalseSharingAnalyzer::Report &report, int exitCode,
+                                   QProcess::ExitStatus exitStatus)
+{
+    lineTree->clear();
+    if (!report.error.isEmpty()) {
+        summaryLabel->setText(report.error);
+        emit finished(exitCode, exitStatus);
+        return;
+    }
+
+    int falseSharing = 0;
+    for (const FalseSharingAnalyzer::CacheLine &line : report.lines) {
+        if (line.falseSharing) ++falseSharing;
+
+        QTreeWidgetItem *lineItem = new QTreeWidgetItem(lineTree);
+        lineItem->setText(DescriptionColumn, QString("%1  0x%2：%3")
+                                                 .arg(line.falseSharing ? "伪共享" : "争用")
+                                                 .arg(line.address, 0, 16).arg(line.advice));
+        lineItem->setToolTip(DescriptionColumn, line.advice);
+        lineItem->setForeground(DescriptionColumn, QColor(line.falseSharing ? "#f44747" : "#d7ba7d"));
+        lineItem->setText(HitmColumn, QString::number(line.hitm));
+        lineItem->setText(LoadsColumn, QString::number(line.loads));
+        lineItem->setText(StoresColumn, QString::number(line.stores));
+        lineItem->setText(ThreadsColumn, QString("%1 / %2").arg(line.writers.size()).arg(line.threads.size()));
+
+        for (const FalseSharingAnalyzer::Access &access : line.accesses) {
+            QTreeWidgetItem *accessItem = new QTreeWidgetItem(lineItem);
+            QString name = QString("+0x%1").arg(access.offset, 2, 16, QChar('0'));
+            if (!access.field.isEmpty()) name += "  " + access.field;
+            accessItem->setText(DescriptionColumn, name);
+            accessItem->setText(HitmColumn, QString::number(access.hitm));
+            accessItem->setText(LoadsColumn, QString::number(access.loads));
+            accessItem->setText(StoresColumn, QString::number(access.stores));
+            accessItem->setText(ThreadsColumn, QString("%1 / %2").arg(access.writers.size()).arg(access.threads.size()));
+            const Symbolizer::Location &location = access.location;
+            if (location.isValid()) {
+                accessItem->setText(LocationColumn, QString("%1:%2  %3").arg(QFileInfo(location.file).fileName())
+                                                        .arg(location.line).arg(location.function));
+                accessItem->setToolTip(LocationColumn, location.file);
+                accessItem->setData(DescriptionColumn, FileRole, location.file);
+                accessItem->setData(DescriptionColumn, LineRole, location.line);
+            } else {
+                accessItem->setText(LocationColumn, access.symbol);
+            }
+            if (!access.writers.isEmpty()) accessItem->setForeground(StoresColumn, QColor("#f44747"));
+        }
+    }
+    for (int column = HitmColumn; column < ColumnCount; ++column) {
+        lineTree->resizeColumnToContents(column);
+    }
+    if (lineTree->topLevelItemCount() > 0) lineTree->topLevelItem(0)->setExpanded(true);
+
+    if (report.lines.isEmpty()) {
+        summaryLabel->setText(QString("%1 个访存样本，没有发现线程间争用的缓存行").arg(report.samples));
+    } else {
+        summaryLabel->setText(QString("%1 个访存样本，%2 个 HITM；%3 条争用的缓存行，其中 %4 条为伪共享")
+                                  .arg(report.samples).arg(report.hitmSamples)
+                                  .arg(report.lines.size()).arg(falseSharing));
+    }
+    emit finished(exitCode, exitStatus);
+}
+
+void FalseSharingPanel::onItemActivated(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column)
+    QString file = item->data(DescriptionColumn, FileRole).toString();
+    int line = item->data(DescriptionColumn, LineRole).toInt();
+    if (!file.isEmpty() && line > 0 && QFileInfo::exists(file)) {
+        emit openFileRequested(file, line);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QWidget>
+#include <QTreeWidget>
+#include <QLabel>
+
+#include "falsesharinganalyzer.h"
+
+// 伪共享检测窗口
+// 每条发生争用的缓存行一行，给出可操作的结论；展开后是行内各偏移的访问和对应源码位置
+class FalseSharingPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FalseSharingPanel(QWidget *parent = nullptr);
+
+    bool startAnalysis(const QString &executable, const QString &workingDirectory, QString *errorMessage);
+    void stop();
+    bool isRunning() const { return analyzer->isRunning(); }
+
+signals:
+    void output(const QString &text);
+    void openFileRequested(const QString &filePath, int line);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onFinished(const FalseSharingAnalyzer::Report &report, int exitCode, QProcess::ExitStatus exitStatus);
+    void onItemActivated(QTreeWidgetItem *item, int column);
+
+private:
+    FalseSharingAnalyzer *analyzer;
+    QLabel *summaryLabel;
+    QTreeWidget *lineTree;
+};
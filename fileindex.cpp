@@ -0,0 +1,214 @@
+#include "fileindex.h"
+
+namespace
+{
+const QStringList SourceExtensions = { "cpp", "c", "cc", "cxx" };
+const QStringList HeaderExtensions = { "h", "hpp", "hh", "hxx" };
+
+QString suffixOf(const QString &name)
+{
+    const int dot = name.lastIndexOf('.');
+    return dot > 0 ? name.mid(dot + 1).toLower() : QString();
+}
+}
+
+FileIndex::FileIndex()
+    : fileCount(0)
+    , changeCount(0)
+{
+    clear();
+}
+
+FileIndex::Category FileIndex::categoryOf(const QString &path)
+{
+    const QString suffix = suffixOf(path.mid(path.lastIndexOf('/') + 1));
+    if (SourceExtensions.contains(suffix)) return Source;
+    if (HeaderExtensions.contains(suffix)) return Header;
+    return Other;
+}
+
+QStringList FileIndex::extensions(Category category)
+{
+    switch (category) {
+    case Source: return SourceExtensions;
+    case Header: return HeaderExtensions;
+    case Other: break;
+    }
+    return QStringList();
+}
+
+void FileIndex::clear()
+{
+    directories.clear();
+    directoryIds.clear();
+    entries.clear();
+    freeEntries.clear();
+    extensionBuckets.clear();
+    fileCount = 0;
+    ++changeCount;
+
+    directories.append(Directory());
+    directoryIds.insert(QString(), 0);
+}
+
+int FileIndex::internDirectory(const QString &relativePath)
+{
+    auto it = directoryIds.constFind(relativePath);
+    if (it != directoryIds.constEnd()) return it.value();
+
+    const int slash = relativePath.lastIndexOf('/');
+    const int parent = internDirectory(slash < 0 ? QString() : relativePath.left(slash));
+
+    Directory directory;
+    directory.parent = parent;
+    directory.name = relativePath.mid(slash + 1);
+    directory.path = relativePath;
+
+    const int id = directories.size();
+    directories.append(directory);
+    directories[parent].directories.insert(directory.name, id);
+    directoryIds.insert(relativePath, id);
+    return id;
+}
+
+int FileIndex::findDirectory(const QString &relativePath) const
+{
+    return directoryIds.value(relativePath, -1);
+}
+
+bool FileIndex::insert(const QString &relativePath)
+{
+    const int slash = relativePath.lastIndexOf('/');
+    const QString name = relativePath.mid(slash + 1);
+    if (name.isEmpty()) return false;
+
+    const int directory = internDirectory(slash < 0 ? QString() : relativePath.left(slash));
+    if (directories[directory].files.contains(name)) return false;
+
+    Entry entry;
+    entry.directory = directory;
+    entry.name = name;
+    entry.suffix = suffixOf(name);
+
+    int id;
+    if (!freeEntries.isEmpty()) {
+        id = freeEntries.takeLast();
+        entries[id] = entry;
+    } else {
+        id = entries.size();
+        entries.append(entry);
+    }
+
+    directories[directory].files.insert(name, id);
+    extensionBuckets[entry.suffix].insert(id);
+    ++fileCount;
+    ++changeCount;
+    return true;
+}
+
+bool FileIndex::remove(const QString &relativePath)
+{
+    const int id = find(relativePath);
+    if (id < 0) return false;
+
+    Entry &entry = entries[id];
+    directories[entry.directory].files.remove(entry.name);
+
+    auto bucket = extensionBuckets.find(entry.suffix);
+    if (bucket != extensionBuckets.end()) {
+        bucket->remove(id);
+        if (bucket->isEmpty()) extensionBuckets.erase(bucket);
+    }
+
+    entry = Entry();
+    freeEntries.append(id);
+    --fileCount;
+    ++changeCount;
+    return true;
+}
+
+QStringList FileIndex::removeDirectory(const QString &relativePath)
+{
+    QStringList removed;
+    const int id = findDirectory(relativePath);
+    if (id <= 0) return removed;
+
+    Directory &directory = directories[id];
+    directories[directory.parent].directories.remove(directory.name);
+    removeDirectoryTree(id, removed);
+    return removed;
+}
+
+void FileIndex::removeDirectoryTree(int id, QStringList &removed)
+{
+    // 目录槽位不回收，只断开与父目录和路径表的联系
+    const QList<int> subdirectories = directories[id].directories.values();
+    for (int subdirectory : subdirectories) removeDirectoryTree(subdirectory, removed);
+
+    const QList<int> files = directories[id].files.values();
+    for (int file : files) {
+        const QString filePath = path(file);
+        remove(filePath);
+        removed.append(filePath);
+    }
+
+    directoryIds.remove(directories[id].path);
+    directories[id].directories.clear();
+    directories[id].parent = -1;
+}
+
+int FileIndex::find(const QString &relativePath) const
+{
+    const int slash = relativePath.lastIndexOf('/');
+    const int directory = findDirectory(slash < 0 ? QString() : relativePath.left(slash));
+    if (directory < 0) return -1;
+    return directories[directory].files.value(relativePath.mid(slash + 1), -1);
+}
+
+QString FileIndex::path(int file) const
+{
+    const Entry &entry = entries[file];
+    if (entry.directory < 0) return QString();
+    const QString &directory = directories[entry.directory].path;
+    return directory.isEmpty() ? entry.name : directory + '/' + entry.name;
+}
+
+QStringList FileIndex::files() const
+{
+    QStringList result;
+    result.reserve(fileCount);
+    for (int id = 0; id < entries.size(); ++id) {
+        if (entries[id].directory >= 0) result.append(path(id));
+    }
+    return result;
+}
+
+QStringList FileIndex::filesWithExtension(const QString &suffix) const
+{
+    QStringList result;
+    auto bucket = extensionBuckets.constFind(suffix.toLower());
+    if (bucket == extensionBuckets.constEnd()) return result;
+
+    result.reserve(bucket->size());
+    for (int id : *bucket) result.append(path(id));
+    result.sort();
+    return result;
+}
+
+QStringList FileIndex::filesInCategory(Category category) const
+{
+    if (category != Other) {
+        QStringList result;
+        for (const QString &suffix : extensions(category)) result += filesWithExtension(suffix);
+        result.sort();
+        return result;
+    }
+
+    QStringList result;
+    for (auto bucket = extensionBuckets.constBegin(); bucket != extensionBuckets.constEnd(); ++bucket) {
+        if (SourceExtensions.contains(bucket.key()) || HeaderExtensions.contains(bucket.key())) continue;
+        for (int id : bucket.value()) result.append(path(id));
+    }
+    result.sort();
+    return result;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QSet>
+
+// 项目文件索引
+// 路径按目录驻留：每个目录只保存一次完整路径，文件只保存所在目录的编号和文件名，
+// 几十万个文件共享同一批目录字符串。另按扩展名分桶，按类别或扩展名取文件时不必遍历全部文件。
+// 文件编号在删除后会被复用，调用方不应长期保存编号。
+class FileIndex
+{
+public:
+    enum Category { Source, Header, Other };
+
+    static Category categoryOf(const QString &path);
+    static QStringList extensions(Category category);
+
+    struct Directory
+    {
+        int parent = -1;
+        QString name;
+        QString path;                   // 相对项目根目录，根目录为空字符串
+        QHash<QString, int> directories; // 子目录名 -> 目录编号
+        QHash<QString, int> files;      // 文件名 -> 文件编号
+    };
+
+    FileIndex();
+
+    // 路径相对项目根目录、以 / 分隔；已存在时返回 false
+    bool insert(const QString &relativePath);
+    bool remove(const QString &relativePath);
+    // 删除目录下的所有文件和子目录，返回被删除的文件路径
+    QStringList removeDirectory(const QString &relativePath);
+    bool contains(const QString &relativePath) const { return find(relativePath) >= 0; }
+    void clear();
+
+    int size() const { return fileCount; }
+    // 每次增删文件后递增，调用方据此判断缓存的文件列表是否过期
+    int revision() const { return changeCount; }
+    int find(const QString &relativePath) const;
+    QString path(int file) const;
+    QString fileName(int file) const { return entries[file].name; }
+    int directoryOf(int file) const { return entries[file].directory; }
+
+    QStringList files() const;
+    QStringList filesInCategory(Category category) const;
+    QStringList filesWithExtension(const QString &suffix) const;
+
+    // 0 号目录是项目根目录
+    const Directory &directory(int id) const { return directories[id]; }
+    int findDirectory(const QString &relativePath) const;
+
+private:
+    struct Entry
+    {
+        int directory = -1;     // -1 表示已删除
+        QString name;
+        QString suffix;
+    };
+
+    int internDirectory(const QString &relativePath);
+    void removeDirectoryTree(int id, QStringList &removed);
+
+    QList<Directory> directories;
+    QHash<QString, int> directoryIds;
+    QList<Entry> entries;
+    QList<int> freeEntries;
+    QHash<QString, QSet<int>> extensionBuckets;
+    int fileCount;
+    int changeCount;
+};
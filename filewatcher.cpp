@@ -0,0 +1,442 @@
+#include "filewatcher.h"
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#endif
+
+namespace
+{
+#ifdef Q_OS_LINUX
+const quint32 WatchMask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO
+    | IN_ONLYDIR | IN_EXCL_UNLINK;
+#endif
+
+bool isUnder(const QString &path, const QString &directory)
+{
+    return path == directory || path.startsWith(directory + '/');
+}
+}
+
+#ifdef Q_OS_LINUX
+
+FileWatcher::FileWatcher(QObject *parent)
+    : QObject(parent)
+    , fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , notifier(nullptr)
+    , coalesceTimer(new QTimer(this))
+    , limitReported(false)
+{
+    coalesceTimer->setSingleShot(true);
+    coalesceTimer->setInterval(CoalesceMs);
+    connect(coalesceTimer, &QTimer::timeout, this, &FileWatcher::flush);
+
+    if (fd >= 0) {
+        notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &FileWatcher::onActivated);
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (fd >= 0) ::close(fd);
+}
+
+bool FileWatcher::isValid() const
+{
+    return fd >= 0;
+}
+
+bool FileWatcher::addDirectory(const QString &path)
+{
+    if (fd < 0) return false;
+
+    auto count = refCounts.find(path);
+    if (count != refCounts.end()) {
+        ++count.value();
+        return true;
+    }
+
+    const int wd = inotify_add_watch(fd, QFile::encodeName(path).constData(), WatchMask);
+    if (wd < 0) {
+        if (errno == ENOSPC && !limitReported) {
+            limitReported = true;
+            emit watchLimitReached();
+        }
+        return false;
+    }
+
+    watchPaths.insert(wd, path);
+    watchIds.insert(path, wd);
+    refCounts.insert(path, 1);
+    return true;
+}
+
+void FileWatcher::removeDirectory(const QString &path)
+{
+    auto count = refCounts.find(path);
+    if (count == refCounts.end()) return;
+    if (--count.value() > 0) return;
+
+    refCounts.erase(count);
+    const int wd = watchIds.take(path);
+    watchPaths.remove(wd);
+    inotify_rm_watch(fd, wd);
+}
+
+void FileWatcher::removeDirectoryTree(const QString &path)
+{
+    for (auto it = watchIds.begin(); it != watchIds.end();) {
+        if (isUnder(it.key(), path)) {
+            inotify_rm_watch(fd, it.value());
+            watchPaths.remove(it.value());
+            refCounts.remove(it.key());
+            it = watchIds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void FileWatcher::clear()
+{
+    for (auto it = watchPaths.constBegin(); it != watchPaths.constEnd(); ++it) {
+        inotify_rm_watch(fd, it.key());
+    }
+    watchPaths.clear();
+    watchIds.clear();
+    refCounts.clear();
+    pending.clear();
+    pendingOrder.clear();
+    pendingMoves.clear();
+    coalesceTimer->stop();
+    limitReported = false;
+}
+
+void FileWatcher::onActivated()
+{
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    bool overflow = false;
+
+    for (;;) {
+        const ssize_t length = ::read(fd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (ssize_t position = 0; position < length;) {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(buffer + position);
+            position += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            auto watch = watchPaths.find(event->wd);
+            if (watch == watchPaths.end()) continue;
+
+            // 目录被删除或移出后内核自动取消监视
+            if (event->mask & IN_IGNORED) {
+                refCounts.remove(watch.value());
+                watchIds.remove(watch.value());
+                watchPaths.erase(watch);
+                continue;
+            }
+            if (event->len == 0) continue;
+
+            Change change;
+            change.path = watch.value() + '/' + QFile::decodeName(event->name);
+            change.isDirectory = event->mask & IN_ISDIR;
+
+            if (event->mask & IN_MOVED_FROM) {
+                pendingMoves.insert(event->cookie, qMakePair(change.path, change.isDirectory));
+                continue;
+            }
+
+            if (event->mask & IN_MOVED_TO) {
+                auto move = pendingMoves.find(event->cookie);
+                if (move != pendingMoves.end()) {
+                    change.type = Renamed;
+                    change.oldPath = move->first;
+                    pendingMoves.erase(move);
+                    if (change.isDirectory) renameWatches(change.oldPath, change.path);
+                } else {
+                    // 从监视范围外移入
+                    change.type = Created;
+                }
+            } else if (event->mask & IN_CREATE) {
+                change.type = Created;
+            } else if (event->mask & IN_DELETE) {
+                change.type = Removed;
+            } else {
+                change.type = Modified;
+            }
+            record(change);
+        }
+    }
+
+    if (overflow) {
+        // 合并中的事件已经不完整，交给调用方整体重新检查
+        pending.clear();
+        pendingOrder.clear();
+        pendingMoves.clear();
+        emit overflowed();
+        return;
+    }
+
+    if (!pending.isEmpty() || !pendingMoves.isEmpty()) scheduleFlush();
+}
+
+void FileWatcher::renameWatches(const QString &oldPath, const QString &newPath)
+{
+    QList<QPair<QString, int>> moved;
+    for (auto it = watchIds.begin(); it != watchIds.end();) {
+        if (isUnder(it.key(), oldPath)) {
+            moved.append(qMakePair(it.key(), it.value()));
+            it = watchIds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto &watch : moved) {
+        const QString path = newPath + watch.first.mid(oldPath.length());
+        watchPaths[watch.second] = path;
+        watchIds.insert(path, watch.second);
+        refCounts.insert(path, refCounts.take(watch.first));
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFileSystemWatcher(this))
+    , coalesceTimer(new QTimer(this))
+    , limitReported(false)
+{
+    coalesceTimer->setSingleShot(true);
+    coalesceTimer->setInterval(CoalesceMs);
+    connect(coalesceTimer, &QTimer::timeout, this, &FileWatcher::flush);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &FileWatcher::rescanDirectory);
+}
+
+FileWatcher::~FileWatcher()
+{
+}
+
+bool FileWatcher::isValid() const
+{
+    return true;
+}
+
+bool FileWatcher::addDirectory(const QString &path)
+{
+    auto count = refCounts.find(path);
+    if (count != refCounts.end()) {
+        ++count.value();
+        return true;
+    }
+
+    if (!watcher->addPath(path)) return false;
+    snapshots.insert(path, listDirectory(path));
+    refCounts.insert(path, 1);
+    return true;
+}
+
+void FileWatcher::removeDirectory(const QString &path)
+{
+    auto count = refCounts.find(path);
+    if (count == refCounts.end()) return;
+    if (--count.value() > 0) return;
+
+    refCounts.erase(count);
+    snapshots.remove(path);
+    watcher->removePath(path);
+}
+
+void FileWatcher::removeDirectoryTree(const QString &path)
+{
+    for (auto it = refCounts.begin(); it != refCounts.end();) {
+        if (isUnder(it.key(), path)) {
+            watcher->removePath(it.key());
+            snapshots.remove(it.key());
+            it = refCounts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void FileWatcher::clear()
+{
+    const QStringList directories = watcher->directories();
+    if (!directories.isEmpty()) watcher->removePaths(directories);
+    snapshots.clear();
+    refCounts.clear();
+    pending.clear();
+    pendingOrder.clear();
+    coalesceTimer->stop();
+    limitReported = false;
+}
+
+FileWatcher::Snapshot FileWatcher::listDirectory(const QString &path)
+{
+    Snapshot snapshot;
+    const QFileInfoList entries = QDir(path).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot
+                                                           | QDir::Hidden | QDir::System);
+    for (const QFileInfo &info : entries) {
+        Entry entry;
+        entry.modifiedTime = info.lastModified().toMSecsSinceEpoch();
+        entry.size = info.size();
+        entry.isDirectory = info.isDir();
+        snapshot.insert(info.fileName(), entry);
+    }
+    return snapshot;
+}
+
+void FileWatcher::rescanDirectory(const QString &path)
+{
+    auto snapshot = snapshots.find(path);
+    if (snapshot == snapshots.end()) return;
+
+    // 目录本身被删除时由上一级目录报告
+    if (!QFileInfo(path).isDir()) {
+        removeDirectoryTree(path);
+        return;
+    }
+
+    const Snapshot previous = snapshot.value();
+    const Snapshot current = listDirectory(path);
+    snapshot.value() = current;
+
+    QStringList removedDirectories;
+    for (auto it = previous.constBegin(); it != previous.constEnd(); ++it) {
+        if (current.contains(it.key())) continue;
+        Change change;
+        change.type = Removed;
+        change.path = path + '/' + it.key();
+        change.isDirectory = it->isDirectory;
+        if (change.isDirectory) removedDirectories.append(change.path);
+        record(change);
+    }
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        auto old = previous.constFind(it.key());
+        Change change;
+        change.path = path + '/' + it.key();
+        change.isDirectory = it->isDirectory;
+        if (old == previous.constEnd()) {
+            change.type = Created;
+        } else if (!it->isDirectory && (it->modifiedTime != old->modifiedTime || it->size != old->size)) {
+            change.type = Modified;
+        } else {
+            continue;
+        }
+        record(change);
+    }
+
+    for (const QString &directory : std::as_const(removedDirectories)) removeDirectoryTree(directory);
+    if (!pending.isEmpty()) scheduleFlush();
+}
+
+#endif
+
+void FileWatcher::scheduleFlush()
+{
+    // 窗口从第一个事件开始计时，不因后续事件顺延，持续写入时也能定期得到结果
+    if (!coalesceTimer->isActive()) coalesceTimer->start();
+}
+
+void FileWatcher::record(const Change &change)
+{
+    auto previous = pending.find(change.path);
+    const bool known = previous != pending.end();
+
+    switch (change.type) {
+    case Created:
+        // 删除后又创建（部分编辑器的保存方式）等同于修改
+        if (known && previous->type == Removed && !change.isDirectory) {
+            previous->type = Modified;
+            return;
+        }
+        break;
+
+    case Modified:
+        if (known && previous->type != Removed) return;
+        break;
+
+    case Removed:
+        if (known) {
+            if (previous->type == Created) {
+                // 窗口内创建又删除的临时文件不报告
+                pending.erase(previous);
+                return;
+            }
+            if (previous->type == Renamed) {
+                // 改名后又被删除，相当于删除了原来的文件
+                Change removed = change;
+                removed.path = previous->oldPath;
+                pending.erase(previous);
+                record(removed);
+                return;
+            }
+        }
+        break;
+
+    case Renamed: {
+        auto source = pending.find(change.oldPath);
+        if (source != pending.end()) {
+            Change merged = change;
+            if (source->type == Created) {
+                // 写临时文件再改名覆盖：对外只是目标文件被创建
+                merged.type = Created;
+                merged.oldPath.clear();
+            } else if (source->type == Renamed) {
+                merged.oldPath = source->oldPath;
+            }
+            pending.erase(source);
+            pending.insert(change.path, merged);
+            pendingOrder.append(change.path);
+            return;
+        }
+        break;
+    }
+    }
+
+    pending.insert(change.path, change);
+    pendingOrder.append(change.path);
+}
+
+void FileWatcher::flush()
+{
+#ifdef Q_OS_LINUX
+    // 没有配对的 IN_MOVED_FROM 表示移出了监视范围
+    for (auto it = pendingMoves.constBegin(); it != pendingMoves.constEnd(); ++it) {
+        Change change;
+        change.type = Removed;
+        change.path = it.value().first;
+        change.isDirectory = it.value().second;
+        if (change.isDirectory) removeDirectoryTree(change.path);
+        record(change);
+    }
+    pendingMoves.clear();
+#endif
+
+    QList<Change> changes;
+    changes.reserve(pending.size());
+    for (const QString &path : pendingOrder) {
+        auto it = pending.find(path);
+        if (it == pending.end()) continue;
+        changes.append(it.value());
+        pending.erase(it);
+    }
+    pendingOrder.clear();
+    pending.clear();
+
+    if (!changes.isEmpty()) emit changed(changes);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+#else
+#include <QFileSystemWatcher>
+#endif
+
+// 目录监视，Linux 上基于 inotify
+// 每个目录一个 watch（不自动递归，由调用方为子目录逐个添加），同一目录可以被多次添加，
+// 引用计数归零时才取消监视。事件先在短时间窗口内合并再一次性发出：
+// 同一文件的多次写入只报一次修改；先创建后删除的临时文件不报告；
+// 编辑器“写临时文件再改名覆盖”的保存方式合并为目标文件的一次创建；
+// 成对的 IN_MOVED_FROM/IN_MOVED_TO 报告为改名。
+// 其他平台使用 QFileSystemWatcher：目录变化时与上次的目录快照比较，改名报告为删除加创建。
+class FileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ChangeType { Created, Removed, Modified, Renamed };
+
+    struct Change
+    {
+        ChangeType type = Modified;
+        QString path;               // 绝对路径；改名时为新路径
+        QString oldPath;            // 只在改名时有效
+        bool isDirectory = false;
+    };
+
+    explicit FileWatcher(QObject *parent = nullptr);
+    ~FileWatcher();
+
+    bool isValid() const;
+
+    bool addDirectory(const QString &path);
+    void removeDirectory(const QString &path);
+    // 移除 path 及其下所有子目录的监视，不考虑引用计数
+    void removeDirectoryTree(const QString &path);
+    void clear();
+    bool isWatching(const QString &path) const { return refCounts.contains(path); }
+
+signals:
+    void changed(const QList<FileWatcher::Change> &changes);
+    // 内核事件队列溢出，部分事件已丢失，调用方应重新检查监视的内容
+    void overflowed();
+    // 达到 fs.inotify.max_user_watches 等限制，之后的目录不再被监视
+    void watchLimitReached();
+
+private slots:
+    void flush();
+
+private:
+    static const int CoalesceMs = 150;
+
+    void record(const Change &change);
+    void scheduleFlush();
+
+#ifdef Q_OS_LINUX
+    void onActivated();
+    void renameWatches(const QString &oldPath, const QString &newPath);
+
+    int fd;
+    QSocketNotifier *notifier;
+
+    QHash<int, QString> watchPaths;     // watch 描述符 -> 目录
+    QHash<QString, int> watchIds;
+    // 等待配对 IN_MOVED_TO 的 IN_MOVED_FROM：cookie -> (旧路径, 是否目录)
+    QHash<quint32, QPair<QString, bool>> pendingMoves;
+#else
+    struct Entry
+    {
+        qint64 modifiedTime = 0;
+        qint64 size = 0;
+        bool isDirectory = false;
+    };
+    using Snapshot = QHash<QString, Entry>;     // 文件名 -> 状态
+
+    static Snapshot listDirectory(const QString &path);
+    void rescanDirectory(const QString &path);
+
+    QFileSystemWatcher *watcher;
+    QHash<QString, Snapshot> snapshots;
+#endif
+
+    QTimer *coalesceTimer;
+    bool limitReported;
+    QHash<QString, int> refCounts;
+
+    // 合并中的事件，按路径去重，按首次出现的顺序发出
+    QHash<QString, Change> pending;
+    QStringList pendingOrder;
+};
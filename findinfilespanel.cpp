@@ -0,0 +1,245 @@
+#include "findinfilespanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QSet>
+
+namespace {
+const int SearchDelay = 250;    // 输入停顿这么久后开始查找（毫秒）
+}
+
+SearchResultModel::SearchResultModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void SearchResultModel::clear()
+{
+    beginResetModel();
+    matches.clear();
+    endResetModel();
+}
+
+void SearchResultModel::appendMatches(const QList<ProjectSearcher::Match> &newMatches)
+{
+    if (newMatches.isEmpty()) return;
+
+    const int first = matches.size();
+    beginInsertRows(QModelIndex(), first, first + newMatches.size() - 1);
+    matches += newMatches;
+    endInsertRows();
+}
+
+int SearchResultModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : matches.size();
+}
+
+QVariant SearchResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= matches.size()) return QVariant();
+
+    const ProjectSearcher::Match &match = matches[index.row()];
+    switch (role) {
+    case Qt::DisplayRole: {
+        // 显示时才拼接文本，模型中只保存匹配本身
+        QString path = match.filePath;
+        if (!root.isEmpty() && path.startsWith(root + '/')) path = path.mid(root.size() + 1);
+        return QString("%1:%2: %3").arg(path).arg(match.line).arg(match.lineText.trimmed());
+    }
+    case Qt::ToolTipRole:
+        return QString("%1:%2:%3").arg(match.filePath).arg(match.line).arg(match.column);
+    case FilePathRole:
+        return match.filePath;
+    case LineRole:
+        return match.line;
+    case ColumnRole:
+        return match.column;
+    case LengthRole:
+        return match.length;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+FindInFilesPanel::FindInFilesPanel(QWidget *parent)
+    : QWidget(parent)
+    , searcher(new ProjectSearcher(this))
+    , resultModel(new SearchResultModel(this))
+    , searchTimer(new QTimer(this))
+    , fileIndex(nullptr)
+    , filesRevision(-1)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *queryLayout = new QHBoxLayout();
+    queryEdit = new QLineEdit(this);
+    queryEdit->setPlaceholderText("在项目中查找");
+    queryEdit->setClearButtonEnabled(true);
+    caseCheck = new QCheckBox("区分大小写", this);
+    wholeWordCheck = new QCheckBox("全词匹配", this);
+    regexCheck = new QCheckBox("正则表达式", this);
+    queryLayout->addWidget(queryEdit, 1);
+    queryLayout->addWidget(caseCheck);
+    queryLayout->addWidget(wholeWordCheck);
+    queryLayout->addWidget(regexCheck);
+    layout->addLayout(queryLayout);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filePatternEdit = new QLineEdit(this);
+    filePatternEdit->setPlaceholderText("文件类型，例如 *.cpp *.h，为空表示全部文件");
+    statusLabel = new QLabel(this);
+    filterLayout->addWidget(filePatternEdit, 1);
+    filterLayout->addWidget(statusLabel, 1);
+    layout->addLayout(filterLayout);
+
+    QHBoxLayout *replaceLayout = new QHBoxLayout();
+    replaceEdit = new QLineEdit(this);
+    replaceEdit->setPlaceholderText("替换为（正则表达式模式下可用 \\1 或 $1 引用分组）");
+    replaceButton = new QPushButton("替换...", this);
+    replaceButton->setEnabled(false);
+    replaceLayout->addWidget(replaceEdit, 1);
+    replaceLayout->addWidget(replaceButton);
+    layout->addLayout(replaceLayout);
+
+    resultView = new QListView(this);
+    resultView->setModel(resultModel);
+    resultView->setUniformItemSizes(true);
+    resultView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultView->setTextElideMode(Qt::ElideRight);
+    layout->addWidget(resultView, 1);
+
+    searchTimer->setSingleShot(true);
+    searchTimer->setInterval(SearchDelay);
+
+    connect(searchTimer, &QTimer::timeout, this, &FindInFilesPanel::startSearch);
+    connect(queryEdit, &QLineEdit::textChanged, this, &FindInFilesPanel::scheduleSearch);
+    connect(queryEdit, &QLineEdit::returnPressed, this, &FindInFilesPanel::startSearch);
+    connect(filePatternEdit, &QLineEdit::textChanged, this, &FindInFilesPanel::scheduleSearch);
+    connect(caseCheck, &QCheckBox::toggled, this, &FindInFilesPanel::scheduleSearch);
+    connect(wholeWordCheck, &QCheckBox::toggled, this, &FindInFilesPanel::scheduleSearch);
+    connect(regexCheck, &QCheckBox::toggled, this, &FindInFilesPanel::scheduleSearch);
+    connect(searcher, &ProjectSearcher::matchesFound, this, &FindInFilesPanel::onMatchesFound);
+    connect(searcher, &ProjectSearcher::finished, this, &FindInFilesPanel::onSearchFinished);
+    connect(resultView, &QListView::activated, this, &FindInFilesPanel::onResultActivated);
+    connect(replaceButton, &QPushButton::clicked, this, &FindInFilesPanel::onReplaceClicked);
+}
+
+void FindInFilesPanel::setProject(const FileIndex *index, const QString &rootPath)
+{
+    if (fileIndex == index && root == rootPath) return;
+    fileIndex = index;
+    root = rootPath;
+    files.clear();
+    filesRevision = -1;
+}
+
+void FindInFilesPanel::activate(const QString &text)
+{
+    if (!text.isEmpty() && text != queryEdit->text()) {
+        queryEdit->setText(text);
+        startSearch();
+    }
+    queryEdit->setFocus();
+    queryEdit->selectAll();
+}
+
+void FindInFilesPanel::searchFor(const QString &text, bool caseSensitive, bool wholeWord, const QString &filePatterns)
+{
+    // 各控件的变化信号只会启动延时查找，startSearch 会停止它
+    queryEdit->setText(text);
+    filePatternEdit->setText(filePatterns);
+    caseCheck->setChecked(caseSensitive);
+    wholeWordCheck->setChecked(wholeWord);
+    regexCheck->setChecked(false);
+    startSearch();
+    resultView->setFocus();
+}
+
+const QStringList &FindInFilesPanel::projectFiles()
+{
+    if (fileIndex && fileIndex->revision() != filesRevision) {
+        files = fileIndex->files();
+        filesRevision = fileIndex->revision();
+    }
+    return files;
+}
+
+void FindInFilesPanel::scheduleSearch()
+{
+    // 旧的查找立即停止，等输入停顿后再开始新的
+    searcher->cancel();
+    searchTimer->start();
+}
+
+ProjectSearcher::Options FindInFilesPanel::currentOptions() const
+{
+    ProjectSearcher::Options options;
+    options.pattern = queryEdit->text();
+    options.caseSensitive = caseCheck->isChecked();
+    options.wholeWord = wholeWordCheck->isChecked();
+    options.regularExpression = regexCheck->isChecked();
+    options.filePatterns = ProjectSearcher::parseFilePatterns(filePatternEdit->text());
+    return options;
+}
+
+void FindInFilesPanel::startSearch()
+{
+    searchTimer->stop();
+    resultModel->clear();
+    resultModel->setRootPath(root);
+    replaceButton->setEnabled(false);
+
+    const ProjectSearcher::Options options = currentOptions();
+    if (options.pattern.isEmpty()) {
+        searcher->cancel();
+        statusLabel->clear();
+        return;
+    }
+
+    const QHash<QString, QString> buffers = bufferProvider ? bufferProvider() : QHash<QString, QString>();
+    QString errorMessage;
+    if (!searcher->start(root, projectFiles(), buffers, options, &errorMessage)) {
+        statusLabel->setText(errorMessage);
+        return;
+    }
+    statusLabel->setText("正在查找...");
+}
+
+void FindInFilesPanel::onMatchesFound(const QList<ProjectSearcher::Match> &matches)
+{
+    resultModel->appendMatches(matches);
+    statusLabel->setText(QString("正在查找... 已找到 %1 处").arg(resultModel->rowCount()));
+}
+
+void FindInFilesPanel::onSearchFinished(int fileCount, int matchCount, bool truncated, qint64 elapsedMs)
+{
+    QString text = QString("%1 个文件中找到 %2 处，用时 %3 ms").arg(fileCount).arg(matchCount).arg(elapsedMs);
+    if (truncated) text += QString("（结果过多，只显示前 %1 处）").arg(ProjectSearcher::MaxMatches);
+    statusLabel->setText(text);
+    replaceButton->setEnabled(matchCount > 0);
+}
+
+void FindInFilesPanel::onReplaceClicked()
+{
+    // 结果中的文件按出现顺序去重；结果被截断时替换仍然只作用于这些文件
+    QStringList filePaths;
+    QSet<QString> seen;
+    for (const ProjectSearcher::Match &match : resultModel->allMatches()) {
+        if (seen.contains(match.filePath)) continue;
+        seen.insert(match.filePath);
+        filePaths.append(match.filePath);
+    }
+    if (filePaths.isEmpty()) return;
+
+    emit replaceRequested(filePaths, currentOptions(), replaceEdit->text());
+}
+
+void FindInFilesPanel::onResultActivated(const QModelIndex &index)
+{
+    if (!index.isValid()) return;
+    emit openFileRequested(index.data(SearchResultModel::FilePathRole).toString(),
+                           index.data(SearchResultModel::LineRole).toInt(),
+                           index.data(SearchResultModel::ColumnRole).toInt());
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QWidget>
+#include <QAbstractListModel>
+#include <QListView>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <functional>
+
+#include "fileindex.h"
+#include "projectsearcher.h"
+
+// 查找结果列表模型
+// 每个匹配一行，结果分批追加；视图使用统一行高，只绘制可见的行，几万条结果也不会卡顿
+class SearchResultModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles
+    {
+        FilePathRole = Qt::UserRole,
+        LineRole,
+        ColumnRole,
+        LengthRole
+    };
+
+    explicit SearchResultModel(QObject *parent = nullptr);
+
+    void setRootPath(const QString &path) { root = path; }
+    void clear();
+    void appendMatches(const QList<ProjectSearcher::Match> &newMatches);
+    const QList<ProjectSearcher::Match> &allMatches() const { return matches; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QString root;
+    QList<ProjectSearcher::Match> matches;
+};
+
+// 在文件中查找窗口
+// 输入停顿片刻后开始查找，修改查找内容或选项时取消正在进行的查找并重新开始；
+// 替换作用于当前结果涉及的文件，先预览再应用
+class FindInFilesPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // 返回未保存的已打开文件（绝对路径 -> 编辑器中的内容）
+    using BufferProvider = std::function<QHash<QString, QString>()>;
+
+    explicit FindInFilesPanel(QWidget *parent = nullptr);
+
+    void setProject(const FileIndex *fileIndex, const QString &rootPath);
+    void setBufferProvider(const BufferProvider &provider) { bufferProvider = provider; }
+
+    // 聚焦到查找框；text 不为空时替换查找内容
+    void activate(const QString &text = QString());
+    // 查找所有引用：按给定选项立即查找 text，filePatterns 写法同文件类型框
+    void searchFor(const QString &text, bool caseSensitive, bool wholeWord, const QString &filePatterns);
+
+public slots:
+    void startSearch();
+
+signals:
+    void openFileRequested(const QString &filePath, int line, int column);
+    // 在当前结果涉及的文件中替换，filePaths 为绝对路径
+    void replaceRequested(const QStringList &filePaths, const ProjectSearcher::Options &options,
+                          const QString &replacement);
+
+private slots:
+    void scheduleSearch();
+    void onReplaceClicked();
+    void onMatchesFound(const QList<ProjectSearcher::Match> &matches);
+    void onSearchFinished(int fileCount, int matchCount, bool truncated, qint64 elapsedMs);
+    void onResultActivated(const QModelIndex &index);
+
+private:
+    const QStringList &projectFiles();
+    ProjectSearcher::Options currentOptions() const;
+
+    ProjectSearcher *searcher;
+    SearchResultModel *resultModel;
+    QLineEdit *queryEdit;
+    QLineEdit *filePatternEdit;
+    QLineEdit *replaceEdit;
+    QPushButton *replaceButton;
+    QCheckBox *caseCheck;
+    QCheckBox *wholeWordCheck;
+    QCheckBox *regexCheck;
+    QLabel *statusLabel;
+    QListView *resultView;
+    QTimer *searchTimer;
+
+    BufferProvider bufferProvider;
+    const FileIndex *fileIndex;
+    QString root;
+    QStringList files;          // 文件列表快照，索引变化后重新获取
+    int filesRevision;
+};
@@ -0,0 +1,224 @@
+#include "fuzzymatcher.h"
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// 位置加分
+const int MatchScore = 16;
+const int PathStartBonus = 10;      // 路径开头或 / 之后
+const int WordStartBonus = 8;       // _ - . 空格之后
+const int CamelCaseBonus = 7;       // 小写字母之后的大写字母
+const int FileNameBonus = 4;        // 落在文件名部分
+const int ConsecutiveBonus = 6;
+const int MaxGapPenalty = 8;
+
+inline char lowerAscii(char c)
+{
+    return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+}
+
+inline quint64 maskBit(char c)
+{
+    // 只作为预筛选，不同字符落到同一位只会让筛选变宽，不会漏掉结果
+    return quint64(1) << (uchar(c) & 63);
+}
+
+inline bool isWordSeparator(char c)
+{
+    return c == '_' || c == '-' || c == '.' || c == ' ';
+}
+}
+
+void FuzzyMatcher::setItems(const QStringList &paths)
+{
+    original.clear();
+    lowered.clear();
+    bonuses.clear();
+    offsets.clear();
+    masks.clear();
+    recency.clear();
+    recentItems.clear();
+    lastQuery.clear();
+    lastCandidates.clear();
+
+    offsets.reserve(paths.size() + 1);
+    masks.reserve(paths.size());
+    offsets.append(0);
+
+    for (const QString &path : paths) {
+        const QByteArray bytes = path.toUtf8();
+        const int fileNameStart = bytes.lastIndexOf('/') + 1;
+        quint64 mask = 0;
+
+        for (int k = 0; k < bytes.size(); ++k) {
+            const char c = bytes[k];
+            const char lower = lowerAscii(c);
+
+            int bonus = 0;
+            if (k == 0 || bytes[k - 1] == '/') {
+                bonus = PathStartBonus;
+            } else if (isWordSeparator(bytes[k - 1])) {
+                bonus = WordStartBonus;
+            } else if (c != lower && bytes[k - 1] >= 'a' && bytes[k - 1] <= 'z') {
+                bonus = CamelCaseBonus;
+            }
+            if (k >= fileNameStart) bonus += FileNameBonus;
+
+            original.append(c);
+            lowered.append(lower);
+            bonuses.append(char(bonus));
+            mask |= maskBit(lower);
+        }
+
+        offsets.append(quint32(original.size()));
+        masks.append(mask);
+    }
+
+    recency.fill(0, paths.size());
+}
+
+QString FuzzyMatcher::item(int index) const
+{
+    return QString::fromUtf8(original.constData() + offsets[index], offsets[index + 1] - offsets[index]);
+}
+
+void FuzzyMatcher::setRecent(const QStringList &recentPaths)
+{
+    recency.fill(0, size());
+    recentItems.clear();
+
+    QHash<QByteArray, int> ranks;
+    for (int rank = 0; rank < recentPaths.size() && rank < RecentLimit; ++rank) {
+        ranks.insert(recentPaths[rank].toUtf8(), rank);
+    }
+    if (ranks.isEmpty()) return;
+
+    QList<QPair<int, int>> found;
+    for (int i = 0; i < size(); ++i) {
+        const QByteArray path = QByteArray::fromRawData(original.constData() + offsets[i], offsets[i + 1] - offsets[i]);
+        auto rank = ranks.constFind(path);
+        if (rank == ranks.constEnd()) continue;
+
+        recency[i] = quint8(2 * (RecentLimit - rank.value()) + 10);
+        found.append(qMakePair(rank.value(), i));
+    }
+
+    std::sort(found.begin(), found.end());
+    for (const auto &entry : found) recentItems.append(entry.second);
+}
+
+QByteArray FuzzyMatcher::normalizeQuery(const QString &query)
+{
+    QByteArray result;
+    const QByteArray bytes = query.toUtf8();
+    for (char c : bytes) {
+        if (c == ' ' || c == '\t') continue;
+        result.append(lowerAscii(c));
+    }
+    return result;
+}
+
+int FuzzyMatcher::score(int item, const QByteArray &query) const
+{
+    const char *text = lowered.constData() + offsets[item];
+    const int length = offsets[item + 1] - offsets[item];
+    const char *q = query.constData();
+    const int queryLength = query.size();
+
+    // 正向用 memchr 找到子序列的最早结束位置
+    const char *cursor = text;
+    const char *end = text + length;
+    int last = -1;
+    for (int i = 0; i < queryLength; ++i) {
+        const void *found = memchr(cursor, q[i], end - cursor);
+        if (!found) return -1;
+        last = int(static_cast<const char *>(found) - text);
+        cursor = text + last + 1;
+    }
+
+    // 再从结束位置反向匹配，得到结束于该处的最短窗口
+    int first = last;
+    for (int k = last, i = queryLength - 1; k >= 0; --k) {
+        if (text[k] != q[i]) continue;
+        first = k;
+        if (--i < 0) break;
+    }
+
+    // 在窗口内计分：位置加分、连续加分、间隔扣分
+    const char *bonus = bonuses.constData() + offsets[item];
+    int total = 0;
+    int previous = -1;
+    for (int k = first, i = 0; k <= last && i < queryLength; ++k) {
+        if (text[k] != q[i]) continue;
+
+        total += MatchScore + bonus[k];
+        if (previous >= 0) {
+            total += previous == k - 1 ? ConsecutiveBonus : -qMin(k - previous - 1, MaxGapPenalty);
+        }
+        previous = k;
+        ++i;
+    }
+
+    // 同等条件下短路径优先
+    return total - length / 16 + recency[item];
+}
+
+QList<FuzzyMatcher::Match> FuzzyMatcher::match(const QString &query, int limit)
+{
+    const QByteArray normalized = normalizeQuery(query);
+
+    if (normalized.isEmpty()) {
+        lastQuery.clear();
+        lastCandidates.clear();
+        QList<Match> results;
+        for (int i = 0; i < recentItems.size() && i < limit; ++i) {
+            Match match;
+            match.item = recentItems[i];
+            match.score = recency[recentItems[i]];
+            results.append(match);
+        }
+        return results;
+    }
+
+    quint64 queryMask = 0;
+    for (char c : normalized) queryMask |= maskBit(c);
+
+    QList<Match> matches;
+    QList<int> candidates;
+    auto consider = [&](int item) {
+        const int value = score(item, normalized);
+        if (value < 0) return;
+        Match match;
+        match.item = item;
+        match.score = value;
+        matches.append(match);
+        candidates.append(item);
+    };
+
+    // 在上一次查询后追加字符时，结果一定是上一次结果的子集
+    const bool incremental = !lastQuery.isEmpty() && normalized.startsWith(lastQuery);
+    if (incremental) {
+        matches.reserve(lastCandidates.size());
+        candidates.reserve(lastCandidates.size());
+        for (int item : lastCandidates) consider(item);
+    } else {
+        const int count = size();
+        const quint64 *itemMasks = masks.constData();
+        for (int item = 0; item < count; ++item) {
+            if ((itemMasks[item] & queryMask) == queryMask) consider(item);
+        }
+    }
+
+    lastQuery = normalized;
+    lastCandidates = candidates;
+
+    // 只排出前 limit 个；分数相同时按路径顺序
+    const int count = qMin(limit, int(matches.size()));
+    std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), [](const Match &a, const Match &b) {
+        return a.score > b.score || (a.score == b.score && a.item < b.item);
+    });
+    matches.resize(count);
+    return matches;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+
+// 文件路径模糊匹配（Ctrl+P 转到文件）
+// 所有路径的小写 UTF-8 字节连续存放在一块内存中，另有每个字节的位置加分（路径/单词开头、
+// 驼峰、文件名部分）和每个路径的 64 位字符集掩码。匹配时先用掩码整批排除不可能匹配的路径
+// （连续的整数比较，编译器可以向量化），再对剩下的路径用 memchr 找出子序列并计分。
+// 输入在上一次查询后面追加字符时只在上一次的匹配结果中查找，逐键输入越打越快。
+class FuzzyMatcher
+{
+public:
+    struct Match
+    {
+        int item = -1;
+        int score = 0;
+    };
+
+    static const int RecentLimit = 30;
+
+    void setItems(const QStringList &paths);
+    int size() const { return offsets.isEmpty() ? 0 : offsets.size() - 1; }
+    QString item(int index) const;
+
+    // 最近打开的文件排在前面；匹配分数相同或接近时优先
+    void setRecent(const QStringList &recentPaths);
+
+    // 按分数从高到低返回至多 limit 个结果；查询为空时返回最近打开的文件
+    QList<Match> match(const QString &query, int limit);
+
+private:
+    static QByteArray normalizeQuery(const QString &query);
+    int score(int item, const QByteArray &query) const;
+
+    QByteArray original;        // 原始 UTF-8 路径，依次相连
+    QByteArray lowered;         // ASCII 字母转为小写后的副本
+    QByteArray bonuses;         // 每个字节匹配时的位置加分
+    QList<quint32> offsets;     // 第 i 个路径占 [offsets[i], offsets[i + 1])
+    QList<quint64> masks;
+    QList<quint8> recency;      // 最近打开的加分，0 表示不在最近列表中
+    QList<int> recentItems;     // 最近打开的文件，最近的在前
+
+    QByteArray lastQuery;
+    QList<int> lastCandidates;  // 匹配 lastQuery 的全部路径
+};
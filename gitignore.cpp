@@ -0,0 +1,114 @@
+#include "gitignore.h"
+
+void GitIgnore::addRules(const QString &baseDirectory, const QString &content)
+{
+    const QStringList lines = content.split('\n');
+    for (QString line : lines) {
+        if (line.endsWith('\r')) line.chop(1);
+        addPattern(baseDirectory, line);
+    }
+}
+
+void GitIgnore::addPattern(const QString &baseDirectory, const QString &pattern)
+{
+    QString text = pattern;
+
+    // 行尾未转义的空格会被忽略
+    while (text.endsWith(' ') && !text.endsWith("\\ ")) text.chop(1);
+    if (text.isEmpty() || text.startsWith('#')) return;
+
+    Rule rule;
+    rule.baseDirectory = baseDirectory;
+
+    if (text.startsWith('!')) {
+        rule.negated = true;
+        text.remove(0, 1);
+    } else if (text.startsWith("\\!") || text.startsWith("\\#")) {
+        text.remove(0, 1);
+    }
+
+    if (text.endsWith('/')) {
+        rule.directoryOnly = true;
+        text.chop(1);
+    }
+    if (text.isEmpty()) return;
+
+    // 模式中间或开头有 / 时相对所在目录匹配，否则匹配任意层级的文件名
+    const bool anchored = text.contains('/');
+    if (text.startsWith('/')) text.remove(0, 1);
+
+    QString expression = patternToRegularExpression(text);
+    if (!anchored) expression = "(?:.*/)?" + expression;
+
+    rule.expression = QRegularExpression(QRegularExpression::anchoredPattern(expression));
+    if (!rule.expression.isValid()) return;
+    rules.append(rule);
+}
+
+QString GitIgnore::patternToRegularExpression(const QString &pattern)
+{
+    QString result;
+    const int length = pattern.length();
+
+    for (int i = 0; i < length; ++i) {
+        const QChar c = pattern[i];
+
+        if (c == '*') {
+            const bool doubleStar = i + 1 < length && pattern[i + 1] == '*';
+            const bool atSegmentStart = i == 0 || pattern[i - 1] == '/';
+            if (doubleStar && atSegmentStart) {
+                if (i + 2 == length) {
+                    // 末尾的 ** 匹配其下的所有内容
+                    result += ".*";
+                    i += 1;
+                    continue;
+                }
+                if (pattern[i + 2] == '/') {
+                    // **/ 匹配零个或多个目录
+                    result += "(?:.*/)?";
+                    i += 2;
+                    continue;
+                }
+            }
+            result += "[^/]*";
+            if (doubleStar) ++i;
+        } else if (c == '?') {
+            result += "[^/]";
+        } else if (c == '[') {
+            const int close = pattern.indexOf(']', i + 2);
+            if (close < 0) {
+                result += "\\[";
+                continue;
+            }
+            QString set = pattern.mid(i + 1, close - i - 1);
+            if (set.startsWith('!')) set[0] = '^';
+            set.replace("\\", "\\\\");
+            result += "[" + set + "]";
+            i = close;
+        } else if (c == '\\' && i + 1 < length) {
+            result += QRegularExpression::escape(QString(pattern[++i]));
+        } else {
+            result += QRegularExpression::escape(QString(c));
+        }
+    }
+
+    return result;
+}
+
+bool GitIgnore::isIgnored(const QString &relativePath, bool isDirectory) const
+{
+    // 从后往前找到第一条匹配的规则
+    for (int i = rules.size() - 1; i >= 0; --i) {
+        const Rule &rule = rules[i];
+        if (rule.directoryOnly && !isDirectory) continue;
+
+        QString path = relativePath;
+        if (!rule.baseDirectory.isEmpty()) {
+            if (!relativePath.startsWith(rule.baseDirectory + '/')) continue;
+            path = relativePath.mid(rule.baseDirectory.length() + 1);
+        }
+
+        if (rule.expression.match(path).hasMatch()) return !rule.negated;
+    }
+    return false;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QRegularExpression>
+
+// .gitignore 规则匹配
+// 支持取反（!）、只匹配目录（末尾 /）、锚定到所在目录（模式中含 /）以及 **、*、?、[] 通配。
+// 每条规则记录所在的目录，按 git 的语义只作用于该目录之下；后添加的规则优先，
+// 子目录的规则集是父目录规则集加上本目录 .gitignore 的内容。
+class GitIgnore
+{
+public:
+    // baseDirectory 是 .gitignore 所在目录相对项目根目录的路径，根目录为空字符串
+    void addRules(const QString &baseDirectory, const QString &content);
+    void addPattern(const QString &baseDirectory, const QString &pattern);
+
+    // relativePath 是相对项目根目录、以 / 分隔的路径
+    bool isIgnored(const QString &relativePath, bool isDirectory) const;
+    bool isEmpty() const { return rules.isEmpty(); }
+
+    static QString patternToRegularExpression(const QString &pattern);
+
+private:
+    struct Rule
+    {
+        QString baseDirectory;
+        QRegularExpression expression;
+        bool negated = false;
+        bool directoryOnly = false;
+    };
+
+    QList<Rule> rules;
+};
@@ -7,6 +7,8 @@
 #include <QVBoxLayout>
 #include <QMouseEvent>
 #include <QDebug>
+#include <QHelpEvent>
+#include <QToolTip>
 
 LineNumberArea::LineNumberArea(CodeEditor *editor)
     : QWidget(editor)
@@ -74,6 +76,14 @@ void LineNumberArea::paintEvent(QPaintEvent *event)
 
             // 绘制行号
             painter.drawText(blockRect, Qt::AlignRight | Qt::AlignVCenter, number);
+
+            // 绘制优化提示图标
+            if (codeEditor->hasOptimizationRemarks()) {
+                QList<OptimizationRemark> remarks = codeEditor->optimizationRemarks(block);
+                if (!remarks.isEmpty()) {
+                    drawRemarkIcon(painter, blockRect, remarks);
+                }
+            }
         }
 
         block = block.next();
@@ -86,6 +96,52 @@ void LineNumberArea::paintEvent(QPaintEvent *event)
     }
 }
 
+void LineNumberArea::drawRemarkIcon(QPainter &painter, const QRectF &blockRect,
+                                    const QList<OptimizationRemark> &remarks)
+{
+    // 有未完成的优化时显示黄色，全部成功显示绿色，只有分析信息显示蓝色
+    bool missed = false;
+    bool optimized = false;
+    for (const OptimizationRemark &remark : remarks) {
+        if (remark.kind == RemarkKind::Missed) missed = true;
+        else if (remark.kind == RemarkKind::Optimized) optimized = true;
+    }
+    QColor color = missed ? QColor("#d7ba7d") : optimized ? QColor("#4ec9b0") : QColor("#569cd6");
+
+    qreal size = qMin<qreal>(codeEditor->remarkIconWidth(), blockRect.height()) * 0.6;
+    QRectF iconRect(4, blockRect.top() + (blockRect.height() - size) / 2, size, size);
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    painter.drawEllipse(iconRect);
+    painter.restore();
+}
+
+bool LineNumberArea::event(QEvent *event)
+{
+    // 悬停在优化提示图标所在行时显示提示内容
+    if (event->type() == QEvent::ToolTip && codeEditor && codeEditor->hasOptimizationRemarks()) {
+        QHelpEvent *helpEvent = static_cast<QHelpEvent*>(event);
+        QTextBlock block = codeEditor->getCursorForPosition(QPoint(0, helpEvent->pos().y())).block();
+        qreal top = codeEditor->getBlockBoundingGeometry(block).translated(codeEditor->getContentOffset()).top();
+        qreal bottom = top + codeEditor->getBlockBoundingRect(block).height();
+
+        QList<OptimizationRemark> remarks;
+        if (helpEvent->pos().y() >= top && helpEvent->pos().y() < bottom) {
+            remarks = codeEditor->optimizationRemarks(block);
+        }
+        if (!remarks.isEmpty()) {
+            QToolTip::showText(helpEvent->globalPos(), OptimizationRemarks::toolTip(remarks), this);
+        } else {
+            QToolTip::hideText();
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
+
 void LineNumberArea::contextMenuEvent(QContextMenuEvent *event)
 {
     if (!codeEditor) {
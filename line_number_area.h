@@ -24,10 +24,13 @@ public:
     void setCurrentLine(int line);
 
 protected:
+    bool event(QEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
 
 private:
+    void drawRemarkIcon(QPainter &painter, const QRectF &blockRect, const QList<OptimizationRemark> &remarks);
+
     CodeEditor *codeEditor;
     int currentLine;
     
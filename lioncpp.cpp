@@ -1,4 +1,5 @@
 #include "lioncpp.h"
+#include "measurementdialog.h"
 #include "./ui_lioncpp.h"
 #include <QFile>
 #include <QTextStream>
@@ -7,19 +8,25 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QTimer>
-#include <QFileSystemModel>
 #include <QProgressDialog>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QCoreApplication>
 #include <QDateTime>
+#include <QSet>
+#include <QTextCursor>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QTextEdit>
 #include <QPushButton>
 #include <QDialog>
+#include <QTemporaryDir>
 #include "findreplacedialog.h"
+#include "replacepreviewdialog.h"
+#include "symbolizer.h"
+#include "compilationdatabase.h"
+#include <memory>
 
 LionCPP::LionCPP(QWidget *parent)
     : QMainWindow(parent)
@@ -27,8 +34,19 @@ LionCPP::LionCPP(QWidget *parent)
     , settingsDialog(nullptr)
     , compileProcess(nullptr)
     , runProcess(nullptr)
+    , sanitizerProcess(nullptr)
+    , remarksProcess(nullptr)
+    , buildCache(new BuildCache(this))
+    , projectReplacer(new ProjectReplacer(this))
+    , symbolNavigator(new SymbolNavigator(this))
+    , clangdClient(new ClangdClient(this))
+    , bufferWatcher(new FileWatcher(this))
+    , quickOpenDialog(nullptr)
     , isCompiling(false)
     , isRunning(false)
+    , reloadPromptOpen(false)
+    , sanitizerRun(0)
+    , remarksRun(0)
     , settings("LionCPP", "IDE")
 {
     ui->setupUi(this);
@@ -47,27 +65,26 @@ LionCPP::LionCPP(QWidget *parent)
     outputWidget = findChild<QTextEdit*>("outputWidget");
     QDockWidget* sideDock = findChild<QDockWidget*>("sideDock");
 
-    // 初始化文件系统模型
+    // 项目树：后台索引项目目录，模型按需展开
+    projectManager = new ProjectManager(this);
     if (projectTreeView) {
-        auto *model = new QFileSystemModel(projectTreeView);
-        model->setRootPath(QDir::currentPath());
-        QStringList filters;
-        filters << "*.cpp" << "*.h" << "*.hpp" << "*.c" << "*.cc" << "*.cxx";
-        model->setNameFilters(filters);
-        model->setNameFilterDisables(false);
-        projectTreeView->setModel(static_cast<QAbstractItemModel*>(model));
-        projectTreeView->setRootIndex(model->index(QDir::currentPath()));
-        projectTreeView->setHeaderHidden(true);
-        projectTreeView->setEditTriggers(QAbstractItemView::NoEditTriggers); // 类型已匹配
-
-        // 双击打开文件
-        connect(projectTreeView, &QTreeView::doubleClicked, this, [this, model](const QModelIndex &index) {
-            QString filePath = model->filePath(index);
-            QFileInfo info(filePath);
-            if (info.isFile()) {
-                openFileInEditor(filePath);
-            }
-        });
+        projectManager->setProjectTree(projectTreeView);
+    }
+    connect(projectManager, &ProjectManager::fileOpenRequested, this, &LionCPP::openFileInEditor);
+    connect(projectManager, &ProjectManager::indexingFinished, this, [this](int fileCount, qint64 elapsedMs) {
+        statusBar()->showMessage(QString("项目索引完成: %1 个文件，用时 %2 ms").arg(fileCount).arg(elapsedMs), 5000);
+    });
+    connect(projectManager->getSymbolIndex(), &SymbolIndex::updated, this,
+            [this](int fileCount, int symbolCount, int scannedFiles, qint64 elapsedMs) {
+        if (scannedFiles == 0) return;
+        statusBar()->showMessage(QString("符号索引完成: %1 个文件 %2 个符号，重新扫描 %3 个文件，用时 %4 ms")
+                                 .arg(fileCount).arg(symbolCount).arg(scannedFiles).arg(elapsedMs), 5000);
+    });
+    
+    // 打开上次的项目目录；用户主目录不作为项目扫描
+    QString projectDirectory = settings.value("project/lastDirectory", QDir::currentPath()).toString();
+    if (QFileInfo(projectDirectory).isDir() && QDir(projectDirectory) != QDir::home()) {
+        projectManager->openProject(projectDirectory);
     }
 
     // 设置objectName消除saveState警告
@@ -88,6 +105,7 @@ LionCPP::LionCPP(QWidget *parent)
     statusBar()->addPermanentWidget(lineColumnLabel);
     setupConnections();
     loadSettings();
+    restartLanguageServer();
     
     setWindowTitle("小狮子C++ IDE");
     resize(1200, 800);
@@ -134,10 +152,20 @@ void LionCPP::setupMenuBar()
     newFileAction->setShortcut(QKeySequence::New);
     fileMenu->addAction(newFileAction);
     
+    newBenchmarkProjectAction = new QAction("新建基准测试项目(&B)...", this);
+    fileMenu->addAction(newBenchmarkProjectAction);
+    
     openFileAction = new QAction("打开文件(&O)", this);
     openFileAction->setShortcut(QKeySequence::Open);
     fileMenu->addAction(openFileAction);
     
+    openProjectAction = new QAction("打开项目目录(&D)...", this);
+    fileMenu->addAction(openProjectAction);
+    
+    quickOpenAction = new QAction("转到文件(&G)...", this);
+    quickOpenAction->setShortcut(QKeySequence("Ctrl+P"));
+    fileMenu->addAction(quickOpenAction);
+    
     fileMenu->addSeparator();
     
     saveFileAction = new QAction("保存文件(&S)", this);
@@ -193,6 +221,20 @@ void LionCPP::setupMenuBar()
     replaceAction->setShortcut(QKeySequence::Replace);
     editMenu->addAction(replaceAction);
     
+    findInFilesAction = new QAction("在文件中查找(&I)...", this);
+    findInFilesAction->setShortcut(QKeySequence("Ctrl+Shift+F"));
+    editMenu->addAction(findInFilesAction);
+    
+    editMenu->addSeparator();
+    
+    goToDefinitionAction = new QAction("转到定义(&D)", this);
+    goToDefinitionAction->setShortcut(QKeySequence("F12"));
+    editMenu->addAction(goToDefinitionAction);
+    
+    findReferencesAction = new QAction("查找所有引用(&U)", this);
+    findReferencesAction->setShortcut(QKeySequence("Shift+F12"));
+    editMenu->addAction(findReferencesAction);
+    
     // 运行菜单
     runMenu = menuBar->addMenu("运行(&R)");
     
@@ -212,9 +254,73 @@ void LionCPP::setupMenuBar()
     stopAction->setShortcut(QKeySequence("Ctrl+Break"));
     runMenu->addAction(stopAction);
     
+    builtinTerminalAction = new QAction("使用内置终端运行(&I)", this);
+    builtinTerminalAction->setCheckable(true);
+    builtinTerminalAction->setChecked(settings.value("run/useBuiltinTerminal", false).toBool());
+    runMenu->addAction(builtinTerminalAction);
+    
+    runMenu->addSeparator();
+    
+    runTestsAction = new QAction("运行测试用例(&T)", this);
+    runTestsAction->setShortcut(QKeySequence("F6"));
+    runMenu->addAction(runTestsAction);
+    
+    stressTestAction = new QAction("对拍(&P)", this);
+    runMenu->addAction(stressTestAction);
+    
+    // 打开后每次保存都会重新分析，提示显示在编辑器行号旁
+    optimizationRemarksAction = new QAction("显示优化报告(&O)", this);
+    optimizationRemarksAction->setCheckable(true);
+    optimizationRemarksAction->setChecked(settings.value("build/optimizationRemarks", false).toBool());
+    runMenu->addAction(optimizationRemarksAction);
+    
+    runBenchmarkAction = new QAction("运行基准测试(&M)", this);
+    runBenchmarkAction->setShortcut(QKeySequence("Ctrl+F5"));
+    runMenu->addAction(runBenchmarkAction);
+    
+    perfCompareAction = new QAction("A/B 性能对比(&A)", this);
+    runMenu->addAction(perfCompareAction);
+    
+    complexityAction = new QAction("复杂度分析(&X)", this);
+    runMenu->addAction(complexityAction);
+    
+    scalingAction = new QAction("线程扩展性测试(&S)", this);
+    runMenu->addAction(scalingAction);
+    
+    // 计时类功能（基准测试、A/B 对比、复杂度和扩展性分析）共用的核心绑定和优先级
+    measurementAction = new QAction("测量环境(&E)...", this);
+    runMenu->addAction(measurementAction);
+    
+    memoryProfileAction = new QAction("内存分析运行(&H)", this);
+    runMenu->addAction(memoryProfileAction);
+    
+    lockProfileAction = new QAction("锁竞争分析运行(&L)", this);
+    runMenu->addAction(lockProfileAction);
+    
+    falseSharingAction = new QAction("伪共享检测运行(&F)", this);
+    runMenu->addAction(falseSharingAction);
+    
+    // 检测器运行模式：插桩构建单独缓存，切换模式不会重复编译未修改的代码
+    sanitizerMenu = runMenu->addMenu("检测器运行(&D)");
+    const SanitizerKind sanitizerKinds[] = {
+        SanitizerKind::Address, SanitizerKind::Undefined, SanitizerKind::Thread, SanitizerKind::Leak
+    };
+    for (SanitizerKind kind : sanitizerKinds) {
+        QAction *action = sanitizerMenu->addAction(SanitizerReport::displayName(kind));
+        action->setData(static_cast<int>(kind));
+        sanitizerActions.append(action);
+    }
+    
     // 工具菜单
     toolsMenu = menuBar->addMenu("工具(&T)");
     
+    // 补全、诊断和悬停提示改由 clangd 提供，需要系统中安装了 clangd
+    clangdAction = new QAction("使用 clangd 语言服务(&L)", this);
+    clangdAction->setCheckable(true);
+    clangdAction->setChecked(settings.value("editor/useClangd", false).toBool());
+    toolsMenu->addAction(clangdAction);
+    toolsMenu->addSeparator();
+    
     settingsAction = new QAction("设置(&S)", this);
     toolsMenu->addAction(settingsAction);
     
@@ -267,13 +373,188 @@ void LionCPP::setupDockWidgets()
     outputDock->setWidget(outputWidget);
     
     addDockWidget(Qt::BottomDockWidgetArea, outputDock);
+    
+    // 检测器报告窗口
+    sanitizerDock = new QDockWidget(tr("检测器报告"), this);
+    sanitizerDock->setObjectName("sanitizerDock");
+    sanitizerDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    sanitizerTree = new QTreeWidget(sanitizerDock);
+    sanitizerTree->setHeaderHidden(true);
+    sanitizerTree->setColumnCount(1);
+    sanitizerDock->setWidget(sanitizerTree);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, sanitizerDock);
+    tabifyDockWidget(outputDock, sanitizerDock);
+    
+    // 内置终端（伪终端，支持交互输入）
+    terminalDock = new QDockWidget(tr("终端"), this);
+    terminalDock->setObjectName("terminalDock");
+    terminalDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    terminalWidget = new TerminalWidget(terminalDock);
+    terminalDock->setWidget(terminalWidget);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, terminalDock);
+    tabifyDockWidget(outputDock, terminalDock);
+    
+    // 测试用例窗口
+    testCaseDock = new QDockWidget(tr("测试用例"), this);
+    testCaseDock->setObjectName("testCaseDock");
+    testCaseDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    testCasePanel = new TestCasePanel(testCaseDock);
+    testCaseDock->setWidget(testCasePanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, testCaseDock);
+    tabifyDockWidget(outputDock, testCaseDock);
+    
+    // 对拍窗口
+    stressDock = new QDockWidget(tr("对拍"), this);
+    stressDock->setObjectName("stressDock");
+    stressDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    stressPanel = new StressPanel(stressDock);
+    stressDock->setWidget(stressPanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, stressDock);
+    tabifyDockWidget(outputDock, stressDock);
+    
+    // 基准测试窗口
+    benchmarkDock = new QDockWidget(tr("基准测试"), this);
+    benchmarkDock->setObjectName("benchmarkDock");
+    benchmarkDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    benchmarkPanel = new BenchmarkPanel(benchmarkDock);
+    benchmarkDock->setWidget(benchmarkPanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, benchmarkDock);
+    tabifyDockWidget(outputDock, benchmarkDock);
+    
+    // A/B 性能对比窗口
+    perfCompareDock = new QDockWidget(tr("A/B 对比"), this);
+    perfCompareDock->setObjectName("perfCompareDock");
+    perfCompareDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    perfComparePanel = new PerfComparePanel(perfCompareDock);
+    perfCompareDock->setWidget(perfComparePanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, perfCompareDock);
+    tabifyDockWidget(outputDock, perfCompareDock);
+    
+    // 复杂度分析窗口
+    complexityDock = new QDockWidget(tr("复杂度分析"), this);
+    complexityDock->setObjectName("complexityDock");
+    complexityDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    complexityPanel = new ComplexityPanel(complexityDock);
+    complexityDock->setWidget(complexityPanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, complexityDock);
+    tabifyDockWidget(outputDock, complexityDock);
+    
+    // 线程扩展性窗口
+    scalingDock = new QDockWidget(tr("线程扩展性"), this);
+    scalingDock->setObjectName("scalingDock");
+    scalingDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    scalingPanel = new ScalingPanel(scalingDock);
+    scalingDock->setWidget(scalingPanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, scalingDock);
+    tabifyDockWidget(outputDock, scalingDock);
+    
+    // 内存分析窗口
+    memoryProfileDock = new QDockWidget(tr("内存分析"), this);
+    memoryProfileDock->setObjectName("memoryProfileDock");
+    memoryProfileDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    memoryProfilePanel = new MemoryProfilePanel(memoryProfileDock);
+    memoryProfileDock->setWidget(memoryProfilePanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, memoryProfileDock);
+    tabifyDockWidget(outputDock, memoryProfileDock);
+    
+    // 锁竞争分析窗口
+    lockProfileDock = new QDockWidget(tr("锁竞争"), this);
+    lockProfileDock->setObjectName("lockProfileDock");
+    lockProfileDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    lockProfilePanel = new LockProfilePanel(lockProfileDock);
+    lockProfileDock->setWidget(lockProfilePanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, lockProfileDock);
+    tabifyDockWidget(outputDock, lockProfileDock);
+    
+    // 伪共享检测窗口
+    falseSharingDock = new QDockWidget(tr("伪共享"), this);
+    falseSharingDock->setObjectName("falseSharingDock");
+    falseSharingDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    falseSharingPanel = new FalseSharingPanel(falseSharingDock);
+    falseSharingDock->setWidget(falseSharingPanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, falseSharingDock);
+    tabifyDockWidget(outputDock, falseSharingDock);
+    
+    // 在文件中查找窗口
+    findInFilesDock = new QDockWidget(tr("查找结果"), this);
+    findInFilesDock->setObjectName("findInFilesDock");
+    findInFilesDock->setAllowedAreas(Qt::BottomDockWidgetArea);
+    
+    findInFilesPanel = new FindInFilesPanel(findInFilesDock);
+    findInFilesPanel->setBufferProvider([this]() { return editorBuffers(true); });
+    findInFilesDock->setWidget(findInFilesPanel);
+    
+    addDockWidget(Qt::BottomDockWidgetArea, findInFilesDock);
+    tabifyDockWidget(outputDock, findInFilesDock);
+    outputDock->raise();
+
+    // 汇编视图窗口，放在右侧与编辑器并排
+    asmDock = new QDockWidget(tr("汇编"), this);
+    asmDock->setObjectName("asmDock");
+    asmDock->setAllowedAreas(Qt::RightDockWidgetArea | Qt::LeftDockWidgetArea);
+
+    assemblyView = new AssemblyView(asmDock);
+    asmDock->setWidget(assemblyView);
+
+    addDockWidget(Qt::RightDockWidgetArea, asmDock);
+    asmDock->hide();
+    connect(asmDock, &QDockWidget::visibilityChanged, assemblyView, &AssemblyView::setActive);
+
+    QAction *asmViewAction = asmDock->toggleViewAction();
+    asmViewAction->setText("汇编视图(&A)");
+    asmViewAction->setShortcut(QKeySequence("Ctrl+Shift+A"));
+    toolsMenu->insertAction(settingsAction, asmViewAction);
+
+    // 结构体布局窗口，与汇编视图放在同一侧
+    layoutDock = new QDockWidget(tr("结构体布局"), this);
+    layoutDock->setObjectName("layoutDock");
+    layoutDock->setAllowedAreas(Qt::RightDockWidgetArea | Qt::LeftDockWidgetArea);
+
+    structLayoutView = new StructLayoutView(layoutDock);
+    layoutDock->setWidget(structLayoutView);
+
+    addDockWidget(Qt::RightDockWidgetArea, layoutDock);
+    tabifyDockWidget(asmDock, layoutDock);
+    layoutDock->hide();
+    connect(layoutDock, &QDockWidget::visibilityChanged, structLayoutView, &StructLayoutView::setActive);
+
+    QAction *layoutViewAction = layoutDock->toggleViewAction();
+    layoutViewAction->setText("结构体布局(&L)");
+    layoutViewAction->setShortcut(QKeySequence("Ctrl+Shift+L"));
+    toolsMenu->insertAction(settingsAction, layoutViewAction);
+    toolsMenu->insertSeparator(settingsAction);
 }
 
 void LionCPP::setupConnections()
 {
     // 文件菜单连接
     connect(newFileAction, &QAction::triggered, this, &LionCPP::onNewFile);
+    connect(newBenchmarkProjectAction, &QAction::triggered, this, &LionCPP::onNewBenchmarkProject);
     connect(openFileAction, &QAction::triggered, this, &LionCPP::onOpenFile);
+    connect(openProjectAction, &QAction::triggered, this, &LionCPP::onOpenProject);
+    connect(quickOpenAction, &QAction::triggered, this, &LionCPP::onQuickOpen);
     connect(saveFileAction, &QAction::triggered, this, &LionCPP::onSaveFile);
     connect(saveAsFileAction, &QAction::triggered, this, &LionCPP::onSaveAsFile);
     connect(closeFileAction, &QAction::triggered, this, &LionCPP::onCloseFile);
@@ -287,12 +568,121 @@ void LionCPP::setupConnections()
     connect(pasteAction, &QAction::triggered, this, &LionCPP::onPaste);
     connect(findAction, &QAction::triggered, this, &LionCPP::onFind);
     connect(replaceAction, &QAction::triggered, this, &LionCPP::onReplace);
+    connect(findInFilesAction, &QAction::triggered, this, &LionCPP::onFindInFiles);
+    connect(findInFilesPanel, &FindInFilesPanel::openFileRequested, this, &LionCPP::openFileAtLine);
+    connect(findInFilesPanel, &FindInFilesPanel::replaceRequested, this, &LionCPP::replaceInFiles);
+    connect(projectReplacer, &ProjectReplacer::prepared, this, &LionCPP::onReplacePrepared);
+    connect(projectReplacer, &ProjectReplacer::applied, this, &LionCPP::onReplaceApplied);
+    connect(goToDefinitionAction, &QAction::triggered, this, &LionCPP::onGoToDefinition);
+    connect(findReferencesAction, &QAction::triggered, this, &LionCPP::onFindReferences);
+    connect(symbolNavigator, &SymbolNavigator::targetsFound, this, &LionCPP::onDefinitionTargets);
+    symbolNavigator->setBufferProvider([this]() { return editorBuffers(true); });
     
     // 运行菜单连接
     connect(compileAction, &QAction::triggered, this, &LionCPP::onCompile);
     connect(runAction, &QAction::triggered, this, &LionCPP::onRun);
     connect(compileAndRunAction, &QAction::triggered, this, &LionCPP::onCompileAndRun);
     connect(stopAction, &QAction::triggered, this, &LionCPP::onStop);
+    for (QAction *action : std::as_const(sanitizerActions)) {
+        connect(action, &QAction::triggered, this, [this, action]() {
+            runWithSanitizer(static_cast<SanitizerKind>(action->data().toInt()));
+        });
+    }
+    connect(sanitizerTree, &QTreeWidget::itemActivated, this, &LionCPP::onSanitizerItemActivated);
+    connect(builtinTerminalAction, &QAction::toggled, this, [this](bool checked) {
+        settings.setValue("run/useBuiltinTerminal", checked);
+    });
+    connect(clangdAction, &QAction::toggled, this, [this](bool checked) {
+        settings.setValue("editor/useClangd", checked);
+        restartLanguageServer();
+        for (int i = 0; i < editorTabWidget->count(); ++i) {
+            if (CodeEditor *editor = qobject_cast<CodeEditor*>(editorTabWidget->widget(i))) {
+                attachLanguageClient(editor);
+            }
+        }
+    });
+    connect(clangdClient, &ClangdClient::serverStopped, this, [this](const QString &message) {
+        statusBar()->showMessage(message, 5000);
+    });
+    connect(terminalWidget, &TerminalWidget::finished, this, [this](int exitCode, QProcess::ExitStatus exitStatus) {
+        terminalWidget->appendMessage(exitStatus == QProcess::CrashExit
+            ? QString("--- 程序被信号 %1 终止 ---").arg(exitCode)
+            : QString("--- 程序已退出，返回值 %1 ---").arg(exitCode));
+        onRunFinished(exitCode, exitStatus);
+    });
+    connect(runTestsAction, &QAction::triggered, this, &LionCPP::runTestCases);
+    connect(runBenchmarkAction, &QAction::triggered, this, &LionCPP::runBenchmarks);
+    connect(perfCompareAction, &QAction::triggered, this, [this]() {
+        perfCompareDock->show();
+        perfCompareDock->raise();
+    });
+    connect(perfComparePanel, &PerfComparePanel::startRequested, this, &LionCPP::runPerfComparison);
+    connect(complexityAction, &QAction::triggered, this, [this]() {
+        complexityDock->show();
+        complexityDock->raise();
+    });
+    connect(complexityPanel, &ComplexityPanel::startRequested, this, &LionCPP::runComplexityAnalysis);
+    connect(scalingAction, &QAction::triggered, this, [this]() {
+        scalingDock->show();
+        scalingDock->raise();
+    });
+    connect(scalingPanel, &ScalingPanel::startRequested, this, &LionCPP::runThreadScaling);
+    connect(measurementAction, &QAction::triggered, this, &LionCPP::showMeasurementDialog);
+    connect(memoryProfileAction, &QAction::triggered, this, &LionCPP::runMemoryProfile);
+    connect(memoryProfilePanel, &MemoryProfilePanel::output, this, [this](const QString &text) {
+        outputWidget->append("程序输出: " + text.trimmed());
+    });
+    connect(memoryProfilePanel, &MemoryProfilePanel::finished, this, &LionCPP::onRunFinished);
+    connect(memoryProfilePanel, &MemoryProfilePanel::openFileRequested, this, [this](const QString &filePath, int line) {
+        openFileAtLine(filePath, line);
+    });
+    connect(lockProfileAction, &QAction::triggered, this, &LionCPP::runLockProfile);
+    connect(lockProfilePanel, &LockProfilePanel::output, this, [this](const QString &text) {
+        outputWidget->append("程序输出: " + text.trimmed());
+    });
+    connect(lockProfilePanel, &LockProfilePanel::finished, this, &LionCPP::onRunFinished);
+    connect(lockProfilePanel, &LockProfilePanel::openFileRequested, this, [this](const QString &filePath, int line) {
+        openFileAtLine(filePath, line);
+    });
+    connect(falseSharingAction, &QAction::triggered, this, &LionCPP::runFalseSharing);
+    connect(falseSharingPanel, &FalseSharingPanel::output, this, [this](const QString &text) {
+        outputWidget->append("程序输出: " + text.trimmed());
+    });
+    connect(falseSharingPanel, &FalseSharingPanel::finished, this, &LionCPP::onRunFinished);
+    connect(falseSharingPanel, &FalseSharingPanel::openFileRequested, this, [this](const QString &filePath, int line) {
+        openFileAtLine(filePath, line);
+    });
+    connect(benchmarkPanel, &BenchmarkPanel::output, this, [this](const QString &text) {
+        outputWidget->append(text.trimmed());
+    });
+    connect(benchmarkPanel, &BenchmarkPanel::configured, this, &LionCPP::refreshLanguageServer);
+    connect(optimizationRemarksAction, &QAction::toggled, this, [this](bool checked) {
+        settings.setValue("build/optimizationRemarks", checked);
+        if (checked) {
+            if (saveCurrentFile()) analyzeOptimizations();
+            return;
+        }
+        for (int i = 0; i < editorTabWidget->count(); ++i) {
+            if (CodeEditor *editor = qobject_cast<CodeEditor*>(editorTabWidget->widget(i))) {
+                editor->clearOptimizationRemarks();
+            }
+        }
+    });
+    connect(testCasePanel, &TestCasePanel::runRequested, this, &LionCPP::runTestCases);
+    connect(testCasePanel, &TestCasePanel::openFileRequested, this, &LionCPP::openFileInEditor);
+    connect(testCasePanel, &TestCasePanel::testsFinished, this, [this](int accepted, int total) {
+        outputWidget->append(QString("测试完成: 通过 %1 / %2").arg(accepted).arg(total));
+    });
+    connect(stressTestAction, &QAction::triggered, this, [this]() {
+        stressDock->show();
+        stressDock->raise();
+    });
+    connect(stressPanel, &StressPanel::startRequested, this, &LionCPP::runStressTest);
+    connect(stressPanel, &StressPanel::failureFound, this, [this](const QString &inputFile) {
+        outputWidget->append("对拍发现错误，失败数据: " + inputFile);
+        openFileInEditor(inputFile);
+        stressDock->raise();
+    });
     
     // 工具菜单连接
     connect(settingsAction, &QAction::triggered, this, &LionCPP::onSettings);
@@ -300,8 +690,35 @@ void LionCPP::setupConnections()
     
     // 编辑器标签页连接
     connect(editorTabWidget, &QTabWidget::tabCloseRequested, [this](int index) {
+        unwatchEditorFile(qobject_cast<CodeEditor*>(editorTabWidget->widget(index)));
         editorTabWidget->removeTab(index);
     });
+    connect(bufferWatcher, &FileWatcher::changed, this, &LionCPP::onBufferFilesChanged);
+    connect(bufferWatcher, &FileWatcher::overflowed, this, [this]() {
+        for (int i = 0; i < editorTabWidget->count(); ++i) {
+            checkExternalModification(qobject_cast<CodeEditor*>(editorTabWidget->widget(i)));
+        }
+    });
+    connect(editorTabWidget, &QTabWidget::currentChanged, this, [this]() {
+        CodeEditor *editor = getCurrentEditor();
+        testCasePanel->setSourceFile(editor ? editor->property("filePath").toString() : QString());
+        assemblyView->setEditor(editor);
+        structLayoutView->setEditor(editor);
+        if (editor) {
+            QString benchmarkProject = BenchmarkRunner::findProjectDirectory(editor->property("filePath").toString());
+            if (!benchmarkProject.isEmpty()) benchmarkPanel->setProjectDirectory(benchmarkProject);
+        }
+        if (editor && optimizationRemarksAction->isChecked() && !editor->hasOptimizationRemarks()
+            && !editor->document()->isModified()) {
+            analyzeOptimizations();
+        }
+        if (editor && stressPanel->solutionSource().isEmpty()) {
+            stressPanel->setSolutionSource(editor->property("filePath").toString());
+        }
+        if (editor && complexityPanel->solutionSource().isEmpty()) {
+            complexityPanel->setSolutionSource(editor->property("filePath").toString());
+        }
+    });
 }
 
 void LionCPP::loadSettings()
@@ -310,6 +727,9 @@ void LionCPP::loadSettings()
     restoreGeometry(settings.value("window/geometry").toByteArray());
     restoreState(settings.value("window/state").toByteArray());
     
+    // 转到文件的最近打开列表
+    recentFiles = settings.value("quickOpen/recentFiles").toStringList();
+    
     // 应用编辑器设置
     applyEditorSettings();
 }
@@ -319,6 +739,7 @@ void LionCPP::saveSettings()
     // 保存窗口几何信息
     settings.setValue("window/geometry", saveGeometry());
     settings.setValue("window/state", saveState());
+    settings.setValue("quickOpen/recentFiles", recentFiles);
     
     settings.sync();
 }
@@ -350,12 +771,16 @@ void LionCPP::updateActions()
     pasteAction->setEnabled(hasEditor);
     findAction->setEnabled(hasEditor);
     replaceAction->setEnabled(hasEditor);
+    goToDefinitionAction->setEnabled(hasEditor);
+    findReferencesAction->setEnabled(hasEditor);
     
     // 运行操作
     compileAction->setEnabled(hasEditor && !isCompiling);
     runAction->setEnabled(hasEditor && !isRunning);
     compileAndRunAction->setEnabled(hasEditor && !isCompiling && !isRunning);
     stopAction->setEnabled(isCompiling || isRunning);
+    sanitizerMenu->setEnabled(hasEditor && !isCompiling && !isRunning);
+    runTestsAction->setEnabled(hasEditor && !isCompiling);
 }
 
 CodeEditor* LionCPP::getCurrentEditor()
@@ -368,6 +793,8 @@ void LionCPP::openFileInEditor(const QString &filePath)
 {
     qDebug() << "[openFileInEditor] called with filePath:" << filePath;
     qDebug() << "[openFileInEditor] called with filePath:" << filePath;
+    addRecentFile(filePath);
+    
     // 检查文件是否已经打开
     for (int i = 0; i < editorTabWidget->count(); ++i) {
         CodeEditor *editor = qobject_cast<CodeEditor*>(editorTabWidget->widget(i));
@@ -381,6 +808,8 @@ void LionCPP::openFileInEditor(const QString &filePath)
     CodeEditor *editor = new CodeEditor();
     qDebug() << "[openFileInEditor] CodeEditor created";
     editor->setProperty("filePath", filePath);
+    editor->setSymbolIndex(projectManager->getSymbolIndex());
+    connect(editor, &CodeEditor::definitionRequested, this, &LionCPP::onGoToDefinition);
     
     // 应用当前编辑器设置
     applyEditorSettingsToEditor(editor);
@@ -396,6 +825,7 @@ void LionCPP::openFileInEditor(const QString &filePath)
         qDebug() << "[openFileInEditor] setPlainText done";
         file.close();
     }
+    attachLanguageClient(editor);
     
     QFileInfo fileInfo(filePath);
     qDebug() << "[openFileInEditor] before addTab";
@@ -409,6 +839,7 @@ void LionCPP::openFileInEditor(const QString &filePath)
         updateTabTitle(editor);
     });
     
+    watchEditorFile(editor);
     currentFilePath = filePath;
     updateWindowTitle();
     updateActions();
@@ -434,6 +865,8 @@ bool LionCPP::saveCurrentFile()
         
         // 标记文档为未修改状态
         editor->document()->setModified(false);
+        watchEditorFile(editor);
+        attachLanguageClient(editor);
         
         // 更新标签页标题
         updateTabTitle(editor);
@@ -450,6 +883,8 @@ void LionCPP::closeCurrentFile()
     if (saveFileIfModified()) {
         int index = editorTabWidget->currentIndex();
         if (index >= 0) {
+            unwatchEditorFile(getCurrentEditor());
+            getCurrentEditor()->setLanguageClient(nullptr, QString());
             editorTabWidget->removeTab(index);
             currentFilePath.clear();
             updateWindowTitle();
@@ -478,6 +913,137 @@ bool LionCPP::saveFileIfModified()
     return true;
 }
 
+void LionCPP::watchEditorFile(CodeEditor *editor)
+{
+    QFileInfo info(editor->property("filePath").toString());
+    if (info.filePath().isEmpty()) return;
+    
+    // 只监视文件所在目录：编辑器保存时常常先写临时文件再改名，直接监视文件会丢失
+    QString directory = info.absolutePath();
+    QString watched = editor->property("watchedDirectory").toString();
+    if (watched != directory) {
+        if (!watched.isEmpty()) bufferWatcher->removeDirectory(watched);
+        bufferWatcher->addDirectory(directory);
+        editor->setProperty("watchedDirectory", directory);
+    }
+    
+    // 记录磁盘上文件的修改时间和大小，收到事件时据此判断内容是否真的变了
+    editor->setProperty("fileLastModified", info.lastModified());
+    editor->setProperty("fileSize", info.size());
+    editor->setProperty("fileMissing", false);
+}
+
+void LionCPP::unwatchEditorFile(CodeEditor *editor)
+{
+    if (!editor) return;
+    
+    QString watched = editor->property("watchedDirectory").toString();
+    if (!watched.isEmpty()) bufferWatcher->removeDirectory(watched);
+    editor->setProperty("watchedDirectory", QString());
+    pendingReloadChecks.removeAll(editor);
+}
+
+void LionCPP::onBufferFilesChanged(const QList<FileWatcher::Change> &changes)
+{
+    QSet<QString> paths;
+    for (const FileWatcher::Change &change : changes) {
+        paths.insert(change.path);
+        if (!change.oldPath.isEmpty()) paths.insert(change.oldPath);
+    }
+    
+    for (int i = 0; i < editorTabWidget->count(); ++i) {
+        CodeEditor *editor = qobject_cast<CodeEditor*>(editorTabWidget->widget(i));
+        if (!editor) continue;
+        
+        QString filePath = editor->property("filePath").toString();
+        if (!filePath.isEmpty() && paths.contains(QFileInfo(filePath).absoluteFilePath())) {
+            checkExternalModification(editor);
+        }
+    }
+}
+
+void LionCPP::checkExternalModification(CodeEditor *editor)
+{
+    if (!editor || editor->property("watchedDirectory").toString().isEmpty()) return;
+    
+    // 同一时间只弹出一个提示，其余的等提示关闭后再检查
+    if (reloadPromptOpen) {
+        if (!pendingReloadChecks.contains(editor)) pendingReloadChecks.append(editor);
+        return;
+    }
+    
+    QString filePath = editor->property("filePath").toString();
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+        if (!editor->property("fileMissing").toBool()) {
+            editor->setProperty("fileMissing", true);
+            outputWidget->append("文件已在外部被删除或移走: " + filePath + "，保存时会重新创建");
+        }
+        return;
+    }
+    editor->setProperty("fileMissing", false);
+    
+    // 只比较元数据，内容没有变化（例如本 IDE 自己保存）时不读取文件
+    if (info.lastModified() == editor->property("fileLastModified").toDateTime()
+        && info.size() == editor->property("fileSize").toLongLong()) {
+        return;
+    }
+    
+    QString question = editor->document()->isModified()
+        ? QString("文件 %1 已在外部修改。\n编辑器中有未保存的修改，重新加载会丢失这些修改。是否重新加载？").arg(info.fileName())
+        : QString("文件 %1 已在外部修改，是否重新加载？").arg(info.fileName());
+    
+    QPointer<CodeEditor> target(editor);
+    reloadPromptOpen = true;
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "文件已修改", question,
+        QMessageBox::Yes | QMessageBox::No);
+    reloadPromptOpen = false;
+    
+    if (target) {
+        if (reply == QMessageBox::Yes) {
+            reloadEditor(target);
+        } else {
+            // 保留编辑器中的内容：记住磁盘上的这个版本不再询问，保存时覆盖它
+            watchEditorFile(target);
+            target->document()->setModified(true);
+            updateTabTitle(target);
+        }
+    }
+    
+    QList<QPointer<CodeEditor>> pending = pendingReloadChecks;
+    pendingReloadChecks.clear();
+    for (const QPointer<CodeEditor> &next : pending) {
+        if (next) checkExternalModification(next);
+    }
+}
+
+void LionCPP::reloadEditor(CodeEditor *editor)
+{
+    QString filePath = editor->property("filePath").toString();
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+    
+    QTextStream in(&file);
+    QString content = in.readAll();
+    file.close();
+    
+    // 整体替换放在一个编辑块中，重新加载可以用一次撤销恢复
+    int position = editor->textCursor().position();
+    QTextCursor cursor(editor->document());
+    cursor.beginEditBlock();
+    cursor.select(QTextCursor::Document);
+    cursor.insertText(content);
+    cursor.endEditBlock();
+    
+    cursor.setPosition(qMin(position, editor->document()->characterCount() - 1));
+    editor->setTextCursor(cursor);
+    editor->document()->setModified(false);
+    
+    watchEditorFile(editor);
+    updateTabTitle(editor);
+    outputWidget->append("已重新加载外部修改的文件: " + filePath);
+}
+
 void LionCPP::compileCurrentFile()
 {
     CodeEditor *editor = getCurrentEditor();
@@ -521,12 +1087,12 @@ void LionCPP::compileCurrentFile()
     QString executablePath = filePath;
     executablePath.replace(".cpp", "");
     
-    // 使用更完整的编译参数
-    QStringList arguments;
-    arguments << "-std=c++17" << "-Wall" << "-O2" << "-o" << executablePath << filePath;
+    // 编译参数与检测器等运行模式共用同一套构造逻辑
+    QStringList arguments = BuildCache::compileArguments(filePath, executablePath);
+    updateCompilationDatabase(filePath, executablePath, arguments);
     
     compileProcess->setWorkingDirectory(QFileInfo(filePath).absolutePath());
-    compileProcess->start("g++", arguments);
+    compileProcess->start(BuildCache::compilerPath(), arguments);
 }
 
 void LionCPP::runCurrentFile()
@@ -552,11 +1118,16 @@ void LionCPP::runCurrentFile()
     
     isRunning = true;
     updateActions();
-    outputWidget->append("=== 在独立控制台中运行程序 ===");
     
     onRunStarted();
     
+    if (builtinTerminalAction->isChecked()) {
+        runInBuiltinTerminal(executablePath);
+        return;
+    }
+    
     // 在独立的终端窗口中运行程序（类似Dev C++）
+    outputWidget->append("=== 在独立控制台中运行程序 ===");
     runInExternalTerminal(executablePath);
 }
 
@@ -700,64 +1271,628 @@ void LionCPP::runInExternalTerminal(const QString &executablePath)
 
 void LionCPP::runInBuiltinTerminal(const QString &executablePath)
 {
-    // 回退方案：在IDE内置终端运行（保留原有功能）
+    // 在IDE内置终端运行：程序通过伪终端读写，cin 可以交互输入
     outputWidget->append("=== 在内置终端中运行程序 ===");
     
-    if (!runProcess) {
-        runProcess = new QProcess(this);
-        connect(runProcess, &QProcess::finished, this, &LionCPP::onRunFinished);
-        connect(runProcess, &QProcess::readyReadStandardOutput, [this]() {
-            QString output = QString::fromUtf8(runProcess->readAllStandardOutput());
+    terminalDock->show();
+    terminalDock->raise();
+    
+    if (!terminalWidget->start(executablePath, QStringList(), QFileInfo(executablePath).absolutePath())) {
+        outputWidget->append("运行错误: " + terminalWidget->errorString());
+        onRunFinished(1, QProcess::CrashExit);
+    }
+}
+
+void LionCPP::runWithSanitizer(SanitizerKind kind)
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    QString filePath = editor->property("filePath").toString();
+    if (filePath.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先保存文件");
+        return;
+    }
+    
+    if (isCompiling || isRunning) return;
+    
+    if (!saveCurrentFile()) {
+        QMessageBox::warning(this, "错误", "保存文件失败");
+        return;
+    }
+    
+    isCompiling = true;
+    updateActions();
+    outputWidget->clear();
+    outputWidget->append(QString("=== 使用 %1 编译 %2 ===")
+                         .arg(SanitizerReport::displayName(kind), QFileInfo(filePath).fileName()));
+    
+    buildCache->build(filePath, SanitizerReport::profileName(kind), SanitizerReport::compileFlags(kind),
+        [this, kind, filePath](const BuildCache::Result &result) {
+            isCompiling = false;
+            updateActions();
+            
+            if (!result.output.trimmed().isEmpty()) {
+                outputWidget->append(result.output.trimmed());
+            }
+            if (!result.success) {
+                outputWidget->append("编译失败!");
+                return;
+            }
+            
+            outputWidget->append(result.cached ? "源码未修改，复用已缓存的检测器构建" : "检测器构建完成");
+            startSanitizerRun(kind, result.executablePath, filePath);
+        });
+}
+
+void LionCPP::startSanitizerRun(SanitizerKind kind, const QString &executablePath, const QString &sourcePath)
+{
+    if (!sanitizerProcess) {
+        sanitizerProcess = new QProcess(this);
+        connect(sanitizerProcess, &QProcess::finished, this, &LionCPP::onSanitizerRunFinished);
+        connect(sanitizerProcess, &QProcess::readyReadStandardOutput, [this]() {
+            QString output = QString::fromUtf8(sanitizerProcess->readAllStandardOutput());
             outputWidget->append("程序输出: " + output.trimmed());
         });
-        connect(runProcess, &QProcess::readyReadStandardError, [this]() {
-            QString error = QString::fromUtf8(runProcess->readAllStandardError());
-            outputWidget->append("程序错误: " + error.trimmed());
+        connect(sanitizerProcess, &QProcess::readyReadStandardError, [this]() {
+            QString error = QString::fromUtf8(sanitizerProcess->readAllStandardError());
+            sanitizerStderr += error;
+            outputWidget->append(error.trimmed());
+        });
+        connect(sanitizerProcess, &QProcess::errorOccurred, [this](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                outputWidget->append("运行错误: 程序启动失败");
+                onRunFinished(1, QProcess::CrashExit);
+            }
         });
     }
     
-    runProcess->setWorkingDirectory(QFileInfo(executablePath).absolutePath());
-    runProcess->start(executablePath);
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    SanitizerReport::setupEnvironment(kind, environment);
+    
+    sanitizerStderr.clear();
+    sanitizerSourceDir = QFileInfo(sourcePath).absolutePath();
+    sanitizerTree->clear();
+    ++sanitizerRun;
+    
+    isRunning = true;
+    updateActions();
+    onRunStarted();
+    
+    sanitizerProcess->setProcessEnvironment(environment);
+    sanitizerProcess->setWorkingDirectory(sanitizerSourceDir);
+    sanitizerProcess->start(executablePath);
+    // 检测器运行不提供交互输入，关闭标准输入避免程序等待 cin
+    sanitizerProcess->closeWriteChannel();
 }
 
-void LionCPP::setDarkTheme()
+void LionCPP::onSanitizerRunFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
-    // 设置深色主题样式表 - 参考VS Code深色主题
-    QString darkStyle = R"(
-        QMainWindow {
-            background-color: #1e1e1e;
-            color: #d4d4d4;
-        }
-        
-        QMenuBar {
-            background-color: #2d2d30;
-            color: #d4d4d4;
-            border: none;
-        }
-        
-        QMenuBar::item {
-            background-color: transparent;
-            padding: 4px 8px;
-        }
+    QList<SanitizerIssue> issues = SanitizerReport::parse(sanitizerStderr, sanitizerSourceDir);
+    onRunFinished(exitCode, exitStatus);
+    
+    // addr2line 解析大量地址需要数秒，在后台完成后再显示报告
+    const int run = sanitizerRun;
+    SanitizerReport::symbolizeAsync(issues, this, [this, run](const QList<SanitizerIssue> &symbolized) {
+        if (run == sanitizerRun) showSanitizerReport(symbolized);
+    });
+}
+
+void LionCPP::showSanitizerReport(const QList<SanitizerIssue> &issues)
+{
+    sanitizerTree->clear();
+    
+    if (issues.isEmpty()) {
+        outputWidget->append("检测器未发现问题");
+        return;
+    }
+    
+    const QColor userFrameColor("#4ec9b0");
+    
+    for (const SanitizerIssue &issue : issues) {
+        QTreeWidgetItem *issueItem = new QTreeWidgetItem(sanitizerTree);
+        issueItem->setText(0, QString("[%1] %2").arg(issue.tool, issue.message));
         
-        QMenuBar::item:selected {
-            background-color: #3e3e42;
+        // 问题本身定位到第一个用户代码位置
+        QString file = issue.file;
+        int line = issue.line;
+        int column = issue.column;
+        if (file.isEmpty()) {
+            if (const SanitizerFrame *frame = SanitizerReport::firstUserFrame(issue)) {
+                file = frame->file;
+                line = frame->line;
+                column = frame->column;
+            }
         }
-        
-        QMenu {
-            background-color: #2d2d30;
-            color: #d4d4d4;
-            border: 1px solid #3e3e42;
+        if (!file.isEmpty()) {
+            issueItem->setText(0, issueItem->text(0) + QString("  (%1:%2)").arg(QFileInfo(file).fileName()).arg(line));
+            issueItem->setData(0, Qt::UserRole, file);
+            issueItem->setData(0, Qt::UserRole + 1, line);
+            issueItem->setData(0, Qt::UserRole + 2, column);
         }
-        
-        QMenu::item {
-            padding: 4px 20px;
+        if (!issue.summary.isEmpty()) {
+            issueItem->setToolTip(0, issue.summary);
         }
         
-        QMenu::item:selected {
-            background-color: #3e3e42;
+        for (const SanitizerStack &stack : issue.stacks) {
+            QTreeWidgetItem *stackItem = new QTreeWidgetItem(issueItem);
+            stackItem->setText(0, stack.title);
+            
+            for (const SanitizerFrame &frame : stack.frames) {
+                QTreeWidgetItem *frameItem = new QTreeWidgetItem(stackItem);
+                QString location;
+                if (!frame.file.isEmpty()) {
+                    location = QString("%1:%2").arg(frame.file).arg(frame.line);
+                } else if (!frame.module.isEmpty()) {
+                    location = QString("%1+0x%2").arg(frame.module).arg(frame.moduleOffset, 0, 16);
+                }
+                frameItem->setText(0, QString("#%1  %2  %3").arg(frame.index).arg(frame.function, location));
+                if (!frame.file.isEmpty()) {
+                    frameItem->setData(0, Qt::UserRole, frame.file);
+                    frameItem->setData(0, Qt::UserRole + 1, frame.line);
+                    frameItem->setData(0, Qt::UserRole + 2, frame.column);
+                }
+                if (Symbolizer::isUserSource(frame.file)) {
+                    frameItem->setForeground(0, userFrameColor);
+                }
+            }
+            stackItem->setExpanded(true);
         }
-        
+        issueItem->setExpanded(true);
+    }
+    
+    outputWidget->append(QString("检测器发现 %1 个问题，详见“检测器报告”窗口").arg(issues.size()));
+    sanitizerDock->show();
+    sanitizerDock->raise();
+}
+
+void LionCPP::runTestCases()
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    QString filePath = editor->property("filePath").toString();
+    if (filePath.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先保存文件");
+        return;
+    }
+    
+    if (isCompiling || testCasePanel->isRunning()) return;
+    
+    if (!saveCurrentFile()) {
+        QMessageBox::warning(this, "错误", "保存文件失败");
+        return;
+    }
+    
+    testCasePanel->setSourceFile(filePath);
+    testCaseDock->show();
+    testCaseDock->raise();
+    
+    if (testCasePanel->caseCount() == 0) {
+        outputWidget->append("当前文件还没有测试用例，请在“测试用例”窗口中添加");
+        return;
+    }
+    
+    isCompiling = true;
+    updateActions();
+    outputWidget->clear();
+    outputWidget->append("=== 编译并测试 " + QFileInfo(filePath).fileName() + " ===");
+    
+    buildCache->build(filePath, "release", QStringList(), [this](const BuildCache::Result &result) {
+        isCompiling = false;
+        updateActions();
+        
+        if (!result.output.trimmed().isEmpty()) {
+            outputWidget->append(result.output.trimmed());
+        }
+        if (!result.success) {
+            outputWidget->append("编译失败!");
+            return;
+        }
+        
+        outputWidget->append(QString("正在并行运行 %1 个测试用例...").arg(testCasePanel->caseCount()));
+        testCasePanel->runTests(result.executablePath);
+    });
+}
+
+void LionCPP::runStressTest()
+{
+    if (isCompiling || stressPanel->isRunning()) return;
+    
+    if (stressPanel->solutionSource().isEmpty()) {
+        if (CodeEditor *editor = getCurrentEditor()) {
+            stressPanel->setSolutionSource(editor->property("filePath").toString());
+        }
+    }
+    
+    const QStringList sources = {
+        stressPanel->generatorSource(), stressPanel->bruteSource(), stressPanel->solutionSource()
+    };
+    for (const QString &source : sources) {
+        if (source.isEmpty() || !QFileInfo::exists(source)) {
+            QMessageBox::warning(this, "错误", "请先选择生成器、标准程序和待测程序的源文件");
+            return;
+        }
+    }
+    
+    // 正在编辑的文件是其中之一时先保存
+    if (CodeEditor *editor = getCurrentEditor()) {
+        if (sources.contains(editor->property("filePath").toString()) && !saveCurrentFile()) {
+            QMessageBox::warning(this, "错误", "保存文件失败");
+            return;
+        }
+    }
+    
+    stressPanel->setBuilding(true);
+    outputWidget->clear();
+    outputWidget->append("=== 编译对拍程序 ===");
+    
+    // 三个程序并行编译，全部完成后开始对拍
+    buildSources(sources, "release", QStringList(), [this](const QStringList &executables) {
+        stressPanel->setBuilding(false);
+        if (executables.isEmpty()) return;
+        outputWidget->append("编译完成，开始对拍");
+        stressPanel->startTesting(executables.at(0), executables.at(1), executables.at(2));
+    });
+}
+
+void LionCPP::runBenchmarks()
+{
+    CodeEditor *editor = getCurrentEditor();
+    QString projectDirectory = benchmarkPanel->projectDirectory();
+    if (editor) {
+        QString filePath = editor->property("filePath").toString();
+        QString found = filePath.isEmpty() ? QString() : BenchmarkRunner::findProjectDirectory(filePath);
+        if (!found.isEmpty()) projectDirectory = found;
+        if (!filePath.isEmpty() && editor->document()->isModified() && !saveCurrentFile()) {
+            QMessageBox::warning(this, "错误", "保存文件失败");
+            return;
+        }
+    }
+    
+    if (projectDirectory.isEmpty()) {
+        QMessageBox::warning(this, "错误", "当前文件不属于基准测试项目，请先通过“文件 > 新建基准测试项目”创建");
+        return;
+    }
+    if (benchmarkPanel->isRunning()) return;
+    
+    outputWidget->clear();
+    outputWidget->append("=== 构建并运行基准测试 " + QFileInfo(projectDirectory).fileName() + " ===");
+    benchmarkPanel->setProjectDirectory(projectDirectory);
+    benchmarkDock->show();
+    benchmarkDock->raise();
+    benchmarkPanel->runBenchmarks();
+}
+
+void LionCPP::runPerfComparison()
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    // 工作目录和 Git 版本都以源文件位置为准，编辑器内容可以不保存
+    QString filePath = editor->property("filePath").toString();
+    if (filePath.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先保存文件");
+        return;
+    }
+    
+    perfCompareDock->show();
+    perfCompareDock->raise();
+    perfComparePanel->startComparison(filePath, editor->toPlainText());
+}
+
+void LionCPP::runComplexityAnalysis()
+{
+    if (isCompiling || complexityPanel->isRunning()) return;
+    
+    if (complexityPanel->solutionSource().isEmpty()) {
+        if (CodeEditor *editor = getCurrentEditor()) {
+            complexityPanel->setSolutionSource(editor->property("filePath").toString());
+        }
+    }
+    
+    const QStringList sources = { complexityPanel->generatorSource(), complexityPanel->solutionSource() };
+    for (const QString &source : sources) {
+        if (source.isEmpty() || !QFileInfo::exists(source)) {
+            QMessageBox::warning(this, "错误", "请先选择生成器和待测程序的源文件");
+            return;
+        }
+    }
+    
+    if (CodeEditor *editor = getCurrentEditor()) {
+        if (sources.contains(editor->property("filePath").toString()) && !saveCurrentFile()) {
+            QMessageBox::warning(this, "错误", "保存文件失败");
+            return;
+        }
+    }
+    
+    complexityPanel->setBuilding(true);
+    outputWidget->clear();
+    outputWidget->append("=== 编译复杂度分析程序 ===");
+    
+    buildSources(sources, "release", QStringList(), [this](const QStringList &executables) {
+        complexityPanel->setBuilding(false);
+        if (executables.isEmpty()) return;
+        outputWidget->append("编译完成，开始测量");
+        complexityPanel->startAnalysis(executables.at(0), executables.at(1));
+    });
+}
+
+void LionCPP::runThreadScaling()
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    QString filePath = editor->property("filePath").toString();
+    if (filePath.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先保存文件");
+        return;
+    }
+    if (isCompiling || scalingPanel->isRunning()) return;
+    if (editor->document()->isModified() && !saveCurrentFile()) {
+        QMessageBox::warning(this, "错误", "保存文件失败");
+        return;
+    }
+    
+    scalingPanel->setBuilding(true);
+    scalingDock->show();
+    scalingDock->raise();
+    outputWidget->clear();
+    outputWidget->append("=== 编译 " + QFileInfo(filePath).fileName() + " ===");
+    
+    buildSources({filePath}, "release", scalingPanel->compileFlags(), [this, filePath](const QStringList &executables) {
+        scalingPanel->setBuilding(false);
+        if (executables.isEmpty()) return;
+        outputWidget->append("编译完成，开始线程扩展性测试");
+        scalingPanel->startSweep(executables.first(), QFileInfo(filePath).absolutePath());
+    });
+}
+
+void LionCPP::showMeasurementDialog()
+{
+    MeasurementDialog dialog(this);
+    if (dialog.exec() == QDialog::Accepted) {
+        MeasurementConditions conditions = MeasurementEnvironment::check();
+        outputWidget->append("测量环境：" + MeasurementEnvironment::summary(conditions));
+        for (const QString &warning : std::as_const(conditions.warnings)) {
+            outputWidget->append("    警告：" + warning);
+        }
+    }
+}
+
+// 并行编译 sources，全部完成后回调；有任何一个失败时 executables 为空，否则与 sources 一一对应
+void LionCPP::buildSources(const QStringList &sources, const QString &profile, const QStringList &flags,
+                           const std::function<void(const QStringList &executables)> &finished)
+{
+    isCompiling = true;
+    updateActions();
+    
+    auto executables = std::make_shared<QStringList>();
+    for (int i = 0; i < sources.size(); ++i) executables->append(QString());
+    auto pending = std::make_shared<int>(sources.size());
+    auto failed = std::make_shared<bool>(false);
+    
+    for (int i = 0; i < sources.size(); ++i) {
+        const QString source = sources.at(i);
+        buildCache->build(source, profile, flags,
+            [this, i, source, sources, executables, pending, failed, finished](const BuildCache::Result &result) {
+                const QString output = result.output.trimmed();
+                if (!output.isEmpty()) {
+                    outputWidget->append(sources.size() > 1 ? QFileInfo(source).fileName() + ":\n" + output : output);
+                }
+                if (result.success) {
+                    (*executables)[i] = result.executablePath;
+                } else {
+                    *failed = true;
+                }
+                if (--*pending > 0) return;
+                
+                isCompiling = false;
+                updateActions();
+                
+                if (*failed) {
+                    outputWidget->append("编译失败!");
+                    finished(QStringList());
+                    return;
+                }
+                finished(*executables);
+            });
+    }
+}
+
+// 保存当前文件，按 profile 编译后在 dock 中启动分析；title 用于输出窗口中的提示
+void LionCPP::runProfiler(const QString &profile, const QStringList &flags, const QString &title, QDockWidget *dock,
+                          const std::function<bool(const QString &executablePath, const QString &workingDirectory,
+                                                   QString *errorMessage)> &start)
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    QString filePath = editor->property("filePath").toString();
+    if (filePath.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先保存文件");
+        return;
+    }
+    
+    if (isCompiling || isRunning) return;
+    
+    if (!saveCurrentFile()) {
+        QMessageBox::warning(this, "错误", "保存文件失败");
+        return;
+    }
+    
+    outputWidget->clear();
+    outputWidget->append("=== 编译 " + QFileInfo(filePath).fileName() + "（" + title + "）===");
+    
+    buildSources({filePath}, profile, flags, [this, filePath, title, dock, start](const QStringList &executables) {
+        if (executables.isEmpty()) return;
+        
+        dock->show();
+        dock->raise();
+        
+        QString errorMessage;
+        if (!start(executables.first(), QFileInfo(filePath).absolutePath(), &errorMessage)) {
+            outputWidget->append("无法启动" + title + ": " + errorMessage);
+            return;
+        }
+        isRunning = true;
+        updateActions();
+        onRunStarted();
+    });
+}
+
+void LionCPP::runMemoryProfile()
+{
+    runProfiler("memprof", MemoryProfiler::compileFlags(), "内存分析", memoryProfileDock,
+        [this](const QString &executablePath, const QString &workingDirectory, QString *errorMessage) {
+            return memoryProfilePanel->startProfiling(executablePath, workingDirectory, errorMessage);
+        });
+}
+
+void LionCPP::runLockProfile()
+{
+    runProfiler("lockprof", LockProfiler::compileFlags(), "锁竞争分析", lockProfileDock,
+        [this](const QString &executablePath, const QString &workingDirectory, QString *errorMessage) {
+            return lockProfilePanel->startProfiling(executablePath, workingDirectory, errorMessage);
+        });
+}
+
+void LionCPP::runFalseSharing()
+{
+    runProfiler("c2c", FalseSharingAnalyzer::compileFlags(), "伪共享检测", falseSharingDock,
+        [this](const QString &executablePath, const QString &workingDirectory, QString *errorMessage) {
+            return falseSharingPanel->startAnalysis(executablePath, workingDirectory, errorMessage);
+        });
+}
+
+void LionCPP::analyzeOptimizations()
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    QString filePath = editor->property("filePath").toString();
+    if (filePath.isEmpty()) return;
+    
+    // 上一次分析尚未结束时直接终止，不等待它退出；它的结果按序号丢弃，以最新保存的内容为准
+    if (remarksProcess) remarksProcess->kill();
+    const int run = ++remarksRun;
+    
+    // 每次分析使用自己的临时目录，进程结束、连接断开时随之删除
+    auto objectDirectory = std::make_shared<QTemporaryDir>();
+    if (!objectDirectory->isValid()) {
+        outputWidget->append("优化报告: 无法创建临时目录");
+        return;
+    }
+    
+    QProcess *process = new QProcess(this);
+    remarksProcess = process;
+    connect(process, &QProcess::errorOccurred, process, [process](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) process->deleteLater();
+    });
+    connect(process, &QProcess::finished, this, [this, process, run, objectDirectory](int exitCode, QProcess::ExitStatus exitStatus) {
+        process->deleteLater();
+        QString output = QString::fromUtf8(process->readAllStandardError());
+        // 被新一次分析取代，或分析期间文件已关闭
+        if (run != remarksRun || exitStatus != QProcess::NormalExit || !remarksEditor) return;
+        if (exitCode != 0) {
+            outputWidget->append("优化报告: 编译失败，请先修正编译错误");
+            return;
+        }
+        
+        QString sourcePath = remarksEditor->property("filePath").toString();
+        QMap<int, QList<OptimizationRemark>> remarks = OptimizationRemarks::indexByLine(
+            OptimizationRemarks::parse(output, QFileInfo(sourcePath).absolutePath()), sourcePath);
+        remarksEditor->setOptimizationRemarks(remarks);
+        
+        int optimized = 0;
+        int missed = 0;
+        for (const QList<OptimizationRemark> &lineRemarks : remarks) {
+            for (const OptimizationRemark &remark : lineRemarks) {
+                if (remark.kind == RemarkKind::Optimized) ++optimized;
+                else if (remark.kind == RemarkKind::Missed) ++missed;
+            }
+        }
+        outputWidget->append(QString("优化报告 %1: 已优化 %2 处，未优化 %3 处，悬停行号旁的图标查看详情")
+                             .arg(QFileInfo(sourcePath).fileName()).arg(optimized).arg(missed));
+    });
+    
+    remarksEditor = editor;
+    QString compiler = BuildCache::compilerPath();
+    QStringList flags = OptimizationRemarks::compileFlags(compiler);
+    flags << "-c";
+    QString objectPath = QDir(objectDirectory->path()).filePath("remarks.o");
+    
+    process->setWorkingDirectory(QFileInfo(filePath).absolutePath());
+    process->start(compiler, BuildCache::compileArguments(filePath, objectPath, flags));
+}
+
+void LionCPP::onSanitizerItemActivated(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column)
+    
+    QString filePath = item->data(0, Qt::UserRole).toString();
+    if (filePath.isEmpty() || !QFileInfo::exists(filePath)) return;
+    
+    openFileAtLine(filePath, item->data(0, Qt::UserRole + 1).toInt(), item->data(0, Qt::UserRole + 2).toInt());
+}
+
+void LionCPP::openFileAtLine(const QString &filePath, int line, int column)
+{
+    openFileInEditor(filePath);
+    
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor || editor->property("filePath").toString() != filePath) return;
+    
+    QTextBlock block = editor->document()->findBlockByNumber(qMax(0, line - 1));
+    if (!block.isValid()) return;
+    
+    QTextCursor cursor(block);
+    if (column > 1) {
+        cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, qMin(column - 1, block.length() - 1));
+    }
+    editor->setTextCursor(cursor);
+    editor->centerCursor();
+    editor->setFocus();
+}
+
+void LionCPP::setDarkTheme()
+{
+    // 设置深色主题样式表 - 参考VS Code深色主题
+    QString darkStyle = R"(
+        QMainWindow {
+            background-color: #1e1e1e;
+            color: #d4d4d4;
+        }
+        
+        QMenuBar {
+            background-color: #2d2d30;
+            color: #d4d4d4;
+            border: none;
+        }
+        
+        QMenuBar::item {
+            background-color: transparent;
+            padding: 4px 8px;
+        }
+        
+        QMenuBar::item:selected {
+            background-color: #3e3e42;
+        }
+        
+        QMenu {
+            background-color: #2d2d30;
+            color: #d4d4d4;
+            border: 1px solid #3e3e42;
+        }
+        
+        QMenu::item {
+            padding: 4px 20px;
+        }
+        
+        QMenu::item:selected {
+            background-color: #3e3e42;
+        }
+        
         QToolBar {
             background-color: #2d2d30;
             border: none;
@@ -961,6 +2096,8 @@ void LionCPP::onNewFile()
     qDebug() << "[onNewFile] called";
     // 创建新的编辑器标签页
     CodeEditor *editor = new CodeEditor();
+    editor->setSymbolIndex(projectManager->getSymbolIndex());
+    connect(editor, &CodeEditor::definitionRequested, this, &LionCPP::onGoToDefinition);
     
     // 应用当前编辑器设置
     applyEditorSettingsToEditor(editor);
@@ -986,6 +2123,30 @@ void LionCPP::onNewFile()
     updateActions();
 }
 
+void LionCPP::onNewBenchmarkProject()
+{
+    QString name = QInputDialog::getText(this, "新建基准测试项目", "项目名称:");
+    if (name.isEmpty()) return;
+    
+    QString parentDirectory = QFileDialog::getExistingDirectory(this, "选择项目位置", QDir::homePath());
+    if (parentDirectory.isEmpty()) return;
+    
+    QString projectDirectory = QDir(parentDirectory).filePath(name);
+    if (QFile::exists(QDir(projectDirectory).filePath("CMakeLists.txt"))) {
+        QMessageBox::warning(this, "错误", "该目录下已经存在项目: " + projectDirectory);
+        return;
+    }
+    
+    // 项目树切换到新项目目录
+    projectManager->createNewProject(name, projectDirectory, ProjectTemplate::Benchmark);
+    settings.setValue("project/lastDirectory", projectDirectory);
+    restartLanguageServer();
+    
+    openFileInEditor(QDir(projectDirectory).filePath("main.cpp"));
+    benchmarkPanel->setProjectDirectory(projectDirectory);
+    outputWidget->append("已创建基准测试项目 " + projectDirectory + "，按 Ctrl+F5 构建并运行");
+}
+
 void LionCPP::onOpenFile()
 {
     qDebug() << "[onOpenFile] called";
@@ -997,9 +2158,43 @@ void LionCPP::onOpenFile()
     }
 }
 
+void LionCPP::onOpenProject()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "打开项目目录", projectManager->getProjectPath());
+    if (directory.isEmpty()) return;
+    
+    projectManager->openProject(directory);
+    findInFilesPanel->setProject(&projectManager->getFileIndex(), projectManager->getProjectPath());
+    settings.setValue("project/lastDirectory", directory);
+    restartLanguageServer();
+    outputWidget->append("正在索引项目目录 " + directory);
+}
+
+void LionCPP::onQuickOpen()
+{
+    if (!quickOpenDialog) {
+        quickOpenDialog = new QuickOpenDialog(this);
+        connect(quickOpenDialog, &QuickOpenDialog::fileSelected, this, &LionCPP::openFileInEditor);
+    }
+    
+    quickOpenDialog->setFileIndex(&projectManager->getFileIndex(), projectManager->getProjectPath());
+    quickOpenDialog->setRecentFiles(recentFiles);
+    quickOpenDialog->popup();
+}
+
+void LionCPP::addRecentFile(const QString &filePath)
+{
+    const QString path = QFileInfo(filePath).absoluteFilePath();
+    recentFiles.removeAll(path);
+    recentFiles.prepend(path);
+    while (recentFiles.size() > FuzzyMatcher::RecentLimit) recentFiles.removeLast();
+}
+
 void LionCPP::onSaveFile()
 {
-    saveCurrentFile();
+    if (saveCurrentFile() && optimizationRemarksAction->isChecked()) {
+        analyzeOptimizations();
+    }
 }
 
 void LionCPP::onSaveAsFile()
@@ -1093,6 +2288,275 @@ void LionCPP::onReplace()
     dialog->activateWindow();
 }
 
+void LionCPP::onFindInFiles()
+{
+    // 有选中文本时用它作为查找内容
+    QString text;
+    if (CodeEditor *editor = getCurrentEditor()) {
+        text = editor->textCursor().selectedText();
+        if (text.contains(QChar::ParagraphSeparator)) text.clear();
+    }
+    
+    findInFilesPanel->setProject(&projectManager->getFileIndex(), projectManager->getProjectPath());
+    findInFilesDock->show();
+    findInFilesDock->raise();
+    findInFilesPanel->activate(text);
+}
+
+void LionCPP::onGoToDefinition()
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    QString qualifier;
+    const QString name = editor->identifierAt(editor->textCursor(), &qualifier);
+    if (name.isEmpty()) {
+        statusBar()->showMessage("光标处没有标识符", 3000);
+        return;
+    }
+    
+    statusBar()->showMessage(QString("正在查找 %1 的定义...").arg(name));
+    symbolNavigator->setProject(projectManager->getSymbolIndex(), &projectManager->getFileIndex(),
+                                projectManager->getProjectPath());
+    symbolNavigator->goToDefinition(name, qualifier, editor->property("filePath").toString(),
+                                    editor->textCursor().blockNumber() + 1);
+}
+
+void LionCPP::onDefinitionTargets(const QString &name, const QList<SymbolNavigator::Target> &targets, bool fromTextSearch)
+{
+    if (targets.isEmpty()) {
+        statusBar()->showMessage(QString("没有找到 %1 的定义").arg(name), 5000);
+        return;
+    }
+    const QString source = fromTextSearch ? "（符号索引已过期，结果来自文本查找）" : QString();
+    
+    // 只有一个结果，或者只有一个定义时直接跳转
+    int definitions = 0;
+    for (const SymbolNavigator::Target &target : targets) {
+        if (target.definition) ++definitions;
+    }
+    if (targets.size() == 1 || definitions == 1) {
+        const SymbolNavigator::Target &target = targets.first();
+        openFileAtLine(target.filePath, target.line, target.column);
+        statusBar()->showMessage(target.description + source, 5000);
+        return;
+    }
+    
+    // 多个候选时在光标处弹出菜单选择
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    const QString root = projectManager->getProjectPath();
+    const int MaxMenuItems = 30;
+    QMenu menu(this);
+    for (int i = 0; i < targets.size() && i < MaxMenuItems; ++i) {
+        const SymbolNavigator::Target &target = targets[i];
+        QString path = target.filePath;
+        if (!root.isEmpty() && path.startsWith(root + '/')) path = QDir(root).relativeFilePath(path);
+        QAction *action = menu.addAction(QString("%1 — %2:%3").arg(target.description, path).arg(target.line));
+        action->setData(i);
+    }
+    if (targets.size() > MaxMenuItems) {
+        menu.addSeparator();
+        menu.addAction(QString("另有 %1 个结果未列出").arg(targets.size() - MaxMenuItems))->setEnabled(false);
+    }
+    statusBar()->showMessage(QString("%1 有 %2 个候选位置%3").arg(name).arg(targets.size()).arg(source), 5000);
+    
+    QAction *chosen = menu.exec(editor->viewport()->mapToGlobal(editor->cursorRect().bottomLeft()));
+    if (!chosen || !chosen->data().isValid()) return;
+    const SymbolNavigator::Target &target = targets[chosen->data().toInt()];
+    openFileAtLine(target.filePath, target.line, target.column);
+}
+
+void LionCPP::onFindReferences()
+{
+    CodeEditor *editor = getCurrentEditor();
+    if (!editor) return;
+    
+    const QString name = editor->identifierAt(editor->textCursor());
+    if (name.isEmpty()) {
+        statusBar()->showMessage("光标处没有标识符", 3000);
+        return;
+    }
+    
+    // 索引只记录声明，引用按全词、区分大小写在 C/C++ 文件中查找
+    findInFilesPanel->setProject(&projectManager->getFileIndex(), projectManager->getProjectPath());
+    findInFilesDock->show();
+    findInFilesDock->raise();
+    findInFilesPanel->searchFor(name, true, true, "*.cpp *.c *.cc *.cxx *.h *.hpp *.hh *.hxx");
+}
+
+void LionCPP::restartLanguageServer()
+{
+    // 项目切换后 clangd 的根目录和编译数据库都要换
+    clangdClient->stop();
+    if (!clangdAction->isChecked()) return;
+    
+    const QString program = ClangdClient::findClangd();
+    if (program.isEmpty()) {
+        statusBar()->showMessage("没有找到 clangd，补全和诊断仍使用内置功能", 5000);
+        return;
+    }
+    QString errorMessage;
+    const QString projectPath = projectManager->getProjectPath();
+    languageServerDatabase = CompilationDatabase::findDirectory(projectPath);
+    if (!clangdClient->start(program, projectPath, languageServerDatabase, &errorMessage)) {
+        statusBar()->showMessage(errorMessage, 5000);
+        return;
+    }
+    statusBar()->showMessage("clangd 已启动: " + program, 5000);
+}
+
+void LionCPP::refreshLanguageServer()
+{
+    // clangd 只在启动时读取 --compile-commands-dir，目录变了只能重启
+    if (!clangdClient->isRunning()) return;
+    if (CompilationDatabase::findDirectory(projectManager->getProjectPath()) == languageServerDatabase) return;
+    restartLanguageServer();
+}
+
+void LionCPP::attachLanguageClient(CodeEditor *editor)
+{
+    // 停止期间文档仍然登记在客户端中，clangd 重新启动后自动打开
+    editor->setLanguageClient(clangdAction->isChecked() ? clangdClient : nullptr, editor->property("filePath").toString());
+}
+
+void LionCPP::updateCompilationDatabase(const QString &filePath, const QString &executablePath, const QStringList &arguments)
+{
+    // CMake 项目中的文件由 CMake 导出数据库，这里只记录单独的源文件
+    const QString root = projectManager->getProjectPath();
+    if (!root.isEmpty() && filePath.startsWith(root + '/') && QFileInfo::exists(root + "/CMakeLists.txt")) return;
+    
+    QString errorMessage;
+    if (!CompilationDatabase::update(filePath, executablePath, QStringList{BuildCache::compilerPath()} + arguments,
+                                     &errorMessage)) {
+        outputWidget->append("编译数据库: " + errorMessage);
+        return;
+    }
+    refreshLanguageServer();
+}
+
+QHash<QString, QString> LionCPP::editorBuffers(bool modifiedOnly)
+{
+    QHash<QString, QString> buffers;
+    for (int i = 0; i < editorTabWidget->count(); ++i) {
+        CodeEditor *editor = qobject_cast<CodeEditor*>(editorTabWidget->widget(i));
+        if (!editor || (modifiedOnly && !editor->document()->isModified())) continue;
+        
+        const QString filePath = editor->property("filePath").toString();
+        if (!filePath.isEmpty()) buffers.insert(filePath, editor->toPlainText());
+    }
+    return buffers;
+}
+
+CodeEditor *LionCPP::findEditor(const QString &filePath)
+{
+    for (int i = 0; i < editorTabWidget->count(); ++i) {
+        CodeEditor *editor = qobject_cast<CodeEditor*>(editorTabWidget->widget(i));
+        if (editor && editor->property("filePath").toString() == filePath) return editor;
+    }
+    return nullptr;
+}
+
+void LionCPP::replaceInFiles(const QStringList &filePaths, const ProjectSearcher::Options &options, const QString &replacement)
+{
+    // 已打开的文件（无论是否修改）都以编辑器中的内容为准，替换写入编辑器
+    QString errorMessage;
+    if (!projectReplacer->prepare(filePaths, editorBuffers(false), options, replacement, &errorMessage)) {
+        QMessageBox::warning(this, "替换", errorMessage);
+        return;
+    }
+    statusBar()->showMessage(QString("正在计算 %1 个文件的替换...").arg(filePaths.size()));
+}
+
+void LionCPP::onReplacePrepared(const QList<ProjectReplacer::FileEdit> &edits, const QStringList &skipped)
+{
+    statusBar()->clearMessage();
+    if (edits.isEmpty()) {
+        QMessageBox::information(this, "替换", skipped.isEmpty() ? "没有需要替换的内容" : "没有可以替换的文件:\n" + skipped.join('\n'));
+        return;
+    }
+    
+    ReplacePreviewDialog dialog(edits, skipped, projectManager->getProjectPath(), this);
+    if (dialog.exec() != QDialog::Accepted) return;
+    const QList<ProjectReplacer::FileEdit> selected = dialog.selectedEdits();
+    
+    // 预览期间编辑器内容被改动时放弃整个替换，避免覆盖新的修改
+    pendingEditorEdits.clear();
+    for (const ProjectReplacer::FileEdit &edit : selected) {
+        if (!edit.inEditor) continue;
+        CodeEditor *editor = findEditor(edit.filePath);
+        if (!editor || editor->toPlainText() != edit.original) {
+            QMessageBox::warning(this, "替换", "文件在预览后被修改，请重新查找: " + edit.filePath);
+            return;
+        }
+        pendingEditorEdits.append(edit);
+    }
+    
+    projectReplacer->apply(selected);
+    statusBar()->showMessage("正在写入替换结果...");
+}
+
+void LionCPP::onReplaceApplied(bool success, const QString &errorMessage, int fileCount)
+{
+    statusBar()->clearMessage();
+    const QList<ProjectReplacer::FileEdit> editorEdits = pendingEditorEdits;
+    pendingEditorEdits.clear();
+    
+    if (!success) {
+        QMessageBox::warning(this, "替换失败", errorMessage + "\n\n所有文件均未修改。");
+        return;
+    }
+    
+    // 磁盘文件全部写入成功后再修改编辑器，失败时编辑器保持原样。
+    // 这些文件的替换只写入编辑器，写入磁盘期间被关闭或改动的编辑器不会被替换
+    int editorCount = 0;
+    QStringList skippedEditors;
+    for (const ProjectReplacer::FileEdit &edit : editorEdits) {
+        CodeEditor *editor = findEditor(edit.filePath);
+        if (!editor) {
+            outputWidget->append("未替换（编辑器已关闭）: " + edit.filePath);
+            skippedEditors.append(edit.filePath);
+            continue;
+        }
+        if (editor->toPlainText() != edit.original) {
+            outputWidget->append("未替换（编辑器内容在替换期间被修改）: " + edit.filePath);
+            skippedEditors.append(edit.filePath);
+            continue;
+        }
+        applyEditorReplacement(editor, edit);
+        ++editorCount;
+    }
+    
+    QString summary = QString("替换完成: 写入 %1 个文件，修改 %2 个已打开的文件（未保存）").arg(fileCount).arg(editorCount);
+    if (!skippedEditors.isEmpty()) summary += QString("，%1 个已打开的文件未替换").arg(skippedEditors.size());
+    outputWidget->append(summary);
+    findInFilesPanel->startSearch();
+    
+    if (!skippedEditors.isEmpty()) {
+        QMessageBox::warning(this, "替换", "以下文件在替换期间被关闭或修改，没有被替换，请重新查找:\n" + skippedEditors.join('\n'));
+    }
+}
+
+void LionCPP::applyEditorReplacement(CodeEditor *editor, const ProjectReplacer::FileEdit &edit)
+{
+    // 只替换首尾相同部分之间的文本，光标、滚动位置和其余内容不受影响；整个修改是一个撤销步骤
+    const QString &before = edit.original;
+    const QString &after = edit.replaced;
+    qsizetype prefix = 0;
+    const qsizetype limit = qMin(before.size(), after.size());
+    while (prefix < limit && before[prefix] == after[prefix]) ++prefix;
+    qsizetype suffix = 0;
+    while (suffix < limit - prefix && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) ++suffix;
+    
+    QTextCursor cursor(editor->document());
+    cursor.beginEditBlock();
+    cursor.setPosition(prefix);
+    cursor.setPosition(before.size() - suffix, QTextCursor::KeepAnchor);
+    cursor.insertText(after.mid(prefix, after.size() - prefix - suffix));
+    cursor.endEditBlock();
+}
+
 // 运行菜单槽函数
 void LionCPP::onCompile()
 {
@@ -1162,12 +2626,12 @@ void LionCPP::onCompileAndRun()
     QString executablePath = filePath;
     executablePath.replace(".cpp", "");
     
-    // 使用更完整的编译参数
-    QStringList arguments;
-    arguments << "-std=c++17" << "-Wall" << "-O2" << "-o" << executablePath << filePath;
+    // 编译参数与检测器等运行模式共用同一套构造逻辑
+    QStringList arguments = BuildCache::compileArguments(filePath, executablePath);
+    updateCompilationDatabase(filePath, executablePath, arguments);
     
     compileProcess->setWorkingDirectory(QFileInfo(filePath).absolutePath());
-    compileProcess->start("g++", arguments);
+    compileProcess->start(BuildCache::compilerPath(), arguments);
 }
 
 void LionCPP::onStop()
@@ -1180,6 +2644,48 @@ void LionCPP::onStop()
         runProcess->terminate();
         runProcess->waitForFinished(3000);
     }
+    if (sanitizerProcess && sanitizerProcess->state() == QProcess::Running) {
+        sanitizerProcess->terminate();
+        sanitizerProcess->waitForFinished(3000);
+    }
+    if (terminalWidget->isRunning()) {
+        terminalWidget->terminate();
+    }
+    if (testCasePanel->isRunning()) {
+        testCasePanel->cancel();
+    }
+    if (stressPanel->isRunning()) {
+        stressPanel->stop();
+    }
+    if (benchmarkPanel->isRunning()) {
+        benchmarkPanel->stop();
+    }
+    if (perfComparePanel->isRunning()) {
+        perfComparePanel->stop();
+    }
+    if (complexityPanel->isRunning()) {
+        complexityPanel->stop();
+    }
+    if (scalingPanel->isRunning()) {
+        scalingPanel->stop();
+    }
+    if (memoryProfilePanel->isRunning()) {
+        memoryProfilePanel->stop();
+    }
+    if (lockProfilePanel->isRunning()) {
+        lockProfilePanel->stop();
+    }
+    if (falseSharingPanel->isRunning()) {
+        falseSharingPanel->stop();
+    }
+    if (isCompiling) {
+        buildCache->cancelAll();
+        stressPanel->setBuilding(false);
+        complexityPanel->setBuilding(false);
+        scalingPanel->setBuilding(false);
+        isCompiling = false;
+        updateActions();
+    }
 }
 
 // 工具菜单槽函数
@@ -21,6 +21,9 @@
 #include <QLabel>
 #include <QProgressBar>
 #include <QProcess>
+#include <QTreeWidget>
+#include <QPointer>
+#include <functional>
 
 #include "codeeditor.h"
 #include "projectmanager.h"
@@ -28,6 +31,25 @@
 #include "settingsdialog.h"
 #include "findreplacedialog.h"
 #include "welcomedialog.h"
+#include "buildcache.h"
+#include "sanitizerreport.h"
+#include "terminalwidget.h"
+#include "testcasepanel.h"
+#include "stresspanel.h"
+#include "assemblyview.h"
+#include "benchmarkpanel.h"
+#include "perfcomparepanel.h"
+#include "complexitypanel.h"
+#include "scalingpanel.h"
+#include "memoryprofilepanel.h"
+#include "lockprofilepanel.h"
+#include "structlayoutview.h"
+#include "falsesharingpanel.h"
+#include "filewatcher.h"
+#include "quickopendialog.h"
+#include "findinfilespanel.h"
+#include "projectreplacer.h"
+#include "symbolnavigator.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -49,7 +71,10 @@ protected:
 private slots:
     // 文件菜单
     void onNewFile();
+    void onNewBenchmarkProject();
     void onOpenFile();
+    void onOpenProject();
+    void onQuickOpen();
     void onSaveFile();
     void onSaveAsFile();
     void onCloseFile();
@@ -63,6 +88,9 @@ private slots:
     void onPaste();
     void onFind();
     void onReplace();
+    void onFindInFiles();
+    void onGoToDefinition();
+    void onFindReferences();
     
     // 运行菜单
     void onCompile();
@@ -79,6 +107,13 @@ private slots:
     void onCompilationFinished(int exitCode, QProcess::ExitStatus exitStatus);
     void onRunStarted();
     void onRunFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    
+    // 检测器运行
+    void onSanitizerRunFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onSanitizerItemActivated(QTreeWidgetItem *item, int column);
+    
+    // 外部修改
+    void onBufferFilesChanged(const QList<FileWatcher::Change> &changes);
 
 private:
     void setupUI();
@@ -93,13 +128,50 @@ private:
     void updateActions();
     CodeEditor* getCurrentEditor();
     void openFileInEditor(const QString &filePath);
+    void addRecentFile(const QString &filePath);
     bool saveCurrentFile();
     void closeCurrentFile();
+    QHash<QString, QString> editorBuffers(bool modifiedOnly);
+    CodeEditor *findEditor(const QString &filePath);
+    void restartLanguageServer();
+    // 编译数据库所在目录变化时（例如第一次 CMake 配置完成）重启 clangd
+    void refreshLanguageServer();
+    void attachLanguageClient(CodeEditor *editor);
+    void updateCompilationDatabase(const QString &filePath, const QString &executablePath, const QStringList &arguments);
+    void replaceInFiles(const QStringList &filePaths, const ProjectSearcher::Options &options, const QString &replacement);
+    void onReplacePrepared(const QList<ProjectReplacer::FileEdit> &edits, const QStringList &skipped);
+    void onReplaceApplied(bool success, const QString &errorMessage, int fileCount);
+    void onDefinitionTargets(const QString &name, const QList<SymbolNavigator::Target> &targets, bool fromTextSearch);
+    void applyEditorReplacement(CodeEditor *editor, const ProjectReplacer::FileEdit &edit);
     bool saveFileIfModified();
+    void watchEditorFile(CodeEditor *editor);
+    void unwatchEditorFile(CodeEditor *editor);
+    void checkExternalModification(CodeEditor *editor);
+    void reloadEditor(CodeEditor *editor);
     void compileCurrentFile();
     void runCurrentFile();
     void runInExternalTerminal(const QString &executablePath);
     void runInBuiltinTerminal(const QString &executablePath);
+    void runWithSanitizer(SanitizerKind kind);
+    void startSanitizerRun(SanitizerKind kind, const QString &executablePath, const QString &sourcePath);
+    void showSanitizerReport(const QList<SanitizerIssue> &issues);
+    void runTestCases();
+    void runStressTest();
+    void analyzeOptimizations();
+    void runBenchmarks();
+    void runPerfComparison();
+    void runComplexityAnalysis();
+    void runThreadScaling();
+    void showMeasurementDialog();
+    void runMemoryProfile();
+    void runLockProfile();
+    void runFalseSharing();
+    void buildSources(const QStringList &sources, const QString &profile, const QStringList &flags,
+                      const std::function<void(const QStringList &executables)> &finished);
+    void runProfiler(const QString &profile, const QStringList &flags, const QString &title, QDockWidget *dock,
+                     const std::function<bool(const QString &executablePath, const QString &workingDirectory,
+                                              QString *errorMessage)> &start);
+    void openFileAtLine(const QString &filePath, int line, int column = 0);
     void showWelcomeDialog();
     void onWelcomeNewFile();
     void onWelcomeOpenFile();
@@ -121,7 +193,36 @@ private:
     QTabWidget *editorTabWidget;
     QTextEdit *outputWidget;
     QTreeView *projectTreeView;
+    ProjectManager *projectManager;
     QDockWidget *outputDock;
+    QDockWidget *sanitizerDock;
+    QTreeWidget *sanitizerTree;
+    QDockWidget *terminalDock;
+    TerminalWidget *terminalWidget;
+    QDockWidget *testCaseDock;
+    TestCasePanel *testCasePanel;
+    QDockWidget *stressDock;
+    StressPanel *stressPanel;
+    QDockWidget *asmDock;
+    AssemblyView *assemblyView;
+    QDockWidget *layoutDock;
+    StructLayoutView *structLayoutView;
+    QDockWidget *benchmarkDock;
+    BenchmarkPanel *benchmarkPanel;
+    QDockWidget *perfCompareDock;
+    PerfComparePanel *perfComparePanel;
+    QDockWidget *complexityDock;
+    ComplexityPanel *complexityPanel;
+    QDockWidget *scalingDock;
+    ScalingPanel *scalingPanel;
+    QDockWidget *memoryProfileDock;
+    MemoryProfilePanel *memoryProfilePanel;
+    QDockWidget *lockProfileDock;
+    LockProfilePanel *lockProfilePanel;
+    QDockWidget *falseSharingDock;
+    FalseSharingPanel *falseSharingPanel;
+    QDockWidget *findInFilesDock;
+    FindInFilesPanel *findInFilesPanel;
     
     // 菜单和工具栏
     QMenuBar *mainMenuBar;
@@ -136,12 +237,16 @@ private:
     QMenu *fileMenu;
     QMenu *editMenu;
     QMenu *runMenu;
+    QMenu *sanitizerMenu;
     QMenu *toolsMenu;
     QMenu *helpMenu;
     
     // 动作
     QAction *newFileAction;
+    QAction *newBenchmarkProjectAction;
     QAction *openFileAction;
+    QAction *openProjectAction;
+    QAction *quickOpenAction;
     QAction *saveFileAction;
     QAction *saveAsFileAction;
     QAction *closeFileAction;
@@ -154,12 +259,29 @@ private:
     QAction *pasteAction;
     QAction *findAction;
     QAction *replaceAction;
+    QAction *findInFilesAction;
+    QAction *goToDefinitionAction;
+    QAction *findReferencesAction;
     
     QAction *compileAction;
     QAction *runAction;
     QAction *compileAndRunAction;
     QAction *stopAction;
+    QAction *builtinTerminalAction;
+    QAction *runTestsAction;
+    QAction *stressTestAction;
+    QAction *optimizationRemarksAction;
+    QAction *runBenchmarkAction;
+    QAction *perfCompareAction;
+    QAction *complexityAction;
+    QAction *scalingAction;
+    QAction *measurementAction;
+    QAction *memoryProfileAction;
+    QAction *lockProfileAction;
+    QAction *falseSharingAction;
+    QList<QAction*> sanitizerActions;
     
+    QAction *clangdAction;
     QAction *settingsAction;
     QAction *aboutAction;
     
@@ -167,11 +289,29 @@ private:
     SettingsDialog *settingsDialog;
     QProcess *compileProcess;
     QProcess *runProcess;
+    QProcess *sanitizerProcess;
+    QPointer<QProcess> remarksProcess;     // 正在进行的优化报告分析
+    BuildCache *buildCache;
+    ProjectReplacer *projectReplacer;
+    SymbolNavigator *symbolNavigator;
+    ClangdClient *clangdClient;
+    FileWatcher *bufferWatcher;     // 监视已打开文件所在的目录
+    QuickOpenDialog *quickOpenDialog;
     
     // 状态
     QString currentFilePath;
     bool isCompiling;
     bool isRunning;
+    bool reloadPromptOpen;
+    QList<QPointer<CodeEditor>> pendingReloadChecks;
+    QStringList recentFiles;        // 最近打开的文件，最近的在前
+    QList<ProjectReplacer::FileEdit> pendingEditorEdits;    // 磁盘文件替换成功后再写入编辑器
+    QString sanitizerStderr;
+    QString sanitizerSourceDir;
+    int sanitizerRun;               // 符号化完成时丢弃已被新一次运行取代的报告
+    QPointer<CodeEditor> remarksEditor;
+    int remarksRun;                 // 分析结束时丢弃已被新一次分析取代的结果
+    QString languageServerDatabase; // clangd 启动时使用的编译数据库目录
     
     // 设置
     QSettings settings;
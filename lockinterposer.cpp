@@ -0,0 +1,666 @@
+// 锁竞争分析拦截库（liblioncpp_lockprof.so）
+// 通过 LD_PRELOAD 注入被测程序，替换 pthread 互斥量、读写锁和条件变量的等待函数，
+// 统计每把锁的获取次数、竞争次数、等待时间和持有时间；每次获取都记录调用栈，
+// 竞争和持有时间按（锁，获取位置）汇总，用于定位是哪一行在等锁、哪一行拿着锁不放。
+// 结果在进程退出时写入 LIONCPP_LOCKPROF_FD 指定的管道：
+//   L <锁地址> <m|r|c> <获取次数> <竞争次数> <等待纳秒> <最长等待纳秒> <持有纳秒>
+//   S <锁地址> <竞争次数> <等待纳秒> <获取次数> <持有纳秒>    一个获取位置，后面跟若干 F 行
+//   F <偏移(十六进制)> <模块路径>
+//   E                                  正常结束
+// m 为互斥量，r 为读写锁（std::shared_mutex 等），c 为条件变量（等待时间即 pthread_cond_wait/timedwait/clockwait 中阻塞的时间）。
+// 与内存分析拦截库相同，这里不分配内存，也不使用 printf 系列函数。
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+using MutexFunction = int (*)(pthread_mutex_t *);
+using MutexTimedLockFunction = int (*)(pthread_mutex_t *, const struct timespec *);
+using MutexClockLockFunction = int (*)(pthread_mutex_t *, clockid_t, const struct timespec *);
+using RwlockFunction = int (*)(pthread_rwlock_t *);
+using RwlockTimedLockFunction = int (*)(pthread_rwlock_t *, const struct timespec *);
+using RwlockClockLockFunction = int (*)(pthread_rwlock_t *, clockid_t, const struct timespec *);
+using CondWaitFunction = int (*)(pthread_cond_t *, pthread_mutex_t *);
+using CondTimedWaitFunction = int (*)(pthread_cond_t *, pthread_mutex_t *, const struct timespec *);
+using CondClockWaitFunction = int (*)(pthread_cond_t *, pthread_mutex_t *, clockid_t, const struct timespec *);
+
+MutexFunction realMutexLock = nullptr;
+MutexFunction realMutexTrylock = nullptr;
+MutexFunction realMutexUnlock = nullptr;
+MutexTimedLockFunction realMutexTimedLock = nullptr;
+MutexClockLockFunction realMutexClockLock = nullptr;       // glibc 2.30 起才有，可能为空
+RwlockFunction realRwlockRdlock = nullptr;
+RwlockFunction realRwlockWrlock = nullptr;
+RwlockFunction realRwlockTryRdlock = nullptr;
+RwlockFunction realRwlockTryWrlock = nullptr;
+RwlockFunction realRwlockUnlock = nullptr;
+RwlockTimedLockFunction realRwlockTimedRdlock = nullptr;
+RwlockTimedLockFunction realRwlockTimedWrlock = nullptr;
+RwlockClockLockFunction realRwlockClockRdlock = nullptr;   // 同上
+RwlockClockLockFunction realRwlockClockWrlock = nullptr;
+CondWaitFunction realCondWait = nullptr;
+CondTimedWaitFunction realCondTimedWait = nullptr;
+CondClockWaitFunction realCondClockWait = nullptr;     // glibc 2.30 起才有，可能为空
+
+const int LockTableSize = 4096;             // 必须是 2 的幂
+const int SiteTableSize = 4096;
+const int MaxFrames = 24;
+const int MaxHeldLocks = 32;                // 每个线程同时持有的锁
+
+struct LockEntry
+{
+    std::atomic<uintptr_t> address;
+    char kind;
+    std::atomic<uint64_t> acquisitions;
+    std::atomic<uint64_t> contentions;
+    std::atomic<uint64_t> waitNs;
+    std::atomic<uint64_t> maxWaitNs;
+    std::atomic<uint64_t> holdNs;
+};
+
+struct SiteEntry
+{
+    std::atomic<uint64_t> hash;             // 0 表示空位
+    std::atomic<bool> ready;                // 插入者写完调用栈后置位
+    uintptr_t lock;
+    int depth;
+    void *frames[MaxFrames];
+    std::atomic<uint64_t> acquisitions;
+    std::atomic<uint64_t> contentions;
+    std::atomic<uint64_t> waitNs;
+    std::atomic<uint64_t> holdNs;
+};
+
+// 读锁可以被多个线程同时持有，获取时间按线程记录
+struct HeldLock
+{
+    LockEntry *entry;
+    SiteEntry *site;
+    int64_t acquiredAt;
+};
+
+LockEntry lockTable[LockTableSize];
+SiteEntry siteTable[SiteTableSize];
+std::atomic<uint64_t> droppedLocks(0);
+
+int outputFd = -1;
+std::atomic<int> initState(0);              // 0 未初始化，1 初始化中，2 完成
+std::atomic<bool> finished(false);
+
+__thread bool inHook __attribute__((tls_model("initial-exec"))) = false;
+__thread HeldLock heldLocks[MaxHeldLocks] __attribute__((tls_model("initial-exec")));
+__thread int heldCount __attribute__((tls_model("initial-exec"))) = 0;
+
+class LineBuffer
+{
+public:
+    void append(const char *text)
+    {
+        while (*text && length < sizeof(data)) data[length++] = *text++;
+    }
+
+    void appendNumber(uint64_t value, int base = 10)
+    {
+        char digits[24];
+        int count = 0;
+        do {
+            digits[count++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value > 0);
+        while (count > 0 && length < sizeof(data)) data[length++] = digits[--count];
+    }
+
+    void flush()
+    {
+        size_t written = 0;
+        while (written < length) {
+            ssize_t count = ::write(outputFd, data + written, length - written);
+            if (count <= 0) break;
+            written += static_cast<size_t>(count);
+        }
+        length = 0;
+    }
+
+    size_t size() const { return length; }
+
+private:
+    char data[4096];
+    size_t length = 0;
+};
+
+// 条件变量函数有两个符号版本，dlsym 默认会拿到旧的兼容版本
+template <typename Function>
+Function findFunction(const char *name, const char *version)
+{
+    void *symbol = version ? dlvsym(RTLD_NEXT, name, version) : nullptr;
+    if (!symbol) symbol = dlsym(RTLD_NEXT, name);
+    return reinterpret_cast<Function>(symbol);
+}
+
+void initialize()
+{
+    int expected = 0;
+    if (!initState.compare_exchange_strong(expected, 1)) {
+        // 其他线程正在初始化
+        while (initState.load() != 2) {
+        }
+        return;
+    }
+
+    realMutexLock = findFunction<MutexFunction>("pthread_mutex_lock", nullptr);
+    realMutexTrylock = findFunction<MutexFunction>("pthread_mutex_trylock", nullptr);
+    realMutexUnlock = findFunction<MutexFunction>("pthread_mutex_unlock", nullptr);
+    // std::timed_mutex::try_lock_for/try_lock_until
+    realMutexTimedLock = findFunction<MutexTimedLockFunction>("pthread_mutex_timedlock", nullptr);
+    realMutexClockLock = findFunction<MutexClockLockFunction>("pthread_mutex_clocklock", nullptr);
+    // std::shared_mutex、std::shared_timed_mutex
+    realRwlockRdlock = findFunction<RwlockFunction>("pthread_rwlock_rdlock", nullptr);
+    realRwlockWrlock = findFunction<RwlockFunction>("pthread_rwlock_wrlock", nullptr);
+    realRwlockTryRdlock = findFunction<RwlockFunction>("pthread_rwlock_tryrdlock", nullptr);
+    realRwlockTryWrlock = findFunction<RwlockFunction>("pthread_rwlock_trywrlock", nullptr);
+    realRwlockUnlock = findFunction<RwlockFunction>("pthread_rwlock_unlock", nullptr);
+    realRwlockTimedRdlock = findFunction<RwlockTimedLockFunction>("pthread_rwlock_timedrdlock", nullptr);
+    realRwlockTimedWrlock = findFunction<RwlockTimedLockFunction>("pthread_rwlock_timedwrlock", nullptr);
+    realRwlockClockRdlock = findFunction<RwlockClockLockFunction>("pthread_rwlock_clockrdlock", nullptr);
+    realRwlockClockWrlock = findFunction<RwlockClockLockFunction>("pthread_rwlock_clockwrlock", nullptr);
+    realCondWait = findFunction<CondWaitFunction>("pthread_cond_wait", "GLIBC_2.3.2");
+    realCondTimedWait = findFunction<CondTimedWaitFunction>("pthread_cond_timedwait", "GLIBC_2.3.2");
+    // libstdc++ 的 condition_variable 按 steady_clock 等待时调用它
+    realCondClockWait = findFunction<CondClockWaitFunction>("pthread_cond_clockwait", nullptr);
+
+    if (const char *fd = getenv("LIONCPP_LOCKPROF_FD")) outputFd = static_cast<int>(strtol(fd, nullptr, 10));
+
+    initState.store(2);
+}
+
+void ensureInitialized()
+{
+    if (initState.load(std::memory_order_acquire) != 2) initialize();
+}
+
+int64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// 按地址查找锁，第一次出现时无锁插入
+LockEntry *findLock(const void *address, char kind)
+{
+    uintptr_t key = reinterpret_cast<uintptr_t>(address);
+    uint64_t index = (key >> 4) * 11400714819323198485ULL;
+    for (int probe = 0; probe < LockTableSize; ++probe) {
+        LockEntry &entry = lockTable[(index + probe) & (LockTableSize - 1)];
+        uintptr_t current = entry.address.load(std::memory_order_acquire);
+        if (current == key) return &entry;
+        if (current == 0) {
+            uintptr_t empty = 0;
+            if (entry.address.compare_exchange_strong(empty, key, std::memory_order_acq_rel)) {
+                entry.kind = kind;
+                return &entry;
+            }
+            if (empty == key) return &entry;
+        }
+    }
+    droppedLocks.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void updateMax(std::atomic<uint64_t> &value, uint64_t candidate)
+{
+    uint64_t current = value.load(std::memory_order_relaxed);
+    while (candidate > current && !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+    }
+}
+
+// 取当前调用栈，去掉 captureStack 和拦截函数本身，因此只能由拦截函数直接调用
+__attribute__((noinline)) int captureStack(void **frames)
+{
+    const int skip = 2;
+    void *raw[MaxFrames + skip];
+    int depth = backtrace(raw, MaxFrames + skip);
+    if (depth <= skip) return 0;
+    memcpy(frames, raw + skip, sizeof(void*) * (depth - skip));
+    return depth - skip;
+}
+
+// 按（锁，调用栈）查找获取位置，第一次出现时无锁插入。每次获取都会走到这里，不能用自旋锁串行化
+SiteEntry *findSite(uintptr_t lock, void *const *frames, int depth)
+{
+    if (depth <= 0) return nullptr;
+    uint64_t hash = 1469598103934665603ULL ^ lock;
+    for (int i = 0; i < depth; ++i) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ULL;
+    }
+    if (hash == 0) hash = 1;
+
+    for (int probe = 0; probe < SiteTableSize; ++probe) {
+        SiteEntry &entry = siteTable[(hash + probe) & (SiteTableSize - 1)];
+        uint64_t current = entry.hash.load(std::memory_order_acquire);
+        if (current == 0) {
+            if (entry.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+                entry.lock = lock;
+                entry.depth = depth;
+                memcpy(entry.frames, frames, sizeof(void*) * depth);
+                entry.ready.store(true, std::memory_order_release);
+                return &entry;
+            }
+        }
+        if (current != hash) continue;
+        // 同一位置刚被其他线程插入，等它写完调用栈再比较
+        while (!entry.ready.load(std::memory_order_acquire)) {
+        }
+        if (entry.lock == lock && entry.depth == depth
+            && memcmp(entry.frames, frames, sizeof(void*) * depth) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void recordWait(LockEntry *entry, SiteEntry *site, uint64_t waitNs)
+{
+    entry->contentions.fetch_add(1, std::memory_order_relaxed);
+    entry->waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+    updateMax(entry->maxWaitNs, waitNs);
+    if (site) {
+        site->contentions.fetch_add(1, std::memory_order_relaxed);
+        site->waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+    }
+}
+
+// 取栈在这之前完成，不计入持有时间
+void recordAcquired(LockEntry *entry, SiteEntry *site)
+{
+    entry->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (site) site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (heldCount < MaxHeldLocks) heldLocks[heldCount++] = HeldLock{entry, site, nowNs()};
+}
+
+void recordReleased(LockEntry *entry)
+{
+    // 从后往前找，递归锁释放的是最近一次获取
+    for (int i = heldCount - 1; i >= 0; --i) {
+        if (heldLocks[i].entry != entry) continue;
+        int64_t held = nowNs() - heldLocks[i].acquiredAt;
+        SiteEntry *site = heldLocks[i].site;
+        heldLocks[i] = heldLocks[--heldCount];
+        if (held <= 0) return;
+        entry->holdNs.fetch_add(static_cast<uint64_t>(held), std::memory_order_relaxed);
+        if (site) site->holdNs.fetch_add(static_cast<uint64_t>(held), std::memory_order_relaxed);
+        return;
+    }
+}
+
+// 拦截函数共用的获取流程：先尝试不阻塞地获取，失败才算一次竞争。
+// 强制内联，captureStack 去掉的两层栈帧仍然是它自己和拦截函数
+template <typename TryLock, typename Lock>
+inline __attribute__((always_inline)) int acquireLock(const void *lock, char kind, TryLock tryLock, Lock blockingLock)
+{
+    LockEntry *entry = findLock(lock, kind);
+    int result = tryLock();
+    const bool contended = result != 0;
+    uint64_t waited = 0;
+    if (contended) {
+        int64_t start = nowNs();
+        result = blockingLock();
+        waited = static_cast<uint64_t>(nowNs() - start);
+    }
+    if (!entry) return result;
+
+    void *frames[MaxFrames];
+    int depth = captureStack(frames);
+    SiteEntry *site = findSite(reinterpret_cast<uintptr_t>(lock), frames, depth);
+    if (contended) recordWait(entry, site, waited);
+    if (result == 0) recordAcquired(entry, site);
+    return result;
+}
+
+void writeReport()
+{
+    if (outputFd < 0 || finished.exchange(true)) return;
+    inHook = true;
+
+    LineBuffer line;
+    for (int i = 0; i < LockTableSize; ++i) {
+        const LockEntry &entry = lockTable[i];
+        uintptr_t address = entry.address.load();
+        if (address == 0) continue;
+        line.append("L ");
+        line.appendNumber(address, 16);
+        line.append(entry.kind == 'c' ? " c " : entry.kind == 'r' ? " r " : " m ");
+        line.appendNumber(entry.acquisitions.load());
+        line.append(" ");
+        line.appendNumber(entry.contentions.load());
+        line.append(" ");
+        line.appendNumber(entry.waitNs.load());
+        line.append(" ");
+        line.appendNumber(entry.maxWaitNs.load());
+        line.append(" ");
+        line.appendNumber(entry.holdNs.load());
+        line.append("\n");
+        if (line.size() > 3072) line.flush();
+    }
+
+    for (int i = 0; i < SiteTableSize; ++i) {
+        const SiteEntry &entry = siteTable[i];
+        if (!entry.ready.load(std::memory_order_acquire)) continue;
+        line.append("S ");
+        line.appendNumber(entry.lock, 16);
+        line.append(" ");
+        line.appendNumber(entry.contentions.load());
+        line.append(" ");
+        line.appendNumber(entry.waitNs.load());
+        line.append(" ");
+        line.appendNumber(entry.acquisitions.load());
+        line.append(" ");
+        line.appendNumber(entry.holdNs.load());
+        line.append("\n");
+        for (int f = 0; f < entry.depth; ++f) {
+            Dl_info info;
+            if (!dladdr(entry.frames[f], &info) || !info.dli_fname) continue;
+            // 返回地址指向调用指令的下一条，减一才落在调用所在的行
+            uintptr_t offset = reinterpret_cast<uintptr_t>(entry.frames[f]) - 1
+                               - reinterpret_cast<uintptr_t>(info.dli_fbase);
+            line.append("F ");
+            line.appendNumber(offset, 16);
+            line.append(" ");
+            line.append(info.dli_fname);
+            line.append("\n");
+            if (line.size() > 3072) line.flush();
+        }
+    }
+
+    line.append("E\n");
+    line.flush();
+    ::close(outputFd);
+    outputFd = -1;
+}
+
+__attribute__((constructor)) void onLoad()
+{
+    initialize();
+    // backtrace 第一次调用时会加载 libgcc_s，提前完成
+    inHook = true;
+    void *frames[2];
+    backtrace(frames, 2);
+    inHook = false;
+}
+
+__attribute__((destructor)) void onUnload()
+{
+    writeReport();
+}
+
+} // namespace
+
+extern "C" {
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realMutexLock(mutex);
+    inHook = true;
+    int result = acquireLock(mutex, 'm', [mutex]() { return realMutexTrylock(mutex); },
+                             [mutex]() { return realMutexLock(mutex); });
+    inHook = false;
+    return result;
+}
+
+int pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realMutexTimedLock(mutex, abstime);
+    inHook = true;
+    int result = acquireLock(mutex, 'm', [mutex]() { return realMutexTrylock(mutex); },
+                             [mutex, abstime]() { return realMutexTimedLock(mutex, abstime); });
+    inHook = false;
+    return result;
+}
+
+int pthread_mutex_clocklock(pthread_mutex_t *mutex, clockid_t clock, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (!realMutexClockLock) return EINVAL;
+    if (inHook || finished.load(std::memory_order_relaxed)) return realMutexClockLock(mutex, clock, abstime);
+    inHook = true;
+    int result = acquireLock(mutex, 'm', [mutex]() { return realMutexTrylock(mutex); },
+                             [mutex, clock, abstime]() { return realMutexClockLock(mutex, clock, abstime); });
+    inHook = false;
+    return result;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+    ensureInitialized();
+    int result = realMutexTrylock(mutex);
+    if (result == 0 && !inHook && !finished.load(std::memory_order_relaxed)) {
+        inHook = true;
+        if (LockEntry *entry = findLock(mutex, 'm')) {
+            void *frames[MaxFrames];
+            int depth = captureStack(frames);
+            recordAcquired(entry, findSite(reinterpret_cast<uintptr_t>(mutex), frames, depth));
+        }
+        inHook = false;
+    }
+    return result;
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+    ensureInitialized();
+    if (!inHook && !finished.load(std::memory_order_relaxed)) {
+        inHook = true;
+        if (LockEntry *entry = findLock(mutex, 'm')) recordReleased(entry);
+        inHook = false;
+    }
+    return realMutexUnlock(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realCondWait(cond, mutex);
+    inHook = true;
+
+    // 等待期间互斥量被释放，返回时重新持有
+    LockEntry *mutexEntry = findLock(mutex, 'm');
+    LockEntry *condEntry = findLock(cond, 'c');
+    if (mutexEntry) recordReleased(mutexEntry);
+    int64_t start = nowNs();
+    int result = realCondWait(cond, mutex);
+    uint64_t waited = static_cast<uint64_t>(nowNs() - start);
+    // 条件变量的等待和互斥量的重新持有记在同一个位置上
+    void *frames[MaxFrames];
+    int depth = captureStack(frames);
+    if (condEntry) {
+        SiteEntry *site = findSite(reinterpret_cast<uintptr_t>(cond), frames, depth);
+        condEntry->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (site) site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        recordWait(condEntry, site, waited);
+    }
+    if (mutexEntry) recordAcquired(mutexEntry, findSite(reinterpret_cast<uintptr_t>(mutex), frames, depth));
+
+    inHook = false;
+    return result;
+}
+
+int pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realCondTimedWait(cond, mutex, abstime);
+    inHook = true;
+
+    LockEntry *mutexEntry = findLock(mutex, 'm');
+    LockEntry *condEntry = findLock(cond, 'c');
+    if (mutexEntry) recordReleased(mutexEntry);
+    int64_t start = nowNs();
+    int result = realCondTimedWait(cond, mutex, abstime);
+    uint64_t waited = static_cast<uint64_t>(nowNs() - start);
+    // 条件变量的等待和互斥量的重新持有记在同一个位置上
+    void *frames[MaxFrames];
+    int depth = captureStack(frames);
+    if (condEntry) {
+        SiteEntry *site = findSite(reinterpret_cast<uintptr_t>(cond), frames, depth);
+        condEntry->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (site) site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        recordWait(condEntry, site, waited);
+    }
+    if (mutexEntry) recordAcquired(mutexEntry, findSite(reinterpret_cast<uintptr_t>(mutex), frames, depth));
+
+    inHook = false;
+    return result;
+}
+
+int pthread_cond_clockwait(pthread_cond_t *cond, pthread_mutex_t *mutex, clockid_t clock, const struct timespec *abstime)
+{
+    ensureInitialized();
+    // 被测程序只有在 glibc 提供该函数时才会调用到这里，找不到时按不支持的时钟处理
+    if (!realCondClockWait) return EINVAL;
+    if (inHook || finished.load(std::memory_order_relaxed)) return realCondClockWait(cond, mutex, clock, abstime);
+    inHook = true;
+
+    LockEntry *mutexEntry = findLock(mutex, 'm');
+    LockEntry *condEntry = findLock(cond, 'c');
+    if (mutexEntry) recordReleased(mutexEntry);
+    int64_t start = nowNs();
+    int result = realCondClockWait(cond, mutex, clock, abstime);
+    uint64_t waited = static_cast<uint64_t>(nowNs() - start);
+    // 条件变量的等待和互斥量的重新持有记在同一个位置上
+    void *frames[MaxFrames];
+    int depth = captureStack(frames);
+    if (condEntry) {
+        SiteEntry *site = findSite(reinterpret_cast<uintptr_t>(cond), frames, depth);
+        condEntry->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (site) site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        recordWait(condEntry, site, waited);
+    }
+    if (mutexEntry) recordAcquired(mutexEntry, findSite(reinterpret_cast<uintptr_t>(mutex), frames, depth));
+
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realRwlockRdlock(rwlock);
+    inHook = true;
+    int result = acquireLock(rwlock, 'r', [rwlock]() { return realRwlockTryRdlock(rwlock); },
+                             [rwlock]() { return realRwlockRdlock(rwlock); });
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realRwlockWrlock(rwlock);
+    inHook = true;
+    int result = acquireLock(rwlock, 'r', [rwlock]() { return realRwlockTryWrlock(rwlock); },
+                             [rwlock]() { return realRwlockWrlock(rwlock); });
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realRwlockTimedRdlock(rwlock, abstime);
+    inHook = true;
+    int result = acquireLock(rwlock, 'r', [rwlock]() { return realRwlockTryRdlock(rwlock); },
+                             [rwlock, abstime]() { return realRwlockTimedRdlock(rwlock, abstime); });
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (inHook || finished.load(std::memory_order_relaxed)) return realRwlockTimedWrlock(rwlock, abstime);
+    inHook = true;
+    int result = acquireLock(rwlock, 'r', [rwlock]() { return realRwlockTryWrlock(rwlock); },
+                             [rwlock, abstime]() { return realRwlockTimedWrlock(rwlock, abstime); });
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_clockrdlock(pthread_rwlock_t *rwlock, clockid_t clock, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (!realRwlockClockRdlock) return EINVAL;
+    if (inHook || finished.load(std::memory_order_relaxed)) return realRwlockClockRdlock(rwlock, clock, abstime);
+    inHook = true;
+    int result = acquireLock(rwlock, 'r', [rwlock]() { return realRwlockTryRdlock(rwlock); },
+                             [rwlock, clock, abstime]() { return realRwlockClockRdlock(rwlock, clock, abstime); });
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_clockwrlock(pthread_rwlock_t *rwlock, clockid_t clock, const struct timespec *abstime)
+{
+    ensureInitialized();
+    if (!realRwlockClockWrlock) return EINVAL;
+    if (inHook || finished.load(std::memory_order_relaxed)) return realRwlockClockWrlock(rwlock, clock, abstime);
+    inHook = true;
+    int result = acquireLock(rwlock, 'r', [rwlock]() { return realRwlockTryWrlock(rwlock); },
+                             [rwlock, clock, abstime]() { return realRwlockClockWrlock(rwlock, clock, abstime); });
+    inHook = false;
+    return result;
+}
+
+int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
+{
+    ensureInitialized();
+    int result = realRwlockTryRdlock(rwlock);
+    if (result == 0 && !inHook && !finished.load(std::memory_order_relaxed)) {
+        inHook = true;
+        if (LockEntry *entry = findLock(rwlock, 'r')) {
+            void *frames[MaxFrames];
+            int depth = captureStack(frames);
+            recordAcquired(entry, findSite(reinterpret_cast<uintptr_t>(rwlock), frames, depth));
+        }
+        inHook = false;
+    }
+    return result;
+}
+
+int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
+{
+    ensureInitialized();
+    int result = realRwlockTryWrlock(rwlock);
+    if (result == 0 && !inHook && !finished.load(std::memory_order_relaxed)) {
+        inHook = true;
+        if (LockEntry *entry = findLock(rwlock, 'r')) {
+            void *frames[MaxFrames];
+            int depth = captureStack(frames);
+            recordAcquired(entry, findSite(reinterpret_cast<uintptr_t>(rwlock), frames, depth));
+        }
+        inHook = false;
+    }
+    return result;
+}
+
+int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
+{
+    ensureInitialized();
+    if (!inHook && !finished.load(std::memory_order_relaxed)) {
+        inHook = true;
+        if (LockEntry *entry = findLock(rwlock, 'r')) recordReleased(entry);
+        inHook = false;
+    }
+    return realRwlockUnlock(rwlock);
+}
+
+}
@@ -0,0 +1,194 @@
+#include "lockprofilepanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileInfo>
+#include <QMultiHash>
+#include <QSettings>
+
+namespace {
+enum Column {
+    LockColumn, KindColumn, AcquisitionsColumn, ContentionsColumn, RateColumn,
+    WaitColumn, MaxWaitColumn, HoldColumn, ColumnCount
+};
+
+const int FileRole = Qt::UserRole;
+const int LineRole = Qt::UserRole + 1;
+const int SortRole = Qt::UserRole + 2;
+
+// 按数值排序的表格项
+class NumericTreeItem : public QTreeWidgetItem
+{
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem &other) const override
+    {
+        int column = treeWidget() ? treeWidget()->sortColumn() : 0;
+        QVariant a = data(column, SortRole);
+        QVariant b = other.data(column, SortRole);
+        if (a.isValid() && b.isValid()) return a.toDouble() < b.toDouble();
+        return QTreeWidgetItem::operator<(other);
+    }
+};
+
+void setNumber(QTreeWidgetItem *item, int column, const QString &text, double value)
+{
+    item->setText(column, text);
+    item->setData(column, SortRole, value);
+    item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+}
+
+QString describeLocation(const LockProfiler::Site &site)
+{
+    if (site.file.isEmpty()) return site.function.isEmpty() ? QString("<运行库>") : site.function;
+    return QString("%1:%2  %3").arg(QFileInfo(site.file).fileName()).arg(site.line).arg(site.function);
+}
+}
+
+LockProfilePanel::LockProfilePanel(QWidget *parent)
+    : QWidget(parent)
+    , profiler(new LockProfiler(this))
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *topLayout = new QHBoxLayout();
+    contendedOnlyCheckBox = new QCheckBox("只显示发生竞争的锁", this);
+    contendedOnlyCheckBox->setChecked(QSettings("LionCPP", "IDE").value("lockprof/contendedOnly", true).toBool());
+    summaryLabel = new QLabel("通过“运行 > 锁竞争分析运行”启动", this);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    topLayout->addWidget(contendedOnlyCheckBox);
+    topLayout->addWidget(summaryLabel, 1);
+    layout->addLayout(topLayout);
+
+    lockTree = new QTreeWidget(this);
+    lockTree->setColumnCount(ColumnCount);
+    lockTree->setHeaderLabels(QStringList() << "锁 / 获取位置" << "类型" << "获取次数" << "竞争次数"
+                                            << "竞争率" << "等待总时间" << "最长等待" << "持有总时间");
+    lockTree->setSortingEnabled(true);
+    lockTree->header()->setSectionResizeMode(LockColumn, QHeaderView::Stretch);
+    layout->addWidget(lockTree, 1);
+
+    connect(profiler, &LockProfiler::output, this, &LockProfilePanel::output);
+    connect(profiler, &LockProfiler::finished, this, &LockProfilePanel::onFinished);
+    connect(lockTree, &QTreeWidget::itemActivated, this, &LockProfilePanel::onItemActivated);
+    connect(contendedOnlyCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        QSettings("LionCPP", "IDE").setValue("lockprof/contendedOnly", checked);
+        showReport();
+    });
+}
+
+QString LockProfilePanel::formatDuration(quint64 ns)
+{
+    if (ns >= 1000000000ULL) return QString("%1 s").arg(ns / 1e9, 0, 'f', 3);
+    if (ns >= 1000000ULL) return QString("%1 ms").arg(ns / 1e6, 0, 'f', 2);
+    if (ns >= 1000ULL) return QString("%1 µs").arg(ns / 1e3, 0, 'f', 1);
+    return QString("%1 ns").arg(ns);
+}
+
+bool LockProfilePanel::startProfiling(const QString &executable, const QString &workingDirectory,
+                                      QString *errorMessage)
+{
+    lockTree->clear();
+    lastReport = LockProfiler::Report();
+    if (!profiler->start(executable, workingDirectory, errorMessage)) {
+        return false;
+    }
+    summaryLabel->setText("运行中...");
+    return true;
+}
+
+void LockProfilePanel::stop()
+{
+    profiler->stop();
+}
+
+void LockProfilePanel::onFinished(const LockProfiler::Report &report, int exitCode,
+                                  QProcess::ExitStatus exitStatus)
+{
+    lastReport = report;
+
+    quint64 totalWait = 0;
+    int contended = 0;
+    for (const LockProfiler::Lock &lock : report.locks) {
+        if (lock.condition) continue;
+        totalWait += lock.waitNs;
+        if (lock.contentions > 0) ++contended;
+    }
+    QString summary = QString("共 %1 个锁/条件变量，%2 个锁发生竞争，锁等待合计 %3")
+                          .arg(report.locks.size()).arg(contended).arg(formatDuration(totalWait));
+    if (!report.complete) summary += "（程序没有正常退出，没有统计数据）";
+    summaryLabel->setText(summary);
+
+    showReport();
+    emit finished(exitCode, exitStatus);
+}
+
+void LockProfilePanel::showReport()
+{
+    QMultiHash<quint64, const LockProfiler::Site*> sitesByLock;
+    // 逆序插入，values() 取出时保持等待、持有时间从大到小
+    for (int i = lastReport.sites.size() - 1; i >= 0; --i) {
+        sitesByLock.insert(lastReport.sites[i].lockAddress, &lastReport.sites[i]);
+    }
+
+    lockTree->setSortingEnabled(false);
+    lockTree->clear();
+    for (const LockProfiler::Lock &lock : lastReport.locks) {
+        if (contendedOnlyCheckBox->isChecked() && lock.contentions == 0) continue;
+
+        const QList<const LockProfiler::Site*> sites = sitesByLock.values(lock.address);
+        NumericTreeItem *lockItem = new NumericTreeItem(lockTree);
+        QString name = QString("0x%1").arg(lock.address, 0, 16);
+        // 锁本身没有名字，用等待（没有竞争时是持有）最多的位置来标识
+        if (!sites.isEmpty()) name += "  " + describeLocation(*sites.first());
+        lockItem->setText(LockColumn, name);
+        lockItem->setText(KindColumn, lock.condition ? "条件变量" : lock.readWrite ? "读写锁" : "互斥量");
+        setNumber(lockItem, AcquisitionsColumn, QString::number(lock.acquisitions), lock.acquisitions);
+        setNumber(lockItem, ContentionsColumn, QString::number(lock.contentions), lock.contentions);
+        if (!lock.condition) {
+            double rate = 100.0 * lock.contentionRate();
+            setNumber(lockItem, RateColumn, QString("%1%").arg(rate, 0, 'f', 1), rate);
+            setNumber(lockItem, HoldColumn, formatDuration(lock.holdNs), lock.holdNs);
+        }
+        setNumber(lockItem, WaitColumn, formatDuration(lock.waitNs), lock.waitNs);
+        setNumber(lockItem, MaxWaitColumn, formatDuration(lock.maxWaitNs), lock.maxWaitNs);
+        if (lock.contentions > 0 && !lock.condition && lock.contentionRate() >= 0.1) {
+            lockItem->setForeground(LockColumn, QColor("#f44747"));
+        }
+        if (!sites.isEmpty()) {
+            lockItem->setData(LockColumn, FileRole, sites.first()->file);
+            lockItem->setData(LockColumn, LineRole, sites.first()->line);
+        }
+
+        for (const LockProfiler::Site *site : sites) {
+            NumericTreeItem *siteItem = new NumericTreeItem(lockItem);
+            siteItem->setText(LockColumn, describeLocation(*site));
+            siteItem->setToolTip(LockColumn, site->file);
+            setNumber(siteItem, AcquisitionsColumn, QString::number(site->acquisitions), site->acquisitions);
+            setNumber(siteItem, ContentionsColumn, QString::number(site->contentions), site->contentions);
+            setNumber(siteItem, WaitColumn, formatDuration(site->waitNs), site->waitNs);
+            if (!lock.condition) setNumber(siteItem, HoldColumn, formatDuration(site->holdNs), site->holdNs);
+            siteItem->setData(LockColumn, FileRole, site->file);
+            siteItem->setData(LockColumn, LineRole, site->line);
+            siteItem->setForeground(LockColumn, QColor(site->file.isEmpty() ? "#808080" : "#4ec9b0"));
+        }
+    }
+    lockTree->setSortingEnabled(true);
+    lockTree->sortByColumn(WaitColumn, Qt::DescendingOrder);
+    for (int column = 1; column < ColumnCount; ++column) {
+        lockTree->resizeColumnToContents(column);
+    }
+    if (lockTree->topLevelItemCount() > 0) lockTree->topLevelItem(0)->setExpanded(true);
+}
+
+void LockProfilePanel::onItemActivated(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column)
+    QString file = item->data(LockColumn, FileRole).toString();
+    int line = item->data(LockColumn, LineRole).toInt();
+    if (!file.isEmpty() && line > 0 && QFileInfo::exists(file)) {
+        emit openFileRequested(file, line);
+    }
+}
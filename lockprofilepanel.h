@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QWidget>
+#include <QTreeWidget>
+#include <QCheckBox>
+#include <QLabel>
+
+#include "lockprofiler.h"
+
+// 锁竞争分析窗口
+// 每把锁一行，按等待总时间排序；展开后是获取它的源码行及各自的等待和持有时间，双击跳转
+class LockProfilePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LockProfilePanel(QWidget *parent = nullptr);
+
+    bool startProfiling(const QString &executable, const QString &workingDirectory, QString *errorMessage);
+    void stop();
+    bool isRunning() const { return profiler->isRunning(); }
+
+    static QString formatDuration(quint64 ns);
+
+signals:
+    void output(const QString &text);
+    void openFileRequested(const QString &filePath, int line);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onFinished(const LockProfiler::Report &report, int exitCode, QProcess::ExitStatus exitStatus);
+    void onItemActivated(QTreeWidgetItem *item, int column);
+
+private:
+    void showReport();
+
+    LockProfiler *profiler;
+    LockProfiler::Report lastReport;
+    QCheckBox *contendedOnlyCheckBox;
+    QLabel *summaryLabel;
+    QTreeWidget *lockTree;
+};
@@ -0,0 +1,138 @@
+#include "lockprofiler.h"
+#include <QCoreApplication>
+#include <QHash>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <algorithm>
+
+LockProfiler::LockProfiler(QObject *parent)
+    : QObject(parent)
+    , process(new PreloadProcess(this))
+    , generation(0)
+{
+    connect(process, &PreloadProcess::output, this, &LockProfiler::output);
+    connect(process, &PreloadProcess::lineReceived, this, [this](const QByteArray &line) {
+        parseLine(line, report);
+    });
+    connect(process, &PreloadProcess::finished, this, &LockProfiler::onProcessFinished);
+}
+
+QString LockProfiler::libraryPath()
+{
+    return PreloadProcess::libraryPath("liblioncpp_lockprof.so");
+}
+
+QStringList LockProfiler::compileFlags()
+{
+    // 与内存分析相同，关闭内联后 std::mutex::lock 等包装函数保留自己的栈帧，竞争能对应到用户代码行
+    return QStringList() << "-g" << "-fno-omit-frame-pointer" << "-fno-inline" << "-pthread";
+}
+
+bool LockProfiler::start(const QString &executable, const QString &workingDirectory, QString *errorMessage)
+{
+    this->executable = executable;
+    ++generation;
+    report = Report();
+    return process->start(executable, workingDirectory, libraryPath(), "LIONCPP_LOCKPROF_FD",
+                          QProcessEnvironment(), errorMessage);
+}
+
+void LockProfiler::stop()
+{
+    process->kill();
+}
+
+void LockProfiler::parseLine(const QByteArray &line, Report &report)
+{
+    const QList<QByteArray> fields = line.split(' ');
+    if (fields.isEmpty()) return;
+
+    if (fields[0] == "L" && fields.size() >= 8) {
+        Lock lock;
+        lock.address = fields[1].toULongLong(nullptr, 16);
+        lock.condition = fields[2] == "c";
+        lock.readWrite = fields[2] == "r";
+        lock.acquisitions = fields[3].toULongLong();
+        lock.contentions = fields[4].toULongLong();
+        lock.waitNs = fields[5].toULongLong();
+        lock.maxWaitNs = fields[6].toULongLong();
+        lock.holdNs = fields[7].toULongLong();
+        report.locks.append(lock);
+    } else if (fields[0] == "S" && fields.size() >= 4) {
+        Site site;
+        site.lockAddress = fields[1].toULongLong(nullptr, 16);
+        site.contentions = fields[2].toULongLong();
+        site.waitNs = fields[3].toULongLong();
+        if (fields.size() >= 6) {
+            site.acquisitions = fields[4].toULongLong();
+            site.holdNs = fields[5].toULongLong();
+        }
+        report.sites.append(site);
+    } else if (fields[0] == "F" && !report.sites.isEmpty()) {
+        StackFrame frame;
+        if (PreloadProcess::parseFrame(line, &frame)) report.sites.last().frames.append(frame);
+    } else if (fields[0] == "E") {
+        report.complete = true;
+    }
+}
+
+void LockProfiler::symbolize(Report &report, const QString &executable)
+{
+    QList<QList<StackFrame>*> stacks;
+    for (Site &site : report.sites) stacks.append(&site.frames);
+    PreloadProcess::symbolize(stacks, executable);
+
+    // 同一行经由不同调用路径的获取合并为一项，保留等待（没有等待时是持有）最多的那条调用栈
+    QHash<QString, int> indexById;
+    QList<Site> merged;
+    for (Site &site : report.sites) {
+        if (const StackFrame *userFrame = PreloadProcess::firstUserFrame(site.frames)) {
+            site.file = userFrame->location.file;
+            site.line = userFrame->location.line;
+            site.function = userFrame->location.function;
+        } else if (!site.frames.isEmpty()) {
+            site.function = site.frames.first().location.function;
+        }
+
+        QString id = QString("%1|%2:%3|%4").arg(site.lockAddress).arg(site.file).arg(site.line).arg(site.function);
+        auto it = indexById.constFind(id);
+        if (it == indexById.constEnd()) {
+            indexById.insert(id, merged.size());
+            merged.append(site);
+            continue;
+        }
+        Site &target = merged[it.value()];
+        if (site.waitNs > target.waitNs || (target.waitNs == 0 && site.holdNs > target.holdNs)) {
+            target.frames = site.frames;
+        }
+        target.acquisitions += site.acquisitions;
+        target.contentions += site.contentions;
+        target.waitNs += site.waitNs;
+        target.holdNs += site.holdNs;
+    }
+
+    std::sort(merged.begin(), merged.end(), [](const Site &a, const Site &b) {
+        return a.waitNs != b.waitNs ? a.waitNs > b.waitNs : a.holdNs > b.holdNs;
+    });
+    report.sites = merged;
+
+    std::sort(report.locks.begin(), report.locks.end(), [](const Lock &a, const Lock &b) {
+        if (a.waitNs != b.waitNs) return a.waitNs > b.waitNs;
+        return a.contentions != b.contentions ? a.contentions > b.contentions : a.acquisitions > b.acquisitions;
+    });
+}
+
+void LockProfiler::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // 与内存分析相同，addr2line 在工作线程中运行，this 只在界面线程中检查
+    QPointer<LockProfiler> guard(this);
+    const int run = generation;
+    QThreadPool::globalInstance()->start(QRunnable::create(
+        [guard, run, report = report, executable = executable, exitCode, exitStatus]() mutable {
+            symbolize(report, executable);
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, run, report, exitCode, exitStatus]() {
+                if (guard && guard->generation == run) emit guard->finished(report, exitCode, exitStatus);
+            }, Qt::QueuedConnection);
+        }));
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QProcess>
+
+#include "preloadprocess.h"
+
+// 锁竞争分析
+// 运行程序时通过 LD_PRELOAD 注入 liblioncpp_lockprof.so，拦截 pthread 互斥量、读写锁和条件变量，
+// 程序结束后读回每把锁的获取、竞争、等待和持有统计，以及按获取位置汇总的同样统计和调用栈。
+class LockProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 一个获取锁的位置，已归到第一个用户源码帧所在的行
+    struct Site
+    {
+        quint64 lockAddress = 0;
+        QString file;
+        int line = 0;
+        QString function;
+        quint64 acquisitions = 0;
+        quint64 contentions = 0;
+        quint64 waitNs = 0;
+        quint64 holdNs = 0;             // 从这里获取后持有的总时间
+        QList<StackFrame> frames;
+    };
+
+    struct Lock
+    {
+        quint64 address = 0;
+        bool condition = false;         // 条件变量（等待时间是 wait 中阻塞的时间）
+        bool readWrite = false;         // 读写锁，读锁可能被多个线程同时持有，持有时间按线程累加
+        quint64 acquisitions = 0;
+        quint64 contentions = 0;
+        quint64 waitNs = 0;
+        quint64 maxWaitNs = 0;
+        quint64 holdNs = 0;
+
+        double contentionRate() const { return acquisitions > 0 ? double(contentions) / acquisitions : 0; }
+    };
+
+    struct Report
+    {
+        QList<Lock> locks;              // 按等待时间从大到小
+        QList<Site> sites;              // 按等待时间、持有时间从大到小
+        bool complete = false;          // 收到了拦截库的结束标记
+    };
+
+    explicit LockProfiler(QObject *parent = nullptr);
+
+    static QString libraryPath();
+    static QStringList compileFlags();
+
+    bool start(const QString &executable, const QString &workingDirectory, QString *errorMessage = nullptr);
+    void stop();
+    bool isRunning() const { return process->isRunning(); }
+
+    static void parseLine(const QByteArray &line, Report &report);
+    // 符号化调用栈，同一把锁在同一行的获取位置合并，并按等待时间排序
+    static void symbolize(Report &report, const QString &executable);
+
+signals:
+    void output(const QString &text);
+    void finished(const LockProfiler::Report &report, int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    PreloadProcess *process;
+    Report report;
+    QString executable;
+    int generation;                 // 每次启动递增，丢弃上一次运行的符号化结果
+};
@@ -0,0 +1,94 @@
+#include "measurementdialog.h"
+#include "processrunner.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QPushButton>
+#include <QDialogButtonBox>
+
+MeasurementDialog::MeasurementDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("测量环境");
+    resize(560, 360);
+
+    MeasurementEnvironment::Options options = MeasurementEnvironment::loadOptions();
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *formLayout = new QFormLayout();
+    cpusEdit = new QLineEdit(MeasurementEnvironment::formatCpuList(options.cpus), this);
+    cpusEdit->setPlaceholderText("例如 2,3 或 2-5，为空表示不绑定");
+    cpusEdit->setToolTip(QString("本进程可用的 CPU: %1")
+                         .arg(MeasurementEnvironment::formatCpuList(ProcessRunner::availableCpus())));
+    priorityCheck = new QCheckBox("提高被测程序的优先级", this);
+    priorityCheck->setChecked(options.raisePriority);
+    formLayout->addRow("绑定核心:", cpusEdit);
+    formLayout->addRow(QString(), priorityCheck);
+    layout->addLayout(formLayout);
+
+    errorLabel = new QLabel(this);
+    errorLabel->setStyleSheet("color: #f44747;");
+    layout->addWidget(errorLabel);
+
+    QHBoxLayout *checkLayout = new QHBoxLayout();
+    checkLayout->addWidget(new QLabel("当前状态:", this));
+    checkLayout->addStretch();
+    QPushButton *refreshButton = new QPushButton("重新检查", this);
+    checkLayout->addWidget(refreshButton);
+    layout->addLayout(checkLayout);
+
+    checkView = new QPlainTextEdit(this);
+    checkView->setReadOnly(true);
+    layout->addWidget(checkView, 1);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    layout->addWidget(buttons);
+
+    connect(refreshButton, &QPushButton::clicked, this, &MeasurementDialog::refresh);
+    connect(cpusEdit, &QLineEdit::editingFinished, this, &MeasurementDialog::refresh);
+    connect(priorityCheck, &QCheckBox::toggled, this, &MeasurementDialog::refresh);
+    connect(buttons, &QDialogButtonBox::accepted, this, &MeasurementDialog::onAccepted);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    refresh();
+}
+
+MeasurementEnvironment::Options MeasurementDialog::currentOptions(bool *ok) const
+{
+    MeasurementEnvironment::Options options;
+    options.cpus = MeasurementEnvironment::parseCpuList(cpusEdit->text(), ok);
+    options.raisePriority = priorityCheck->isChecked();
+    return options;
+}
+
+void MeasurementDialog::refresh()
+{
+    bool ok = true;
+    MeasurementConditions conditions = MeasurementEnvironment::check(currentOptions(&ok));
+    errorLabel->setText(ok ? QString() : "核心列表格式不正确");
+    errorLabel->setVisible(!ok);
+
+    QStringList lines;
+    lines << MeasurementEnvironment::summary(conditions);
+    lines << QString();
+    if (conditions.warnings.isEmpty()) {
+        lines << "没有发现会影响测量的问题";
+    } else {
+        for (const QString &warning : std::as_const(conditions.warnings)) {
+            lines << "⚠ " + warning;
+        }
+    }
+    checkView->setPlainText(lines.join('\n'));
+}
+
+void MeasurementDialog::onAccepted()
+{
+    bool ok = true;
+    MeasurementEnvironment::Options options = currentOptions(&ok);
+    if (!ok) {
+        refresh();
+        return;
+    }
+    MeasurementEnvironment::saveOptions(options);
+    accept();
+}
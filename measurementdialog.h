@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QLabel>
+#include <QPlainTextEdit>
+
+#include "measurementenvironment.h"
+
+// 测量环境对话框
+// 设置计时运行绑定的核心和优先级，并显示当前系统状态的检查结果
+class MeasurementDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MeasurementDialog(QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+    void onAccepted();
+
+private:
+    MeasurementEnvironment::Options currentOptions(bool *ok) const;
+
+    QLineEdit *cpusEdit;
+    QCheckBox *priorityCheck;
+    QLabel *errorLabel;
+    QPlainTextEdit *checkView;
+};
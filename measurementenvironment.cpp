@@ -0,0 +1,279 @@
+#include "measurementenvironment.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QProcess>
+#include <QSettings>
+#include <QThread>
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#endif
+
+namespace {
+// 提高优先级时使用的 nice 值
+const int RaisedNiceValue = -10;
+// 1 分钟平均负载超过该值时提示后台有其他任务
+const double LoadWarningThreshold = 1.0;
+}
+
+MeasurementEnvironment::Options MeasurementEnvironment::loadOptions()
+{
+    QSettings settings("LionCPP", "IDE");
+    Options options;
+    options.cpus = parseCpuList(settings.value("measure/cpus").toString());
+    options.raisePriority = settings.value("measure/raisePriority", false).toBool();
+    return options;
+}
+
+void MeasurementEnvironment::saveOptions(const Options &options)
+{
+    QSettings settings("LionCPP", "IDE");
+    settings.setValue("measure/cpus", formatCpuList(options.cpus));
+    settings.setValue("measure/raisePriority", options.raisePriority);
+}
+
+QList<int> MeasurementEnvironment::parseCpuList(const QString &text, bool *ok)
+{
+    QList<int> cpus;
+    bool valid = true;
+    const QStringList parts = text.split(',', Qt::SkipEmptyParts);
+    for (const QString &part : parts) {
+        QStringList range = part.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        int first = range.value(0).toInt(&firstOk);
+        int last = range.size() == 2 ? range.at(1).toInt(&lastOk) : first;
+        if (range.size() == 1) lastOk = firstOk;
+        if (!firstOk || !lastOk || range.size() > 2 || first < 0 || last < first) {
+            valid = false;
+            continue;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (!cpus.contains(cpu)) cpus.append(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    if (ok) *ok = valid;
+    return cpus;
+}
+
+QString MeasurementEnvironment::formatCpuList(const QList<int> &cpus)
+{
+    QStringList parts;
+    for (int i = 0; i < cpus.size(); ) {
+        int j = i;
+        while (j + 1 < cpus.size() && cpus.at(j + 1) == cpus.at(j) + 1) ++j;
+        parts << (j > i ? QString("%1-%2").arg(cpus.at(i)).arg(cpus.at(j)) : QString::number(cpus.at(i)));
+        i = j + 1;
+    }
+    return parts.join(',');
+}
+
+QString MeasurementEnvironment::readSysFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    return QString::fromLatin1(file.readAll()).trimmed();
+}
+
+bool MeasurementEnvironment::canRaisePriority(int niceValue)
+{
+#ifdef Q_OS_UNIX
+#ifdef Q_OS_LINUX
+    // 是否能调低 nice 值由 CAP_SYS_NICE（第 23 位）决定，而不是看是否为 root：
+    // 容器中的 root 可能没有该能力，普通用户的程序也可能被单独授予
+    const QString status = readSysFile("/proc/self/status");
+    for (const QString &line : status.split('\n')) {
+        if (!line.startsWith("CapEff:")) continue;
+        bool ok = false;
+        const quint64 capabilities = line.mid(7).trimmed().toULongLong(&ok, 16);
+        if (ok && (capabilities & (quint64(1) << 23))) return true;
+        break;
+    }
+#else
+    if (::geteuid() == 0) return true;
+#endif
+#ifdef RLIMIT_NICE
+    // RLIMIT_NICE 允许的最低 nice 值为 20 - rlim_cur，不限制时任意值都可以
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NICE, &limit) == 0) {
+        if (limit.rlim_cur == RLIM_INFINITY) return true;
+        return 20 - static_cast<int>(limit.rlim_cur) <= niceValue;
+    }
+#else
+    Q_UNUSED(niceValue)
+#endif
+    return false;
+#else
+    Q_UNUSED(niceValue)
+    return false;
+#endif
+}
+
+MeasurementConditions MeasurementEnvironment::check(const Options &options)
+{
+    MeasurementConditions conditions;
+    conditions.timestamp = QDateTime::currentDateTime();
+    conditions.cpuCount = QThread::idealThreadCount();
+
+    const QList<int> available = ProcessRunner::availableCpus();
+    QList<int> rejected;
+    for (int cpu : options.cpus) {
+        if (available.contains(cpu)) {
+            conditions.cpus.append(cpu);
+        } else {
+            rejected.append(cpu);
+        }
+    }
+    if (!rejected.isEmpty()) {
+        conditions.warnings << QString("CPU %1 不存在或不允许使用，已忽略").arg(formatCpuList(rejected));
+    }
+
+    if (options.raisePriority) {
+        if (canRaisePriority(RaisedNiceValue)) {
+            conditions.niceValue = RaisedNiceValue;
+        } else {
+            conditions.warnings << "没有权限提高优先级（需要 root、CAP_SYS_NICE 或足够的 RLIMIT_NICE），按普通优先级运行";
+        }
+    }
+
+    // 调频策略：只检查实际会用到的核心
+    const QList<int> usedCpus = conditions.cpus.isEmpty() ? available : conditions.cpus;
+    QStringList slowCpus;
+    for (int cpu : usedCpus) {
+        QString governor = readSysFile(QString("/sys/devices/system/cpu/cpu%1/cpufreq/scaling_governor").arg(cpu));
+        if (governor.isEmpty()) continue;
+        if (!conditions.governors.contains(governor)) conditions.governors.append(governor);
+        if (governor != "performance") slowCpus << QString::number(cpu);
+    }
+    if (!slowCpus.isEmpty()) {
+        conditions.warnings << QString("调频策略为 %1 而不是 performance，频率会随负载变化（涉及 %2 个核心）")
+                               .arg(conditions.governors.join('/')).arg(slowCpus.size());
+    }
+
+    // 睿频：intel_pstate 用 no_turbo，acpi-cpufreq 等用 boost
+    QString noTurbo = readSysFile("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    QString boost = readSysFile("/sys/devices/system/cpu/cpufreq/boost");
+    if (!noTurbo.isEmpty()) {
+        conditions.turbo = noTurbo == "1" ? TurboState::Disabled : TurboState::Enabled;
+    } else if (!boost.isEmpty()) {
+        conditions.turbo = boost == "1" ? TurboState::Enabled : TurboState::Disabled;
+    }
+    if (conditions.turbo == TurboState::Enabled) {
+        conditions.warnings << "睿频已开启，频率受温度和其他核心负载影响";
+    }
+
+    QString loadAverage = readSysFile("/proc/loadavg");
+    if (!loadAverage.isEmpty()) {
+        conditions.loadAverage = loadAverage.section(' ', 0, 0).toDouble();
+        if (conditions.loadAverage > LoadWarningThreshold) {
+            conditions.warnings << QString("1 分钟平均负载为 %1，后台有其他任务在运行").arg(conditions.loadAverage, 0, 'f', 2);
+        }
+    }
+
+    return conditions;
+}
+
+void MeasurementEnvironment::applyTo(ProcessRunner::Spec &spec, const MeasurementConditions &conditions)
+{
+    spec.cpuAffinity = conditions.cpus;
+    spec.niceValue = conditions.niceValue;
+}
+
+void MeasurementEnvironment::applyTo(QProcess *process, const MeasurementConditions &conditions)
+{
+#ifdef Q_OS_UNIX
+    const QList<int> cpus = conditions.cpus;
+    const int niceValue = conditions.niceValue;
+    if (cpus.isEmpty() && niceValue == 0) {
+        process->setChildProcessModifier(std::function<void()>());
+        return;
+    }
+#ifdef Q_OS_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpuSet);
+    }
+#endif
+    process->setChildProcessModifier([=]() {
+#ifdef Q_OS_LINUX
+        if (!cpus.isEmpty()) ::sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+#endif
+        if (niceValue != 0) ::setpriority(PRIO_PROCESS, 0, niceValue);
+    });
+#else
+    Q_UNUSED(process)
+    Q_UNUSED(conditions)
+#endif
+}
+
+QString MeasurementEnvironment::turboName(TurboState state)
+{
+    switch (state) {
+    case TurboState::Enabled:  return "开启";
+    case TurboState::Disabled: return "关闭";
+    case TurboState::Unknown:  break;
+    }
+    return "未知";
+}
+
+QString MeasurementEnvironment::summary(const MeasurementConditions &conditions)
+{
+    QStringList parts;
+    parts << conditions.timestamp.toString("yyyy-MM-dd HH:mm:ss");
+    parts << (conditions.cpus.isEmpty() ? QString("未绑定核心") : "CPU " + formatCpuList(conditions.cpus));
+    parts << QString("nice %1").arg(conditions.niceValue);
+    parts << "调频 " + (conditions.governors.isEmpty() ? QString("未知") : conditions.governors.join('/'));
+    parts << "睿频" + turboName(conditions.turbo);
+    if (conditions.loadAverage >= 0) {
+        parts << QString("负载 %1").arg(conditions.loadAverage, 0, 'f', 2);
+    }
+    return parts.join("，");
+}
+
+QJsonObject MeasurementEnvironment::toJson(const MeasurementConditions &conditions)
+{
+    QJsonArray cpus;
+    for (int cpu : conditions.cpus) cpus.append(cpu);
+
+    QJsonObject object;
+    object["timestamp"] = conditions.timestamp.toString(Qt::ISODate);
+    object["cpus"] = cpus;
+    object["nice"] = conditions.niceValue;
+    object["governors"] = QJsonArray::fromStringList(conditions.governors);
+    object["turbo"] = conditions.turbo == TurboState::Enabled ? "enabled"
+                      : conditions.turbo == TurboState::Disabled ? "disabled" : "unknown";
+    object["load_average"] = conditions.loadAverage;
+    object["cpu_count"] = conditions.cpuCount;
+    object["warnings"] = QJsonArray::fromStringList(conditions.warnings);
+    return object;
+}
+
+MeasurementConditions MeasurementEnvironment::fromJson(const QJsonObject &object)
+{
+    MeasurementConditions conditions;
+    conditions.timestamp = QDateTime::fromString(object.value("timestamp").toString(), Qt::ISODate);
+    for (const QJsonValue &cpu : object.value("cpus").toArray()) {
+        conditions.cpus.append(cpu.toInt());
+    }
+    conditions.niceValue = object.value("nice").toInt();
+    for (const QJsonValue &governor : object.value("governors").toArray()) {
+        conditions.governors.append(governor.toString());
+    }
+    QString turbo = object.value("turbo").toString();
+    conditions.turbo = turbo == "enabled" ? TurboState::Enabled
+                       : turbo == "disabled" ? TurboState::Disabled : TurboState::Unknown;
+    conditions.loadAverage = object.value("load_average").toDouble(-1);
+    conditions.cpuCount = object.value("cpu_count").toInt();
+    for (const QJsonValue &warning : object.value("warnings").toArray()) {
+        conditions.warnings.append(warning.toString());
+    }
+    return conditions;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDateTime>
+#include <QJsonObject>
+
+#include "processrunner.h"
+
+class QProcess;
+
+enum class TurboState
+{
+    Unknown,
+    Enabled,
+    Disabled
+};
+
+// 测量条件
+// 记录每次计时时的核心绑定、优先级、调频策略、睿频和系统负载，
+// 与结果一起保存，便于判断两次结果是否可比
+struct MeasurementConditions
+{
+    QDateTime timestamp;
+    QList<int> cpus;            // 绑定的 CPU，为空表示不限制
+    int niceValue = 0;          // 实际使用的 nice 值
+    QStringList governors;      // 所用 CPU 的调频策略（去重）
+    TurboState turbo = TurboState::Unknown;
+    double loadAverage = -1;    // 1 分钟平均负载，-1 表示无法读取
+    int cpuCount = 0;
+    QStringList warnings;
+};
+
+// 测量环境控制（降低基准测试噪声）
+// 选项保存在设置的 measure/ 下，运行菜单中的各种计时功能共用
+class MeasurementEnvironment
+{
+public:
+    struct Options
+    {
+        QList<int> cpus;
+        bool raisePriority = false;
+    };
+
+    static Options loadOptions();
+    static void saveOptions(const Options &options);
+
+    // "2,3" 或 "2-5,8" 格式
+    static QList<int> parseCpuList(const QString &text, bool *ok = nullptr);
+    static QString formatCpuList(const QList<int> &cpus);
+
+    // 读取当前系统状态，给出实际生效的绑定和优先级以及需要注意的问题
+    static MeasurementConditions check(const Options &options);
+    static MeasurementConditions check() { return check(loadOptions()); }
+
+    static void applyTo(ProcessRunner::Spec &spec, const MeasurementConditions &conditions);
+    static void applyTo(QProcess *process, const MeasurementConditions &conditions);
+
+    static QString turboName(TurboState state);
+    static QString summary(const MeasurementConditions &conditions);
+    static QJsonObject toJson(const MeasurementConditions &conditions);
+    static MeasurementConditions fromJson(const QJsonObject &object);
+
+private:
+    static QString readSysFile(const QString &path);
+    static bool canRaisePriority(int niceValue);
+};
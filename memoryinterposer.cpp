@@ -0,0 +1,490 @@
+// 内存分析拦截库（liblioncpp_memprof.so）
+// 通过 LD_PRELOAD 注入被测程序，替换 malloc/free/realloc 及各种对齐分配函数，统计分配次数、字节数和峰值堆大小，
+// 并按采样间隔记录分配时的调用栈。结果以文本行写入 LIONCPP_MEMPROF_FD 指定的管道：
+//   T <分配次数> <释放次数> <分配字节> <当前占用> <峰值占用>
+//   S <估计次数> <估计字节>        一个采样调用栈，后面跟若干 F 行
+//   F <偏移(十六进制)> <模块路径>
+//   E                             正常结束
+// 拦截函数里不能再分配内存，因此这里不使用标准库容器和 printf 系列函数。
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <malloc.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+using MallocFunction = void *(*)(size_t);
+using FreeFunction = void (*)(void *);
+using CallocFunction = void *(*)(size_t, size_t);
+using ReallocFunction = void *(*)(void *, size_t);
+using PosixMemalignFunction = int (*)(void **, size_t, size_t);
+using AlignedAllocFunction = void *(*)(size_t, size_t);
+using PageAllocFunction = void *(*)(size_t);
+
+MallocFunction realMalloc = nullptr;
+FreeFunction realFree = nullptr;
+CallocFunction realCalloc = nullptr;
+ReallocFunction realRealloc = nullptr;
+PosixMemalignFunction realPosixMemalign = nullptr;
+AlignedAllocFunction realAlignedAlloc = nullptr;
+AlignedAllocFunction realMemalign = nullptr;
+PageAllocFunction realValloc = nullptr;
+PageAllocFunction realPvalloc = nullptr;
+
+const int MaxFrames = 32;
+const int StackTableSize = 8192;            // 必须是 2 的幂
+const long DefaultSampleRate = 64;
+const long TotalsIntervalNs = 250 * 1000 * 1000;
+
+// dlsym 本身会调用 calloc，真正的函数找到之前先从这里分配
+const size_t BootstrapSize = 64 * 1024;
+alignas(16) char bootstrapBuffer[BootstrapSize];
+size_t bootstrapUsed = 0;
+
+struct StackEntry
+{
+    bool used;
+    uint64_t hash;
+    int depth;
+    void *frames[MaxFrames];
+    uint64_t count;
+    uint64_t bytes;
+};
+
+StackEntry stackTable[StackTableSize];
+std::atomic_flag stackLock = ATOMIC_FLAG_INIT;
+std::atomic_flag writeLock = ATOMIC_FLAG_INIT;
+
+std::atomic<uint64_t> allocationCount(0);
+std::atomic<uint64_t> freeCount(0);
+std::atomic<uint64_t> allocatedBytes(0);
+std::atomic<int64_t> liveBytes(0);
+std::atomic<int64_t> peakBytes(0);
+std::atomic<uint64_t> droppedSamples(0);
+std::atomic<int64_t> lastTotalsNs(0);
+
+int outputFd = -1;
+long sampleRate = DefaultSampleRate;
+std::atomic<int> initState(0);              // 0 未初始化，1 初始化中，2 完成
+bool finished = false;
+
+__thread bool inHook __attribute__((tls_model("initial-exec"))) = false;
+__thread long sampleCountdown __attribute__((tls_model("initial-exec"))) = 0;
+__thread uint32_t randomState __attribute__((tls_model("initial-exec"))) = 0;
+
+class LineBuffer
+{
+public:
+    void append(const char *text)
+    {
+        while (*text && length < sizeof(data)) data[length++] = *text++;
+    }
+
+    void appendNumber(uint64_t value, int base = 10)
+    {
+        char digits[24];
+        int count = 0;
+        do {
+            digits[count++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value > 0);
+        while (count > 0 && length < sizeof(data)) data[length++] = digits[--count];
+    }
+
+    void flush()
+    {
+        size_t written = 0;
+        while (written < length) {
+            ssize_t count = ::write(outputFd, data + written, length - written);
+            if (count <= 0) break;
+            written += static_cast<size_t>(count);
+        }
+        length = 0;
+    }
+
+    size_t size() const { return length; }
+
+private:
+    char data[4096];
+    size_t length = 0;
+};
+
+void initialize()
+{
+    int expected = 0;
+    if (!initState.compare_exchange_strong(expected, 1)) return;
+
+    realMalloc = reinterpret_cast<MallocFunction>(dlsym(RTLD_NEXT, "malloc"));
+    realFree = reinterpret_cast<FreeFunction>(dlsym(RTLD_NEXT, "free"));
+    realCalloc = reinterpret_cast<CallocFunction>(dlsym(RTLD_NEXT, "calloc"));
+    realRealloc = reinterpret_cast<ReallocFunction>(dlsym(RTLD_NEXT, "realloc"));
+    realPosixMemalign = reinterpret_cast<PosixMemalignFunction>(dlsym(RTLD_NEXT, "posix_memalign"));
+    realAlignedAlloc = reinterpret_cast<AlignedAllocFunction>(dlsym(RTLD_NEXT, "aligned_alloc"));
+    realMemalign = reinterpret_cast<AlignedAllocFunction>(dlsym(RTLD_NEXT, "memalign"));
+    realValloc = reinterpret_cast<PageAllocFunction>(dlsym(RTLD_NEXT, "valloc"));
+    realPvalloc = reinterpret_cast<PageAllocFunction>(dlsym(RTLD_NEXT, "pvalloc"));
+
+    if (const char *fd = getenv("LIONCPP_MEMPROF_FD")) outputFd = static_cast<int>(strtol(fd, nullptr, 10));
+    if (const char *rate = getenv("LIONCPP_MEMPROF_RATE")) sampleRate = strtol(rate, nullptr, 10);
+    if (sampleRate < 1) sampleRate = 1;
+
+    initState.store(2);
+}
+
+bool isBootstrap(void *ptr)
+{
+    char *p = static_cast<char*>(ptr);
+    return p >= bootstrapBuffer && p < bootstrapBuffer + BootstrapSize;
+}
+
+// 每块前面保存大小，realloc 时需要知道复制多少
+void *bootstrapAllocate(size_t size)
+{
+    size_t total = (sizeof(size_t) + size + 15) & ~static_cast<size_t>(15);
+    if (bootstrapUsed + total > BootstrapSize) return nullptr;
+    char *block = bootstrapBuffer + bootstrapUsed;
+    bootstrapUsed += total;
+    *reinterpret_cast<size_t*>(block) = size;
+    return block + sizeof(size_t);
+}
+
+size_t bootstrapSize(void *ptr)
+{
+    return *reinterpret_cast<size_t*>(static_cast<char*>(ptr) - sizeof(size_t));
+}
+
+int64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void acquire(std::atomic_flag &lock)
+{
+    while (lock.test_and_set(std::memory_order_acquire)) {
+    }
+}
+
+void release(std::atomic_flag &lock)
+{
+    lock.clear(std::memory_order_release);
+}
+
+// 下一次采样前要跳过的分配次数：在 [1, 2 * rate - 1] 内均匀分布，平均为 rate，
+// 避免固定间隔与程序中的循环步长同步
+long nextSampleInterval()
+{
+    if (sampleRate <= 1) return 1;
+    if (randomState == 0) {
+        randomState = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&randomState) >> 4) | 1;
+    }
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return 1 + static_cast<long>(randomState % static_cast<uint32_t>(2 * sampleRate - 1));
+}
+
+void writeTotals()
+{
+    if (outputFd < 0) return;
+    LineBuffer line;
+    line.append("T ");
+    line.appendNumber(allocationCount.load());
+    line.append(" ");
+    line.appendNumber(freeCount.load());
+    line.append(" ");
+    line.appendNumber(allocatedBytes.load());
+    line.append(" ");
+    line.appendNumber(static_cast<uint64_t>(liveBytes.load() > 0 ? liveBytes.load() : 0));
+    line.append(" ");
+    line.appendNumber(static_cast<uint64_t>(peakBytes.load()));
+    line.append("\n");
+    acquire(writeLock);
+    line.flush();
+    release(writeLock);
+}
+
+__attribute__((noinline)) void recordSample(size_t size)
+{
+    void *frames[MaxFrames];
+    int depth = backtrace(frames, MaxFrames);
+    // 去掉 recordSample、recordAllocation 和拦截函数本身
+    const int skip = 3;
+    if (depth <= skip) return;
+
+    uint64_t hash = 1469598103934665603ULL;
+    for (int i = skip; i < depth; ++i) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ULL;
+    }
+
+    acquire(stackLock);
+    uint64_t index = hash & (StackTableSize - 1);
+    StackEntry *entry = nullptr;
+    for (int probe = 0; probe < StackTableSize; ++probe) {
+        StackEntry &candidate = stackTable[(index + probe) & (StackTableSize - 1)];
+        if (!candidate.used) {
+            candidate.used = true;
+            candidate.hash = hash;
+            candidate.depth = depth - skip;
+            memcpy(candidate.frames, frames + skip, sizeof(void*) * candidate.depth);
+            entry = &candidate;
+            break;
+        }
+        if (candidate.hash == hash && candidate.depth == depth - skip
+            && memcmp(candidate.frames, frames + skip, sizeof(void*) * candidate.depth) == 0) {
+            entry = &candidate;
+            break;
+        }
+    }
+    if (entry) {
+        entry->count += static_cast<uint64_t>(sampleRate);
+        entry->bytes += static_cast<uint64_t>(size) * static_cast<uint64_t>(sampleRate);
+    } else {
+        droppedSamples.fetch_add(1);
+    }
+    release(stackLock);
+
+    int64_t now = nowNs();
+    int64_t last = lastTotalsNs.load();
+    if (now - last >= TotalsIntervalNs && lastTotalsNs.compare_exchange_strong(last, now)) {
+        writeTotals();
+    }
+}
+
+__attribute__((noinline)) void recordAllocation(void *ptr, size_t size)
+{
+    if (!ptr || finished) return;
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    int64_t usable = static_cast<int64_t>(malloc_usable_size(ptr));
+    int64_t live = liveBytes.fetch_add(usable, std::memory_order_relaxed) + usable;
+    int64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    if (--sampleCountdown <= 0) {
+        sampleCountdown = nextSampleInterval();
+        recordSample(size);
+    }
+}
+
+void recordFree(void *ptr)
+{
+    if (!ptr || finished) return;
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+    liveBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+}
+
+// 进程退出时输出所有采样栈。地址换算为“模块 + 偏移”，由 IDE 调用 addr2line 解析
+void writeReport()
+{
+    if (outputFd < 0) return;
+    inHook = true;
+    finished = true;
+    writeTotals();
+
+    acquire(writeLock);
+    acquire(stackLock);
+    LineBuffer line;
+    for (int i = 0; i < StackTableSize; ++i) {
+        const StackEntry &entry = stackTable[i];
+        if (!entry.used) continue;
+        line.append("S ");
+        line.appendNumber(entry.count);
+        line.append(" ");
+        line.appendNumber(entry.bytes);
+        line.append("\n");
+        for (int f = 0; f < entry.depth; ++f) {
+            Dl_info info;
+            if (!dladdr(entry.frames[f], &info) || !info.dli_fname) continue;
+            // 返回地址指向调用指令的下一条，减一才落在调用所在的行
+            uintptr_t offset = reinterpret_cast<uintptr_t>(entry.frames[f]) - 1
+                               - reinterpret_cast<uintptr_t>(info.dli_fbase);
+            line.append("F ");
+            line.appendNumber(offset, 16);
+            line.append(" ");
+            line.append(info.dli_fname);
+            line.append("\n");
+            if (line.size() > 3072) line.flush();
+        }
+    }
+    line.append("E\n");
+    line.flush();
+    release(stackLock);
+    release(writeLock);
+    ::close(outputFd);
+    outputFd = -1;
+}
+
+__attribute__((constructor)) void onLoad()
+{
+    initialize();
+    // backtrace 第一次调用时会加载 libgcc_s，提前完成，避免在采样时递归分配
+    inHook = true;
+    void *frames[2];
+    backtrace(frames, 2);
+    inHook = false;
+}
+
+__attribute__((destructor)) void onUnload()
+{
+    writeReport();
+}
+
+} // namespace
+
+extern "C" {
+
+void *malloc(size_t size)
+{
+    if (initState.load() != 2) {
+        initialize();
+        if (!realMalloc) return bootstrapAllocate(size);
+    }
+    if (inHook) return realMalloc(size);
+    inHook = true;
+    void *ptr = realMalloc(size);
+    recordAllocation(ptr, size);
+    inHook = false;
+    return ptr;
+}
+
+void free(void *ptr)
+{
+    if (!ptr || isBootstrap(ptr)) return;
+    if (!realFree) initialize();
+    if (inHook) {
+        realFree(ptr);
+        return;
+    }
+    inHook = true;
+    recordFree(ptr);
+    realFree(ptr);
+    inHook = false;
+}
+
+void *calloc(size_t count, size_t size)
+{
+    if (initState.load() != 2) {
+        initialize();
+        if (!realCalloc) {
+            // bootstrapBuffer 是静态存储，初始为零
+            return count && size > static_cast<size_t>(-1) / count ? nullptr : bootstrapAllocate(count * size);
+        }
+    }
+    if (inHook) return realCalloc(count, size);
+    inHook = true;
+    void *ptr = realCalloc(count, size);
+    recordAllocation(ptr, count * size);
+    inHook = false;
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    if (initState.load() != 2) initialize();
+    if (ptr && isBootstrap(ptr)) {
+        void *moved = malloc(size);
+        if (moved) {
+            size_t oldSize = bootstrapSize(ptr);
+            memcpy(moved, ptr, oldSize < size ? oldSize : size);
+        }
+        return moved;
+    }
+    if (!realRealloc) return nullptr;
+    if (inHook) return realRealloc(ptr, size);
+    inHook = true;
+    recordFree(ptr);
+    void *result = realRealloc(ptr, size);
+    if (result) {
+        recordAllocation(result, size);
+    } else if (ptr && size > 0) {
+        // 失败时原来的块仍然有效，撤销上面的释放统计
+        freeCount.fetch_sub(1, std::memory_order_relaxed);
+        liveBytes.fetch_add(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    }
+    inHook = false;
+    return result;
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size)
+{
+    if (initState.load() != 2) initialize();
+    if (!realPosixMemalign) return 12;     // ENOMEM
+    if (inHook) return realPosixMemalign(result, alignment, size);
+    inHook = true;
+    int error = realPosixMemalign(result, alignment, size);
+    if (error == 0) recordAllocation(*result, size);
+    inHook = false;
+    return error;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    if (initState.load() != 2) initialize();
+    if (!realAlignedAlloc) return nullptr;
+    if (inHook) return realAlignedAlloc(alignment, size);
+    inHook = true;
+    void *ptr = realAlignedAlloc(alignment, size);
+    recordAllocation(ptr, size);
+    inHook = false;
+    return ptr;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    if (initState.load() != 2) initialize();
+    if (!realMemalign) return nullptr;
+    if (inHook) return realMemalign(alignment, size);
+    inHook = true;
+    void *ptr = realMemalign(alignment, size);
+    recordAllocation(ptr, size);
+    inHook = false;
+    return ptr;
+}
+
+void *valloc(size_t size)
+{
+    if (initState.load() != 2) initialize();
+    if (!realValloc) return nullptr;
+    if (inHook) return realValloc(size);
+    inHook = true;
+    void *ptr = realValloc(size);
+    recordAllocation(ptr, size);
+    inHook = false;
+    return ptr;
+}
+
+void *pvalloc(size_t size)
+{
+    if (initState.load() != 2) initialize();
+    if (!realPvalloc) return nullptr;
+    if (inHook) return realPvalloc(size);
+    inHook = true;
+    void *ptr = realPvalloc(size);
+    recordAllocation(ptr, size);
+    inHook = false;
+    return ptr;
+}
+
+// glibc 的 reallocarray 在库内部直接调用 realloc 的实现，不经过上面的 realloc，这里自己检查溢出后转给它
+void *reallocarray(void *ptr, size_t count, size_t size)
+{
+    if (count && size > static_cast<size_t>(-1) / count) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    return realloc(ptr, count * size);
+}
+
+}
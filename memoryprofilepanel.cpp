@@ -0,0 +1,206 @@
+#include "memoryprofilepanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileInfo>
+#include <QSettings>
+
+namespace {
+enum LineColumn { LocationColumn, FunctionColumn, CountColumn, BytesColumn, ShareColumn, LineColumnCount };
+
+// 调用栈页只显示分配字节最多的若干个
+const int MaxStacks = 50;
+
+const int FileRole = Qt::UserRole;
+const int LineRole = Qt::UserRole + 1;
+const int SortRole = Qt::UserRole + 2;
+
+// 按数值排序的表格项
+class NumericTreeItem : public QTreeWidgetItem
+{
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem &other) const override
+    {
+        int column = treeWidget() ? treeWidget()->sortColumn() : 0;
+        QVariant a = data(column, SortRole);
+        QVariant b = other.data(column, SortRole);
+        if (a.isValid() && b.isValid()) return a.toDouble() < b.toDouble();
+        return QTreeWidgetItem::operator<(other);
+    }
+};
+}
+
+MemoryProfilePanel::MemoryProfilePanel(QWidget *parent)
+    : QWidget(parent)
+    , profiler(new MemoryProfiler(this))
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *topLayout = new QHBoxLayout();
+    sampleRateSpinBox = new QSpinBox(this);
+    sampleRateSpinBox->setRange(1, 100000);
+    sampleRateSpinBox->setValue(QSettings("LionCPP", "IDE").value("memprof/sampleRate", 64).toInt());
+    sampleRateSpinBox->setToolTip("平均每多少次分配记录一次调用栈，1 表示全部记录（开销最大）");
+    summaryLabel = new QLabel("通过“运行 > 内存分析运行”启动", this);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    topLayout->addWidget(new QLabel("采样间隔:", this));
+    topLayout->addWidget(sampleRateSpinBox);
+    topLayout->addWidget(summaryLabel, 1);
+    layout->addLayout(topLayout);
+
+    tabWidget = new QTabWidget(this);
+
+    lineTree = new QTreeWidget(this);
+    lineTree->setColumnCount(LineColumnCount);
+    lineTree->setHeaderLabels(QStringList() << "位置" << "函数" << "分配次数" << "分配字节" << "占比");
+    lineTree->setRootIsDecorated(false);
+    lineTree->setSortingEnabled(true);
+    lineTree->header()->setSectionResizeMode(FunctionColumn, QHeaderView::Stretch);
+    tabWidget->addTab(lineTree, "按源码行");
+
+    stackTree = new QTreeWidget(this);
+    stackTree->setColumnCount(2);
+    stackTree->setHeaderLabels(QStringList() << "调用栈" << "位置");
+    stackTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    tabWidget->addTab(stackTree, "按调用栈");
+
+    layout->addWidget(tabWidget, 1);
+
+    connect(profiler, &MemoryProfiler::output, this, &MemoryProfilePanel::output);
+    connect(profiler, &MemoryProfiler::totalsUpdated, this, &MemoryProfilePanel::onTotalsUpdated);
+    connect(profiler, &MemoryProfiler::finished, this, &MemoryProfilePanel::onFinished);
+    connect(lineTree, &QTreeWidget::itemActivated, this, &MemoryProfilePanel::onItemActivated);
+    connect(stackTree, &QTreeWidget::itemActivated, this, &MemoryProfilePanel::onItemActivated);
+}
+
+QString MemoryProfilePanel::formatBytes(quint64 bytes)
+{
+    if (bytes >= 1024ULL * 1024 * 1024) return QString("%1 GiB").arg(bytes / (1024.0 * 1024 * 1024), 0, 'f', 2);
+    if (bytes >= 1024ULL * 1024) return QString("%1 MiB").arg(bytes / (1024.0 * 1024), 0, 'f', 2);
+    if (bytes >= 1024) return QString("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+    return QString("%1 B").arg(bytes);
+}
+
+QString MemoryProfilePanel::describeTotals(const MemoryProfiler::Totals &totals)
+{
+    return QString("分配 %1 次，释放 %2 次，共 %3；峰值堆 %4")
+        .arg(totals.allocations).arg(totals.frees)
+        .arg(formatBytes(totals.allocatedBytes), formatBytes(totals.peakBytes));
+}
+
+bool MemoryProfilePanel::startProfiling(const QString &executable, const QString &workingDirectory,
+                                        QString *errorMessage)
+{
+    QSettings("LionCPP", "IDE").setValue("memprof/sampleRate", sampleRateSpinBox->value());
+    lineTree->clear();
+    stackTree->clear();
+    if (!profiler->start(executable, workingDirectory, sampleRateSpinBox->value(), errorMessage)) {
+        return false;
+    }
+    summaryLabel->setText("运行中...");
+    sampleRateSpinBox->setEnabled(false);
+    return true;
+}
+
+void MemoryProfilePanel::stop()
+{
+    profiler->stop();
+}
+
+void MemoryProfilePanel::onTotalsUpdated(const MemoryProfiler::Totals &totals)
+{
+    summaryLabel->setText("运行中：" + describeTotals(totals) + "，当前占用 " + formatBytes(totals.liveBytes));
+}
+
+void MemoryProfilePanel::onFinished(const MemoryProfiler::Report &report, int exitCode,
+                                    QProcess::ExitStatus exitStatus)
+{
+    sampleRateSpinBox->setEnabled(true);
+
+    QString summary = describeTotals(report.totals);
+    if (report.complete) {
+        summary += "，结束时未释放 " + formatBytes(report.totals.liveBytes);
+    } else {
+        summary += "（程序没有正常退出，调用栈数据不完整）";
+    }
+    summaryLabel->setText(summary);
+
+    showLines(report);
+    showStacks(report);
+    emit finished(exitCode, exitStatus);
+}
+
+void MemoryProfilePanel::showLines(const MemoryProfiler::Report &report)
+{
+    quint64 sampledCount = 0;
+    for (const MemoryProfiler::LineStat &stat : report.lines) sampledCount += stat.count;
+
+    lineTree->setSortingEnabled(false);
+    lineTree->clear();
+    for (const MemoryProfiler::LineStat &stat : report.lines) {
+        NumericTreeItem *item = new NumericTreeItem(lineTree);
+        item->setText(LocationColumn, stat.file.isEmpty() ? QString("<运行库>")
+                                                          : QString("%1:%2").arg(QFileInfo(stat.file).fileName()).arg(stat.line));
+        item->setToolTip(LocationColumn, stat.file);
+        item->setText(FunctionColumn, stat.function);
+        item->setText(CountColumn, QString::number(stat.count));
+        item->setData(CountColumn, SortRole, static_cast<double>(stat.count));
+        item->setText(BytesColumn, formatBytes(stat.bytes));
+        item->setData(BytesColumn, SortRole, static_cast<double>(stat.bytes));
+        double share = sampledCount > 0 ? 100.0 * stat.count / sampledCount : 0;
+        item->setText(ShareColumn, QString("%1%").arg(share, 0, 'f', 1));
+        item->setData(ShareColumn, SortRole, share);
+        item->setData(LocationColumn, FileRole, stat.file);
+        item->setData(LocationColumn, LineRole, stat.line);
+    }
+    lineTree->setSortingEnabled(true);
+    lineTree->sortByColumn(CountColumn, Qt::DescendingOrder);
+    for (int column = 0; column < LineColumnCount; ++column) {
+        if (column != FunctionColumn) lineTree->resizeColumnToContents(column);
+    }
+}
+
+void MemoryProfilePanel::showStacks(const MemoryProfiler::Report &report)
+{
+    stackTree->clear();
+    int shown = 0;
+    for (const MemoryProfiler::Stack &stack : report.stacks) {
+        if (++shown > MaxStacks) break;
+        QTreeWidgetItem *stackItem = new QTreeWidgetItem(stackTree);
+        stackItem->setText(0, QString("#%1  约 %2 次，%3").arg(shown).arg(stack.count).arg(formatBytes(stack.bytes)));
+
+        for (const StackFrame &frame : stack.frames) {
+            QTreeWidgetItem *frameItem = new QTreeWidgetItem(stackItem);
+            const Symbolizer::Location &location = frame.location;
+            frameItem->setText(0, location.function.isEmpty() || location.function == "??"
+                                  ? QString("%1+0x%2").arg(QFileInfo(frame.module).fileName()).arg(frame.offset, 0, 16)
+                                  : location.function);
+            if (location.isValid()) {
+                frameItem->setText(1, QString("%1:%2").arg(QFileInfo(location.file).fileName()).arg(location.line));
+                frameItem->setToolTip(1, location.file);
+                frameItem->setData(0, FileRole, location.file);
+                frameItem->setData(0, LineRole, location.line);
+            }
+            // 用户代码帧高亮，运行库和标准库帧变暗
+            if (Symbolizer::isUserSource(location.file)) {
+                frameItem->setForeground(0, QColor("#4ec9b0"));
+            } else {
+                frameItem->setForeground(0, QColor("#808080"));
+            }
+        }
+    }
+    if (stackTree->topLevelItemCount() > 0) stackTree->topLevelItem(0)->setExpanded(true);
+}
+
+void MemoryProfilePanel::onItemActivated(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column)
+    QString file = item->data(0, FileRole).toString();
+    int line = item->data(0, LineRole).toInt();
+    if (!file.isEmpty() && line > 0 && QFileInfo::exists(file)) {
+        emit openFileRequested(file, line);
+    }
+}
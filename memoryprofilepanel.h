@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QWidget>
+#include <QTreeWidget>
+#include <QTabWidget>
+#include <QSpinBox>
+#include <QLabel>
+
+#include "memoryprofiler.h"
+
+// 内存分析窗口
+// 上方是总体统计，下面按源码行和按调用栈两种方式列出分配最多的位置
+class MemoryProfilePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryProfilePanel(QWidget *parent = nullptr);
+
+    bool startProfiling(const QString &executable, const QString &workingDirectory, QString *errorMessage);
+    void stop();
+    bool isRunning() const { return profiler->isRunning(); }
+
+    static QString formatBytes(quint64 bytes);
+
+signals:
+    void output(const QString &text);
+    void openFileRequested(const QString &filePath, int line);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onTotalsUpdated(const MemoryProfiler::Totals &totals);
+    void onFinished(const MemoryProfiler::Report &report, int exitCode, QProcess::ExitStatus exitStatus);
+    void onItemActivated(QTreeWidgetItem *item, int column);
+
+private:
+    void showLines(const MemoryProfiler::Report &report);
+    void showStacks(const MemoryProfiler::Report &report);
+    static QString describeTotals(const MemoryProfiler::Totals &totals);
+
+    MemoryProfiler *profiler;
+    QSpinBox *sampleRateSpinBox;
+    QLabel *summaryLabel;
+    QTabWidget *tabWidget;
+    QTreeWidget *lineTree;
+    QTreeWidget *stackTree;
+};
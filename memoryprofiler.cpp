@@ -0,0 +1,134 @@
+#include "memoryprofiler.h"
+#include <QCoreApplication>
+#include <QHash>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <algorithm>
+
+MemoryProfiler::MemoryProfiler(QObject *parent)
+    : QObject(parent)
+    , process(new PreloadProcess(this))
+    , generation(0)
+{
+    connect(process, &PreloadProcess::output, this, &MemoryProfiler::output);
+    connect(process, &PreloadProcess::lineReceived, this, &MemoryProfiler::onLineReceived);
+    connect(process, &PreloadProcess::finished, this, &MemoryProfiler::onProcessFinished);
+}
+
+QString MemoryProfiler::libraryPath()
+{
+    return PreloadProcess::libraryPath("liblioncpp_memprof.so");
+}
+
+QStringList MemoryProfiler::compileFlags()
+{
+    // 关闭内联：标准库容器的分配函数大多是内联的，不关闭时调用栈停在头文件里，找不到用户代码所在行
+    return QStringList() << "-g" << "-fno-omit-frame-pointer" << "-fno-inline";
+}
+
+bool MemoryProfiler::start(const QString &executable, const QString &workingDirectory, int sampleRate,
+                           QString *errorMessage)
+{
+    this->executable = executable;
+    ++generation;
+    report = Report();
+    report.sampleRate = sampleRate;
+
+    QProcessEnvironment environment;
+    environment.insert("LIONCPP_MEMPROF_RATE", QString::number(sampleRate));
+    return process->start(executable, workingDirectory, libraryPath(), "LIONCPP_MEMPROF_FD",
+                          environment, errorMessage);
+}
+
+void MemoryProfiler::stop()
+{
+    process->kill();
+}
+
+void MemoryProfiler::onLineReceived(const QByteArray &line)
+{
+    parseLine(line, report);
+    if (line.startsWith("T ")) emit totalsUpdated(report.totals);
+}
+
+void MemoryProfiler::parseLine(const QByteArray &line, Report &report)
+{
+    const QList<QByteArray> fields = line.split(' ');
+    if (fields.isEmpty()) return;
+
+    if (fields[0] == "T" && fields.size() >= 6) {
+        report.totals.allocations = fields[1].toULongLong();
+        report.totals.frees = fields[2].toULongLong();
+        report.totals.allocatedBytes = fields[3].toULongLong();
+        report.totals.liveBytes = fields[4].toULongLong();
+        report.totals.peakBytes = fields[5].toULongLong();
+    } else if (fields[0] == "S" && fields.size() >= 3) {
+        Stack stack;
+        stack.count = fields[1].toULongLong();
+        stack.bytes = fields[2].toULongLong();
+        report.stacks.append(stack);
+    } else if (fields[0] == "F" && !report.stacks.isEmpty()) {
+        StackFrame frame;
+        if (PreloadProcess::parseFrame(line, &frame)) report.stacks.last().frames.append(frame);
+    } else if (fields[0] == "E") {
+        report.complete = true;
+    }
+}
+
+void MemoryProfiler::symbolize(Report &report, const QString &executable)
+{
+    QList<QList<StackFrame>*> stacks;
+    for (Stack &stack : report.stacks) stacks.append(&stack.frames);
+    PreloadProcess::symbolize(stacks, executable);
+
+    std::sort(report.stacks.begin(), report.stacks.end(), [](const Stack &a, const Stack &b) {
+        return a.bytes > b.bytes;
+    });
+    report.lines = aggregateByLine(report.stacks);
+}
+
+QList<MemoryProfiler::LineStat> MemoryProfiler::aggregateByLine(const QList<Stack> &stacks)
+{
+    QHash<QString, LineStat> byLine;
+    for (const Stack &stack : stacks) {
+        const StackFrame *userFrame = PreloadProcess::firstUserFrame(stack.frames);
+
+        LineStat key;
+        if (userFrame) {
+            key.file = userFrame->location.file;
+            key.line = userFrame->location.line;
+            key.function = userFrame->location.function;
+        } else {
+            // 没有用户代码帧（运行库启动时的分配等）
+            key.function = stack.frames.isEmpty() ? QString() : stack.frames.first().location.function;
+        }
+
+        QString id = QString("%1:%2").arg(key.file).arg(key.line);
+        if (!userFrame) id = "#" + key.function;
+        LineStat &stat = byLine[id];
+        if (stat.count == 0) stat = key;
+        stat.count += stack.count;
+        stat.bytes += stack.bytes;
+    }
+
+    QList<LineStat> lines = byLine.values();
+    std::sort(lines.begin(), lines.end(), [](const LineStat &a, const LineStat &b) {
+        return a.count != b.count ? a.count > b.count : a.bytes > b.bytes;
+    });
+    return lines;
+}
+
+void MemoryProfiler::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // addr2line 解析上千个调用栈需要数秒，放到工作线程中；this 只在界面线程中检查
+    QPointer<MemoryProfiler> guard(this);
+    const int run = generation;
+    QThreadPool::globalInstance()->start(QRunnable::create(
+        [guard, run, report = report, executable = executable, exitCode, exitStatus]() mutable {
+            symbolize(report, executable);
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, run, report, exitCode, exitStatus]() {
+                if (guard && guard->generation == run) emit guard->finished(report, exitCode, exitStatus);
+            }, Qt::QueuedConnection);
+        }));
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QProcess>
+
+#include "preloadprocess.h"
+
+// 堆分配分析
+// 运行程序时通过 LD_PRELOAD 注入 liblioncpp_memprof.so，拦截库把分配统计和
+// 采样到的调用栈写回管道，程序结束后在工作线程中符号化并按源码行汇总。
+class MemoryProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Totals
+    {
+        quint64 allocations = 0;
+        quint64 frees = 0;
+        quint64 allocatedBytes = 0;
+        quint64 liveBytes = 0;          // 结束时仍未释放的字节
+        quint64 peakBytes = 0;
+    };
+
+    // 采样得到的调用栈，次数和字节数已按采样间隔放大为估计值
+    struct Stack
+    {
+        quint64 count = 0;
+        quint64 bytes = 0;
+        QList<StackFrame> frames;
+    };
+
+    struct LineStat
+    {
+        QString file;
+        int line = 0;
+        QString function;
+        quint64 count = 0;
+        quint64 bytes = 0;
+    };
+
+    struct Report
+    {
+        Totals totals;
+        QList<Stack> stacks;            // 按字节数从大到小
+        QList<LineStat> lines;          // 按次数从大到小
+        int sampleRate = 1;
+        bool complete = false;          // 收到了拦截库的结束标记
+    };
+
+    explicit MemoryProfiler(QObject *parent = nullptr);
+
+    static QString libraryPath();
+    static QStringList compileFlags();
+
+    bool start(const QString &executable, const QString &workingDirectory, int sampleRate,
+               QString *errorMessage = nullptr);
+    void stop();
+    bool isRunning() const { return process->isRunning(); }
+
+    static void parseLine(const QByteArray &line, Report &report);
+    static void symbolize(Report &report, const QString &executable);
+    // 每个调用栈归到第一个用户源码帧所在的行，热循环里的分配因此落在循环所在行
+    static QList<LineStat> aggregateByLine(const QList<Stack> &stacks);
+
+signals:
+    void output(const QString &text);
+    void totalsUpdated(const MemoryProfiler::Totals &totals);
+    void finished(const MemoryProfiler::Report &report, int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onLineReceived(const QByteArray &line);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    PreloadProcess *process;
+    Report report;
+    QString executable;
+    int generation;                 // 每次启动递增，丢弃上一次运行的符号化结果
+};
@@ -0,0 +1,123 @@
+#include "optimizationremarks.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QHash>
+#include <QRegularExpression>
+
+bool OptimizationRemarks::isClang(const QString &compilerPath)
+{
+    return QFileInfo(compilerPath).fileName().contains("clang");
+}
+
+QStringList OptimizationRemarks::compileFlags(const QString &compilerPath)
+{
+    QStringList flags;
+    if (isClang(compilerPath)) {
+        flags << "-Rpass=.*" << "-Rpass-missed=.*" << "-Rpass-analysis=loop-vectorize";
+    } else {
+        flags << "-fopt-info-vec-all" << "-fopt-info-inline";
+    }
+    // 提示需要准确的行列号
+    flags << "-g";
+    return flags;
+}
+
+QList<OptimizationRemark> OptimizationRemarks::parse(const QString &text, const QString &baseDir)
+{
+    // GCC: a.cpp:3:47: missed: couldn't vectorize loop
+    static const QRegularExpression gccPattern(
+        QStringLiteral("^(.+?):(\\d+):(\\d+): (optimized|missed|note): (.*)$"));
+    // Clang: a.cpp:3:5: remark: vectorized loop (vectorization width: 4, ...) [-Rpass=loop-vectorize]
+    static const QRegularExpression clangPattern(
+        QStringLiteral("^(.+?):(\\d+):(\\d+): remark: (.*?)(?: \\[-R(pass|pass-missed|pass-analysis)=([^\\]]+)\\])?$"));
+    // GCC 的内联提示带有调用图节点编号，如 "int f(int)/156"
+    static const QRegularExpression nodeNumber(QStringLiteral("(\\S)/\\d+\\b"));
+
+    QList<OptimizationRemark> remarks;
+    const QStringList lines = text.split('\n');
+    for (const QString &rawLine : lines) {
+        QString line = rawLine.trimmed();
+        OptimizationRemark remark;
+
+        QRegularExpressionMatch match = gccPattern.match(line);
+        if (match.hasMatch()) {
+            QString category = match.captured(4);
+            remark.message = match.captured(5).trimmed();
+            if (category == "note") {
+                // 向量化器逐个尝试向量模式的过程信息和函数汇总对编辑没有帮助
+                if (remark.message.startsWith("***") || remark.message.startsWith("vectorized ")) continue;
+                remark.kind = RemarkKind::Analysis;
+            } else {
+                remark.kind = category == "optimized" ? RemarkKind::Optimized : RemarkKind::Missed;
+            }
+            remark.pass = remark.message.startsWith("Inlin") ? "inline" : "vectorize";
+            remark.message.replace(nodeNumber, "\\1");
+        } else {
+            match = clangPattern.match(line);
+            if (!match.hasMatch()) continue;
+            remark.message = match.captured(4).trimmed();
+            QString option = match.captured(5);
+            remark.kind = option == "pass-missed" ? RemarkKind::Missed
+                        : option == "pass-analysis" ? RemarkKind::Analysis
+                        : RemarkKind::Optimized;
+            remark.pass = match.captured(6);
+        }
+
+        remark.file = match.captured(1);
+        if (!baseDir.isEmpty() && QFileInfo(remark.file).isRelative()) {
+            remark.file = QDir(baseDir).absoluteFilePath(remark.file);
+        }
+        remark.line = match.captured(2).toInt();
+        remark.column = match.captured(3).toInt();
+        remarks.append(remark);
+    }
+    return remarks;
+}
+
+QMap<int, QList<OptimizationRemark>> OptimizationRemarks::indexByLine(const QList<OptimizationRemark> &remarks,
+                                                                     const QString &sourcePath)
+{
+    QString target = QFileInfo(sourcePath).canonicalFilePath();
+    QHash<QString, bool> sameFile;
+    QMap<int, QList<OptimizationRemark>> index;
+    QSet<QString> seen;
+
+    for (const OptimizationRemark &remark : remarks) {
+        // 头文件中的提示（例如标准库内部的内联）不显示
+        auto it = sameFile.constFind(remark.file);
+        if (it == sameFile.constEnd()) {
+            it = sameFile.insert(remark.file, QFileInfo(remark.file).canonicalFilePath() == target);
+        }
+        if (!it.value() || remark.line <= 0) continue;
+
+        // 同一位置可能因为多次内联而重复出现
+        QString key = QString("%1:%2:%3").arg(remark.line).arg(static_cast<int>(remark.kind)).arg(remark.message);
+        if (seen.contains(key)) continue;
+        seen.insert(key);
+        index[remark.line].append(remark);
+    }
+    return index;
+}
+
+QString OptimizationRemarks::kindName(RemarkKind kind)
+{
+    switch (kind) {
+    case RemarkKind::Optimized: return "已优化";
+    case RemarkKind::Missed:    return "未优化";
+    case RemarkKind::Analysis:  return "分析";
+    }
+    return QString();
+}
+
+QString OptimizationRemarks::toolTip(const QList<OptimizationRemark> &remarks)
+{
+    QStringList lines;
+    for (const OptimizationRemark &remark : remarks) {
+        QString prefix = remark.pass.isEmpty()
+            ? kindName(remark.kind)
+            : QString("%1 [%2]").arg(kindName(remark.kind), remark.pass);
+        lines << QString("%1: %2").arg(prefix, remark.message);
+    }
+    return lines.join('\n');
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+
+enum class RemarkKind
+{
+    Optimized,      // 已完成的优化（向量化、内联……）
+    Missed,         // 未能完成的优化及原因
+    Analysis        // 补充分析信息
+};
+
+// 一条编译器优化提示
+struct OptimizationRemark
+{
+    QString file;
+    int line = 0;
+    int column = 0;
+    RemarkKind kind = RemarkKind::Analysis;
+    QString pass;       // vectorize / inline / loop-unroll ...
+    QString message;
+};
+
+// 编译器优化报告
+// GCC 使用 -fopt-info，Clang 使用 -Rpass 系列参数，两者都把提示输出到 stderr，
+// 格式与诊断信息相同（文件:行:列: 类别: 内容），这里统一解析为按行索引的提示。
+class OptimizationRemarks
+{
+public:
+    static bool isClang(const QString &compilerPath);
+    static QStringList compileFlags(const QString &compilerPath);
+
+    // 解析编译器 stderr，baseDir 用于解析相对路径
+    static QList<OptimizationRemark> parse(const QString &text, const QString &baseDir = QString());
+    // 只保留属于 sourcePath 的提示，按行号（从 1 开始）分组并去重
+    static QMap<int, QList<OptimizationRemark>> indexByLine(const QList<OptimizationRemark> &remarks,
+                                                           const QString &sourcePath);
+    static QString kindName(RemarkKind kind);
+    // 悬停提示文本
+    static QString toolTip(const QList<OptimizationRemark> &remarks);
+};
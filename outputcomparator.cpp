@@ -0,0 +1,144 @@
+#include "outputcomparator.h"
+
+OutputComparator::OutputComparator(const QString &expectedFile)
+    : expected(expectedFile)
+    , bufferPos(0)
+    , expectedEof(false)
+    , inToken(false)
+    , mismatch(false)
+    , tokenLength(0)
+    , expectedLine(1)
+    , tokenCount(0)
+{
+    if (!expected.open(QIODevice::ReadOnly)) {
+        expectedEof = true;
+    }
+}
+
+bool OutputComparator::isSpace(int c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+int OutputComparator::peekExpected()
+{
+    if (bufferPos >= buffer.size()) {
+        if (expectedEof) return -1;
+        buffer = expected.read(ReadChunkSize);
+        bufferPos = 0;
+        if (buffer.isEmpty()) {
+            expectedEof = true;
+            return -1;
+        }
+    }
+    return static_cast<unsigned char>(buffer.at(bufferPos));
+}
+
+void OutputComparator::skipExpectedWhitespace()
+{
+    int c;
+    while ((c = peekExpected()) >= 0 && isSpace(c)) {
+        if (c == '\n') ++expectedLine;
+        ++bufferPos;
+    }
+}
+
+QByteArray OutputComparator::readExpectedToken(int maxLength)
+{
+    QByteArray token;
+    int c;
+    while (token.size() < maxLength && (c = peekExpected()) >= 0 && !isSpace(c)) {
+        token.append(static_cast<char>(c));
+        ++bufferPos;
+    }
+    return token;
+}
+
+QByteArray OutputComparator::comparedPrefix() const
+{
+    // 记号过长时只保留了开头部分，无法再拼出完整的片段
+    return tokenLength > actualToken.size() ? actualToken + "..." : actualToken;
+}
+
+bool OutputComparator::feed(const char *data, qint64 size)
+{
+    if (mismatch) return false;
+
+    for (qint64 i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+
+        if (isSpace(c)) {
+            if (inToken) {
+                int e = peekExpected();
+                if (e >= 0 && !isSpace(e)) {
+                    // 实际记号比期望的短
+                    QByteArray prefix = comparedPrefix();
+                    reportMismatch(prefix, prefix + readExpectedToken(SnippetLength));
+                    return false;
+                }
+                inToken = false;
+            }
+            continue;
+        }
+
+        if (!inToken) {
+            skipExpectedWhitespace();
+            inToken = true;
+            actualToken.clear();
+            tokenLength = 0;
+            ++tokenCount;
+        }
+
+        int e = peekExpected();
+        if (e != c) {
+            QByteArray prefix = comparedPrefix();
+            QByteArray actualSnippet = prefix;
+            for (qint64 j = i; j < size && j - i < SnippetLength && !isSpace(static_cast<unsigned char>(data[j])); ++j) {
+                actualSnippet.append(data[j]);
+            }
+            QByteArray expectedSnippet = (e < 0 && tokenLength == 0) ? QByteArray() : prefix + readExpectedToken(SnippetLength);
+            reportMismatch(actualSnippet, expectedSnippet);
+            return false;
+        }
+
+        ++bufferPos;
+        if (actualToken.size() < SnippetLength) {
+            actualToken.append(static_cast<char>(c));
+        }
+        ++tokenLength;
+    }
+    return true;
+}
+
+bool OutputComparator::finish()
+{
+    if (mismatch) return false;
+
+    if (inToken) {
+        int e = peekExpected();
+        if (e >= 0 && !isSpace(e)) {
+            QByteArray prefix = comparedPrefix();
+            reportMismatch(prefix, prefix + readExpectedToken(SnippetLength));
+            return false;
+        }
+        inToken = false;
+    }
+
+    skipExpectedWhitespace();
+    if (peekExpected() >= 0) {
+        ++tokenCount;
+        reportMismatch(QByteArray(), readExpectedToken(SnippetLength));
+        return false;
+    }
+    return true;
+}
+
+void OutputComparator::reportMismatch(const QByteArray &actualSnippet, const QByteArray &expectedSnippet)
+{
+    mismatch = true;
+    description = QString("第 %1 行（第 %2 个记号）：期望 %3，实际 %4")
+        .arg(expectedLine)
+        .arg(tokenCount)
+        .arg(expectedSnippet.isEmpty() ? QString("<输出结束>") : "\"" + QString::fromUtf8(expectedSnippet) + "\"",
+             actualSnippet.isEmpty() ? QString("<输出结束>") : "\"" + QString::fromUtf8(actualSnippet) + "\"");
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+
+// 流式输出比较器
+// 程序输出按块送入 feed()，与期望输出文件逐字符比较，忽略空白差异
+// （按空白分隔的记号逐个比较）。两边都只保留一个读缓冲区，
+// 输出再大也不会整体读入内存。
+class OutputComparator
+{
+public:
+    explicit OutputComparator(const QString &expectedFile);
+
+    bool isOpen() const { return expected.isOpen(); }
+
+    // 返回 false 表示已经发现不一致，后续输出无需再送入
+    bool feed(const char *data, qint64 size);
+    // 程序输出结束后调用，检查期望输出是否也已结束
+    bool finish();
+
+    bool matched() const { return !mismatch; }
+    QString mismatchDescription() const { return description; }
+
+private:
+    int peekExpected();
+    void skipExpectedWhitespace();
+    QByteArray readExpectedToken(int maxLength);
+    QByteArray comparedPrefix() const;
+    void reportMismatch(const QByteArray &actualToken, const QByteArray &expectedToken);
+    static bool isSpace(int c);
+
+    static const int SnippetLength = 32;
+    static const qint64 ReadChunkSize = 64 * 1024;
+
+    QFile expected;
+    QByteArray buffer;
+    qint64 bufferPos;
+    bool expectedEof;
+
+    bool inToken;
+    bool mismatch;
+    QByteArray actualToken;     // 当前记号已比较的部分（只保留前 SnippetLength 个字符）
+    qint64 tokenLength;
+    qint64 expectedLine;
+    qint64 tokenCount;
+    QString description;
+};
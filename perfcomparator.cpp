@@ -0,0 +1,183 @@
+#include "perfcomparator.h"
+#include "processrunner.h"
+#include "buildcache.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QRunnable>
+
+namespace {
+// 显著性判断：秩和检验的 p 值与置信区间需同时支持
+const double SignificanceLevel = 0.05;
+}
+
+PerfComparator::PerfComparator(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , cancelFlag(std::make_shared<std::atomic<bool>>(false))
+    , running(false)
+{
+    // 计时必须串行进行，两个版本不能同时运行互相干扰
+    pool->setMaxThreadCount(1);
+}
+
+PerfComparator::~PerfComparator()
+{
+    cancelFlag->store(true);
+    pool->waitForDone();
+}
+
+QString PerfComparator::workDirectory(const QString &sourcePath)
+{
+    QFileInfo sourceInfo(sourcePath);
+    return sourceInfo.absolutePath() + "/" + sourceInfo.completeBaseName() + ".ab";
+}
+
+bool PerfComparator::start(const Config &config)
+{
+    if (running) return false;
+    if (!QDir().mkpath(config.workDirectory)) return false;
+
+    cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    running = true;
+
+    std::shared_ptr<std::atomic<bool>> flag = cancelFlag;
+    pool->start(QRunnable::create([this, config, flag]() {
+        runComparison(config, flag);
+    }));
+    return true;
+}
+
+void PerfComparator::stop()
+{
+    cancelFlag->store(true);
+}
+
+void PerfComparator::postStage(const QString &description)
+{
+    QMetaObject::invokeMethod(this, [this, description]() { emit stageChanged(description); }, Qt::QueuedConnection);
+}
+
+void PerfComparator::postFailure(const QString &message)
+{
+    QMetaObject::invokeMethod(this, [this, message]() {
+        running = false;
+        emit failed(message);
+    }, Qt::QueuedConnection);
+}
+
+bool PerfComparator::compile(const Variant &variant, const QString &outputPath, const std::atomic<bool> *cancelFlag)
+{
+    QStringList flags = variant.flags;
+    flags << "-iquote" << variant.workingDirectory;
+
+    ProcessRunner::Spec spec;
+    spec.program = variant.compiler.isEmpty() ? BuildCache::compilerPath() : variant.compiler;
+    spec.arguments = BuildCache::compileArguments(variant.sourcePath, outputPath, flags);
+    spec.workingDirectory = variant.workingDirectory;
+    spec.cancelFlag = cancelFlag;
+
+    ProcessRunner::Result result = ProcessRunner::run(spec);
+    if (result.cancelled) return false;
+    if (!result.started) {
+        postFailure(QString("%1: 无法启动编译器 %2（%3）").arg(variant.label, spec.program, result.error));
+        return false;
+    }
+    if (result.crashed()) {
+        postFailure(QString("%1 编译失败:\n%2").arg(variant.label, QString::fromUtf8(result.stderrOutput)));
+        return false;
+    }
+    return true;
+}
+
+void PerfComparator::runComparison(const Config &config, const std::shared_ptr<std::atomic<bool>> &cancelFlag)
+{
+    QDir workDir(config.workDirectory);
+    QString executableA = workDir.filePath("variant_a");
+    QString executableB = workDir.filePath("variant_b");
+
+    postStage("正在编译 " + config.a.label + "...");
+    if (!compile(config.a, executableA, cancelFlag.get())) {
+        if (cancelFlag->load()) postFailure("已停止");
+        return;
+    }
+    postStage("正在编译 " + config.b.label + "...");
+    if (!compile(config.b, executableB, cancelFlag.get())) {
+        if (cancelFlag->load()) postFailure("已停止");
+        return;
+    }
+
+    // 两个版本使用完全相同的运行条件
+    auto runOnce = [&](const QString &executable, const Variant &variant, double *timeMs) -> bool {
+        ProcessRunner::Spec spec;
+        spec.program = executable;
+        spec.workingDirectory = variant.workingDirectory;
+        spec.stdinFile = config.inputFile;
+        spec.wallTimeLimitMs = config.timeLimitMs;
+        spec.cancelFlag = cancelFlag.get();
+        MeasurementEnvironment::applyTo(spec, config.conditions);
+
+        ProcessRunner::Result result = ProcessRunner::run(spec);
+        if (result.cancelled) {
+            postFailure("已停止");
+            return false;
+        }
+        if (!result.started || result.crashed() || result.wallTimeExceeded) {
+            QString reason = result.wallTimeExceeded ? QString("超过时间限制 %1 ms").arg(config.timeLimitMs)
+                           : !result.started ? result.error
+                           : result.signal ? QString("被信号 %1 终止").arg(result.signal)
+                           : QString("返回值 %1").arg(result.exitCode);
+            postFailure(QString("%1 运行失败：%2\n%3").arg(variant.label, reason,
+                                                          QString::fromUtf8(result.stderrOutput)));
+            return false;
+        }
+        if (timeMs) *timeMs = result.wallTimeUs / 1000.0;
+        return true;
+    };
+
+    postStage("预热中...");
+    for (int i = 0; i < config.warmupRuns; ++i) {
+        if (!runOnce(executableA, config.a, nullptr)) return;
+        if (!runOnce(executableB, config.b, nullptr)) return;
+    }
+
+    postStage("交替计时中...");
+    QList<double> timesA;
+    QList<double> timesB;
+    for (int i = 0; i < config.runs; ++i) {
+        // ABBA 顺序：每轮交换先后，避免某个版本总是在“更热”的状态下运行
+        bool aFirst = i % 2 == 0;
+        double first = 0;
+        double second = 0;
+        if (!runOnce(aFirst ? executableA : executableB, aFirst ? config.a : config.b, &first)) return;
+        if (!runOnce(aFirst ? executableB : executableA, aFirst ? config.b : config.a, &second)) return;
+        timesA.append(aFirst ? first : second);
+        timesB.append(aFirst ? second : first);
+
+        int completed = i + 1;
+        QMetaObject::invokeMethod(this, [this, completed, config]() {
+            emit progress(completed, config.runs);
+        }, Qt::QueuedConnection);
+    }
+
+    Report report = analyze(timesA, timesB);
+    report.conditions = config.conditions;
+    QMetaObject::invokeMethod(this, [this, report]() {
+        running = false;
+        emit finished(report);
+    }, Qt::QueuedConnection);
+}
+
+PerfComparator::Report PerfComparator::analyze(const QList<double> &timesA, const QList<double> &timesB)
+{
+    Report report;
+    report.timesA = timesA;
+    report.timesB = timesB;
+    report.medianA = Statistics::median(timesA);
+    report.medianB = Statistics::median(timesB);
+    report.speedup = report.medianB > 0 ? report.medianA / report.medianB : 0;
+    report.speedupInterval = Statistics::bootstrapMedianRatio(timesA, timesB);
+    report.test = Statistics::mannWhitneyU(timesA, timesB);
+    bool intervalExcludesOne = report.speedupInterval.low > 1 || report.speedupInterval.high < 1;
+    report.significant = report.test.pValue < SignificanceLevel && intervalExcludesOne;
+    return report;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+#include "statistics.h"
+#include "measurementenvironment.h"
+
+// A/B 性能对比
+// 分别编译两个版本（不同源码版本、编译器或编译参数），在同一输入下交替运行
+// （ABBA 顺序，抵消频率变化、缓存预热等随时间漂移的因素），再用秩和检验
+// 和自助法置信区间判断速度差异是否显著。
+class PerfComparator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Variant
+    {
+        QString label;
+        QString sourcePath;
+        QString workingDirectory;
+        QString compiler;
+        QStringList flags;
+    };
+
+    struct Config
+    {
+        Variant a;
+        Variant b;
+        QString inputFile;          // 为空时标准输入为 /dev/null
+        QString workDirectory;
+        int runs = 30;              // 每个版本的计时次数
+        int warmupRuns = 2;
+        qint64 timeLimitMs = 10000;
+        MeasurementConditions conditions;   // 核心绑定和优先级，同时记录在报告中
+    };
+
+    struct Report
+    {
+        QList<double> timesA;       // 毫秒
+        QList<double> timesB;
+        double medianA = 0;
+        double medianB = 0;
+        double speedup = 0;         // medianA / medianB，大于 1 表示 B 更快
+        Statistics::Interval speedupInterval;
+        Statistics::MannWhitneyResult test;
+        bool significant = false;
+        MeasurementConditions conditions;
+    };
+
+    explicit PerfComparator(QObject *parent = nullptr);
+    ~PerfComparator();
+
+    bool start(const Config &config);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static QString workDirectory(const QString &sourcePath);
+    static Report analyze(const QList<double> &timesA, const QList<double> &timesB);
+
+signals:
+    void stageChanged(const QString &description);
+    void progress(int completed, int total);
+    void failed(const QString &message);
+    void finished(const PerfComparator::Report &report);
+
+private:
+    void runComparison(const Config &config, const std::shared_ptr<std::atomic<bool>> &cancelFlag);
+    bool compile(const Variant &variant, const QString &outputPath, const std::atomic<bool> *cancelFlag);
+    void postStage(const QString &description);
+    void postFailure(const QString &message);
+
+    QThreadPool *pool;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+    bool running;
+};
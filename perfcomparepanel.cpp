@@ -0,0 +1,330 @@
+#include "perfcomparepanel.h"
+#include "buildcache.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QProcess>
+#include <QSettings>
+#include <QFontDatabase>
+
+PerfComparePanel::PerfComparePanel(QWidget *parent)
+    : QWidget(parent)
+    , comparator(new PerfComparator(this))
+    , gitProcess(new QProcess(this))
+{
+    QSettings settings("LionCPP", "IDE");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QGridLayout *variantLayout = new QGridLayout();
+    variantLayout->addWidget(new QLabel("源码", this), 0, 1);
+    variantLayout->addWidget(new QLabel("编译器", this), 0, 2);
+    variantLayout->addWidget(new QLabel("额外参数", this), 0, 3);
+    rowA = createVariantRow(variantLayout, 1, "A");
+    rowB = createVariantRow(variantLayout, 2, "B");
+    variantLayout->setColumnStretch(3, 1);
+    layout->addLayout(variantLayout);
+
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+    inputEdit = new QLineEdit(this);
+    inputEdit->setPlaceholderText("输入文件（可选）");
+    inputEdit->setText(settings.value("ab/input").toString());
+    QPushButton *browseButton = new QPushButton("浏览...", this);
+    runsSpinBox = new QSpinBox(this);
+    runsSpinBox->setRange(5, 1000);
+    runsSpinBox->setValue(settings.value("ab/runs", 30).toInt());
+    timeLimitSpinBox = new QSpinBox(this);
+    timeLimitSpinBox->setRange(100, 600000);
+    timeLimitSpinBox->setSingleStep(1000);
+    timeLimitSpinBox->setSuffix(" ms");
+    timeLimitSpinBox->setValue(settings.value("ab/timeLimitMs", 10000).toInt());
+    startButton = new QPushButton("开始对比", this);
+
+    controlLayout->addWidget(new QLabel("输入:", this));
+    controlLayout->addWidget(inputEdit, 1);
+    controlLayout->addWidget(browseButton);
+    controlLayout->addWidget(new QLabel("每个版本运行次数:", this));
+    controlLayout->addWidget(runsSpinBox);
+    controlLayout->addWidget(new QLabel("单次时间限制:", this));
+    controlLayout->addWidget(timeLimitSpinBox);
+    controlLayout->addWidget(startButton);
+    layout->addLayout(controlLayout);
+
+    QHBoxLayout *statusLayout = new QHBoxLayout();
+    progressBar = new QProgressBar(this);
+    progressBar->setVisible(false);
+    statusLabel = new QLabel(this);
+    statusLayout->addWidget(statusLabel, 1);
+    statusLayout->addWidget(progressBar);
+    layout->addLayout(statusLayout);
+
+    reportView = new QPlainTextEdit(this);
+    reportView->setReadOnly(true);
+    reportView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(reportView, 1);
+
+    connect(browseButton, &QPushButton::clicked, this, [this]() {
+        QString filePath = QFileDialog::getOpenFileName(this, "选择输入文件", QFileInfo(inputEdit->text()).absolutePath());
+        if (!filePath.isEmpty()) inputEdit->setText(filePath);
+    });
+    connect(startButton, &QPushButton::clicked, this, [this]() {
+        if (isRunning()) {
+            stop();
+            return;
+        }
+        saveOptions();
+        emit startRequested();
+    });
+
+    connect(comparator, &PerfComparator::stageChanged, statusLabel, &QLabel::setText);
+    connect(comparator, &PerfComparator::progress, this, &PerfComparePanel::onProgress);
+    connect(comparator, &PerfComparator::failed, this, &PerfComparePanel::onFailed);
+    connect(comparator, &PerfComparator::finished, this, &PerfComparePanel::onFinished);
+    connect(gitProcess, &QProcess::finished, this, &PerfComparePanel::onGitFinished);
+    connect(gitProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart) return;
+        statusLabel->setText("无法启动 git");
+        updateButtons();
+    });
+
+    updateButtons();
+}
+
+PerfComparePanel::VariantRow PerfComparePanel::createVariantRow(QGridLayout *layout, int row, const QString &name)
+{
+    QSettings settings("LionCPP", "IDE");
+
+    VariantRow variantRow;
+    variantRow.sourceCombo = new QComboBox(this);
+    variantRow.sourceCombo->addItem("编辑器中的内容", EditorBuffer);
+    variantRow.sourceCombo->addItem("已保存的文件", SavedFile);
+    variantRow.sourceCombo->addItem("Git HEAD 版本", GitHead);
+    // 默认比较修改前后：A 为已保存的文件，B 为编辑器中的内容
+    int defaultSource = name == "A" ? SavedFile : EditorBuffer;
+    variantRow.sourceCombo->setCurrentIndex(variantRow.sourceCombo->findData(
+        settings.value("ab/source" + name, defaultSource).toInt()));
+
+    variantRow.compilerEdit = new QLineEdit(this);
+    variantRow.compilerEdit->setText(settings.value("ab/compiler" + name, BuildCache::compilerPath()).toString());
+    variantRow.flagsEdit = new QLineEdit(this);
+    variantRow.flagsEdit->setPlaceholderText("如 -O3 -march=native");
+    variantRow.flagsEdit->setText(settings.value("ab/flags" + name).toString());
+
+    layout->addWidget(new QLabel(name + ":", this), row, 0);
+    layout->addWidget(variantRow.sourceCombo, row, 1);
+    layout->addWidget(variantRow.compilerEdit, row, 2);
+    layout->addWidget(variantRow.flagsEdit, row, 3);
+    return variantRow;
+}
+
+void PerfComparePanel::saveOptions()
+{
+    QSettings settings("LionCPP", "IDE");
+    settings.setValue("ab/sourceA", rowA.sourceCombo->currentData());
+    settings.setValue("ab/compilerA", rowA.compilerEdit->text());
+    settings.setValue("ab/flagsA", rowA.flagsEdit->text());
+    settings.setValue("ab/sourceB", rowB.sourceCombo->currentData());
+    settings.setValue("ab/compilerB", rowB.compilerEdit->text());
+    settings.setValue("ab/flagsB", rowB.flagsEdit->text());
+    settings.setValue("ab/input", inputEdit->text());
+    settings.setValue("ab/runs", runsSpinBox->value());
+    settings.setValue("ab/timeLimitMs", timeLimitSpinBox->value());
+}
+
+bool PerfComparePanel::prepareVariant(const VariantRow &row, const QString &name, const QString &sourcePath,
+                                      const QString &bufferText, const QString &workDirectory,
+                                      const QByteArray &headContent, PerfComparator::Variant *variant,
+                                      QString *errorMessage)
+{
+    QFileInfo sourceInfo(sourcePath);
+    QString copyPath = QDir(workDirectory).filePath("variant_" + name.toLower() + ".cpp");
+    SourceKind kind = static_cast<SourceKind>(row.sourceCombo->currentData().toInt());
+
+    QByteArray content;
+    switch (kind) {
+    case EditorBuffer:
+        content = bufferText.toUtf8();
+        break;
+    case SavedFile:
+        variant->sourcePath = sourceInfo.absoluteFilePath();
+        break;
+    case GitHead:
+        content = headContent;
+        break;
+    }
+
+    // 编辑器内容和 Git 版本写到工作目录，编译时仍以源文件所在目录查找本地头文件
+    if (kind != SavedFile) {
+        QFile file(copyPath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+            *errorMessage = "无法写入 " + copyPath;
+            return false;
+        }
+        variant->sourcePath = copyPath;
+    }
+
+    variant->workingDirectory = sourceInfo.absolutePath();
+    variant->compiler = row.compilerEdit->text().trimmed();
+    variant->flags = QProcess::splitCommand(row.flagsEdit->text());
+    variant->label = QString("%1（%2，%3%4）")
+                         .arg(name, row.sourceCombo->currentText(),
+                              QFileInfo(variant->compiler.isEmpty() ? BuildCache::compilerPath() : variant->compiler).fileName(),
+                              variant->flags.isEmpty() ? QString() : " " + variant->flags.join(' '));
+    return true;
+}
+
+void PerfComparePanel::startComparison(const QString &sourcePath, const QString &bufferText)
+{
+    if (isRunning()) return;
+
+    PerfComparator::Config config;
+    config.workDirectory = PerfComparator::workDirectory(sourcePath);
+    config.inputFile = inputEdit->text().trimmed();
+    config.runs = runsSpinBox->value();
+    config.timeLimitMs = timeLimitSpinBox->value();
+    config.conditions = MeasurementEnvironment::check();
+
+    if (!QDir().mkpath(config.workDirectory)) {
+        statusLabel->setText("无法创建工作目录: " + config.workDirectory);
+        return;
+    }
+    if (!config.inputFile.isEmpty() && !QFileInfo(config.inputFile).isFile()) {
+        statusLabel->setText("输入文件不存在: " + config.inputFile);
+        return;
+    }
+
+    pendingConfig = config;
+    pendingSourcePath = sourcePath;
+    pendingBufferText = bufferText;
+
+    // Git HEAD 版本异步取得，两个版本都选它时只取一次
+    if (rowA.sourceCombo->currentData().toInt() == GitHead || rowB.sourceCombo->currentData().toInt() == GitHead) {
+        QFileInfo sourceInfo(sourcePath);
+        statusLabel->setText("读取 Git HEAD 版本...");
+        gitProcess->setWorkingDirectory(sourceInfo.absolutePath());
+        gitProcess->start("git", QStringList() << "show" << "HEAD:./" + sourceInfo.fileName());
+        updateButtons();
+        return;
+    }
+    continueComparison(QByteArray());
+}
+
+void PerfComparePanel::onGitFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QByteArray content = gitProcess->readAllStandardOutput();
+    QString errors = QString::fromUtf8(gitProcess->readAllStandardError()).trimmed();
+
+    if (exitStatus != QProcess::NormalExit) {
+        // 被停止
+        statusLabel->setText("对比未完成");
+        updateButtons();
+        return;
+    }
+    if (exitCode != 0) {
+        statusLabel->setText(QString("无法取得 %1 的 Git HEAD 版本: %2")
+                                 .arg(QFileInfo(pendingSourcePath).fileName(), errors));
+        updateButtons();
+        return;
+    }
+    continueComparison(content);
+}
+
+void PerfComparePanel::continueComparison(const QByteArray &headContent)
+{
+    PerfComparator::Config config = pendingConfig;
+    QString errorMessage;
+    if (!prepareVariant(rowA, "A", pendingSourcePath, pendingBufferText, config.workDirectory, headContent,
+                        &config.a, &errorMessage)
+        || !prepareVariant(rowB, "B", pendingSourcePath, pendingBufferText, config.workDirectory, headContent,
+                           &config.b, &errorMessage)) {
+        statusLabel->setText(errorMessage);
+        updateButtons();
+        return;
+    }
+    pendingBufferText.clear();
+    labelA = config.a.label;
+    labelB = config.b.label;
+
+    reportView->clear();
+    progressBar->setRange(0, config.runs);
+    progressBar->setValue(0);
+    progressBar->setVisible(true);
+    comparator->start(config);
+    updateButtons();
+}
+
+void PerfComparePanel::stop()
+{
+    if (gitProcess->state() != QProcess::NotRunning) gitProcess->kill();
+    comparator->stop();
+}
+
+void PerfComparePanel::updateButtons()
+{
+    startButton->setText(isRunning() ? "停止" : "开始对比");
+}
+
+void PerfComparePanel::onProgress(int completed, int total)
+{
+    progressBar->setValue(completed);
+    statusLabel->setText(QString("交替计时中：%1 / %2 轮").arg(completed).arg(total));
+}
+
+void PerfComparePanel::onFailed(const QString &message)
+{
+    progressBar->setVisible(false);
+    statusLabel->setText("对比未完成");
+    reportView->setPlainText(message);
+    updateButtons();
+}
+
+QString PerfComparePanel::describeTimes(const QList<double> &times) const
+{
+    return QString("中位数 %1 ms，四分位 %2 ~ %3 ms，最快 %4 ms")
+        .arg(Statistics::median(times), 0, 'f', 3)
+        .arg(Statistics::percentile(times, 0.25), 0, 'f', 3)
+        .arg(Statistics::percentile(times, 0.75), 0, 'f', 3)
+        .arg(Statistics::percentile(times, 0), 0, 'f', 3);
+}
+
+void PerfComparePanel::onFinished(const PerfComparator::Report &report)
+{
+    progressBar->setVisible(false);
+    updateButtons();
+
+    QStringList lines;
+    lines << labelA << "    " + describeTimes(report.timesA);
+    lines << labelB << "    " + describeTimes(report.timesB);
+    lines << QString();
+    lines << QString("加速比 A/B = %1x（95% 置信区间 %2 ~ %3）")
+                 .arg(report.speedup, 0, 'f', 3)
+                 .arg(report.speedupInterval.low, 0, 'f', 3)
+                 .arg(report.speedupInterval.high, 0, 'f', 3);
+    lines << QString("Mann-Whitney U = %1，z = %2，p = %3")
+                 .arg(report.test.u)
+                 .arg(report.test.z, 0, 'f', 2)
+                 .arg(report.test.pValue, 0, 'g', 3);
+    lines << QString();
+
+    QString verdict;
+    if (!report.significant) {
+        verdict = "结论：差异不显著，两个版本的速度在噪声范围内";
+    } else if (report.speedup > 1) {
+        verdict = QString("结论：B 显著更快，约为 A 的 %1 倍").arg(report.speedup, 0, 'f', 2);
+    } else {
+        verdict = QString("结论：B 显著更慢，A 约为 B 的 %1 倍").arg(1 / report.speedup, 0, 'f', 2);
+    }
+    lines << verdict;
+    lines << QString();
+    lines << "测量条件：" + MeasurementEnvironment::summary(report.conditions);
+    for (const QString &warning : std::as_const(report.conditions.warnings)) {
+        lines << "    警告：" + warning;
+    }
+
+    reportView->setPlainText(lines.join('\n'));
+    statusLabel->setText(verdict);
+}
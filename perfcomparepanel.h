@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QGridLayout>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPlainTextEdit>
+#include <QProcess>
+
+#include "perfcomparator.h"
+
+// A/B 性能对比窗口
+// 每个版本可选择源码来源（编辑器中的内容、已保存的文件或 Git HEAD 版本）、
+// 编译器和编译参数，例如比较 -O2 与 -O3、g++ 与 clang++，或修改前后的代码。
+class PerfComparePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum SourceKind
+    {
+        EditorBuffer,
+        SavedFile,
+        GitHead
+    };
+
+    explicit PerfComparePanel(QWidget *parent = nullptr);
+
+    void startComparison(const QString &sourcePath, const QString &bufferText);
+    void stop();
+    bool isRunning() const { return comparator->isRunning() || gitProcess->state() != QProcess::NotRunning; }
+
+signals:
+    void startRequested();
+
+private slots:
+    void onProgress(int completed, int total);
+    void onFailed(const QString &message);
+    void onFinished(const PerfComparator::Report &report);
+    void onGitFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    struct VariantRow
+    {
+        QComboBox *sourceCombo;
+        QLineEdit *compilerEdit;
+        QLineEdit *flagsEdit;
+    };
+
+    VariantRow createVariantRow(QGridLayout *layout, int row, const QString &name);
+    bool prepareVariant(const VariantRow &row, const QString &name, const QString &sourcePath,
+                        const QString &bufferText, const QString &workDirectory,
+                        const QByteArray &headContent, PerfComparator::Variant *variant, QString *errorMessage);
+    // 源码都已取得（需要时包括 Git HEAD 版本）后准备两个版本并开始计时
+    void continueComparison(const QByteArray &headContent);
+    void saveOptions();
+    void updateButtons();
+    QString describeTimes(const QList<double> &times) const;
+
+    PerfComparator *comparator;
+    QProcess *gitProcess;
+    PerfComparator::Config pendingConfig;   // 等待 git show 期间保存的对比设置
+    QString pendingSourcePath;
+    QString pendingBufferText;
+    VariantRow rowA;
+    VariantRow rowB;
+    QLineEdit *inputEdit;
+    QSpinBox *runsSpinBox;
+    QSpinBox *timeLimitSpinBox;
+    QPushButton *startButton;
+    QProgressBar *progressBar;
+    QLabel *statusLabel;
+    QPlainTextEdit *reportView;
+    QString labelA;
+    QString labelB;
+};
@@ -0,0 +1,181 @@
+#include "plotwidget.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <cmath>
+
+namespace {
+const int TickCount = 5;
+const int MarginLeft = 60;
+const int MarginRight = 16;
+const int MarginTop = 16;
+const int MarginBottom = 40;
+}
+
+PlotWidget::PlotWidget(QWidget *parent)
+    : QWidget(parent)
+    , hasMarker(false)
+    , markerX(0)
+{
+    setMinimumHeight(160);
+}
+
+QSize PlotWidget::sizeHint() const
+{
+    return QSize(480, 260);
+}
+
+void PlotWidget::setAxisLabels(const QString &xLabel, const QString &yLabel)
+{
+    this->xLabel = xLabel;
+    this->yLabel = yLabel;
+    update();
+}
+
+void PlotWidget::setSeries(const QList<Series> &series)
+{
+    seriesList = series;
+    update();
+}
+
+void PlotWidget::setMarker(double x, const QString &label)
+{
+    hasMarker = true;
+    markerX = x;
+    markerLabel = label;
+    update();
+}
+
+void PlotWidget::clearMarker()
+{
+    hasMarker = false;
+    update();
+}
+
+void PlotWidget::clear()
+{
+    seriesList.clear();
+    hasMarker = false;
+    update();
+}
+
+QString PlotWidget::formatTick(double value)
+{
+    if (value != 0 && (std::fabs(value) >= 1e5 || std::fabs(value) < 1e-2)) {
+        return QString::number(value, 'g', 3);
+    }
+    return QString::number(value, 'f', std::fabs(value) < 10 ? 2 : 0);
+}
+
+void PlotWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), QColor("#1e1e1e"));
+
+    QRectF plotRect(MarginLeft, MarginTop,
+                    width() - MarginLeft - MarginRight, height() - MarginTop - MarginBottom);
+    if (plotRect.width() <= 0 || plotRect.height() <= 0) return;
+
+    // 数据范围，y 轴从 0 开始
+    double minX = 0;
+    double maxX = 0;
+    double maxY = 0;
+    bool first = true;
+    for (const Series &series : seriesList) {
+        for (const QPointF &point : series.points) {
+            if (first) {
+                minX = maxX = point.x();
+                first = false;
+            }
+            minX = qMin(minX, point.x());
+            maxX = qMax(maxX, point.x());
+            maxY = qMax(maxY, point.y());
+        }
+    }
+    if (hasMarker && !first) {
+        minX = qMin(minX, markerX);
+        maxX = qMax(maxX, markerX);
+    }
+    if (first) {
+        painter.setPen(QColor("#808080"));
+        painter.drawText(plotRect, Qt::AlignCenter, "暂无数据");
+        return;
+    }
+    if (maxX <= minX) maxX = minX + 1;
+    if (maxY <= 0) maxY = 1;
+    maxY *= 1.05;
+
+    auto mapPoint = [&](const QPointF &point) {
+        return QPointF(plotRect.left() + (point.x() - minX) / (maxX - minX) * plotRect.width(),
+                       plotRect.bottom() - point.y() / maxY * plotRect.height());
+    };
+
+    // 网格和刻度
+    QPen gridPen(QColor(60, 60, 60));
+    QPen textPen(QColor("#d4d4d4"));
+    for (int i = 0; i <= TickCount; ++i) {
+        double fraction = static_cast<double>(i) / TickCount;
+        qreal y = plotRect.bottom() - fraction * plotRect.height();
+        qreal x = plotRect.left() + fraction * plotRect.width();
+
+        painter.setPen(gridPen);
+        painter.drawLine(QPointF(plotRect.left(), y), QPointF(plotRect.right(), y));
+        painter.drawLine(QPointF(x, plotRect.top()), QPointF(x, plotRect.bottom()));
+
+        painter.setPen(textPen);
+        painter.drawText(QRectF(0, y - 8, MarginLeft - 6, 16), Qt::AlignRight | Qt::AlignVCenter,
+                         formatTick(fraction * maxY));
+        painter.drawText(QRectF(x - 40, plotRect.bottom() + 4, 80, 16), Qt::AlignCenter,
+                         formatTick(minX + fraction * (maxX - minX)));
+    }
+    painter.drawRect(plotRect);
+    painter.drawText(QRectF(plotRect.left(), height() - 18, plotRect.width(), 16), Qt::AlignCenter, xLabel);
+    painter.save();
+    painter.translate(12, plotRect.center().y());
+    painter.rotate(-90);
+    painter.drawText(QRectF(-plotRect.height() / 2, -8, plotRect.height(), 16), Qt::AlignCenter, yLabel);
+    painter.restore();
+
+    // 数据
+    painter.setClipRect(plotRect.adjusted(-4, -4, 4, 4));
+    for (const Series &series : seriesList) {
+        if (series.points.isEmpty()) continue;
+        if (series.showLine && series.points.size() > 1) {
+            QPainterPath path(mapPoint(series.points.first()));
+            for (int i = 1; i < series.points.size(); ++i) {
+                path.lineTo(mapPoint(series.points.at(i)));
+            }
+            painter.setPen(QPen(series.color, 2, series.penStyle));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPath(path);
+        }
+        if (series.showPoints) {
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(series.color);
+            for (const QPointF &point : series.points) {
+                painter.drawEllipse(mapPoint(point), 3.5, 3.5);
+            }
+        }
+    }
+
+    if (hasMarker) {
+        QPointF top = mapPoint(QPointF(markerX, maxY));
+        painter.setPen(QPen(QColor("#f44747"), 1, Qt::DashLine));
+        painter.drawLine(QPointF(top.x(), plotRect.top()), QPointF(top.x(), plotRect.bottom()));
+        painter.drawText(QPointF(top.x() + 4, plotRect.top() + 14), markerLabel);
+    }
+    painter.setClipping(false);
+
+    // 图例
+    qreal legendY = plotRect.top() + 6;
+    for (const Series &series : seriesList) {
+        if (series.name.isEmpty()) continue;
+        painter.setPen(QPen(series.color, 2, series.penStyle));
+        painter.drawLine(QPointF(plotRect.left() + 8, legendY + 6), QPointF(plotRect.left() + 28, legendY + 6));
+        painter.setPen(textPen);
+        painter.drawText(QPointF(plotRect.left() + 34, legendY + 10), series.name);
+        legendY += 16;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QWidget>
+#include <QList>
+#include <QPointF>
+#include <QColor>
+
+// 简单的折线/散点图
+// 用于复杂度分析、线程扩展性等结果的可视化，只依赖 QPainter，不需要 Qt Charts。
+class PlotWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct Series
+    {
+        QString name;
+        QColor color;
+        QList<QPointF> points;
+        bool showPoints = true;
+        bool showLine = true;
+        Qt::PenStyle penStyle = Qt::SolidLine;
+    };
+
+    explicit PlotWidget(QWidget *parent = nullptr);
+
+    void setAxisLabels(const QString &xLabel, const QString &yLabel);
+    void setSeries(const QList<Series> &series);
+    // 竖直标记线，例如扩展性开始崩溃的位置
+    void setMarker(double x, const QString &label);
+    void clearMarker();
+    void clear();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static QString formatTick(double value);
+
+    QString xLabel;
+    QString yLabel;
+    QList<Series> seriesList;
+    bool hasMarker;
+    double markerX;
+    QString markerLabel;
+};
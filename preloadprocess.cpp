@@ -0,0 +1,204 @@
+#include "preloadprocess.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+PreloadProcess::PreloadProcess(QObject *parent)
+    : QObject(parent)
+    , process(new QProcess(this))
+    , notifier(nullptr)
+    , readFd(-1)
+{
+    connect(process, &QProcess::readyReadStandardOutput, this, [this]() {
+        emit output(QString::fromUtf8(process->readAllStandardOutput()));
+    });
+    connect(process, &QProcess::readyReadStandardError, this, [this]() {
+        emit output(QString::fromUtf8(process->readAllStandardError()));
+    });
+    connect(process, &QProcess::finished, this, &PreloadProcess::onProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            closePipe();
+            emit output("程序启动失败\n");
+            emit finished(-1, QProcess::CrashExit);
+        }
+    });
+}
+
+PreloadProcess::~PreloadProcess()
+{
+    if (process->state() != QProcess::NotRunning) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+    closePipe();
+}
+
+QString PreloadProcess::libraryPath(const QString &fileName)
+{
+    return QDir(QCoreApplication::applicationDirPath()).filePath(fileName);
+}
+
+bool PreloadProcess::start(const QString &executable, const QString &workingDirectory, const QString &library,
+                           const QString &fdVariable, const QProcessEnvironment &extraEnvironment,
+                           QString *errorMessage)
+{
+#ifdef Q_OS_UNIX
+    if (isRunning()) return false;
+    if (!QFileInfo::exists(library)) {
+        if (errorMessage) *errorMessage = "找不到分析库: " + library;
+        return false;
+    }
+
+    int fds[2];
+    if (::pipe2(fds, O_CLOEXEC) != 0) {
+        if (errorMessage) *errorMessage = "无法创建管道";
+        return false;
+    }
+    readFd = fds[0];
+    const int writeFd = fds[1];
+    ::fcntl(readFd, F_SETFL, ::fcntl(readFd, F_GETFL) | O_NONBLOCK);
+    pending.clear();
+
+    notifier = new QSocketNotifier(readFd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, [this]() { readPipe(); });
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    const QStringList extraKeys = extraEnvironment.keys();
+    for (const QString &key : extraKeys) {
+        environment.insert(key, extraEnvironment.value(key));
+    }
+    QString preload = environment.value("LD_PRELOAD");
+    environment.insert("LD_PRELOAD", preload.isEmpty() ? library : library + ":" + preload);
+    environment.insert(fdVariable, QString::number(writeFd));
+
+    // 管道两端都带 O_CLOEXEC，只在子进程里让写端在 exec 后保留下来
+    process->setChildProcessModifier([writeFd]() {
+        ::fcntl(writeFd, F_SETFD, 0);
+    });
+    process->setProcessEnvironment(environment);
+    process->setWorkingDirectory(workingDirectory);
+    process->start(executable);
+    // 分析运行不提供交互输入，关闭标准输入避免程序等待 cin
+    process->closeWriteChannel();
+    ::close(writeFd);
+    return true;
+#else
+    Q_UNUSED(executable)
+    Q_UNUSED(workingDirectory)
+    Q_UNUSED(library)
+    Q_UNUSED(fdVariable)
+    Q_UNUSED(extraEnvironment)
+    if (errorMessage) *errorMessage = "当前平台不支持注入分析库";
+    return false;
+#endif
+}
+
+void PreloadProcess::kill()
+{
+    if (isRunning()) process->kill();
+}
+
+void PreloadProcess::readPipe()
+{
+#ifdef Q_OS_UNIX
+    if (readFd < 0) return;
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t count = ::read(readFd, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            // 写端全部关闭（程序及其子进程都已退出）
+            if (count == 0) closePipe();
+            break;
+        }
+        pending.append(buffer, count);
+    }
+
+    int start = 0;
+    int newline;
+    while ((newline = pending.indexOf('\n', start)) >= 0) {
+        emit lineReceived(pending.mid(start, newline - start));
+        start = newline + 1;
+    }
+    pending.remove(0, start);
+#endif
+}
+
+void PreloadProcess::closePipe()
+{
+    if (notifier) {
+        notifier->setEnabled(false);
+        notifier->deleteLater();
+        notifier = nullptr;
+    }
+#ifdef Q_OS_UNIX
+    if (readFd >= 0) {
+        ::close(readFd);
+        readFd = -1;
+    }
+#endif
+}
+
+void PreloadProcess::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    readPipe();
+    closePipe();
+    if (!pending.isEmpty()) {
+        emit lineReceived(pending);
+        pending.clear();
+    }
+    emit finished(exitCode, exitStatus);
+}
+
+bool PreloadProcess::parseFrame(const QByteArray &line, StackFrame *frame)
+{
+    if (!line.startsWith("F ")) return false;
+    int space = line.indexOf(' ', 2);
+    if (space < 0) return false;
+    bool ok = false;
+    frame->offset = line.mid(2, space - 2).toULongLong(&ok, 16);
+    // 模块路径可能包含空格
+    frame->module = QString::fromLocal8Bit(line.mid(space + 1));
+    return ok && !frame->module.isEmpty();
+}
+
+void PreloadProcess::symbolize(const QList<QList<StackFrame>*> &stacks, const QString &executable)
+{
+    QHash<QString, QSet<quint64>> uniqueOffsets;
+    for (QList<StackFrame> *frames : stacks) {
+        for (StackFrame &frame : *frames) {
+            if (!QFileInfo(frame.module).isAbsolute()) frame.module = executable;
+            uniqueOffsets[frame.module].insert(frame.offset);
+        }
+    }
+    QHash<QString, QList<quint64>> offsetsByModule;
+    for (auto it = uniqueOffsets.constBegin(); it != uniqueOffsets.constEnd(); ++it) {
+        offsetsByModule.insert(it.key(), it.value().values());
+    }
+
+    QHash<QString, QHash<quint64, Symbolizer::Location>> locations = Symbolizer::symbolizeAll(offsetsByModule);
+    for (QList<StackFrame> *frames : stacks) {
+        for (StackFrame &frame : *frames) {
+            frame.location = locations.value(frame.module).value(frame.offset);
+        }
+    }
+}
+
+const StackFrame *PreloadProcess::firstUserFrame(const QList<StackFrame> &frames)
+{
+    for (const StackFrame &frame : frames) {
+        if (frame.location.isValid() && Symbolizer::isUserSource(frame.location.file)) return &frame;
+    }
+    return nullptr;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QProcess>
+
+#include "symbolizer.h"
+
+class QSocketNotifier;
+
+// 分析库记录的一帧调用栈（模块 + 偏移），符号化后带源码位置
+struct StackFrame
+{
+    QString module;
+    quint64 offset = 0;
+    Symbolizer::Location location;
+};
+
+// 注入分析库运行的子进程
+// 通过 LD_PRELOAD 注入拦截库，并把一个管道的写端交给子进程（描述符编号通过环境变量传递），
+// 拦截库写回的文本按行交给调用者。内存分析和锁竞争分析共用。
+class PreloadProcess : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PreloadProcess(QObject *parent = nullptr);
+    ~PreloadProcess();
+
+    // 拦截库与 IDE 可执行文件放在同一目录
+    static QString libraryPath(const QString &fileName);
+
+    bool start(const QString &executable, const QString &workingDirectory, const QString &library,
+               const QString &fdVariable, const QProcessEnvironment &extraEnvironment = QProcessEnvironment(),
+               QString *errorMessage = nullptr);
+    void kill();
+    bool isRunning() const { return process->state() != QProcess::NotRunning; }
+
+    // "F <偏移> <模块路径>" 行
+    static bool parseFrame(const QByteArray &line, StackFrame *frame);
+    // 所有调用栈一起批量符号化；主程序的模块名是启动时的 argv[0]，替换为 executable
+    static void symbolize(const QList<QList<StackFrame>*> &stacks, const QString &executable);
+    // 第一个属于用户源码的帧，没有时返回 nullptr
+    static const StackFrame *firstUserFrame(const QList<StackFrame> &frames);
+
+signals:
+    void output(const QString &text);
+    void lineReceived(const QByteArray &line);
+    // 管道中的数据全部读完后才发出
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void readPipe();
+    void closePipe();
+
+    QProcess *process;
+    QSocketNotifier *notifier;
+    int readFd;
+    QByteArray pending;
+};
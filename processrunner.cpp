@@ -0,0 +1,286 @@
+#include "processrunner.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <cmath>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#endif
+
+ProcessRunner::Result ProcessRunner::run(const Spec &spec)
+{
+    Result result;
+
+#ifdef Q_OS_UNIX
+    QString executable = spec.program;
+    if (!executable.contains('/')) {
+        executable = QStandardPaths::findExecutable(spec.program);
+    }
+    if (executable.isEmpty()) {
+        result.error = "找不到可执行文件: " + spec.program;
+        return result;
+    }
+
+    // fork 之后子进程只能调用 async-signal-safe 的函数，所有参数提前准备好
+    QList<QByteArray> argumentStorage;
+    argumentStorage << QFile::encodeName(executable);
+    for (const QString &argument : spec.arguments) {
+        argumentStorage << argument.toLocal8Bit();
+    }
+    std::vector<char*> argv;
+    for (QByteArray &argument : argumentStorage) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    QList<QByteArray> environmentStorage;
+    std::vector<char*> envp;
+    for (const QString &entry : spec.environment) {
+        environmentStorage << entry.toLocal8Bit();
+    }
+    for (QByteArray &entry : environmentStorage) {
+        envp.push_back(entry.data());
+    }
+    envp.push_back(nullptr);
+    char **childEnvironment = spec.environment.isEmpty() ? environ : envp.data();
+
+    QByteArray directory = QFile::encodeName(spec.workingDirectory);
+
+    // 所有描述符都带 O_CLOEXEC：并行运行时不会被其他线程 fork 出的子进程继承，
+    // 否则管道写端不关闭，读端永远等不到 EOF
+    QByteArray stdinPath = spec.stdinFile.isEmpty() ? QByteArray("/dev/null") : QFile::encodeName(spec.stdinFile);
+    int stdinFd = ::open(stdinPath.constData(), O_RDONLY | O_CLOEXEC);
+    if (stdinFd < 0) {
+        result.error = "无法打开输入文件: " + spec.stdinFile;
+        return result;
+    }
+
+    int stdoutPipe[2] = {-1, -1};
+    int stdoutFd = -1;
+    if (!spec.stdoutFile.isEmpty()) {
+        stdoutFd = ::open(QFile::encodeName(spec.stdoutFile).constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    } else if (spec.stdoutSink) {
+        if (::pipe2(stdoutPipe, O_CLOEXEC) == 0) {
+            stdoutFd = stdoutPipe[1];
+        }
+    } else {
+        stdoutFd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    }
+
+    int stderrPipe[2] = {-1, -1};
+    if (stdoutFd < 0 || ::pipe2(stderrPipe, O_CLOEXEC) != 0) {
+        ::close(stdinFd);
+        if (stdoutFd >= 0) ::close(stdoutFd);
+        if (stdoutPipe[0] >= 0) ::close(stdoutPipe[0]);
+        result.error = "无法创建输出管道";
+        return result;
+    }
+
+    struct rlimit cpuLimit;
+    cpuLimit.rlim_cur = static_cast<rlim_t>(std::ceil(spec.cpuTimeLimit));
+    cpuLimit.rlim_max = cpuLimit.rlim_cur + 1;
+    struct rlimit memoryLimit;
+    memoryLimit.rlim_cur = static_cast<rlim_t>(spec.memoryLimitBytes);
+    memoryLimit.rlim_max = static_cast<rlim_t>(spec.memoryLimitBytes);
+    struct rlimit coreLimit;
+    coreLimit.rlim_cur = 0;
+    coreLimit.rlim_max = 0;
+
+#ifdef Q_OS_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : spec.cpuAffinity) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &cpuSet);
+    }
+#endif
+
+    // 只限制 CPU 时间时，墙钟时间兜底（例如程序阻塞在 sleep 上）
+    qint64 wallLimitMs = spec.wallTimeLimitMs;
+    if (wallLimitMs <= 0 && spec.cpuTimeLimit > 0) {
+        wallLimitMs = static_cast<qint64>(spec.cpuTimeLimit * 3000) + 1000;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ::dup2(stdinFd, STDIN_FILENO);
+        ::dup2(stdoutFd, STDOUT_FILENO);
+        ::dup2(stderrPipe[1], STDERR_FILENO);
+        if (spec.cpuTimeLimit > 0) ::setrlimit(RLIMIT_CPU, &cpuLimit);
+        if (spec.memoryLimitBytes > 0) ::setrlimit(RLIMIT_AS, &memoryLimit);
+        ::setrlimit(RLIMIT_CORE, &coreLimit);
+#ifdef Q_OS_LINUX
+        // 在 exec 之前设置，程序创建的所有线程都会继承
+        if (!spec.cpuAffinity.isEmpty()) ::sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+#endif
+        if (spec.niceValue != 0) ::setpriority(PRIO_PROCESS, 0, spec.niceValue);
+        if (!directory.isEmpty() && ::chdir(directory.constData()) != 0) {
+            ::_exit(127);
+        }
+        ::execve(argv[0], argv.data(), childEnvironment);
+        ::_exit(127);
+    }
+
+    ::close(stdinFd);
+    ::close(stdoutFd);
+    ::close(stderrPipe[1]);
+
+    if (pid < 0) {
+        if (stdoutPipe[0] >= 0) ::close(stdoutPipe[0]);
+        ::close(stderrPipe[0]);
+        result.error = "无法创建子进程";
+        return result;
+    }
+    result.started = true;
+
+    bool killed = false;
+    auto killChild = [&]() {
+        if (!killed) {
+            ::kill(pid, SIGKILL);
+            killed = true;
+        }
+    };
+
+    // 读取标准输出/标准错误，直到两个管道都关闭
+    struct pollfd fds[2];
+    int fdCount = 0;
+    int stdoutIndex = -1;
+    if (stdoutPipe[0] >= 0) {
+        stdoutIndex = fdCount;
+        fds[fdCount++] = {stdoutPipe[0], POLLIN, 0};
+    }
+    int stderrIndex = fdCount;
+    fds[fdCount++] = {stderrPipe[0], POLLIN, 0};
+    int openCount = fdCount;
+
+    std::vector<char> buffer(64 * 1024);
+    bool sinkDone = false;
+
+    while (openCount > 0) {
+        int timeout = 100;
+        if (wallLimitMs > 0) {
+            qint64 remaining = wallLimitMs - timer.elapsed();
+            if (remaining <= 0) {
+                if (!killed) result.wallTimeExceeded = true;
+                killChild();
+            }
+            timeout = static_cast<int>(qBound<qint64>(0, remaining, 100));
+            if (killed) timeout = 100;
+        }
+
+        if (spec.cancelFlag && spec.cancelFlag->load() && !killed) {
+            result.cancelled = true;
+            killChild();
+        }
+
+        int ready = ::poll(fds, fdCount, timeout);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+
+        for (int i = 0; i < fdCount; ++i) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            ssize_t count = ::read(fds[i].fd, buffer.data(), buffer.size());
+            if (count > 0) {
+                if (i == stdoutIndex) {
+                    if (!sinkDone && !spec.stdoutSink(buffer.data(), count)) {
+                        sinkDone = true;
+                        result.stoppedBySink = true;
+                        killChild();
+                    }
+                } else if (i == stderrIndex) {
+                    qint64 room = spec.stderrCaptureLimit - result.stderrOutput.size();
+                    if (room > 0) {
+                        result.stderrOutput.append(buffer.data(), qMin<qint64>(room, count));
+                    }
+                }
+                continue;
+            }
+            if (count < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+
+            ::close(fds[i].fd);
+            fds[i].fd = -1;
+            --openCount;
+        }
+    }
+    for (int i = 0; i < fdCount; ++i) {
+        if (fds[i].fd >= 0) ::close(fds[i].fd);
+    }
+
+    // 等待子进程退出（管道关闭后进程仍可能在运行，继续遵守超时）
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    while (true) {
+        pid_t waited = ::wait4(pid, &status, (wallLimitMs > 0 || spec.cancelFlag) ? WNOHANG : 0, &usage);
+        if (waited == pid) break;
+        if (waited < 0 && errno != EINTR) break;
+        if (waited == 0) {
+            if (spec.cancelFlag && spec.cancelFlag->load() && !killed) {
+                result.cancelled = true;
+                killChild();
+            }
+            if (wallLimitMs > 0 && timer.elapsed() >= wallLimitMs) {
+                if (!killed) result.wallTimeExceeded = true;
+                killChild();
+            }
+            ::usleep(1000);
+        }
+    }
+
+    result.wallTimeUs = timer.nsecsElapsed() / 1000;
+    result.cpuTimeUs = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL
+                       + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+    result.peakMemoryKb = usage.ru_maxrss;
+
+    if (WIFEXITED(status)) {
+        result.exitCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.signal = WTERMSIG(status);
+    }
+    result.cpuTimeExceeded = result.signal == SIGXCPU
+        || (spec.cpuTimeLimit > 0 && result.cpuTimeUs > static_cast<qint64>(spec.cpuTimeLimit * 1e6));
+#else
+    Q_UNUSED(spec)
+    result.error = "当前平台不支持受限运行";
+#endif
+
+    return result;
+}
+
+QList<int> ProcessRunner::availableCpus()
+{
+    QList<int> cpus;
+#ifdef Q_OS_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (::sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet)) cpus.append(cpu);
+        }
+    }
+#endif
+    if (cpus.isEmpty()) {
+        for (int cpu = 0; cpu < QThread::idealThreadCount(); ++cpu) cpus.append(cpu);
+    }
+    return cpus;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+#include <atomic>
+#include <functional>
+
+// 受限进程运行器
+// 直接 fork/exec 子进程，可以在子进程中设置 setrlimit 资源限制，
+// 并通过 wait4 取得 CPU 时间和峰值内存。run() 是同步调用，
+// 设计为在工作线程中并行使用（测试用例、对拍、性能测量等）。
+class ProcessRunner
+{
+public:
+    // 返回 false 表示不再需要后续输出，子进程会被结束
+    using OutputSink = std::function<bool(const char *data, qint64 size)>;
+
+    struct Spec
+    {
+        QString program;
+        QStringList arguments;
+        QString workingDirectory;
+        QStringList environment;        // "KEY=VALUE"，为空时继承当前环境
+        QString stdinFile;              // 为空时使用 /dev/null
+        QString stdoutFile;             // 非空时标准输出直接写入该文件
+        OutputSink stdoutSink;          // 未指定 stdoutFile 时流式接收标准输出
+        qint64 stderrCaptureLimit = 64 * 1024;
+
+        double cpuTimeLimit = 0;        // 秒，0 表示不限制
+        qint64 wallTimeLimitMs = 0;     // 0 表示不限制
+        qint64 memoryLimitBytes = 0;    // 地址空间上限，0 表示不限制
+        QList<int> cpuAffinity;         // 非空时子进程只能运行在这些 CPU 上（仅 Linux）
+        int niceValue = 0;              // 子进程的 nice 值，负数需要相应权限
+
+        const std::atomic<bool> *cancelFlag = nullptr;  // 置位后子进程被结束
+    };
+
+    struct Result
+    {
+        bool started = false;
+        QString error;
+        int exitCode = -1;
+        int signal = 0;                 // 被信号终止时的信号编号
+        bool wallTimeExceeded = false;
+        bool cpuTimeExceeded = false;
+        bool stoppedBySink = false;
+        bool cancelled = false;
+        qint64 wallTimeUs = 0;
+        qint64 cpuTimeUs = 0;
+        qint64 peakMemoryKb = 0;
+        QByteArray stderrOutput;
+
+        bool crashed() const { return signal != 0 || exitCode != 0; }
+    };
+
+    static Result run(const Spec &spec);
+    // 当前进程允许使用的 CPU 编号
+    static QList<int> availableCpus();
+};
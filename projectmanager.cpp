@@ -5,17 +5,54 @@
 #include <QJsonObject>
 #include <QJsonArray>
 
+namespace
+{
+// 两个相对目录的最近公共祖先，根目录为空字符串
+QString commonDirectory(const QString &a, const QString &b)
+{
+    const QStringList aParts = a.split('/', Qt::SkipEmptyParts);
+    const QStringList bParts = b.split('/', Qt::SkipEmptyParts);
+    QStringList common;
+    for (int i = 0; i < aParts.size() && i < bParts.size() && aParts[i] == bParts[i]; ++i) {
+        common.append(aParts[i]);
+    }
+    return common.join('/');
+}
+}
+
 ProjectManager::ProjectManager(QObject *parent)
     : QObject(parent)
     , projectTree(nullptr)
+    , projectTemplate(ProjectTemplate::QtWidgets)
+    , treeModel(new ProjectTreeModel(&fileIndex, this))
+    , scanner(new ProjectScanner(this))
+    , watcher(new FileWatcher(this))
+    , symbolIndex(new SymbolIndex(this))
+    , symbolTimer(new QTimer(this))
 {
+    symbolTimer->setSingleShot(true);
+    symbolTimer->setInterval(1000);
+    
+    connect(scanner, &ProjectScanner::filesFound, this, &ProjectManager::onFilesFound);
+    connect(scanner, &ProjectScanner::directoriesFound, this, &ProjectManager::onDirectoriesFound);
+    connect(scanner, &ProjectScanner::finished, this, &ProjectManager::onScanFinished);
+    connect(watcher, &FileWatcher::changed, this, &ProjectManager::onFilesChanged);
+    connect(symbolTimer, &QTimer::timeout, this, &ProjectManager::updateSymbolIndex);
+    connect(watcher, &FileWatcher::overflowed, this, [this]() {
+        // 丢失了部分事件，只能重新扫描
+        loadProjectFiles();
+        updateProjectTree();
+    });
+    connect(watcher, &FileWatcher::watchLimitReached, this, []() {
+        qWarning("目录监视数量达到系统上限（fs.inotify.max_user_watches），部分目录的外部修改不会自动更新");
+    });
 }
 
 ProjectManager::~ProjectManager()
 {
 }
 
-void ProjectManager::setProjectTree(QTreeWidget *tree)
+void ProjectManager::setProjectTree(QTreeView *tree)
 {
     projectTree = tree;
     setupProjectTree();
@@ -25,12 +62,16 @@ void ProjectManager::setupProjectTree()
 {
     if (!projectTree) return;
 
-    projectTree->setHeaderLabel("项目文件");
+    projectTree->setModel(treeModel);
+    projectTree->setHeaderHidden(true);
+    projectTree->setEditTriggers(QAbstractItemView::NoEditTriggers);
     projectTree->setContextMenuPolicy(Qt::CustomContextMenu);
+    // 所有行等高，视图不必逐行计算高度，大目录展开时滚动仍然流畅
+    projectTree->setUniformRowHeights(true);
     
-    connect(projectTree, &QTreeWidget::itemDoubleClicked,
+    connect(projectTree, &QTreeView::doubleClicked,
             this, &ProjectManager::onTreeItemDoubleClicked);
-    connect(projectTree, &QTreeWidget::customContextMenuRequested,
+    connect(projectTree, &QTreeView::customContextMenuRequested,
             this, &ProjectManager::onTreeContextMenu);
 }
 
@@ -46,10 +87,20 @@ void ProjectManager::openProject(const QString &path)
     emit projectOpened(path);
 }
 
-void ProjectManager::createNewProject(const QString &name, const QString &path)
+QString ProjectManager::templateName(ProjectTemplate projectTemplate)
+{
+    switch (projectTemplate) {
+    case ProjectTemplate::QtWidgets: return "qtwidgets";
+    case ProjectTemplate::Benchmark: return "benchmark";
+    }
+    return QString();
+}
+
+void ProjectManager::createNewProject(const QString &name, const QString &path, ProjectTemplate projectTemplate)
 {
     projectName = name;
     projectPath = path;
+    this->projectTemplate = projectTemplate;
     
     // 创建项目目录
     QDir dir(path);
@@ -63,11 +114,17 @@ void ProjectManager::createNewProject(const QString &name, const QString &path)
     otherFiles.clear();
     
     // 创建默认文件
-    createMainCpp();
-    createCMakeLists();
+    if (projectTemplate == ProjectTemplate::Benchmark) {
+        createBenchmarkCpp();
+        createBenchmarkCMakeLists();
+    } else {
+        createMainCpp();
+        createCMakeLists();
+    }
     
-    // 保存项目文件
+    // 保存项目文件，再按打开项目的流程建立索引（目录中可能已有其他文件）
     saveProjectFile();
+    loadProjectFiles();
     updateProjectTree();
     
     emit projectOpened(path);
@@ -78,15 +135,14 @@ void ProjectManager::loadProjectFiles()
     sourceFiles.clear();
     headerFiles.clear();
     otherFiles.clear();
+    watcher->clear();
+    treeModel->setRootPath(projectPath);
+    treeModel->clear();
     
-    QDir projectDir(projectPath);
-    QStringList filters;
-    filters << "*.cpp" << "*.c" << "*.cc" << "*.cxx";
-    sourceFiles = projectDir.entryList(filters, QDir::Files);
-    
-    filters.clear();
-    filters << "*.h" << "*.hpp" << "*.hh" << "*.hxx";
-    headerFiles = projectDir.entryList(filters, QDir::Files);
+    // 先用上次保存的符号索引，扫描完成后再对照文件更新
+    symbolTimer->stop();
+    changedSymbolFiles.clear();
+    symbolIndex->open(projectPath);
     
     // 加载项目配置文件
     QString projectFile = projectPath + "/" + projectName + ".lionproj";
@@ -96,6 +152,9 @@ void ProjectManager::loadProjectFiles()
             QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
             QJsonObject obj = doc.object();
             
+            projectTemplate = obj["template"].toString() == templateName(ProjectTemplate::Benchmark)
+                ? ProjectTemplate::Benchmark : ProjectTemplate::QtWidgets;
+            
             QJsonArray sources = obj["sourceFiles"].toArray();
             for (const QJsonValue &value : sources) {
                 sourceFiles.append(value.toString());
@@ -107,6 +166,16 @@ void ProjectManager::loadProjectFiles()
             }
         }
     }
+    sourceFiles.removeDuplicates();
+    headerFiles.removeDuplicates();
+    
+    // 登记的文件先进索引，目录扫描到同一文件时索引会去重
+    for (const QString &file : sourceFiles + headerFiles) {
+        treeModel->insertFile(QDir::cleanPath(file));
+    }
+    
+    // 子目录在后台递归扫描，结果分批加入索引和项目树
+    scanner->start(projectPath);
 }
 
 void ProjectManager::saveProjectFile()
@@ -114,6 +183,7 @@ void ProjectManager::saveProjectFile()
     QJsonObject obj;
     obj["projectName"] = projectName;
     obj["projectPath"] = projectPath;
+    obj["template"] = templateName(projectTemplate);
     
     QJsonArray sources;
     for (const QString &file : sourceFiles) {
@@ -206,126 +276,330 @@ void ProjectManager::createMainCpp()
     sourceFiles.append("main.cpp");
 }
 
+void ProjectManager::createBenchmarkCMakeLists()
+{
+    // 依次尝试系统安装的 Google Benchmark、项目内 third_party/benchmark，最后才联网下载
+    QString cmakeContent = QString(
+        "cmake_minimum_required(VERSION 3.14)\n"
+        "project(%1 LANGUAGES CXX)\n\n"
+        "set(CMAKE_CXX_STANDARD 17)\n"
+        "set(CMAKE_CXX_STANDARD_REQUIRED ON)\n"
+        "set(CMAKE_CXX_EXTENSIONS OFF)\n"
+        "set(CMAKE_EXPORT_COMPILE_COMMANDS ON)\n\n"
+        "# 基准测试只在 Release 下有意义\n"
+        "if(NOT CMAKE_BUILD_TYPE)\n"
+        "    set(CMAKE_BUILD_TYPE Release CACHE STRING \"Build type\" FORCE)\n"
+        "endif()\n\n"
+        "find_package(benchmark QUIET)\n"
+        "if(NOT benchmark_FOUND)\n"
+        "    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL \"\" FORCE)\n"
+        "    set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL \"\" FORCE)\n"
+        "    set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL \"\" FORCE)\n"
+        "    if(EXISTS ${CMAKE_CURRENT_SOURCE_DIR}/third_party/benchmark/CMakeLists.txt)\n"
+        "        add_subdirectory(third_party/benchmark EXCLUDE_FROM_ALL)\n"
+        "    else()\n"
+        "        include(FetchContent)\n"
+        "        FetchContent_Declare(benchmark\n"
+        "            GIT_REPOSITORY https://github.com/google/benchmark.git\n"
+        "            GIT_TAG v1.8.3\n"
+        "        )\n"
+        "        FetchContent_MakeAvailable(benchmark)\n"
+        "    endif()\n"
+        "endif()\n\n"
+        "add_executable(%1\n"
+        "    main.cpp\n"
+        ")\n\n"
+        "target_link_libraries(%1 PRIVATE benchmark::benchmark)\n"
+    ).arg(projectName);
+    
+    QString cmakePath = projectPath + "/CMakeLists.txt";
+    QFile file(cmakePath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream stream(&file);
+        stream << cmakeContent;
+    }
+}
+
+void ProjectManager::createBenchmarkCpp()
+{
+    QString mainContent = QString(
+        "#include <benchmark/benchmark.h>\n"
+        "#include <numeric>\n"
+        "#include <vector>\n\n"
+        "// 框架会自动决定迭代次数，state.range(0) 是当前的参数\n"
+        "static void BM_VectorSum(benchmark::State &state)\n"
+        "{\n"
+        "    std::vector<int> data(state.range(0));\n"
+        "    std::iota(data.begin(), data.end(), 0);\n\n"
+        "    for (auto _ : state) {\n"
+        "        long long sum = std::accumulate(data.begin(), data.end(), 0LL);\n"
+        "        // 防止编译器把没有使用的结果优化掉\n"
+        "        benchmark::DoNotOptimize(sum);\n"
+        "    }\n"
+        "    state.SetItemsProcessed(state.iterations() * state.range(0));\n"
+        "}\n"
+        "BENCHMARK(BM_VectorSum)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);\n\n"
+        "BENCHMARK_MAIN();\n"
+    );
+    
+    QString mainPath = projectPath + "/main.cpp";
+    QFile file(mainPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream stream(&file);
+        stream << mainContent;
+    }
+    
+    sourceFiles.append("main.cpp");
+}
+
 void ProjectManager::addFileToProject(const QString &filePath)
 {
-    QFileInfo fileInfo(filePath);
-    QString extension = fileInfo.suffix().toLower();
+    QString file = relativePath(filePath);
     
-    if (extension == "cpp" || extension == "c" || extension == "cc" || extension == "cxx") {
-        if (!sourceFiles.contains(fileInfo.fileName())) {
-            sourceFiles.append(fileInfo.fileName());
+    switch (FileIndex::categoryOf(file)) {
+    case FileIndex::Source:
+        if (!sourceFiles.contains(file)) {
+            sourceFiles.append(file);
         }
-    } else if (extension == "h" || extension == "hpp" || extension == "hh" || extension == "hxx") {
-        if (!headerFiles.contains(fileInfo.fileName())) {
-            headerFiles.append(fileInfo.fileName());
+        break;
+    case FileIndex::Header:
+        if (!headerFiles.contains(file)) {
+            headerFiles.append(file);
         }
-    } else {
-        if (!otherFiles.contains(fileInfo.fileName())) {
-            otherFiles.append(fileInfo.fileName());
+        break;
+    case FileIndex::Other:
+        if (!otherFiles.contains(file)) {
+            otherFiles.append(file);
         }
+        break;
     }
     
+    treeModel->insertFile(file);
     saveProjectFile();
-    updateProjectTree();
     emit fileAdded(filePath);
 }
 
 void ProjectManager::removeFileFromProject(const QString &filePath)
 {
-    QFileInfo fileInfo(filePath);
-    QString fileName = fileInfo.fileName();
+    QString file = relativePath(filePath);
     
-    sourceFiles.removeAll(fileName);
-    headerFiles.removeAll(fileName);
-    otherFiles.removeAll(fileName);
+    sourceFiles.removeAll(file);
+    headerFiles.removeAll(file);
+    otherFiles.removeAll(file);
+    treeModel->removeFile(file);
     
     saveProjectFile();
-    updateProjectTree();
     emit fileRemoved(filePath);
 }
 
+QString ProjectManager::relativePath(const QString &filePath) const
+{
+    return QDir::cleanPath(QDir(projectPath).relativeFilePath(filePath));
+}
+
+QString ProjectManager::targetDirectory() const
+{
+    if (!projectTree) return projectPath;
+    
+    QModelIndex index = projectTree->currentIndex();
+    if (!index.isValid()) return projectPath;
+    
+    QString path = index.data(ProjectTreeModel::FilePathRole).toString();
+    return treeModel->isDirectory(index) ? path : QFileInfo(path).absolutePath();
+}
+
 void ProjectManager::updateProjectTree()
 {
-    if (!projectTree) return;
+    // 模型直接读取索引，只需让视图丢弃已展开的节点
+    treeModel->reload();
+}
+
+void ProjectManager::onFilesFound(const QStringList &relativePaths)
+{
+    // 未展开的目录中的文件只进索引，展开时才生成行
+    for (const QString &file : relativePaths) {
+        treeModel->insertFile(file);
+    }
+}
+
+void ProjectManager::onDirectoriesFound(const QStringList &relativePaths)
+{
+    for (const QString &directory : relativePaths) {
+        watcher->addDirectory(directory.isEmpty() ? projectPath : projectPath + "/" + directory);
+    }
+}
+
+void ProjectManager::onScanFinished(int fileCount, qint64 elapsedMs)
+{
+    Q_UNUSED(fileCount)
+    emit indexingFinished(fileIndex.size(), elapsedMs);
+    
+    symbolTimer->stop();
+    changedSymbolFiles.clear();
+    symbolIndex->update(getSourceFiles() + getHeaderFiles());
+}
+
+void ProjectManager::updateSymbolIndex()
+{
+    // 扫描结束时会整体更新一次
+    if (scanner->isRunning() || changedSymbolFiles.isEmpty()) return;
     
-    projectTree->clear();
+    const QStringList changed = changedSymbolFiles;
+    changedSymbolFiles.clear();
+    symbolIndex->update(getSourceFiles() + getHeaderFiles(), changed);
+}
+
+void ProjectManager::onFilesChanged(const QList<FileWatcher::Change> &changes)
+{
+    // 被修改的 .gitignore 所在目录的公共祖先
+    bool ignoreRulesChanged = false;
+    QString rescanRoot;
     
-    // 添加源文件
-    if (!sourceFiles.isEmpty()) {
-        QTreeWidgetItem *sourceItem = new QTreeWidgetItem(projectTree);
-        sourceItem->setText(0, "源文件");
-        sourceItem->setIcon(0, QIcon(":/icons/source.png"));
+    for (const FileWatcher::Change &change : changes) {
+        const QString file = relativePath(change.path);
+        if (file.startsWith("../")) continue;
         
-        for (const QString &file : sourceFiles) {
-            createFileItem(projectPath + "/" + file, file);
+        if (file == ".gitignore" || file.endsWith("/.gitignore")) {
+            scanner->invalidateIgnoreRules();
+            const QString directory = file == ".gitignore" ? QString() : file.left(file.lastIndexOf('/'));
+            rescanRoot = ignoreRulesChanged ? commonDirectory(rescanRoot, directory) : directory;
+            ignoreRulesChanged = true;
+        }
+        
+        switch (change.type) {
+        case FileWatcher::Created:
+            if (change.isDirectory) {
+                addIndexedDirectory(file);
+            } else {
+                addIndexedFile(file);
+            }
+            break;
+        case FileWatcher::Removed:
+            if (change.isDirectory) {
+                removeIndexedDirectory(file);
+            } else {
+                treeModel->removeFile(file);
+            }
+            break;
+        case FileWatcher::Renamed: {
+            const QString oldFile = relativePath(change.oldPath);
+            if (!change.isDirectory) {
+                renameIndexedFile(oldFile, file);
+            } else if (fileIndex.findDirectory(oldFile) < 0) {
+                addIndexedDirectory(file);
+            } else if (scanner->isIgnored(file, true)) {
+                removeIndexedDirectory(oldFile);
+            } else {
+                // 子目录的监视已随目录改名，只需要改写索引和树中的路径
+                const QStringList files = treeModel->removeDirectory(oldFile);
+                for (const QString &oldPath : files) {
+                    addIndexedFile(file + oldPath.mid(oldFile.length()));
+                }
+            }
+            break;
+        }
+        case FileWatcher::Modified:
+            // 内容变化不影响项目树，打开的文件由编辑器一侧处理
+            break;
         }
-    }
-    
-    // 添加头文件
-    if (!headerFiles.isEmpty()) {
-        QTreeWidgetItem *headerItem = new QTreeWidgetItem(projectTree);
-        headerItem->setText(0, "头文件");
-        headerItem->setIcon(0, QIcon(":/icons/header.png"));
         
-        for (const QString &file : headerFiles) {
-            createFileItem(projectPath + "/" + file, file);
+        // 新出现的文件在更新时总会被扫描，消失的文件会被移出索引，这里只需记下可能改了内容的文件；
+        // 目录的变化也要触发一次更新
+        if (change.isDirectory || FileIndex::categoryOf(file) != FileIndex::Other) {
+            changedSymbolFiles.append(file);
+            symbolTimer->start();
         }
     }
     
-    // 添加其他文件
-    if (!otherFiles.isEmpty()) {
-        QTreeWidgetItem *otherItem = new QTreeWidgetItem(projectTree);
-        otherItem->setText(0, "其他文件");
-        otherItem->setIcon(0, QIcon(":/icons/file.png"));
-        
-        for (const QString &file : otherFiles) {
-            createFileItem(projectPath + "/" + file, file);
+    if (ignoreRulesChanged) rescanDirectory(rescanRoot);
+}
+
+void ProjectManager::addIndexedFile(const QString &file)
+{
+    if (scanner->isIgnored(file, false)) return;
+    treeModel->insertFile(file);
+}
+
+void ProjectManager::addIndexedDirectory(const QString &directory)
+{
+    // 新建或移入的目录通常很小，直接在界面线程扫描
+    if (scanner->isIgnored(directory, true)) return;
+    
+    const QString absolute = projectPath + "/" + directory;
+    watcher->addDirectory(absolute);
+    
+    const QFileInfoList entries = QDir(absolute).entryInfoList(
+        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDir::Name);
+    for (const QFileInfo &info : entries) {
+        const QString path = directory + "/" + info.fileName();
+        if (info.isDir()) {
+            if (!info.isSymLink()) addIndexedDirectory(path);
+        } else {
+            addIndexedFile(path);
         }
     }
-    
-    projectTree->expandAll();
 }
 
-QTreeWidgetItem* ProjectManager::createFileItem(const QString &filePath, const QString &fileName)
+void ProjectManager::removeIndexedDirectory(const QString &directory)
 {
-    QTreeWidgetItem *item = new QTreeWidgetItem(projectTree);
-    item->setText(0, fileName);
-    item->setData(0, Qt::UserRole, filePath);
-    
-    QFileInfo fileInfo(filePath);
-    QString extension = fileInfo.suffix().toLower();
-    
-    if (extension == "cpp" || extension == "c" || extension == "cc" || extension == "cxx") {
-        item->setIcon(0, QIcon(":/icons/cpp.png"));
-    } else if (extension == "h" || extension == "hpp" || extension == "hh" || extension == "hxx") {
-        item->setIcon(0, QIcon(":/icons/h.png"));
-    } else {
-        item->setIcon(0, QIcon(":/icons/file.png"));
+    treeModel->removeDirectory(directory);
+    watcher->removeDirectoryTree(projectPath + "/" + directory);
+}
+
+void ProjectManager::rescanDirectory(const QString &directory)
+{
+    // 规则变化可能让原来忽略的文件出现、原来索引的文件被忽略，整个子树按新规则重新扫描。
+    // 扫描结束时符号索引也会随之更新
+    if (directory.isEmpty() || scanner->isRunning()) {
+        // 根目录的规则影响整个项目；正在进行的扫描可能已经按旧规则走过这个子树
+        loadProjectFiles();
+        updateProjectTree();
+        return;
     }
     
-    return item;
+    removeIndexedDirectory(directory);
+    scanner->rescan(directory);
 }
 
-void ProjectManager::onTreeItemDoubleClicked(QTreeWidgetItem *item, int column)
+void ProjectManager::renameIndexedFile(const QString &oldFile, const QString &newFile)
 {
-    Q_UNUSED(column)
-    
-    if (item->childCount() == 0) { // 文件项
-        QString filePath = item->data(0, Qt::UserRole).toString();
-        if (!filePath.isEmpty()) {
-            emit fileAdded(filePath);
+    treeModel->removeFile(oldFile);
+    addIndexedFile(newFile);
+    
+    // 登记过的文件在外部改名后跟着改名
+    bool declared = false;
+    for (QStringList *files : { &sourceFiles, &headerFiles, &otherFiles }) {
+        const int index = files->indexOf(oldFile);
+        if (index < 0) continue;
+        files->removeAt(index);
+        declared = true;
+    }
+    if (declared) {
+        switch (FileIndex::categoryOf(newFile)) {
+        case FileIndex::Source: sourceFiles.append(newFile); break;
+        case FileIndex::Header: headerFiles.append(newFile); break;
+        case FileIndex::Other: otherFiles.append(newFile); break;
         }
+        saveProjectFile();
     }
 }
 
-void ProjectManager::onTreeContextMenu(const QPoint &pos)
+void ProjectManager::onTreeItemDoubleClicked(const QModelIndex &index)
 {
-    QTreeWidgetItem *item = projectTree->itemAt(pos);
-    if (!item) return;
+    if (!index.isValid() || treeModel->isDirectory(index)) return;
     
+    QString filePath = index.data(ProjectTreeModel::FilePathRole).toString();
+    if (!filePath.isEmpty()) {
+        emit fileOpenRequested(filePath);
+    }
+}
+
+void ProjectManager::onTreeContextMenu(const QPoint &pos)
+{
+    QModelIndex index = projectTree->indexAt(pos);
     QMenu menu;
     
-    if (item->childCount() == 0) { // 文件项
+    if (index.isValid() && !treeModel->isDirectory(index)) { // 文件项
         menu.addAction("打开文件", this, &ProjectManager::onOpenFile);
         menu.addAction("重命名", this, &ProjectManager::onRenameFile);
         menu.addSeparator();
@@ -335,7 +609,7 @@ void ProjectManager::onTreeContextMenu(const QPoint &pos)
         menu.addAction("添加现有文件", this, &ProjectManager::onAddExistingFile);
     }
     
-    menu.exec(projectTree->mapToGlobal(pos));
+    menu.exec(projectTree->viewport()->mapToGlobal(pos));
 }
 
 void ProjectManager::onAddNewFile()
@@ -343,7 +617,7 @@ void ProjectManager::onAddNewFile()
     QString fileName = QInputDialog::getText(nullptr, "新建文件", "文件名:");
     if (fileName.isEmpty()) return;
     
-    QString filePath = projectPath + "/" + fileName;
+    QString filePath = targetDirectory() + "/" + fileName;
     QFile file(filePath);
     if (file.open(QIODevice::WriteOnly)) {
         addFileToProject(filePath);
@@ -352,10 +626,11 @@ void ProjectManager::onAddNewFile()
 
 void ProjectManager::onAddExistingFile()
 {
-    QString filePath = QFileDialog::getOpenFileName(nullptr, "选择文件", projectPath);
+    QString directory = targetDirectory();
+    QString filePath = QFileDialog::getOpenFileName(nullptr, "选择文件", directory);
     if (!filePath.isEmpty()) {
         QFileInfo fileInfo(filePath);
-        QString newPath = projectPath + "/" + fileInfo.fileName();
+        QString newPath = directory + "/" + fileInfo.fileName();
         
         if (QFile::copy(filePath, newPath)) {
             addFileToProject(newPath);
@@ -365,10 +640,10 @@ void ProjectManager::onAddExistingFile()
 
 void ProjectManager::onRemoveFile()
 {
-    QTreeWidgetItem *item = projectTree->currentItem();
-    if (!item) return;
+    QModelIndex index = projectTree->currentIndex();
+    if (!index.isValid() || treeModel->isDirectory(index)) return;
     
-    QString filePath = item->data(0, Qt::UserRole).toString();
+    QString filePath = index.data(ProjectTreeModel::FilePathRole).toString();
     if (!filePath.isEmpty()) {
         removeFileFromProject(filePath);
     }
@@ -376,28 +651,28 @@ void ProjectManager::onRemoveFile()
 
 void ProjectManager::onOpenFile()
 {
-    QTreeWidgetItem *item = projectTree->currentItem();
-    if (!item) return;
+    QModelIndex index = projectTree->currentIndex();
+    if (!index.isValid() || treeModel->isDirectory(index)) return;
     
-    QString filePath = item->data(0, Qt::UserRole).toString();
+    QString filePath = index.data(ProjectTreeModel::FilePathRole).toString();
     if (!filePath.isEmpty()) {
-        emit fileAdded(filePath);
+        emit fileOpenRequested(filePath);
     }
 }
 
 void ProjectManager::onRenameFile()
 {
-    QTreeWidgetItem *item = projectTree->currentItem();
-    if (!item) return;
+    QModelIndex index = projectTree->currentIndex();
+    if (!index.isValid() || treeModel->isDirectory(index)) return;
     
-    QString oldPath = item->data(0, Qt::UserRole).toString();
+    QString oldPath = index.data(ProjectTreeModel::FilePathRole).toString();
     if (oldPath.isEmpty()) return;
     
     QFileInfo fileInfo(oldPath);
     QString newName = QInputDialog::getText(nullptr, "重命名文件", "新文件名:", QLineEdit::Normal, fileInfo.fileName());
     if (newName.isEmpty() || newName == fileInfo.fileName()) return;
     
-    QString newPath = projectPath + "/" + newName;
+    QString newPath = fileInfo.absolutePath() + "/" + newName;
     QFile file(oldPath);
     if (file.rename(newPath)) {
         removeFileFromProject(oldPath);
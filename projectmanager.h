@@ -5,13 +5,26 @@
 #include <QStringList>
 #include <QDir>
 #include <QFileInfo>
-#include <QTreeWidget>
-#include <QTreeWidgetItem>
+#include <QTreeView>
 #include <QMenu>
 #include <QAction>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QTimer>
+
+#include "fileindex.h"
+#include "projecttreemodel.h"
+#include "projectscanner.h"
+#include "filewatcher.h"
+#include "symbolindex.h"
+
+// 新建项目时可选的模板
+enum class ProjectTemplate
+{
+    QtWidgets,      // Qt Widgets 窗口程序
+    Benchmark       // Google Benchmark 微基准测试
+};
 
 class ProjectManager : public QObject
 {
@@ -21,30 +34,46 @@ public:
     explicit ProjectManager(QObject *parent = nullptr);
     ~ProjectManager();
 
-    void setProjectTree(QTreeWidget *tree);
+    void setProjectTree(QTreeView *tree);
     void openProject(const QString &path);
-    void createNewProject(const QString &name, const QString &path);
+    void createNewProject(const QString &name, const QString &path,
+                          ProjectTemplate projectTemplate = ProjectTemplate::QtWidgets);
     void addFileToProject(const QString &filePath);
     void removeFileFromProject(const QString &filePath);
     QString getProjectPath() const { return projectPath; }
     QString getProjectName() const { return projectName; }
-    QStringList getSourceFiles() const { return sourceFiles; }
-    QStringList getHeaderFiles() const { return headerFiles; }
+    // 项目目录下扫描到的文件和 .lionproj 中登记的文件，去重后的结果
+    QStringList getSourceFiles() const { return fileIndex.filesInCategory(FileIndex::Source); }
+    QStringList getHeaderFiles() const { return fileIndex.filesInCategory(FileIndex::Header); }
+    const FileIndex &getFileIndex() const { return fileIndex; }
+    ProjectTreeModel *getTreeModel() const { return treeModel; }
+    SymbolIndex *getSymbolIndex() const { return symbolIndex; }
+    bool isIndexing() const { return scanner->isRunning(); }
+    ProjectTemplate getProjectTemplate() const { return projectTemplate; }
+
+    static QString templateName(ProjectTemplate projectTemplate);
 
 signals:
     void projectOpened(const QString &projectPath);
     void projectClosed();
     void fileAdded(const QString &filePath);
     void fileRemoved(const QString &filePath);
+    void fileOpenRequested(const QString &filePath);
+    void indexingFinished(int fileCount, qint64 elapsedMs);
 
 private slots:
-    void onTreeItemDoubleClicked(QTreeWidgetItem *item, int column);
+    void onTreeItemDoubleClicked(const QModelIndex &index);
     void onTreeContextMenu(const QPoint &pos);
     void onAddNewFile();
     void onAddExistingFile();
     void onRemoveFile();
     void onOpenFile();
     void onRenameFile();
+    void onFilesFound(const QStringList &relativePaths);
+    void onDirectoriesFound(const QStringList &relativePaths);
+    void onScanFinished(int fileCount, qint64 elapsedMs);
+    void onFilesChanged(const QList<FileWatcher::Change> &changes);
+    void updateSymbolIndex();
 
 private:
     void setupProjectTree();
@@ -52,13 +81,32 @@ private:
     void saveProjectFile();
     void createCMakeLists();
     void createMainCpp();
-    QTreeWidgetItem* createFileItem(const QString &filePath, const QString &fileName);
+    void createBenchmarkCMakeLists();
+    void createBenchmarkCpp();
+    QString relativePath(const QString &filePath) const;
+    // 右键菜单中新建/添加文件的目标目录（选中的目录或选中文件所在的目录）
+    QString targetDirectory() const;
     void updateProjectTree();
+    // 增量更新：只改动受影响的索引项和树节点
+    void addIndexedFile(const QString &file);
+    void addIndexedDirectory(const QString &directory);
+    void removeIndexedDirectory(const QString &directory);
+    void rescanDirectory(const QString &directory);
+    void renameIndexedFile(const QString &oldFile, const QString &newFile);
 
-    QTreeWidget *projectTree;
+    QTreeView *projectTree;
     QString projectPath;
     QString projectName;
+    // .lionproj 中登记的文件，保存项目时只写这些
     QStringList sourceFiles;
     QStringList headerFiles;
     QStringList otherFiles;
+    ProjectTemplate projectTemplate;
+    FileIndex fileIndex;
+    ProjectTreeModel *treeModel;    // 索引的修改都经过模型
+    ProjectScanner *scanner;
+    FileWatcher *watcher;
+    SymbolIndex *symbolIndex;
+    QTimer *symbolTimer;            // 文件变化稍作合并后再更新符号索引
+    QStringList changedSymbolFiles;
 }; 
\ No newline at end of file
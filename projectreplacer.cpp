@@ -0,0 +1,395 @@
+#include "projectreplacer.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTemporaryFile>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace
+{
+bool isAscii(const QString &text)
+{
+    for (QChar c : text) {
+        if (c.unicode() >= 0x80) return false;
+    }
+    return true;
+}
+
+inline bool isWordChar(QChar c)
+{
+    // 与 ProjectSearcher 按字节判断的规则一致：非 ASCII 字符都算单词字符
+    const ushort u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') || u == '_' || u >= 0x80;
+}
+
+QString expandReplacement(const QString &replacement, const QRegularExpressionMatch &match)
+{
+    QString result;
+    for (qsizetype i = 0; i < replacement.size(); ++i) {
+        const QChar c = replacement[i];
+        if ((c == '\\' || c == '$') && i + 1 < replacement.size()) {
+            const QChar next = replacement[i + 1];
+            if (next.isDigit()) {
+                result += match.captured(next.digitValue());
+                ++i;
+                continue;
+            }
+            if (next == c) {
+                result += c;
+                ++i;
+                continue;
+            }
+            if (c == '\\' && (next == 'n' || next == 't')) {
+                result += next == 'n' ? QChar('\n') : QChar('\t');
+                ++i;
+                continue;
+            }
+        }
+        result += c;
+    }
+    return result;
+}
+
+// 符号链接替换其指向的文件，不把链接本身换成普通文件
+QString resolvedPath(const QString &filePath)
+{
+    const QString canonical = QFileInfo(filePath).canonicalFilePath();
+    return canonical.isEmpty() ? filePath : canonical;
+}
+
+// 改名之前先把临时文件的内容落盘，断电时不会留下空的目标文件
+bool syncToDisk(int handle)
+{
+#ifdef Q_OS_WIN
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(handle)));
+#else
+    return ::fsync(handle) == 0;
+#endif
+}
+}
+
+ProjectReplacer::ProjectReplacer(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , busy(false)
+{
+    pool->setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+}
+
+ProjectReplacer::~ProjectReplacer()
+{
+    pool->waitForDone();
+}
+
+QString ProjectReplacer::replaceAll(const QString &text, const ProjectSearcher::Options &options,
+                                    const QRegularExpression &expression, const QString &replacement, int *count)
+{
+    QString result;
+    int replacedCount = 0;
+    qsizetype copied = 0;
+
+    if (!options.regularExpression && (options.caseSensitive || isAscii(options.pattern))) {
+        const Qt::CaseSensitivity sensitivity = options.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+        const qsizetype length = options.pattern.size();
+
+        for (qsizetype position = text.indexOf(options.pattern, 0, sensitivity); position >= 0;
+             position = text.indexOf(options.pattern, position, sensitivity)) {
+            if (options.wholeWord
+                && ((position > 0 && isWordChar(text[position - 1]))
+                    || (position + length < text.size() && isWordChar(text[position + length])))) {
+                ++position;
+                continue;
+            }
+            result += QStringView(text).mid(copied, position - copied);
+            result += replacement;
+            copied = position + length;
+            position = copied;
+            ++replacedCount;
+        }
+    } else {
+        QRegularExpressionMatchIterator it = expression.globalMatch(text);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            if (match.capturedLength() == 0) continue;
+
+            result += QStringView(text).mid(copied, match.capturedStart() - copied);
+            result += options.regularExpression ? expandReplacement(replacement, match) : replacement;
+            copied = match.capturedEnd();
+            ++replacedCount;
+        }
+    }
+
+    if (count) *count = replacedCount;
+    if (replacedCount == 0) return text;
+    result += QStringView(text).mid(copied);
+    return result;
+}
+
+bool ProjectReplacer::prepare(const QStringList &filePaths, const QHash<QString, QString> &buffers,
+                              const ProjectSearcher::Options &options, const QString &replacement,
+                              QString *errorMessage)
+{
+    if (busy) {
+        if (errorMessage) *errorMessage = "上一次替换尚未完成";
+        return false;
+    }
+    if (options.pattern.isEmpty()) {
+        if (errorMessage) *errorMessage = "查找内容为空";
+        return false;
+    }
+
+    auto prepareState = std::make_shared<PrepareState>();
+    prepareState->filePaths = filePaths;
+    prepareState->buffers = buffers;
+    prepareState->options = options;
+    prepareState->expression = ProjectSearcher::regularExpressionFor(options);
+    prepareState->replacement = replacement;
+    if (!prepareState->expression.isValid()) {
+        if (errorMessage) *errorMessage = "正则表达式无效: " + prepareState->expression.errorString();
+        return false;
+    }
+
+    busy = true;
+    const int workers = qMin(pool->maxThreadCount(), qMax(1, (int(filePaths.size()) + ChunkSize - 1) / ChunkSize));
+    prepareState->remaining = workers;
+    for (int worker = 0; worker < workers; ++worker) {
+        pool->start(QRunnable::create([this, prepareState]() {
+            runPrepareWorker(prepareState);
+        }));
+    }
+    return true;
+}
+
+void ProjectReplacer::runPrepareWorker(const std::shared_ptr<PrepareState> &prepareState)
+{
+    const int fileCount = prepareState->filePaths.size();
+    for (;;) {
+        const int begin = prepareState->next.fetch_add(ChunkSize);
+        if (begin >= fileCount) break;
+
+        const int end = qMin(begin + ChunkSize, fileCount);
+        for (int i = begin; i < end; ++i) prepareFile(*prepareState, prepareState->filePaths.at(i));
+    }
+
+    // 最后一个结束的线程把结果送回界面线程
+    if (prepareState->remaining.fetch_sub(1) != 1) return;
+
+    QMetaObject::invokeMethod(this, [this, prepareState]() {
+        busy = false;
+        std::sort(prepareState->edits.begin(), prepareState->edits.end(), [](const FileEdit &a, const FileEdit &b) {
+            return a.filePath < b.filePath;
+        });
+        emit prepared(prepareState->edits, prepareState->skipped);
+    }, Qt::QueuedConnection);
+}
+
+void ProjectReplacer::prepareFile(PrepareState &prepareState, const QString &filePath)
+{
+    FileEdit edit;
+    edit.filePath = filePath;
+
+    auto buffer = prepareState.buffers.constFind(filePath);
+    if (buffer != prepareState.buffers.constEnd()) {
+        edit.original = buffer.value();
+        edit.inEditor = true;
+    } else {
+        QFile file(filePath);
+        const QFileInfo info(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            QMutexLocker locker(&prepareState.mutex);
+            prepareState.skipped.append(filePath + ": 无法读取");
+            return;
+        }
+        edit.modifiedTime = info.lastModified().toMSecsSinceEpoch();
+        edit.size = info.size();
+
+        const QByteArray content = file.readAll();
+        edit.original = QString::fromUtf8(content);
+        // 只处理能原样转换回来的 UTF-8 文本，其他编码或二进制文件替换后会损坏
+        if (content.contains('\0') || edit.original.toUtf8() != content) {
+            QMutexLocker locker(&prepareState.mutex);
+            prepareState.skipped.append(filePath + ": 不是 UTF-8 文本");
+            return;
+        }
+    }
+
+    edit.replaced = replaceAll(edit.original, prepareState.options, prepareState.expression,
+                               prepareState.replacement, &edit.count);
+    if (edit.count == 0) return;
+
+    QMutexLocker locker(&prepareState.mutex);
+    prepareState.edits.append(edit);
+}
+
+void ProjectReplacer::apply(const QList<FileEdit> &edits)
+{
+    auto applyState = std::make_shared<ApplyState>();
+    for (const FileEdit &edit : edits) {
+        if (!edit.inEditor) applyState->edits.append(edit);
+    }
+    applyState->temporaryFiles.resize(applyState->edits.size());
+
+    if (applyState->edits.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this]() {
+            emit applied(true, QString(), 0);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    busy = true;
+    const int workers = qMin(pool->maxThreadCount(),
+                             qMax(1, (int(applyState->edits.size()) + ChunkSize - 1) / ChunkSize));
+    applyState->remaining = workers;
+    for (int worker = 0; worker < workers; ++worker) {
+        pool->start(QRunnable::create([this, applyState]() {
+            runApplyWorker(applyState);
+        }));
+    }
+}
+
+void ProjectReplacer::runApplyWorker(const std::shared_ptr<ApplyState> &applyState)
+{
+    // 第一阶段：各线程并行写临时文件，原文件保持不动
+    const int editCount = applyState->edits.size();
+    while (!applyState->failed) {
+        const int begin = applyState->next.fetch_add(ChunkSize);
+        if (begin >= editCount) break;
+
+        const int end = qMin(begin + ChunkSize, editCount);
+        for (int i = begin; i < end && !applyState->failed; ++i) {
+            const FileEdit &edit = applyState->edits.at(i);
+            QString temporaryPath;
+            QString errorMessage;
+            if (!writeTemporary(edit.filePath, edit.replaced.toUtf8(), &temporaryPath, &errorMessage)) {
+                fail(*applyState, errorMessage);
+                break;
+            }
+            QMutexLocker locker(&applyState->mutex);
+            applyState->temporaryFiles[i] = temporaryPath;
+        }
+    }
+
+    if (applyState->remaining.fetch_sub(1) != 1) return;
+
+    // 第二阶段由最后一个线程完成：提交或全部撤销
+    commit(*applyState);
+
+    QMetaObject::invokeMethod(this, [this, applyState]() {
+        busy = false;
+        emit applied(!applyState->failed, applyState->errorMessage,
+                     applyState->failed ? 0 : applyState->edits.size());
+    }, Qt::QueuedConnection);
+}
+
+void ProjectReplacer::fail(ApplyState &applyState, const QString &errorMessage)
+{
+    QMutexLocker locker(&applyState.mutex);
+    if (!applyState.failed) applyState.errorMessage = errorMessage;
+    applyState.failed = true;
+}
+
+void ProjectReplacer::commit(ApplyState &applyState)
+{
+    const int editCount = applyState.edits.size();
+    auto removeTemporaryFiles = [&applyState](int from) {
+        for (int i = from; i < applyState.temporaryFiles.size(); ++i) {
+            if (!applyState.temporaryFiles[i].isEmpty()) QFile::remove(applyState.temporaryFiles[i]);
+        }
+    };
+
+    if (applyState.failed) {
+        removeTemporaryFiles(0);
+        return;
+    }
+
+    // 预览之后在外部被修改的文件不能覆盖，整个替换放弃
+    for (const FileEdit &edit : applyState.edits) {
+        const QFileInfo info(edit.filePath);
+        if (!info.exists() || info.size() != edit.size || info.lastModified().toMSecsSinceEpoch() != edit.modifiedTime) {
+            fail(applyState, "文件在预览后被修改，请重新查找: " + edit.filePath);
+            removeTemporaryFiles(0);
+            return;
+        }
+    }
+
+    for (int i = 0; i < editCount; ++i) {
+        QString errorMessage;
+        if (replaceFile(applyState.temporaryFiles[i], applyState.edits[i].filePath, &errorMessage)) continue;
+
+        fail(applyState, errorMessage);
+        removeTemporaryFiles(i);
+
+        // 已经覆盖的文件同样以临时文件加 rename 的方式写回原内容
+        for (int j = 0; j < i; ++j) {
+            const FileEdit &edit = applyState.edits[j];
+            QString temporaryPath;
+            QString restoreError;
+            if (!writeTemporary(edit.filePath, edit.original.toUtf8(), &temporaryPath, &restoreError)
+                || !replaceFile(temporaryPath, edit.filePath, &restoreError)) {
+                if (!temporaryPath.isEmpty()) QFile::remove(temporaryPath);
+                applyState.errorMessage += "\n无法恢复 " + edit.filePath + ": " + restoreError;
+            }
+        }
+        return;
+    }
+}
+
+bool ProjectReplacer::writeTemporary(const QString &filePath, const QByteArray &content, QString *temporaryPath,
+                                     QString *errorMessage)
+{
+    const QFileInfo target(resolvedPath(filePath));
+
+    // 临时文件放在同一目录，保证 rename 是同一文件系统内的原子替换
+    QTemporaryFile file(target.absolutePath() + "/." + target.fileName() + ".XXXXXX");
+    file.setAutoRemove(false);
+    if (!file.open()) {
+        *errorMessage = QString("无法创建临时文件 %1: %2").arg(filePath, file.errorString());
+        return false;
+    }
+    *temporaryPath = file.fileName();
+
+    const bool written = file.write(content) == content.size() && file.flush() && syncToDisk(file.handle());
+    if (written) file.setPermissions(QFile::permissions(target.filePath()));
+    const QString writeError = file.errorString();
+    file.close();
+
+    if (!written) {
+        QFile::remove(*temporaryPath);
+        temporaryPath->clear();
+        *errorMessage = QString("写入 %1 失败: %2").arg(filePath, writeError);
+        return false;
+    }
+    return true;
+}
+
+bool ProjectReplacer::replaceFile(const QString &temporaryPath, const QString &filePath, QString *errorMessage)
+{
+    // QFile::rename 不覆盖已存在的文件，这里需要系统调用的原子覆盖
+#ifdef Q_OS_WIN
+    const std::wstring source = QDir::toNativeSeparators(temporaryPath).toStdWString();
+    const std::wstring target = QDir::toNativeSeparators(resolvedPath(filePath)).toStdWString();
+    if (!MoveFileExW(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        *errorMessage = QString("无法覆盖 %1: %2").arg(filePath, qt_error_string(int(GetLastError())));
+        return false;
+    }
+#else
+    if (::rename(QFile::encodeName(temporaryPath).constData(), QFile::encodeName(resolvedPath(filePath)).constData()) != 0) {
+        *errorMessage = QString("无法覆盖 %1: %2").arg(filePath, qt_error_string(errno));
+        return false;
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+#include "projectsearcher.h"
+
+// 在文件中替换
+// 分两步：prepare 在工作线程中读取文件并算出替换后的内容（已打开的文件使用编辑器中的内容），
+// 供预览；apply 把磁盘上的文件作为一个事务写入：先由多个工作线程把新内容写到同目录的临时文件，
+// 全部成功并确认文件在预览后没有被改动后再逐个 rename 覆盖原文件，任何一步失败都恢复已覆盖的文件。
+// 已打开文件的替换由调用方在事务成功后写入编辑器。
+class ProjectReplacer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct FileEdit
+    {
+        QString filePath;
+        QString original;
+        QString replaced;
+        int count = 0;              // 替换的处数
+        bool inEditor = false;      // 内容来自已打开的编辑器，替换写入编辑器而不是磁盘
+        qint64 modifiedTime = 0;    // 读取时磁盘文件的修改时间（毫秒）和大小，提交前据此确认未被改动
+        qint64 size = 0;
+    };
+
+    explicit ProjectReplacer(QObject *parent = nullptr);
+    ~ProjectReplacer();
+
+    // 在 text 中替换全部匹配，规则与 ProjectSearcher 相同；正则表达式模式下替换文本中的 \1 或 $1 引用分组
+    static QString replaceAll(const QString &text, const ProjectSearcher::Options &options,
+                              const QRegularExpression &expression, const QString &replacement, int *count);
+
+    // filePaths 为绝对路径；buffers 为全部已打开文件（绝对路径 -> 编辑器中的内容）
+    bool prepare(const QStringList &filePaths, const QHash<QString, QString> &buffers,
+                 const ProjectSearcher::Options &options, const QString &replacement, QString *errorMessage = nullptr);
+    // 只写入 inEditor 为 false 的文件
+    void apply(const QList<FileEdit> &edits);
+    bool isBusy() const { return busy; }
+
+signals:
+    // skipped 为无法替换的文件及原因
+    void prepared(const QList<ProjectReplacer::FileEdit> &edits, const QStringList &skipped);
+    void applied(bool success, const QString &errorMessage, int fileCount);
+
+private:
+    struct PrepareState
+    {
+        QStringList filePaths;
+        QHash<QString, QString> buffers;
+        ProjectSearcher::Options options;
+        QRegularExpression expression;
+        QString replacement;
+        std::atomic<int> next{0};
+        std::atomic<int> remaining{0};
+        QMutex mutex;
+        QList<FileEdit> edits;
+        QStringList skipped;
+    };
+
+    struct ApplyState
+    {
+        QList<FileEdit> edits;
+        QStringList temporaryFiles;     // 与 edits 一一对应
+        std::atomic<int> next{0};
+        std::atomic<int> remaining{0};
+        std::atomic<bool> failed{false};
+        QMutex mutex;
+        QString errorMessage;
+    };
+
+    static const int ChunkSize = 16;
+
+    static void prepareFile(PrepareState &prepareState, const QString &filePath);
+    static bool writeTemporary(const QString &filePath, const QByteArray &content, QString *temporaryPath,
+                               QString *errorMessage);
+    static bool replaceFile(const QString &temporaryPath, const QString &filePath, QString *errorMessage);
+    static void fail(ApplyState &applyState, const QString &errorMessage);
+    static void commit(ApplyState &applyState);
+    void runPrepareWorker(const std::shared_ptr<PrepareState> &prepareState);
+    void runApplyWorker(const std::shared_ptr<ApplyState> &applyState);
+
+    QThreadPool *pool;
+    bool busy;
+};
@@ -0,0 +1,286 @@
+#include "projectscanner.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSettings>
+#include <QThread>
+
+ProjectScanner::ProjectScanner(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , generation(0)
+    , activeWorkers(0)
+    , running(false)
+{
+    // 扫描主要受文件系统限制，线程再多也没有收益
+    pool->setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+}
+
+ProjectScanner::~ProjectScanner()
+{
+    cancel();
+    pool->waitForDone();
+}
+
+QStringList ProjectScanner::defaultExcludes()
+{
+    return { ".git", ".svn", ".hg", "build", "build-*", "cmake-build-*", "_build", ".cache", "node_modules" };
+}
+
+QStringList ProjectScanner::excludes()
+{
+    QSettings settings("LionCPP", "IDE");
+    const QString value = settings.value("project/excludes", defaultExcludes().join(';')).toString();
+    return value.split(';', Qt::SkipEmptyParts);
+}
+
+void ProjectScanner::start(const QString &root)
+{
+    cancel();
+
+    this->root = root;
+    excludePatterns.clear();
+    ignoreCache.clear();
+    for (const QString &pattern : excludes()) {
+        excludePatterns.append(QRegularExpression(
+            QRegularExpression::wildcardToRegularExpression(pattern.trimmed())));
+    }
+
+    Task rootTask;
+    rootTask.ignore = rootIgnoreRules(root);
+    launch(rootTask);
+}
+
+void ProjectScanner::rescan(const QString &directory)
+{
+    if (root.isEmpty()) return;
+    if (directory.isEmpty()) {
+        start(root);
+        return;
+    }
+
+    cancel();
+    ignoreCache.clear();
+
+    // 从父目录累积的规则开始，本目录的 .gitignore 在扫描时叠加
+    Task task;
+    task.directory = directory;
+    const int slash = directory.lastIndexOf('/');
+    task.ignore = ignoreRules(slash < 0 ? QString() : directory.left(slash));
+    launch(task);
+}
+
+void ProjectScanner::launch(const Task &firstTask)
+{
+    state = std::make_shared<State>();
+    state->root = root;
+    state->generation = ++generation;
+    state->excludes = excludePatterns;
+    state->pending.append(firstTask);
+    state->timer.start();
+
+    running = true;
+    activeWorkers = pool->maxThreadCount();
+    for (int worker = 0; worker < activeWorkers; ++worker) {
+        std::shared_ptr<State> workerState = state;
+        pool->start(QRunnable::create([this, workerState]() {
+            runWorker(workerState);
+            const int scanGeneration = workerState->generation;
+            QMetaObject::invokeMethod(this, [this, scanGeneration]() {
+                onWorkerFinished(scanGeneration);
+            }, Qt::QueuedConnection);
+        }));
+    }
+}
+
+void ProjectScanner::cancel()
+{
+    if (!state) return;
+
+    // 递增代号后，已经排队的旧批次在界面线程被丢弃
+    ++generation;
+    running = false;
+    state->cancelled = true;
+    QMutexLocker locker(&state->mutex);
+    state->condition.wakeAll();
+}
+
+std::shared_ptr<GitIgnore> ProjectScanner::rootIgnoreRules(const QString &root)
+{
+    // .git/info/exclude 在前，根目录的 .gitignore 在扫描根目录时再叠加
+    auto rules = std::make_shared<GitIgnore>();
+    QFile exclude(root + "/.git/info/exclude");
+    if (exclude.open(QIODevice::ReadOnly)) {
+        rules->addRules(QString(), QString::fromUtf8(exclude.readAll()));
+    }
+    return rules;
+}
+
+bool ProjectScanner::matchesAny(const QList<QRegularExpression> &patterns, const QString &name)
+{
+    for (const QRegularExpression &pattern : patterns) {
+        if (pattern.match(name).hasMatch()) return true;
+    }
+    return false;
+}
+
+std::shared_ptr<const GitIgnore> ProjectScanner::ignoreRules(const QString &directory)
+{
+    auto cached = ignoreCache.constFind(directory);
+    if (cached != ignoreCache.constEnd()) return cached.value();
+
+    std::shared_ptr<const GitIgnore> parent;
+    if (directory.isEmpty()) {
+        parent = rootIgnoreRules(root);
+    } else {
+        const int slash = directory.lastIndexOf('/');
+        parent = ignoreRules(slash < 0 ? QString() : directory.left(slash));
+    }
+
+    std::shared_ptr<const GitIgnore> rules = parent;
+    QFile gitignoreFile(directory.isEmpty() ? root + "/.gitignore" : root + '/' + directory + "/.gitignore");
+    if (gitignoreFile.open(QIODevice::ReadOnly)) {
+        auto own = std::make_shared<GitIgnore>(*parent);
+        own->addRules(directory, QString::fromUtf8(gitignoreFile.readAll()));
+        rules = own;
+    }
+
+    ignoreCache.insert(directory, rules);
+    return rules;
+}
+
+bool ProjectScanner::isIgnored(const QString &relativePath, bool isDirectory)
+{
+    const QStringList parts = relativePath.split('/', Qt::SkipEmptyParts);
+    QString directory;
+
+    for (int i = 0; i < parts.size(); ++i) {
+        const bool partIsDirectory = i + 1 < parts.size() || isDirectory;
+        const QString path = directory.isEmpty() ? parts[i] : directory + '/' + parts[i];
+
+        if (partIsDirectory && matchesAny(excludePatterns, parts[i])) return true;
+        if (ignoreRules(directory)->isIgnored(path, partIsDirectory)) return true;
+        directory = path;
+    }
+    return false;
+}
+
+void ProjectScanner::runWorker(const std::shared_ptr<State> &scanState)
+{
+    Batch batch;
+    QMutexLocker locker(&scanState->mutex);
+
+    while (!scanState->cancelled) {
+        if (scanState->pending.isEmpty()) {
+            // 栈空且没有线程在扫描时整个目录树已经扫完
+            if (scanState->busy == 0) break;
+
+            // 等待前把手上的结果送出去，避免最后一批一直攒着
+            locker.unlock();
+            flush(scanState, batch);
+            locker.relock();
+            if (scanState->pending.isEmpty() && scanState->busy > 0 && !scanState->cancelled) {
+                scanState->condition.wait(&scanState->mutex);
+            }
+            continue;
+        }
+
+        // 后进先出，深度优先让待扫描目录栈保持很小
+        const Task task = scanState->pending.takeLast();
+        ++scanState->busy;
+        locker.unlock();
+
+        scanDirectory(scanState, task, batch);
+        if (batch.size() >= BatchSize) flush(scanState, batch);
+
+        locker.relock();
+        --scanState->busy;
+        if (scanState->pending.isEmpty() && scanState->busy == 0) scanState->condition.wakeAll();
+    }
+
+    scanState->condition.wakeAll();
+    locker.unlock();
+    flush(scanState, batch);
+}
+
+void ProjectScanner::scanDirectory(const std::shared_ptr<State> &scanState, const Task &task, Batch &batch)
+{
+    const QString absolute = task.directory.isEmpty()
+        ? scanState->root : scanState->root + '/' + task.directory;
+    const QString prefix = task.directory.isEmpty() ? QString() : task.directory + '/';
+
+    // 本目录有 .gitignore 时在父目录规则的副本上追加，否则直接共享父目录的规则
+    std::shared_ptr<const GitIgnore> ignore = task.ignore;
+    QFile gitignoreFile(absolute + "/.gitignore");
+    if (gitignoreFile.open(QIODevice::ReadOnly)) {
+        auto rules = std::make_shared<GitIgnore>(*task.ignore);
+        rules->addRules(task.directory, QString::fromUtf8(gitignoreFile.readAll()));
+        ignore = rules;
+    }
+
+    batch.directories.append(task.directory);
+    QList<Task> subdirectories;
+    QDirIterator it(absolute, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    while (it.hasNext()) {
+        if (scanState->cancelled) return;
+
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString name = info.fileName();
+        const QString relative = prefix + name;
+
+        if (info.isDir()) {
+            if (info.isSymLink()) continue;
+
+            if (matchesAny(scanState->excludes, name) || ignore->isIgnored(relative, true)) continue;
+
+            Task subdirectory;
+            subdirectory.directory = relative;
+            subdirectory.ignore = ignore;
+            subdirectories.append(subdirectory);
+        } else {
+            if (ignore->isIgnored(relative, false)) continue;
+            batch.files.append(relative);
+            scanState->fileCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (subdirectories.isEmpty()) return;
+
+    QMutexLocker locker(&scanState->mutex);
+    scanState->pending += subdirectories;
+    if (subdirectories.size() == 1) {
+        scanState->condition.wakeOne();
+    } else {
+        scanState->condition.wakeAll();
+    }
+}
+
+void ProjectScanner::flush(const std::shared_ptr<State> &scanState, Batch &batch)
+{
+    if (batch.size() == 0 || scanState->cancelled) {
+        batch = Batch();
+        return;
+    }
+
+    const int scanGeneration = scanState->generation;
+    const Batch found = batch;
+    batch = Batch();
+    QMetaObject::invokeMethod(this, [this, scanGeneration, found]() {
+        if (scanGeneration != generation) return;
+        // 先报告目录，调用方可以在文件到达之前开始监视
+        if (!found.directories.isEmpty()) emit directoriesFound(found.directories);
+        if (!found.files.isEmpty()) emit filesFound(found.files);
+    }, Qt::QueuedConnection);
+}
+
+void ProjectScanner::onWorkerFinished(int scanGeneration)
+{
+    if (scanGeneration != generation) return;
+    if (--activeWorkers > 0) return;
+
+    running = false;
+    emit finished(state->fileCount.load(), state->timer.elapsed());
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+#include "gitignore.h"
+
+// 项目目录的后台递归扫描
+// 多个工作线程共享一个待扫描目录栈，每个目录读一次，子目录压回栈中由空闲线程继续扫描。
+// 遵守各级 .gitignore 和 .git/info/exclude，跳过构建目录等排除项（设置 project/excludes）
+// 以及指向目录的符号链接。找到的文件按批次送回界面线程，打开大项目时界面不会卡住。
+class ProjectScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectScanner(QObject *parent = nullptr);
+    ~ProjectScanner();
+
+    static QStringList defaultExcludes();
+    static QStringList excludes();
+
+    // 开始扫描 root，正在进行的扫描会被取消，其后续结果不再发出
+    void start(const QString &root);
+    // 按当前规则重新扫描上次扫描的 root 下的 directory 子树（相对路径），结果同样通过信号发出
+    void rescan(const QString &directory);
+    void cancel();
+    bool isRunning() const { return running; }
+
+    // 扫描结束后增量判断新出现的路径，规则与扫描时相同（逐级检查排除项和 .gitignore）
+    bool isIgnored(const QString &relativePath, bool isDirectory);
+    // 某个 .gitignore 被修改后调用
+    void invalidateIgnoreRules() { ignoreCache.clear(); }
+
+signals:
+    // 相对 root 的路径，以 / 分隔
+    void filesFound(const QStringList &relativePaths);
+    // 扫描过的目录（不含被忽略的目录），根目录为空字符串
+    void directoriesFound(const QStringList &relativePaths);
+    void finished(int fileCount, qint64 elapsedMs);
+
+private:
+    struct Task
+    {
+        QString directory;      // 相对 root，根目录为空字符串
+        std::shared_ptr<const GitIgnore> ignore;
+    };
+
+    struct State
+    {
+        QString root;
+        int generation = 0;
+        QList<QRegularExpression> excludes;
+        QMutex mutex;
+        QWaitCondition condition;
+        QList<Task> pending;
+        int busy = 0;
+        std::atomic<bool> cancelled{false};
+        std::atomic<int> fileCount{0};
+        QElapsedTimer timer;
+    };
+
+    struct Batch
+    {
+        QStringList files;
+        QStringList directories;
+
+        int size() const { return files.size() + directories.size(); }
+    };
+
+    static const int BatchSize = 512;
+
+    static std::shared_ptr<GitIgnore> rootIgnoreRules(const QString &root);
+    static bool matchesAny(const QList<QRegularExpression> &patterns, const QString &name);
+    void launch(const Task &firstTask);
+    void runWorker(const std::shared_ptr<State> &scanState);
+    void scanDirectory(const std::shared_ptr<State> &scanState, const Task &task, Batch &batch);
+    void flush(const std::shared_ptr<State> &scanState, Batch &batch);
+    void onWorkerFinished(int scanGeneration);
+    std::shared_ptr<const GitIgnore> ignoreRules(const QString &directory);
+
+    QThreadPool *pool;
+    std::shared_ptr<State> state;
+    int generation;
+    int activeWorkers;
+    bool running;
+
+    // 增量判断用，只在界面线程访问
+    QString root;
+    QList<QRegularExpression> excludePatterns;
+    QHash<QString, std::shared_ptr<const GitIgnore>> ignoreCache;
+};
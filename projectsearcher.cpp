@@ -0,0 +1,360 @@
+#include "projectsearcher.h"
+#include <QDir>
+#include <QFile>
+#include <QRunnable>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const int MaxLineLength = 400;          // 结果中每行最多保留的字节数
+const qsizetype BinaryCheckSize = 8000; // 前面这么多字节中有 NUL 时视为二进制文件
+
+inline char lowerAscii(char c)
+{
+    return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+}
+
+inline bool isWordByte(char c)
+{
+    // UTF-8 多字节字符按单词字符处理，中文标识符两侧不会被误判为边界
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || uchar(c) >= 0x80;
+}
+
+bool isAscii(const QString &text)
+{
+    for (QChar c : text) {
+        if (c.unicode() >= 0x80) return false;
+    }
+    return true;
+}
+
+bool matchesAny(const QList<QRegularExpression> &patterns, const QString &name)
+{
+    for (const QRegularExpression &pattern : patterns) {
+        if (pattern.match(name).hasMatch()) return true;
+    }
+    return false;
+}
+}
+
+ProjectSearcher::ProjectSearcher(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , generation(0)
+    , activeWorkers(0)
+    , running(false)
+{
+    // 文件通常已在页缓存中，查找主要消耗 CPU
+    pool->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+ProjectSearcher::~ProjectSearcher()
+{
+    cancel();
+    pool->waitForDone();
+}
+
+QStringList ProjectSearcher::parseFilePatterns(const QString &text)
+{
+    QStringList patterns;
+    for (const QString &part : text.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts)) {
+        patterns.append(part.trimmed());
+    }
+    return patterns;
+}
+
+QRegularExpression ProjectSearcher::regularExpressionFor(const Options &options)
+{
+    QString pattern = options.regularExpression ? options.pattern : QRegularExpression::escape(options.pattern);
+    if (options.wholeWord) pattern = "\\b(?:" + pattern + ")\\b";
+
+    QRegularExpression::PatternOptions patternOptions = QRegularExpression::MultilineOption;
+    if (!options.caseSensitive) patternOptions |= QRegularExpression::CaseInsensitiveOption;
+    return QRegularExpression(pattern, patternOptions);
+}
+
+bool ProjectSearcher::start(const QString &root, const QStringList &files, const QHash<QString, QString> &buffers,
+                            const Options &options, QString *errorMessage)
+{
+    cancel();
+
+    if (options.pattern.isEmpty()) {
+        if (errorMessage) *errorMessage = "查找内容为空";
+        return false;
+    }
+
+    auto newState = std::make_shared<State>();
+    newState->root = root;
+    newState->files = files;
+    newState->wholeWord = options.wholeWord;
+    newState->caseSensitive = options.caseSensitive;
+
+    for (const QString &pattern : options.filePatterns) {
+        newState->filePatterns.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern)));
+    }
+
+    // 不区分大小写的非 ASCII 字面量需要 Unicode 大小写折叠，也交给正则表达式
+    if (options.regularExpression || (!options.caseSensitive && !isAscii(options.pattern))) {
+        newState->regularExpression = regularExpressionFor(options);
+        if (!newState->regularExpression.isValid()) {
+            if (errorMessage) *errorMessage = "正则表达式无效: " + newState->regularExpression.errorString();
+            return false;
+        }
+        newState->regularExpression.optimize();
+        newState->useRegularExpression = true;
+    } else {
+        newState->literal = options.pattern.toUtf8();
+        if (options.caseSensitive) {
+            newState->matcher.setPattern(newState->literal);
+        } else {
+            // 字面量和跳跃表都按小写存放，文本中的大小写两种字节查同一个跳距
+            const int length = newState->literal.size();
+            for (int i = 0; i < length; ++i) newState->literal[i] = lowerAscii(newState->literal[i]);
+            std::fill(std::begin(newState->skip), std::end(newState->skip), length);
+            for (int i = 0; i < length - 1; ++i) {
+                const char c = newState->literal[i];
+                newState->skip[uchar(c)] = length - 1 - i;
+                if (c >= 'a' && c <= 'z') newState->skip[uchar(c - 'a' + 'A')] = length - 1 - i;
+            }
+        }
+    }
+
+    // 未保存的文件搜索编辑器中的内容；不在文件列表中的（项目外或尚未索引）追加到列表末尾
+    const QDir rootDirectory(root);
+    for (auto it = buffers.constBegin(); it != buffers.constEnd(); ++it) {
+        newState->buffers.insert(it.key(), it.value().toUtf8());
+
+        const QString relative = rootDirectory.relativeFilePath(it.key());
+        const bool insideRoot = !root.isEmpty() && !relative.startsWith("..") && !QDir::isAbsolutePath(relative);
+        if (!insideRoot) {
+            newState->files.append(it.key());
+        } else if (!files.contains(relative)) {
+            newState->files.append(relative);
+        }
+    }
+
+    state = newState;
+    state->generation = ++generation;
+    state->timer.start();
+
+    running = true;
+    activeWorkers = qMin(pool->maxThreadCount(), qMax(1, (int(state->files.size()) + ChunkSize - 1) / ChunkSize));
+    for (int worker = 0; worker < activeWorkers; ++worker) {
+        std::shared_ptr<State> workerState = state;
+        pool->start(QRunnable::create([this, workerState]() {
+            runWorker(workerState);
+            const int searchGeneration = workerState->generation;
+            QMetaObject::invokeMethod(this, [this, searchGeneration]() {
+                onWorkerFinished(searchGeneration);
+            }, Qt::QueuedConnection);
+        }));
+    }
+    return true;
+}
+
+void ProjectSearcher::cancel()
+{
+    if (!state) return;
+
+    // 递增代号后，已经排队的旧结果在界面线程被丢弃
+    ++generation;
+    running = false;
+    state->cancelled = true;
+}
+
+void ProjectSearcher::runWorker(const std::shared_ptr<State> &searchState)
+{
+    QList<Match> matches;
+    const int fileCount = searchState->files.size();
+
+    // 按块领取文件，每块处理完送出一次结果，既能尽早显示又不会逐条跨线程投递
+    while (!searchState->cancelled) {
+        const int begin = searchState->next.fetch_add(ChunkSize);
+        if (begin >= fileCount) break;
+
+        const int end = qMin(begin + ChunkSize, fileCount);
+        for (int i = begin; i < end && !searchState->cancelled; ++i) {
+            const QString &file = searchState->files[i];
+            searchFile(*searchState, QDir::isAbsolutePath(file) ? file : searchState->root + '/' + file, matches);
+        }
+        flush(searchState, matches);
+    }
+    flush(searchState, matches);
+}
+
+void ProjectSearcher::searchFile(State &searchState, const QString &filePath, QList<Match> &matches)
+{
+    if (!searchState.filePatterns.isEmpty()
+        && !matchesAny(searchState.filePatterns, filePath.mid(filePath.lastIndexOf('/') + 1))) {
+        return;
+    }
+    searchState.fileCount.fetch_add(1, std::memory_order_relaxed);
+
+    auto buffer = searchState.buffers.constFind(filePath);
+    if (buffer != searchState.buffers.constEnd()) {
+        searchBytes(searchState, filePath, buffer->constData(), buffer->size(), matches);
+        return;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return;
+    qsizetype size = file.size();
+    if (size <= 0 || size > MaxFileSize) return;
+
+    // 映射失败（例如特殊文件系统）时退回到整块读取
+    QByteArray content;
+    uchar *mapped = file.map(0, size);
+    const char *data = reinterpret_cast<const char *>(mapped);
+    if (!mapped) {
+        content = file.readAll();
+        data = content.constData();
+        size = content.size();
+    }
+
+    if (!memchr(data, '\0', qMin(size, BinaryCheckSize))) {
+        searchBytes(searchState, filePath, data, size, matches);
+    }
+    if (mapped) file.unmap(mapped);
+}
+
+qsizetype ProjectSearcher::findLiteral(const State &searchState, const char *data, qsizetype size, qsizetype from)
+{
+    const char *literal = searchState.literal.constData();
+    const qsizetype length = searchState.literal.size();
+    if (size - from < length) return -1;
+
+    if (searchState.caseSensitive) {
+        return searchState.matcher.indexIn(data, size, from);
+    }
+
+    // Horspool：比较窗口最后一个字节，不匹配时按该字节查表跳过
+    const char last = literal[length - 1];
+    for (qsizetype position = from; position + length <= size; ) {
+        const char c = data[position + length - 1];
+        if (lowerAscii(c) == last) {
+            qsizetype i = 0;
+            while (i < length - 1 && lowerAscii(data[position + i]) == literal[i]) ++i;
+            if (i == length - 1) return position;
+        }
+        position += searchState.skip[uchar(c)];
+    }
+    return -1;
+}
+
+void ProjectSearcher::searchBytes(State &searchState, const QString &filePath, const char *data, qsizetype size,
+                                  QList<Match> &matches)
+{
+    if (searchState.useRegularExpression) {
+        searchText(searchState, filePath, QString::fromUtf8(data, size), matches);
+        return;
+    }
+
+    const qsizetype length = searchState.literal.size();
+    qsizetype lineStart = 0;
+    int line = 1;
+
+    for (qsizetype position = findLiteral(searchState, data, size, 0); position >= 0;
+         position = findLiteral(searchState, data, size, position)) {
+        if (searchState.cancelled) return;
+
+        if (searchState.wholeWord
+            && ((position > 0 && isWordByte(data[position - 1]))
+                || (position + length < size && isWordByte(data[position + length])))) {
+            ++position;
+            continue;
+        }
+
+        // 只数上一个匹配到这个匹配之间的换行
+        while (const void *newline = memchr(data + lineStart, '\n', position - lineStart)) {
+            lineStart = static_cast<const char *>(newline) - data + 1;
+            ++line;
+        }
+
+        const void *newline = memchr(data + position, '\n', size - position);
+        qsizetype lineEnd = newline ? static_cast<const char *>(newline) - data : size;
+        if (lineEnd > lineStart && data[lineEnd - 1] == '\r') --lineEnd;
+
+        Match match;
+        match.filePath = filePath;
+        match.line = line;
+        match.column = QString::fromUtf8(data + lineStart, position - lineStart).size() + 1;
+        match.length = QString::fromUtf8(data + position, length).size();
+        match.lineText = QString::fromUtf8(data + lineStart, qMin<qsizetype>(lineEnd - lineStart, MaxLineLength));
+        if (!addMatch(searchState, matches, match)) return;
+
+        position += length;
+    }
+}
+
+void ProjectSearcher::searchText(State &searchState, const QString &filePath, const QString &text, QList<Match> &matches)
+{
+    qsizetype lineStart = 0;
+    int line = 1;
+
+    QRegularExpressionMatchIterator it = searchState.regularExpression.globalMatch(text);
+    while (it.hasNext()) {
+        if (searchState.cancelled) return;
+
+        const QRegularExpressionMatch found = it.next();
+        if (found.capturedLength() == 0) continue;
+
+        const qsizetype position = found.capturedStart();
+        for (qsizetype newline = text.indexOf('\n', lineStart); newline >= 0 && newline < position;
+             newline = text.indexOf('\n', lineStart)) {
+            lineStart = newline + 1;
+            ++line;
+        }
+
+        qsizetype lineEnd = text.indexOf('\n', position);
+        if (lineEnd < 0) lineEnd = text.size();
+        if (lineEnd > lineStart && text[lineEnd - 1] == '\r') --lineEnd;
+
+        Match match;
+        match.filePath = filePath;
+        match.line = line;
+        match.column = position - lineStart + 1;
+        match.length = found.capturedLength();
+        match.lineText = text.mid(lineStart, qMin<qsizetype>(lineEnd - lineStart, MaxLineLength));
+        if (!addMatch(searchState, matches, match)) return;
+    }
+}
+
+bool ProjectSearcher::addMatch(State &searchState, QList<Match> &matches, const Match &match)
+{
+    if (searchState.matchCount.fetch_add(1, std::memory_order_relaxed) >= MaxMatches) {
+        searchState.truncated = true;
+        searchState.cancelled = true;
+        return false;
+    }
+    matches.append(match);
+    return true;
+}
+
+void ProjectSearcher::flush(const std::shared_ptr<State> &searchState, QList<Match> &matches)
+{
+    // 因结果太多而提前结束时，已经找到的结果仍然送出
+    if (matches.isEmpty() || (searchState->cancelled && !searchState->truncated)) {
+        matches.clear();
+        return;
+    }
+
+    const int searchGeneration = searchState->generation;
+    const QList<Match> found = matches;
+    matches.clear();
+    QMetaObject::invokeMethod(this, [this, searchGeneration, found]() {
+        if (searchGeneration != generation) return;
+        emit matchesFound(found);
+    }, Qt::QueuedConnection);
+}
+
+void ProjectSearcher::onWorkerFinished(int searchGeneration)
+{
+    if (searchGeneration != generation) return;
+    if (--activeWorkers > 0) return;
+
+    running = false;
+    emit finished(state->fileCount.load(), qMin(state->matchCount.load(), int(MaxMatches)),
+                  state->truncated.load(), state->timer.elapsed());
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QByteArrayMatcher>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+// 在项目文件中查找
+// 文件列表在开始时取一份快照，多个工作线程按块领取文件，用 mmap 映射文件内容后直接在字节上匹配：
+// 区分大小写的字面量用 QByteArrayMatcher（预先建好跳跃表），不区分大小写时用折叠大小写的 Horspool 跳跃表，
+// 正则表达式交给 QRegularExpression（PCRE2 JIT）。已打开且未保存的文件搜索编辑器中的内容。
+// 结果每处理完一块文件就送回界面线程；重新开始查找时旧的查找被取消，其结果不再发出。
+class ProjectSearcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString pattern;
+        bool caseSensitive = false;
+        bool wholeWord = false;
+        bool regularExpression = false;
+        QStringList filePatterns;   // 例如 *.cpp、*.h，为空表示全部文件
+    };
+
+    struct Match
+    {
+        QString filePath;           // 绝对路径
+        int line = 0;               // 从 1 开始
+        int column = 0;             // 从 1 开始，按字符计
+        int length = 0;             // 按字符计
+        QString lineText;
+    };
+
+    static const int MaxMatches = 20000;
+    static const qint64 MaxFileSize = 32 * 1024 * 1024;
+
+    explicit ProjectSearcher(QObject *parent = nullptr);
+    ~ProjectSearcher();
+
+    static QStringList parseFilePatterns(const QString &text);
+    // 按正则表达式匹配时实际使用的表达式：非正则模式下转义字面量，全词匹配时两侧加 \b
+    static QRegularExpression regularExpressionFor(const Options &options);
+
+    // files 为相对 root 的路径；buffers 为未保存的已打开文件（绝对路径 -> 内容），优先于磁盘上的内容。
+    // 正在进行的查找会被取消。正则表达式无效时返回 false
+    bool start(const QString &root, const QStringList &files, const QHash<QString, QString> &buffers,
+               const Options &options, QString *errorMessage = nullptr);
+    void cancel();
+    bool isRunning() const { return running; }
+
+signals:
+    void matchesFound(const QList<ProjectSearcher::Match> &matches);
+    void finished(int fileCount, int matchCount, bool truncated, qint64 elapsedMs);
+
+private:
+    struct State
+    {
+        QString root;
+        int generation = 0;
+        QStringList files;
+        QHash<QString, QByteArray> buffers;     // UTF-8 内容
+        QList<QRegularExpression> filePatterns;
+        bool wholeWord = false;
+        bool useRegularExpression = false;
+        QRegularExpression regularExpression;
+        QByteArray literal;
+        QByteArrayMatcher matcher;              // 区分大小写时使用
+        bool caseSensitive = false;
+        int skip[256];                          // Horspool 跳跃表（不区分大小写时使用）
+        std::atomic<int> next{0};
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> truncated{false};
+        std::atomic<int> fileCount{0};
+        std::atomic<int> matchCount{0};
+        QElapsedTimer timer;
+    };
+
+    static const int ChunkSize = 32;
+
+    static qsizetype findLiteral(const State &searchState, const char *data, qsizetype size, qsizetype from);
+    static void searchFile(State &searchState, const QString &filePath, QList<Match> &matches);
+    static void searchBytes(State &searchState, const QString &filePath, const char *data, qsizetype size,
+                            QList<Match> &matches);
+    static void searchText(State &searchState, const QString &filePath, const QString &text, QList<Match> &matches);
+    static bool addMatch(State &searchState, QList<Match> &matches, const Match &match);
+    void runWorker(const std::shared_ptr<State> &searchState);
+    void flush(const std::shared_ptr<State> &searchState, QList<Match> &matches);
+    void onWorkerFinished(int searchGeneration);
+
+    QThreadPool *pool;
+    std::shared_ptr<State> state;
+    int generation;
+    int activeWorkers;
+    bool running;
+};
@@ -0,0 +1,386 @@
+#include "projecttreemodel.h"
+#include <QApplication>
+#include <QStyle>
+#include <algorithm>
+
+namespace
+{
+// 资源中没有对应图标时退回到系统样式的图标
+QIcon loadIcon(const QString &resource, QStyle::StandardPixmap fallback)
+{
+    QIcon icon(resource);
+    if (icon.availableSizes().isEmpty()) icon = QApplication::style()->standardIcon(fallback);
+    return icon;
+}
+
+// 所有节点共享同一组图标，不为每个文件各自加载
+const QIcon &directoryIcon()
+{
+    static const QIcon icon = loadIcon(":/icons/folder.png", QStyle::SP_DirIcon);
+    return icon;
+}
+
+const QIcon &fileIcon(FileIndex::Category category)
+{
+    static const QIcon sourceIcon = loadIcon(":/icons/cpp.png", QStyle::SP_FileIcon);
+    static const QIcon headerIcon = loadIcon(":/icons/h.png", QStyle::SP_FileIcon);
+    static const QIcon otherIcon = loadIcon(":/icons/file.png", QStyle::SP_FileIcon);
+
+    switch (category) {
+    case FileIndex::Source: return sourceIcon;
+    case FileIndex::Header: return headerIcon;
+    case FileIndex::Other: break;
+    }
+    return otherIcon;
+}
+}
+
+ProjectTreeModel::ProjectTreeModel(FileIndex *fileIndex, QObject *parent)
+    : QAbstractItemModel(parent)
+    , fileIndex(fileIndex)
+    , rootNode(new Node)
+{
+}
+
+ProjectTreeModel::~ProjectTreeModel()
+{
+    deleteNode(rootNode);
+}
+
+void ProjectTreeModel::setRootPath(const QString &path)
+{
+    beginResetModel();
+    root = path;
+    endResetModel();
+}
+
+void ProjectTreeModel::clear()
+{
+    beginResetModel();
+    deleteNode(rootNode);
+    rootNode = new Node;
+    fileIndex->clear();
+    endResetModel();
+}
+
+void ProjectTreeModel::reload()
+{
+    beginResetModel();
+    deleteNode(rootNode);
+    rootNode = new Node;
+    endResetModel();
+}
+
+void ProjectTreeModel::deleteNode(Node *node)
+{
+    for (const Item &item : node->children) {
+        if (item.node) deleteNode(item.node);
+    }
+    delete node;
+}
+
+QString ProjectTreeModel::itemName(const Item &item) const
+{
+    return item.node ? fileIndex->directory(item.id).name : fileIndex->fileName(item.id);
+}
+
+bool ProjectTreeModel::lessThan(const Item &item, bool isDirectory, const QString &name) const
+{
+    // 目录在前；名称不区分大小写排序，相同时再区分大小写保证顺序唯一
+    if ((item.node != nullptr) != isDirectory) return item.node != nullptr;
+
+    const QString itemText = itemName(item);
+    const int order = QString::compare(itemText, name, Qt::CaseInsensitive);
+    if (order != 0) return order < 0;
+    return QString::compare(itemText, name, Qt::CaseSensitive) < 0;
+}
+
+int ProjectTreeModel::lowerBound(const Node *node, bool isDirectory, const QString &name) const
+{
+    int low = 0;
+    int high = node->children.size();
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (lessThan(node->children[middle], isDirectory, name)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+int ProjectTreeModel::rowOf(const Node *node) const
+{
+    return lowerBound(node->parent, true, fileIndex->directory(node->directory).name);
+}
+
+ProjectTreeModel::Node *ProjectTreeModel::nodeFor(const QModelIndex &index) const
+{
+    if (!index.isValid()) return rootNode;
+
+    // 内部指针保存的是父节点，行号定位到子项
+    const Node *parent = static_cast<const Node *>(index.internalPointer());
+    return parent->children[index.row()].node;
+}
+
+QModelIndex ProjectTreeModel::indexOf(Node *node) const
+{
+    if (!node || node == rootNode) return QModelIndex();
+    return createIndex(rowOf(node), 0, node->parent);
+}
+
+ProjectTreeModel::Node *ProjectTreeModel::findChildDirectory(Node *node, const QString &name) const
+{
+    const int row = lowerBound(node, true, name);
+    if (row < node->children.size() && node->children[row].node && itemName(node->children[row]) == name) {
+        return node->children[row].node;
+    }
+    return nullptr;
+}
+
+void ProjectTreeModel::populate(Node *node)
+{
+    const FileIndex::Directory &directory = fileIndex->directory(node->directory);
+
+    QList<Item> children;
+    children.reserve(directory.directories.size() + directory.files.size());
+    for (int id : directory.directories) {
+        Item item;
+        item.id = id;
+        item.node = new Node;
+        item.node->directory = id;
+        item.node->parent = node;
+        children.append(item);
+    }
+    for (int id : directory.files) {
+        Item item;
+        item.id = id;
+        children.append(item);
+    }
+    std::sort(children.begin(), children.end(), [this](const Item &a, const Item &b) {
+        return lessThan(a, b.node != nullptr, itemName(b));
+    });
+
+    node->children = children;
+    node->fetched = true;
+}
+
+QModelIndex ProjectTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column != 0) return QModelIndex();
+
+    Node *node = nodeFor(parent);
+    if (!node || row < 0 || row >= node->children.size()) return QModelIndex();
+    return createIndex(row, column, node);
+}
+
+QModelIndex ProjectTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid()) return QModelIndex();
+    return indexOf(static_cast<Node *>(child.internalPointer()));
+}
+
+int ProjectTreeModel::rowCount(const QModelIndex &parent) const
+{
+    const Node *node = nodeFor(parent);
+    return node ? node->children.size() : 0;
+}
+
+int ProjectTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return 1;
+}
+
+bool ProjectTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    const Node *node = nodeFor(parent);
+    if (!node) return false;
+    if (node->fetched) return !node->children.isEmpty();
+
+    // 未展开的目录只查索引，显示展开箭头但不生成子项
+    const FileIndex::Directory &directory = fileIndex->directory(node->directory);
+    return !directory.directories.isEmpty() || !directory.files.isEmpty();
+}
+
+bool ProjectTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    const Node *node = nodeFor(parent);
+    return node && !node->fetched;
+}
+
+void ProjectTreeModel::fetchMore(const QModelIndex &parent)
+{
+    Node *node = nodeFor(parent);
+    if (!node || node->fetched) return;
+
+    const FileIndex::Directory &directory = fileIndex->directory(node->directory);
+    const int count = directory.directories.size() + directory.files.size();
+    if (count == 0) {
+        node->fetched = true;
+        return;
+    }
+
+    beginInsertRows(parent, 0, count - 1);
+    populate(node);
+    endInsertRows();
+}
+
+QVariant ProjectTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    const Node *parent = static_cast<const Node *>(index.internalPointer());
+    const Item &item = parent->children[index.row()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return itemName(item);
+    case Qt::DecorationRole:
+        return item.node ? directoryIcon() : fileIcon(FileIndex::categoryOf(fileIndex->fileName(item.id)));
+    case Qt::ToolTipRole:
+    case RelativePathRole:
+        return relativePath(index);
+    case FilePathRole: {
+        const QString path = relativePath(index);
+        return path.isEmpty() ? root : root + "/" + path;
+    }
+    case IsDirectoryRole:
+        return item.node != nullptr;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags ProjectTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QString ProjectTreeModel::relativePath(const QModelIndex &index) const
+{
+    if (!index.isValid()) return QString();
+
+    const Node *parent = static_cast<const Node *>(index.internalPointer());
+    const Item &item = parent->children[index.row()];
+    return item.node ? fileIndex->directory(item.id).path : fileIndex->path(item.id);
+}
+
+bool ProjectTreeModel::isDirectory(const QModelIndex &index) const
+{
+    return index.isValid() && nodeFor(index) != nullptr;
+}
+
+ProjectTreeModel::Node *ProjectTreeModel::ensureDirectory(const QString &relativePath, bool fetch)
+{
+    // 沿路径逐级向下；遇到未展开的目录时停止（fetch 为 true 时先展开），子项会在展开时从索引生成
+    Node *node = rootNode;
+    const QStringList parts = relativePath.split('/', Qt::SkipEmptyParts);
+
+    for (const QString &name : parts) {
+        if (!node->fetched) {
+            if (!fetch) return nullptr;
+            fetchMore(indexOf(node));
+        }
+
+        Node *child = findChildDirectory(node, name);
+        if (!child) {
+            const int id = fileIndex->directory(node->directory).directories.value(name, -1);
+            if (id < 0) return nullptr;
+
+            // 索引中新出现的目录，在已展开的父目录中插入一行
+            Item item;
+            item.id = id;
+            item.node = new Node;
+            item.node->directory = id;
+            item.node->parent = node;
+
+            const int row = lowerBound(node, true, name);
+            beginInsertRows(indexOf(node), row, row);
+            node->children.insert(row, item);
+            endInsertRows();
+            child = item.node;
+        }
+        node = child;
+    }
+    return node;
+}
+
+bool ProjectTreeModel::insertFile(const QString &relativePath)
+{
+    if (!fileIndex->insert(relativePath)) return false;
+
+    const int slash = relativePath.lastIndexOf('/');
+    Node *node = ensureDirectory(slash < 0 ? QString() : relativePath.left(slash), false);
+    if (!node || !node->fetched) return true;
+
+    Item item;
+    item.id = fileIndex->find(relativePath);
+    const int row = lowerBound(node, false, relativePath.mid(slash + 1));
+    beginInsertRows(indexOf(node), row, row);
+    node->children.insert(row, item);
+    endInsertRows();
+    return true;
+}
+
+void ProjectTreeModel::removeItem(Node *node, bool isDirectory, const QString &name)
+{
+    const int row = lowerBound(node, isDirectory, name);
+    if (row >= node->children.size() || (node->children[row].node != nullptr) != isDirectory
+        || itemName(node->children[row]) != name) {
+        return;
+    }
+
+    beginRemoveRows(indexOf(node), row, row);
+    Item removed = node->children.takeAt(row);
+    if (removed.node) deleteNode(removed.node);
+    endRemoveRows();
+}
+
+bool ProjectTreeModel::removeFile(const QString &relativePath)
+{
+    const int id = fileIndex->find(relativePath);
+    if (id < 0) return false;
+
+    // 先从树中去掉（定位需要文件名），再从索引删除
+    const int slash = relativePath.lastIndexOf('/');
+    Node *node = ensureDirectory(slash < 0 ? QString() : relativePath.left(slash), false);
+    if (node && node->fetched) removeItem(node, false, relativePath.mid(slash + 1));
+    return fileIndex->remove(relativePath);
+}
+
+QStringList ProjectTreeModel::removeDirectory(const QString &relativePath)
+{
+    const int id = fileIndex->findDirectory(relativePath);
+    if (id <= 0) return QStringList();
+
+    const int parentId = fileIndex->directory(id).parent;
+    const QString parentPath = fileIndex->directory(parentId).path;
+    Node *node = ensureDirectory(parentPath, false);
+    if (node && node->fetched) removeItem(node, true, fileIndex->directory(id).name);
+    return fileIndex->removeDirectory(relativePath);
+}
+
+QModelIndex ProjectTreeModel::indexForPath(const QString &relativePath)
+{
+    const int slash = relativePath.lastIndexOf('/');
+    const QString directory = slash < 0 ? QString() : relativePath.left(slash);
+
+    if (fileIndex->findDirectory(relativePath) > 0) {
+        return indexOf(ensureDirectory(relativePath, true));
+    }
+
+    const int id = fileIndex->find(relativePath);
+    if (id < 0) return QModelIndex();
+
+    Node *node = ensureDirectory(directory, true);
+    if (!node) return QModelIndex();
+    if (!node->fetched) fetchMore(indexOf(node));
+
+    const int row = lowerBound(node, false, relativePath.mid(slash + 1));
+    if (row >= node->children.size() || node->children[row].id != id) return QModelIndex();
+    return createIndex(row, 0, node);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QIcon>
+#include <QList>
+
+#include "fileindex.h"
+
+// 项目树模型
+// 直接建立在 FileIndex 的目录结构上，不为每个文件创建对象：目录节点在第一次展开时
+// 才生成有序的子项列表（只有编号），名称和图标在绘制时从索引和共享图标取得。
+// 未展开的目录只占一个空节点，文件数量增加时加载时间和内存基本不变。
+// 索引的修改都经过本模型，已展开的目录按有序位置增量插入/删除行。
+class ProjectTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles
+    {
+        FilePathRole = Qt::UserRole,    // 绝对路径
+        RelativePathRole,
+        IsDirectoryRole
+    };
+
+    explicit ProjectTreeModel(FileIndex *fileIndex, QObject *parent = nullptr);
+    ~ProjectTreeModel();
+
+    void setRootPath(const QString &path);
+    QString rootPath() const { return root; }
+
+    // 清空索引并重置模型
+    void clear();
+    // 索引被整体替换后调用
+    void reload();
+
+    bool insertFile(const QString &relativePath);
+    bool removeFile(const QString &relativePath);
+    QStringList removeDirectory(const QString &relativePath);
+
+    // 需要时逐级加载父目录，用于在树中定位文件
+    QModelIndex indexForPath(const QString &relativePath);
+    QString relativePath(const QModelIndex &index) const;
+    bool isDirectory(const QModelIndex &index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    struct Node;
+
+    // 子项：node 不为空时是目录，id 是目录编号，否则 id 是文件编号
+    struct Item
+    {
+        int id = -1;
+        Node *node = nullptr;
+    };
+
+    struct Node
+    {
+        int directory = 0;
+        Node *parent = nullptr;
+        bool fetched = false;
+        QList<Item> children;   // 目录在前，同类按名称排序
+    };
+
+    QString itemName(const Item &item) const;
+    bool lessThan(const Item &item, bool isDirectory, const QString &name) const;
+    int lowerBound(const Node *node, bool isDirectory, const QString &name) const;
+    int rowOf(const Node *node) const;
+    Node *nodeFor(const QModelIndex &index) const;
+    QModelIndex indexOf(Node *node) const;
+    Node *findChildDirectory(Node *node, const QString &name) const;
+    void populate(Node *node);
+    void deleteNode(Node *node);
+    Node *ensureDirectory(const QString &relativePath, bool fetch);
+    void removeItem(Node *node, bool isDirectory, const QString &name);
+
+    FileIndex *fileIndex;
+    QString root;
+    Node *rootNode;
+};
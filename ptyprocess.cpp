@@ -0,0 +1,310 @@
+#include "ptyprocess.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+// forkpty 所在的头文件因系统而异
+#if defined(Q_OS_MACOS) || defined(Q_OS_OPENBSD) || defined(Q_OS_NETBSD)
+#include <util.h>
+#elif defined(Q_OS_FREEBSD)
+#include <libutil.h>
+#else
+#include <pty.h>
+#endif
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+PtyProcess::PtyProcess(QObject *parent)
+    : QObject(parent)
+    , masterFd(-1)
+    , pid(0)
+    , running(false)
+    , rows(24)
+    , columns(80)
+    , stopRequested(false)
+    , droppedSinceRead(0)
+    , notifyPending(false)
+    , inputTimer(new QTimer(this))
+{
+    inputTimer->setSingleShot(true);
+    connect(inputTimer, &QTimer::timeout, this, &PtyProcess::flushPendingInput);
+}
+
+PtyProcess::~PtyProcess()
+{
+    if (running) {
+        kill();
+    }
+    stopRequested = true;
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+#ifdef Q_OS_UNIX
+    if (running) {
+        ::waitpid(static_cast<pid_t>(pid), nullptr, 0);
+    }
+    if (masterFd >= 0) {
+        ::close(masterFd);
+    }
+#endif
+}
+
+bool PtyProcess::start(const QString &program, const QStringList &arguments,
+                       const QString &workingDirectory, const QProcessEnvironment &environment)
+{
+#ifdef Q_OS_UNIX
+    if (running) return false;
+
+    QString executable = program;
+    if (!executable.contains('/')) {
+        executable = QStandardPaths::findExecutable(program);
+    }
+    if (executable.isEmpty() || !QFileInfo(executable).isExecutable()) {
+        lastError = "找不到可执行文件: " + program;
+        return false;
+    }
+
+    // fork 之后子进程只能调用 async-signal-safe 的函数，所有参数提前准备好
+    QList<QByteArray> argumentStorage;
+    argumentStorage << QFile::encodeName(executable);
+    for (const QString &argument : arguments) {
+        argumentStorage << argument.toLocal8Bit();
+    }
+    std::vector<char*> argv;
+    for (QByteArray &argument : argumentStorage) {
+        argv.push_back(argument.data());
+    }
+    argv.push_back(nullptr);
+
+    QProcessEnvironment childEnvironment = environment;
+    childEnvironment.insert("TERM", "xterm-256color");
+    QList<QByteArray> environmentStorage;
+    for (const QString &entry : childEnvironment.toStringList()) {
+        environmentStorage << entry.toLocal8Bit();
+    }
+    std::vector<char*> envp;
+    for (QByteArray &entry : environmentStorage) {
+        envp.push_back(entry.data());
+    }
+    envp.push_back(nullptr);
+
+    QByteArray directory = QFile::encodeName(workingDirectory);
+
+    struct winsize windowSize;
+    memset(&windowSize, 0, sizeof(windowSize));
+    windowSize.ws_row = static_cast<unsigned short>(rows);
+    windowSize.ws_col = static_cast<unsigned short>(columns);
+
+    int fd = -1;
+    pid_t child = forkpty(&fd, nullptr, nullptr, &windowSize);
+    if (child < 0) {
+        lastError = QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+    if (child == 0) {
+        if (!directory.isEmpty() && chdir(directory.constData()) != 0) {
+            _exit(127);
+        }
+        execve(argv[0], argv.data(), envp.data());
+        _exit(127);
+    }
+
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+    if (masterFd >= 0) {
+        ::close(masterFd);
+    }
+
+    masterFd = fd;
+    pid = child;
+    running = true;
+    stopRequested = false;
+    droppedSinceRead = 0;
+    outputBuffer.clear();
+    pendingInput.clear();
+
+    fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+    fcntl(masterFd, F_SETFD, FD_CLOEXEC);
+
+    readerThread = std::thread(&PtyProcess::readerLoop, this);
+    return true;
+#else
+    Q_UNUSED(program)
+    Q_UNUSED(arguments)
+    Q_UNUSED(workingDirectory)
+    Q_UNUSED(environment)
+    lastError = "当前平台不支持伪终端";
+    return false;
+#endif
+}
+
+void PtyProcess::readerLoop()
+{
+#ifdef Q_OS_UNIX
+    char buffer[65536];
+    bool slaveClosed = false;
+    int status = 0;
+
+    auto appendOutput = [this](const char *data, qint64 size) {
+        QMutexLocker locker(&bufferMutex);
+        outputBuffer.append(data, size);
+        // 超过上限时一次丢弃到一半容量，避免每次追加都搬移整个缓冲区
+        if (outputBuffer.size() > MaxBufferedBytes) {
+            qint64 excess = outputBuffer.size() - MaxBufferedBytes / 2;
+            outputBuffer.remove(0, excess);
+            droppedSinceRead += excess;
+        }
+    };
+
+    while (!stopRequested) {
+        struct pollfd pfd;
+        pfd.fd = masterFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = ::poll(&pfd, 1, 50);
+        if (ready > 0) {
+            ssize_t count = ::read(masterFd, buffer, sizeof(buffer));
+            if (count > 0) {
+                appendOutput(buffer, count);
+                notifyReadyRead();
+                continue;
+            }
+            if (count < 0 && (errno == EINTR || errno == EAGAIN)) {
+                continue;
+            }
+            // EIO：从端已全部关闭
+            slaveClosed = true;
+        }
+
+        pid_t result = ::waitpid(static_cast<pid_t>(pid), &status, slaveClosed ? 0 : WNOHANG);
+        if (result == static_cast<pid_t>(pid)) {
+            // 子进程已退出，读完伪终端里剩余的输出
+            ssize_t count;
+            while ((count = ::read(masterFd, buffer, sizeof(buffer))) > 0) {
+                appendOutput(buffer, count);
+            }
+            notifyReadyRead();
+            QMetaObject::invokeMethod(this, [this, status]() { onChildExited(status); }, Qt::QueuedConnection);
+            return;
+        }
+        if (result < 0 && errno != EINTR) {
+            QMetaObject::invokeMethod(this, [this]() { onChildExited(0); }, Qt::QueuedConnection);
+            return;
+        }
+    }
+#endif
+}
+
+void PtyProcess::notifyReadyRead()
+{
+    // 合并通知：界面取走数据之前只投递一次事件
+    if (!notifyPending.exchange(true)) {
+        QMetaObject::invokeMethod(this, [this]() { emit readyRead(); }, Qt::QueuedConnection);
+    }
+}
+
+void PtyProcess::onChildExited(int status)
+{
+#ifdef Q_OS_UNIX
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+    running = false;
+    inputTimer->stop();
+    pendingInput.clear();
+
+    if (WIFSIGNALED(status)) {
+        emit finished(WTERMSIG(status), QProcess::CrashExit);
+    } else {
+        emit finished(WEXITSTATUS(status), QProcess::NormalExit);
+    }
+#else
+    Q_UNUSED(status)
+#endif
+}
+
+QByteArray PtyProcess::readOutput(qint64 maxBytes, qint64 *droppedBytes)
+{
+    QByteArray data;
+    qint64 dropped = 0;
+    {
+        QMutexLocker locker(&bufferMutex);
+        if (outputBuffer.size() > maxBytes) {
+            dropped = outputBuffer.size() - maxBytes;
+            data = outputBuffer.right(maxBytes);
+            outputBuffer.clear();
+        } else {
+            data.swap(outputBuffer);
+        }
+        dropped += droppedSinceRead;
+        droppedSinceRead = 0;
+        notifyPending = false;
+    }
+    if (droppedBytes) *droppedBytes = dropped;
+    return data;
+}
+
+void PtyProcess::write(const QByteArray &data)
+{
+    if (!running || data.isEmpty()) return;
+    pendingInput.append(data);
+    flushPendingInput();
+}
+
+void PtyProcess::flushPendingInput()
+{
+#ifdef Q_OS_UNIX
+    while (running && !pendingInput.isEmpty()) {
+        ssize_t written = ::write(masterFd, pendingInput.constData(), pendingInput.size());
+        if (written > 0) {
+            pendingInput.remove(0, written);
+            continue;
+        }
+        if (written < 0 && errno == EINTR) continue;
+        // 伪终端输入队列已满（子进程没有读取），稍后重试
+        inputTimer->start(10);
+        return;
+    }
+#endif
+}
+
+void PtyProcess::terminate()
+{
+#ifdef Q_OS_UNIX
+    // forkpty 创建了新会话，向整个进程组发送信号，连同子进程创建的进程一起结束
+    if (running) ::kill(-static_cast<pid_t>(pid), SIGTERM);
+#endif
+}
+
+void PtyProcess::kill()
+{
+#ifdef Q_OS_UNIX
+    if (running) ::kill(-static_cast<pid_t>(pid), SIGKILL);
+#endif
+}
+
+void PtyProcess::setWindowSize(int newRows, int newColumns)
+{
+    rows = qMax(1, newRows);
+    columns = qMax(1, newColumns);
+#ifdef Q_OS_UNIX
+    if (masterFd >= 0 && running) {
+        struct winsize windowSize;
+        memset(&windowSize, 0, sizeof(windowSize));
+        windowSize.ws_row = static_cast<unsigned short>(rows);
+        windowSize.ws_col = static_cast<unsigned short>(columns);
+        ioctl(masterFd, TIOCSWINSZ, &windowSize);
+    }
+#endif
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QMutex>
+#include <QTimer>
+#include <atomic>
+#include <thread>
+
+// 伪终端进程
+// 子进程的标准输入/输出/错误都连接到伪终端从端，因此程序按行刷新输出、
+// 可以读取 cin，内核的行规程负责回显和行编辑（退格、Ctrl+U 等）。
+// 主端由后台线程持续读取到有上限的缓冲区中，缓冲区满时丢弃最旧的数据，
+// 子进程永远不会因为界面来不及渲染而被阻塞。
+class PtyProcess : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PtyProcess(QObject *parent = nullptr);
+    ~PtyProcess();
+
+    bool start(const QString &program, const QStringList &arguments,
+               const QString &workingDirectory,
+               const QProcessEnvironment &environment = QProcessEnvironment::systemEnvironment());
+    void write(const QByteArray &data);
+    void terminate();
+    void kill();
+    void setWindowSize(int rows, int columns);
+
+    bool isRunning() const { return running; }
+    qint64 processId() const { return pid; }
+    QString errorString() const { return lastError; }
+
+    // 取出缓冲的输出，最多 maxBytes 字节；超出部分从最旧的数据开始丢弃
+    QByteArray readOutput(qint64 maxBytes, qint64 *droppedBytes = nullptr);
+
+signals:
+    void readyRead();
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void flushPendingInput();
+
+private:
+    void readerLoop();
+    void notifyReadyRead();
+    void onChildExited(int status);
+
+    static const qint64 MaxBufferedBytes = 8 * 1024 * 1024;
+
+    int masterFd;
+    qint64 pid;
+    bool running;
+    int rows;
+    int columns;
+    QString lastError;
+
+    std::thread readerThread;
+    std::atomic<bool> stopRequested;
+    QMutex bufferMutex;
+    QByteArray outputBuffer;
+    qint64 droppedSinceRead;
+    std::atomic<bool> notifyPending;
+
+    QByteArray pendingInput;
+    QTimer *inputTimer;
+};
@@ -0,0 +1,175 @@
+#include "quickopendialog.h"
+#include <QVBoxLayout>
+#include <QKeyEvent>
+#include <QDir>
+
+QuickOpenDialog::QuickOpenDialog(QWidget *parent)
+    : QDialog(parent, Qt::Popup)
+    , fileIndex(nullptr)
+    , indexedRevision(-1)
+    , itemsDirty(true)
+    , recentDirty(true)
+{
+    resize(600, 400);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->setSpacing(4);
+
+    queryEdit = new QLineEdit(this);
+    queryEdit->setPlaceholderText("输入文件名（模糊匹配，例如 pmgr 匹配 projectmanager.cpp）");
+    queryEdit->installEventFilter(this);
+    layout->addWidget(queryEdit);
+
+    resultList = new QListWidget(this);
+    resultList->setUniformItemSizes(true);
+    resultList->setFocusPolicy(Qt::NoFocus);
+    layout->addWidget(resultList);
+
+    connect(queryEdit, &QLineEdit::textChanged, this, &QuickOpenDialog::updateResults);
+    connect(queryEdit, &QLineEdit::returnPressed, this, &QuickOpenDialog::acceptCurrent);
+    connect(resultList, &QListWidget::itemActivated, this, &QuickOpenDialog::acceptCurrent);
+}
+
+void QuickOpenDialog::setFileIndex(const FileIndex *index, const QString &rootPath)
+{
+    if (fileIndex == index && root == rootPath) return;
+    fileIndex = index;
+    root = rootPath;
+    itemsDirty = true;
+}
+
+void QuickOpenDialog::setRecentFiles(const QStringList &files)
+{
+    if (recentFiles == files) return;
+    recentFiles = files;
+    recentDirty = true;
+}
+
+QString QuickOpenDialog::toItem(const QString &filePath) const
+{
+    // 项目内的文件用相对路径匹配，项目外的用绝对路径
+    if (!root.isEmpty()) {
+        const QString relative = QDir(root).relativeFilePath(filePath);
+        if (!relative.startsWith("..") && !QDir::isAbsolutePath(relative)) return relative;
+    }
+    return filePath;
+}
+
+QString QuickOpenDialog::toAbsolute(const QString &item) const
+{
+    if (QDir::isAbsolutePath(item) || root.isEmpty()) return item;
+    return root + "/" + item;
+}
+
+void QuickOpenDialog::rebuildItems()
+{
+    QStringList recentItems;
+    QStringList outsideFiles;
+    recentItems.reserve(recentFiles.size());
+    for (const QString &file : recentFiles) {
+        const QString item = toItem(file);
+        recentItems.append(item);
+        if (QDir::isAbsolutePath(item)) outsideFiles.append(item);
+    }
+
+    // 项目外的最近文件也是候选项；只有它们或索引变化时才重建匹配表，否则只更新最近顺序
+    const int revision = fileIndex ? fileIndex->revision() : -1;
+    if (itemsDirty || revision != indexedRevision || outsideFiles != externalFiles) {
+        QStringList items;
+        if (fileIndex) items = fileIndex->files();
+        items.append(outsideFiles);
+
+        matcher.setItems(items);
+        externalFiles = outsideFiles;
+        indexedRevision = revision;
+        itemsDirty = false;
+    }
+
+    matcher.setRecent(recentItems);
+    recentDirty = false;
+}
+
+void QuickOpenDialog::popup()
+{
+    if (itemsDirty || recentDirty || (fileIndex && fileIndex->revision() != indexedRevision)) rebuildItems();
+
+    QWidget *owner = parentWidget() ? parentWidget()->window() : nullptr;
+    if (owner) {
+        const int width = qMin(600, owner->width() - 40);
+        resize(width, qMin(400, owner->height() / 2));
+        move(owner->mapToGlobal(QPoint((owner->width() - width) / 2, 60)));
+    }
+
+    queryEdit->clear();
+    updateResults();
+    show();
+    raise();
+    activateWindow();
+    queryEdit->setFocus();
+}
+
+void QuickOpenDialog::updateResults()
+{
+    const QList<FuzzyMatcher::Match> matches = matcher.match(queryEdit->text(), MaxResults);
+
+    resultList->setUpdatesEnabled(false);
+    resultList->clear();
+    for (const FuzzyMatcher::Match &match : matches) {
+        const QString item = matcher.item(match.item);
+        const int slash = item.lastIndexOf('/');
+        const QString fileName = item.mid(slash + 1);
+        const QString directory = slash < 0 ? QString() : item.left(slash);
+
+        QListWidgetItem *row = new QListWidgetItem(directory.isEmpty()
+                                                   ? fileName
+                                                   : QString("%1    %2").arg(fileName, directory),
+                                                   resultList);
+        row->setData(Qt::UserRole, toAbsolute(item));
+        row->setToolTip(toAbsolute(item));
+    }
+    if (resultList->count() > 0) resultList->setCurrentRow(0);
+    resultList->setUpdatesEnabled(true);
+}
+
+void QuickOpenDialog::acceptCurrent()
+{
+    QListWidgetItem *item = resultList->currentItem();
+    if (!item) return;
+
+    const QString filePath = item->data(Qt::UserRole).toString();
+    hide();
+    emit fileSelected(filePath);
+}
+
+bool QuickOpenDialog::eventFilter(QObject *watched, QEvent *event)
+{
+    // 焦点留在输入框，上下键和翻页键转给结果列表
+    if (watched == queryEdit && event->type() == QEvent::KeyPress) {
+        QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+        switch (keyEvent->key()) {
+        case Qt::Key_Up:
+        case Qt::Key_Down:
+        case Qt::Key_PageUp:
+        case Qt::Key_PageDown: {
+            const int count = resultList->count();
+            if (count == 0) return true;
+
+            const int page = qMax(1, resultList->height() / qMax(1, resultList->sizeHintForRow(0)) - 1);
+            int row = resultList->currentRow();
+            if (keyEvent->key() == Qt::Key_Up) row = (row - 1 + count) % count;
+            else if (keyEvent->key() == Qt::Key_Down) row = (row + 1) % count;
+            else if (keyEvent->key() == Qt::Key_PageUp) row = qMax(0, row - page);
+            else row = qMin(count - 1, row + page);
+            resultList->setCurrentRow(row);
+            return true;
+        }
+        case Qt::Key_Escape:
+            hide();
+            return true;
+        default:
+            break;
+        }
+    }
+    return QDialog::eventFilter(watched, event);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QListWidget>
+
+#include "fileindex.h"
+#include "fuzzymatcher.h"
+
+// 转到文件（Ctrl+P）
+// 弹出窗口中输入文件名片段，实时列出模糊匹配的项目文件，最近打开的文件排在前面。
+// 匹配表只在索引变化后打开窗口时重建，逐键输入只做匹配。
+class QuickOpenDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static const int MaxResults = 50;
+
+    explicit QuickOpenDialog(QWidget *parent = nullptr);
+
+    void setFileIndex(const FileIndex *fileIndex, const QString &rootPath);
+    // 最近打开的文件（绝对路径，最近的在前），项目外的文件也可以转到
+    void setRecentFiles(const QStringList &files);
+
+    // 清空输入并显示在父窗口上方
+    void popup();
+
+signals:
+    void fileSelected(const QString &filePath);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void updateResults();
+    void acceptCurrent();
+
+private:
+    void rebuildItems();
+    QString toItem(const QString &filePath) const;
+    QString toAbsolute(const QString &item) const;
+
+    QLineEdit *queryEdit;
+    QListWidget *resultList;
+
+    FuzzyMatcher matcher;
+    const FileIndex *fileIndex;
+    QString root;
+    QStringList recentFiles;
+    QStringList externalFiles;  // 匹配表中的项目外文件
+    int indexedRevision;
+    bool itemsDirty;
+    bool recentDirty;
+};
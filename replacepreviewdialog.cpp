@@ -0,0 +1,126 @@
+#include "replacepreviewdialog.h"
+#include "textdiff.h"
+#include <QVBoxLayout>
+#include <QSplitter>
+#include <QDialogButtonBox>
+#include <QFontDatabase>
+#include <QTextCursor>
+#include <QTextCharFormat>
+
+ReplacePreviewDialog::ReplacePreviewDialog(const QList<ProjectReplacer::FileEdit> &edits, const QStringList &skipped,
+                                           const QString &rootPath, QWidget *parent)
+    : QDialog(parent)
+    , edits(edits)
+{
+    setWindowTitle("替换预览");
+    resize(960, 600);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+    fileList = new QListWidget(splitter);
+    fileList->setUniformItemSizes(true);
+    for (const ProjectReplacer::FileEdit &edit : edits) {
+        QString path = edit.filePath;
+        if (!rootPath.isEmpty() && path.startsWith(rootPath + '/')) path = path.mid(rootPath.size() + 1);
+
+        QListWidgetItem *item = new QListWidgetItem(QString("%1 (%2)").arg(path).arg(edit.count), fileList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Checked);
+        item->setToolTip(edit.inEditor ? edit.filePath + "\n已在编辑器中打开，替换写入编辑器（可撤销）" : edit.filePath);
+    }
+
+    diffView = new QPlainTextEdit(splitter);
+    diffView->setReadOnly(true);
+    diffView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    diffView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    splitter->setStretchFactor(1, 2);
+    layout->addWidget(splitter, 1);
+
+    if (!skipped.isEmpty()) {
+        QLabel *skippedLabel = new QLabel(QString("跳过 %1 个文件: %2").arg(skipped.size()).arg(skipped.mid(0, 5).join("; ")), this);
+        skippedLabel->setWordWrap(true);
+        skippedLabel->setToolTip(skipped.join('\n'));
+        skippedLabel->setStyleSheet("color: #cca700;");
+        layout->addWidget(skippedLabel);
+    }
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Cancel, this);
+    applyButton = buttons->addButton("替换", QDialogButtonBox::AcceptRole);
+    layout->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(fileList, &QListWidget::currentRowChanged, this, &ReplacePreviewDialog::showDiff);
+    connect(fileList, &QListWidget::itemChanged, this, &ReplacePreviewDialog::updateSummary);
+
+    updateSummary();
+    if (fileList->count() > 0) fileList->setCurrentRow(0);
+}
+
+QList<ProjectReplacer::FileEdit> ReplacePreviewDialog::selectedEdits() const
+{
+    QList<ProjectReplacer::FileEdit> selected;
+    for (int row = 0; row < fileList->count(); ++row) {
+        if (fileList->item(row)->checkState() == Qt::Checked) selected.append(edits[row]);
+    }
+    return selected;
+}
+
+void ReplacePreviewDialog::updateSummary()
+{
+    int fileCount = 0;
+    int replaceCount = 0;
+    for (int row = 0; row < fileList->count(); ++row) {
+        if (fileList->item(row)->checkState() != Qt::Checked) continue;
+        ++fileCount;
+        replaceCount += edits[row].count;
+    }
+    summaryLabel->setText(QString("将在 %1 个文件中替换 %2 处。磁盘上的文件全部写入成功才会生效，任何一个失败都会恢复原样。")
+                          .arg(fileCount).arg(replaceCount));
+    applyButton->setEnabled(fileCount > 0);
+}
+
+void ReplacePreviewDialog::showDiff(int row)
+{
+    diffView->clear();
+    if (row < 0 || row >= edits.size()) return;
+
+    // 只在选中时计算差异，文件很多时打开预览也不慢
+    const ProjectReplacer::FileEdit &edit = edits[row];
+    const QList<TextDiff::Line> lines = TextDiff::withContext(
+        TextDiff::diff(edit.original.split('\n'), edit.replaced.split('\n')));
+
+    QTextCharFormat normalFormat;
+    normalFormat.setForeground(QColor("#d4d4d4"));
+    QTextCharFormat removedFormat;
+    removedFormat.setForeground(QColor("#f44747"));
+    QTextCharFormat addedFormat;
+    addedFormat.setForeground(QColor("#4ec9b0"));
+
+    QTextCursor cursor(diffView->document());
+    cursor.beginEditBlock();
+    for (const TextDiff::Line &line : lines) {
+        switch (line.type) {
+        case TextDiff::Line::Removed:
+            cursor.insertText(QString("-%1 | %2\n").arg(line.oldLine, 5).arg(line.text), removedFormat);
+            break;
+        case TextDiff::Line::Added:
+            cursor.insertText(QString("+%1 | %2\n").arg(line.newLine, 5).arg(line.text), addedFormat);
+            break;
+        case TextDiff::Line::Equal:
+            if (line.oldLine == 0) {
+                cursor.insertText("  ...\n", normalFormat);
+            } else {
+                cursor.insertText(QString(" %1 | %2\n").arg(line.oldLine, 5).arg(line.text), normalFormat);
+            }
+            break;
+        }
+    }
+    cursor.endEditBlock();
+    diffView->moveCursor(QTextCursor::Start);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QDialog>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QLabel>
+#include <QPushButton>
+
+#include "projectreplacer.h"
+
+// 替换预览对话框
+// 左侧列出将被修改的文件（可取消勾选），右侧显示选中文件替换前后的差异，确认后只应用勾选的文件
+class ReplacePreviewDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    ReplacePreviewDialog(const QList<ProjectReplacer::FileEdit> &edits, const QStringList &skipped,
+                         const QString &rootPath, QWidget *parent = nullptr);
+
+    QList<ProjectReplacer::FileEdit> selectedEdits() const;
+
+private slots:
+    void showDiff(int row);
+    void updateSummary();
+
+private:
+    QList<ProjectReplacer::FileEdit> edits;
+    QListWidget *fileList;
+    QPlainTextEdit *diffView;
+    QLabel *summaryLabel;
+    QPushButton *applyButton;
+};
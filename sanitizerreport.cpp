@@ -0,0 +1,282 @@
+#include "sanitizerreport.h"
+#include "symbolizer.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+
+QString SanitizerReport::displayName(SanitizerKind kind)
+{
+    switch (kind) {
+    case SanitizerKind::Address:   return "AddressSanitizer (ASan)";
+    case SanitizerKind::Undefined: return "UndefinedBehaviorSanitizer (UBSan)";
+    case SanitizerKind::Thread:    return "ThreadSanitizer (TSan)";
+    case SanitizerKind::Leak:      return "LeakSanitizer (LSan)";
+    }
+    return QString();
+}
+
+QString SanitizerReport::profileName(SanitizerKind kind)
+{
+    switch (kind) {
+    case SanitizerKind::Address:   return "asan";
+    case SanitizerKind::Undefined: return "ubsan";
+    case SanitizerKind::Thread:    return "tsan";
+    case SanitizerKind::Leak:      return "lsan";
+    }
+    return QString();
+}
+
+QStringList SanitizerReport::compileFlags(SanitizerKind kind)
+{
+    // -O1 + 帧指针：报告中的调用栈更完整，运行速度仍可接受
+    QStringList flags;
+    switch (kind) {
+    case SanitizerKind::Address:
+        flags << "-fsanitize=address" << "-fno-omit-frame-pointer";
+        break;
+    case SanitizerKind::Undefined:
+        flags << "-fsanitize=undefined" << "-fno-omit-frame-pointer";
+        break;
+    case SanitizerKind::Thread:
+        flags << "-fsanitize=thread";
+        break;
+    case SanitizerKind::Leak:
+        flags << "-fsanitize=leak" << "-fno-omit-frame-pointer";
+        break;
+    }
+    flags << "-g" << "-O1";
+    return flags;
+}
+
+void SanitizerReport::setupEnvironment(SanitizerKind kind, QProcessEnvironment &environment)
+{
+    QString options = "symbolize=1:print_summary=1";
+    QString symbolizer = QStandardPaths::findExecutable("llvm-symbolizer");
+    if (!symbolizer.isEmpty()) {
+        options += ":external_symbolizer_path=" + symbolizer;
+    }
+
+    QString variable;
+    switch (kind) {
+    case SanitizerKind::Address:
+        variable = "ASAN_OPTIONS";
+        options += ":detect_leaks=1:abort_on_error=0";
+        break;
+    case SanitizerKind::Undefined:
+        variable = "UBSAN_OPTIONS";
+        options += ":print_stacktrace=1";
+        break;
+    case SanitizerKind::Thread:
+        variable = "TSAN_OPTIONS";
+        options += ":second_deadlock_stack=1";
+        break;
+    case SanitizerKind::Leak:
+        variable = "LSAN_OPTIONS";
+        break;
+    }
+
+    // 用户自己设置的选项放在后面，优先级更高
+    QString userOptions = environment.value(variable);
+    if (!userOptions.isEmpty()) {
+        options += ":" + userOptions;
+    }
+    environment.insert(variable, options);
+}
+
+static void parseFrame(const QString &text, SanitizerFrame &frame, const QString &baseDir)
+{
+    static const QRegularExpression buildIdRegex(QStringLiteral("\\s*\\(BuildId: [0-9a-fA-F]+\\)$"));
+    static const QRegularExpression addressRegex(QStringLiteral("^(0x[0-9a-fA-F]+)\\s*"));
+    static const QRegularExpression moduleRegex(QStringLiteral("\\s*\\(([^()]+)\\+(0x[0-9a-fA-F]+)\\)$"));
+    static const QRegularExpression locationRegex(QStringLiteral("(?:^|\\s)(\\S+):(\\d+)(?::(\\d+))?$"));
+
+    QString rest = text.trimmed();
+    rest.remove(buildIdRegex);
+
+    QRegularExpressionMatch match = addressRegex.match(rest);
+    if (match.hasMatch()) {
+        frame.address = match.captured(1);
+        rest = rest.mid(match.capturedEnd());
+    }
+    if (rest.startsWith("in ")) {
+        rest = rest.mid(3);
+    }
+
+    match = moduleRegex.match(rest);
+    if (match.hasMatch()) {
+        frame.module = match.captured(1);
+        frame.moduleOffset = match.captured(2).toULongLong(nullptr, 16);
+        rest.truncate(match.capturedStart());
+    }
+
+    match = locationRegex.match(rest);
+    if (match.hasMatch()) {
+        frame.file = match.captured(1);
+        frame.line = match.captured(2).toInt();
+        frame.column = match.captured(3).toInt();
+        rest.truncate(match.capturedStart());
+    }
+    frame.function = rest.trimmed();
+
+    if (!frame.file.isEmpty() && QFileInfo(frame.file).isRelative() && !baseDir.isEmpty()) {
+        QString resolved = QDir(baseDir).filePath(frame.file);
+        if (QFileInfo::exists(resolved)) {
+            frame.file = QDir::cleanPath(resolved);
+        }
+    }
+}
+
+QList<SanitizerIssue> SanitizerReport::parse(const QString &text, const QString &baseDir)
+{
+    static const QRegularExpression headerRegex(
+        QStringLiteral("^(?:==\\d+==)?(?:ERROR|WARNING): (\\w+Sanitizer): (.*)$"));
+    static const QRegularExpression runtimeErrorRegex(
+        QStringLiteral("^(.+?):(\\d+):(\\d+): runtime error: (.*)$"));
+    static const QRegularExpression summaryRegex(QStringLiteral("^SUMMARY: (\\w+Sanitizer): (.*)$"));
+    static const QRegularExpression frameRegex(QStringLiteral("^\\s*#(\\d+)\\s+(.*)$"));
+
+    QList<SanitizerIssue> issues;
+    SanitizerIssue *current = nullptr;
+
+    const QStringList lines = text.split('\n');
+    for (QString line : lines) {
+        line.remove('\r');
+        if (line.trimmed().isEmpty()) continue;
+
+        QRegularExpressionMatch match = headerRegex.match(line);
+        if (match.hasMatch()) {
+            SanitizerIssue issue;
+            issue.tool = match.captured(1);
+            issue.message = match.captured(2).trimmed();
+            if (issue.tool == "LeakSanitizer") {
+                issue.kind = "memory-leak";
+            } else {
+                QString kind = issue.message;
+                int pidPos = kind.indexOf(" (pid=");
+                if (pidPos > 0) kind.truncate(pidPos);
+                int onPos = kind.indexOf(" on ");
+                if (onPos > 0) kind.truncate(onPos);
+                issue.kind = kind;
+            }
+            issues.append(issue);
+            current = &issues.last();
+            continue;
+        }
+
+        match = runtimeErrorRegex.match(line);
+        if (match.hasMatch()) {
+            SanitizerIssue issue;
+            issue.tool = "UndefinedBehaviorSanitizer";
+            issue.file = match.captured(1);
+            issue.line = match.captured(2).toInt();
+            issue.column = match.captured(3).toInt();
+            issue.message = match.captured(4).trimmed();
+            issue.kind = issue.message.section(':', 0, 0).trimmed();
+            if (QFileInfo(issue.file).isRelative() && !baseDir.isEmpty()
+                && QFileInfo::exists(QDir(baseDir).filePath(issue.file))) {
+                issue.file = QDir::cleanPath(QDir(baseDir).filePath(issue.file));
+            }
+            issues.append(issue);
+            current = &issues.last();
+            continue;
+        }
+
+        if (!current) continue;
+
+        match = summaryRegex.match(line);
+        if (match.hasMatch()) {
+            current->summary = match.captured(2).trimmed();
+            // LeakSanitizer 的 SUMMARY 汇总了前面所有泄漏，之后的内容不再属于这条报告
+            current = nullptr;
+            continue;
+        }
+
+        match = frameRegex.match(line);
+        if (match.hasMatch()) {
+            if (current->stacks.isEmpty()) {
+                SanitizerStack stack;
+                stack.title = current->message;
+                current->stacks.append(stack);
+            }
+            SanitizerFrame frame;
+            frame.index = match.captured(1).toInt();
+            parseFrame(match.captured(2), frame, baseDir);
+            current->stacks.last().frames.append(frame);
+            continue;
+        }
+
+        // 以冒号结尾的说明行开始一段新的调用栈
+        QString trimmed = line.trimmed();
+        if (trimmed.endsWith(':') && !trimmed.startsWith("Shadow")) {
+            SanitizerStack stack;
+            stack.title = trimmed.left(trimmed.length() - 1);
+            current->stacks.append(stack);
+        }
+    }
+
+    return issues;
+}
+
+void SanitizerReport::symbolize(QList<SanitizerIssue> &issues)
+{
+    QHash<QString, QList<quint64>> offsetsByModule;
+    for (const SanitizerIssue &issue : std::as_const(issues)) {
+        for (const SanitizerStack &stack : issue.stacks) {
+            for (const SanitizerFrame &frame : stack.frames) {
+                if (frame.file.isEmpty() && !frame.module.isEmpty()
+                    && !offsetsByModule.value(frame.module).contains(frame.moduleOffset)) {
+                    offsetsByModule[frame.module].append(frame.moduleOffset);
+                }
+            }
+        }
+    }
+    if (offsetsByModule.isEmpty()) return;
+
+    QHash<QString, QHash<quint64, Symbolizer::Location>> resolved = Symbolizer::symbolizeAll(offsetsByModule);
+    for (SanitizerIssue &issue : issues) {
+        for (SanitizerStack &stack : issue.stacks) {
+            for (SanitizerFrame &frame : stack.frames) {
+                if (!frame.file.isEmpty() || frame.module.isEmpty()) continue;
+                Symbolizer::Location location = resolved.value(frame.module).value(frame.moduleOffset);
+                if (location.isValid()) {
+                    frame.file = location.file;
+                    frame.line = location.line;
+                }
+                if (frame.function.isEmpty()) {
+                    frame.function = location.function;
+                }
+            }
+        }
+    }
+}
+
+void SanitizerReport::symbolizeAsync(const QList<SanitizerIssue> &issues, QObject *context,
+                                     const std::function<void(const QList<SanitizerIssue> &issues)> &callback)
+{
+    // context 只在界面线程中检查，工作线程结束时它可能已经销毁
+    QPointer<QObject> guard(context);
+    QThreadPool::globalInstance()->start(QRunnable::create([issues, guard, callback]() mutable {
+        symbolize(issues);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [issues, guard, callback]() {
+            if (guard) callback(issues);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+const SanitizerFrame *SanitizerReport::firstUserFrame(const SanitizerIssue &issue)
+{
+    for (const SanitizerStack &stack : issue.stacks) {
+        for (const SanitizerFrame &frame : stack.frames) {
+            if (Symbolizer::isUserSource(frame.file)) {
+                return &frame;
+            }
+        }
+    }
+    return nullptr;
+}
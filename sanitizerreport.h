@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QProcessEnvironment>
+#include <functional>
+
+class QObject;
+
+enum class SanitizerKind
+{
+    Address,
+    Undefined,
+    Thread,
+    Leak
+};
+
+// 报告中的一帧调用栈
+struct SanitizerFrame
+{
+    int index = 0;
+    QString address;
+    QString function;
+    QString file;
+    int line = 0;
+    int column = 0;
+    QString module;
+    quint64 moduleOffset = 0;
+};
+
+// 一段调用栈，例如 "READ of size 4 ..." 或 "previously allocated by thread T0 here:"
+struct SanitizerStack
+{
+    QString title;
+    QList<SanitizerFrame> frames;
+};
+
+// 一条检测器报告
+struct SanitizerIssue
+{
+    QString tool;       // AddressSanitizer / ThreadSanitizer ...
+    QString kind;       // heap-buffer-overflow / data race ...
+    QString message;    // 报告首行
+    QString summary;    // SUMMARY 行
+    QString file;       // UBSan 直接给出的出错位置
+    int line = 0;
+    int column = 0;
+    QList<SanitizerStack> stacks;
+};
+
+class SanitizerReport
+{
+public:
+    static QString displayName(SanitizerKind kind);
+    static QString profileName(SanitizerKind kind);
+    static QStringList compileFlags(SanitizerKind kind);
+    static void setupEnvironment(SanitizerKind kind, QProcessEnvironment &environment);
+
+    // 解析 stderr 中的检测器输出，baseDir 用于解析相对路径
+    static QList<SanitizerIssue> parse(const QString &text, const QString &baseDir = QString());
+    // 为缺少源码位置的帧补全符号信息。需要等待 addr2line，不要在界面线程中调用
+    static void symbolize(QList<SanitizerIssue> &issues);
+    // 在工作线程中补全符号信息，完成后在界面线程回调；context 销毁后不再回调
+    static void symbolizeAsync(const QList<SanitizerIssue> &issues, QObject *context,
+                               const std::function<void(const QList<SanitizerIssue> &issues)> &callback);
+    // 报告中第一个位于用户代码的帧
+    static const SanitizerFrame *firstUserFrame(const SanitizerIssue &issue);
+};
@@ -0,0 +1,270 @@
+#include "scalingpanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSettings>
+#include <QThread>
+
+namespace {
+// 至少两个线程数才能拟合
+const int MinPointsForFit = 2;
+}
+
+ScalingPanel::ScalingPanel(QWidget *parent)
+    : QWidget(parent)
+    , scaler(new ThreadScaler(this))
+    , building(false)
+{
+    QSettings settings("LionCPP", "IDE");
+    variableName = settings.value("scaling/variable", "OMP_NUM_THREADS").toString();
+    argumentTemplate = settings.value("scaling/arguments", "{threads}").toString();
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *threadLayout = new QHBoxLayout();
+    controlCombo = new QComboBox(this);
+    controlCombo->addItem("环境变量", static_cast<int>(ThreadScaler::ThreadControl::EnvironmentVariable));
+    controlCombo->addItem("命令行参数", static_cast<int>(ThreadScaler::ThreadControl::Argument));
+    controlEdit = new QLineEdit(this);
+    flagsEdit = new QLineEdit(settings.value("scaling/flags", "-fopenmp -pthread").toString(), this);
+    flagsEdit->setToolTip("额外的编译参数，使用 OpenMP 时需要 -fopenmp");
+    threadLayout->addWidget(new QLabel("线程数通过:", this));
+    threadLayout->addWidget(controlCombo);
+    threadLayout->addWidget(controlEdit, 1);
+    threadLayout->addWidget(new QLabel("编译参数:", this));
+    threadLayout->addWidget(flagsEdit, 1);
+    layout->addLayout(threadLayout);
+
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+    inputEdit = new QLineEdit(settings.value("scaling/input").toString(), this);
+    inputEdit->setPlaceholderText("输入文件（可选）");
+    QPushButton *browseButton = new QPushButton("浏览...", this);
+    maxThreadsSpinBox = new QSpinBox(this);
+    maxThreadsSpinBox->setRange(1, 1024);
+    maxThreadsSpinBox->setValue(settings.value("scaling/maxThreads", QThread::idealThreadCount()).toInt());
+    repetitionsSpinBox = new QSpinBox(this);
+    repetitionsSpinBox->setRange(1, 100);
+    repetitionsSpinBox->setValue(settings.value("scaling/repetitions", 3).toInt());
+    pinCheck = new QCheckBox("绑定核心", this);
+    pinCheck->setToolTip("n 个线程时只允许程序运行在前 n 个 CPU 上，并设置 OMP_PROC_BIND/OMP_PLACES");
+    pinCheck->setChecked(settings.value("scaling/pin", true).toBool());
+    startButton = new QPushButton("开始测试", this);
+
+    controlLayout->addWidget(inputEdit, 1);
+    controlLayout->addWidget(browseButton);
+    controlLayout->addWidget(new QLabel("最多线程:", this));
+    controlLayout->addWidget(maxThreadsSpinBox);
+    controlLayout->addWidget(new QLabel("重复:", this));
+    controlLayout->addWidget(repetitionsSpinBox);
+    controlLayout->addWidget(pinCheck);
+    controlLayout->addWidget(startButton);
+    layout->addLayout(controlLayout);
+
+    statusLabel = new QLabel(this);
+    resultLabel = new QLabel(this);
+    resultLabel->setTextFormat(Qt::RichText);
+    resultLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(statusLabel);
+    layout->addWidget(resultLabel);
+    conditionsLabel = new QLabel(this);
+    layout->addWidget(conditionsLabel);
+
+    QHBoxLayout *plotLayout = new QHBoxLayout();
+    speedupPlot = new PlotWidget(this);
+    speedupPlot->setAxisLabels("线程数", "加速比");
+    efficiencyPlot = new PlotWidget(this);
+    efficiencyPlot->setAxisLabels("线程数", "并行效率");
+    plotLayout->addWidget(speedupPlot);
+    plotLayout->addWidget(efficiencyPlot);
+    layout->addLayout(plotLayout, 1);
+
+    controlCombo->setCurrentIndex(settings.value("scaling/control", 0).toInt());
+    onControlChanged(controlCombo->currentIndex());
+
+    connect(controlCombo, &QComboBox::currentIndexChanged, this, &ScalingPanel::onControlChanged);
+    connect(controlEdit, &QLineEdit::textEdited, this, [this](const QString &text) {
+        if (controlCombo->currentIndex() == 0) {
+            variableName = text;
+        } else {
+            argumentTemplate = text;
+        }
+    });
+    connect(browseButton, &QPushButton::clicked, this, [this]() {
+        QString filePath = QFileDialog::getOpenFileName(this, "选择输入文件", QFileInfo(inputEdit->text()).absolutePath());
+        if (!filePath.isEmpty()) inputEdit->setText(filePath);
+    });
+    connect(startButton, &QPushButton::clicked, this, [this]() {
+        if (scaler->isRunning()) {
+            stop();
+            return;
+        }
+        saveOptions();
+        emit startRequested();
+    });
+
+    connect(scaler, &ThreadScaler::stageChanged, statusLabel, &QLabel::setText);
+    connect(scaler, &ThreadScaler::pointMeasured, this, &ScalingPanel::onPointMeasured);
+    connect(scaler, &ThreadScaler::failed, this, &ScalingPanel::onFailed);
+    connect(scaler, &ThreadScaler::finished, this, &ScalingPanel::onFinished);
+
+    updateButtons();
+}
+
+void ScalingPanel::onControlChanged(int index)
+{
+    if (index == 0) {
+        controlEdit->setText(variableName);
+        controlEdit->setToolTip("环境变量名，值为线程数");
+    } else {
+        controlEdit->setText(argumentTemplate);
+        controlEdit->setToolTip("命令行参数，{threads} 会被替换为线程数，例如 -t {threads}");
+    }
+}
+
+void ScalingPanel::saveOptions()
+{
+    QSettings settings("LionCPP", "IDE");
+    settings.setValue("scaling/control", controlCombo->currentIndex());
+    settings.setValue("scaling/variable", variableName);
+    settings.setValue("scaling/arguments", argumentTemplate);
+    settings.setValue("scaling/flags", flagsEdit->text());
+    settings.setValue("scaling/input", inputEdit->text());
+    settings.setValue("scaling/maxThreads", maxThreadsSpinBox->value());
+    settings.setValue("scaling/repetitions", repetitionsSpinBox->value());
+    settings.setValue("scaling/pin", pinCheck->isChecked());
+}
+
+QStringList ScalingPanel::compileFlags() const
+{
+    return QProcess::splitCommand(flagsEdit->text());
+}
+
+void ScalingPanel::setBuilding(bool value)
+{
+    building = value;
+    statusLabel->setText(building ? "正在编译..." : QString());
+    updateButtons();
+}
+
+void ScalingPanel::updateButtons()
+{
+    startButton->setText(scaler->isRunning() ? "停止" : "开始测试");
+    startButton->setEnabled(!building);
+}
+
+void ScalingPanel::startSweep(const QString &executable, const QString &workingDirectory)
+{
+    ThreadScaler::Config config;
+    config.executable = executable;
+    config.workingDirectory = workingDirectory;
+    config.inputFile = inputEdit->text();
+    config.control = static_cast<ThreadScaler::ThreadControl>(controlCombo->currentData().toInt());
+    config.variableName = variableName;
+    config.argumentTemplate = argumentTemplate;
+    config.maxThreads = maxThreadsSpinBox->value();
+    config.repetitions = repetitionsSpinBox->value();
+    config.pinThreads = pinCheck->isChecked();
+    config.conditions = MeasurementEnvironment::check();
+
+    if (!config.inputFile.isEmpty() && !QFileInfo::exists(config.inputFile)) {
+        statusLabel->setText("输入文件不存在: " + config.inputFile);
+        return;
+    }
+
+    points.clear();
+    speedupPlot->clear();
+    efficiencyPlot->clear();
+    resultLabel->clear();
+    conditionsLabel->setText("测量条件：" + MeasurementEnvironment::summary(config.conditions));
+    conditionsLabel->setStyleSheet(config.conditions.warnings.isEmpty() ? QString() : "color: #d7ba7d;");
+    conditionsLabel->setToolTip(config.conditions.warnings.join('\n'));
+    scaler->start(config);
+    updateButtons();
+}
+
+void ScalingPanel::stop()
+{
+    scaler->stop();
+}
+
+void ScalingPanel::onPointMeasured(const ThreadScaler::Point &point)
+{
+    points.append(point);
+    updatePlots();
+}
+
+void ScalingPanel::updatePlots()
+{
+    PlotWidget::Series measuredSpeedup;
+    measuredSpeedup.name = "实测";
+    measuredSpeedup.color = QColor("#569cd6");
+    PlotWidget::Series measuredEfficiency = measuredSpeedup;
+    PlotWidget::Series ideal;
+    ideal.name = "线性";
+    ideal.color = QColor("#808080");
+    ideal.showPoints = false;
+    ideal.penStyle = Qt::DotLine;
+
+    for (const ThreadScaler::Point &point : std::as_const(points)) {
+        measuredSpeedup.points.append(QPointF(point.threads, point.speedup));
+        measuredEfficiency.points.append(QPointF(point.threads, point.efficiency));
+        ideal.points.append(QPointF(point.threads, point.threads));
+    }
+
+    QList<PlotWidget::Series> speedupSeries = {measuredSpeedup, ideal};
+    QList<PlotWidget::Series> efficiencySeries = {measuredEfficiency};
+
+    if (points.size() >= MinPointsForFit) {
+        double serialFraction = ThreadScaler::fitSerialFraction(points);
+        PlotWidget::Series amdahlSpeedup;
+        amdahlSpeedup.name = QString("Amdahl (串行 %1%)").arg(serialFraction * 100, 0, 'f', 1);
+        amdahlSpeedup.color = QColor("#4ec9b0");
+        amdahlSpeedup.showPoints = false;
+        amdahlSpeedup.penStyle = Qt::DashLine;
+        PlotWidget::Series amdahlEfficiency = amdahlSpeedup;
+        for (const ThreadScaler::Point &point : std::as_const(points)) {
+            double speedup = ThreadScaler::amdahlSpeedup(serialFraction, point.threads);
+            amdahlSpeedup.points.append(QPointF(point.threads, speedup));
+            amdahlEfficiency.points.append(QPointF(point.threads, speedup / point.threads));
+        }
+        speedupSeries.append(amdahlSpeedup);
+        efficiencySeries.append(amdahlEfficiency);
+
+        const ThreadScaler::Point &last = points.last();
+        QString summary = QString("%1 线程：加速比 %2x，效率 %3%；Amdahl 拟合串行部分 %4%，理论上限 %5")
+                          .arg(last.threads)
+                          .arg(last.speedup, 0, 'f', 2)
+                          .arg(last.efficiency * 100, 0, 'f', 0)
+                          .arg(serialFraction * 100, 0, 'f', 1)
+                          .arg(serialFraction > 0 ? QString("%1x").arg(1 / serialFraction, 0, 'f', 1) : QString("无限"));
+
+        ThreadScaler::Collapse collapse = ThreadScaler::findCollapse(points);
+        if (collapse.threads > 0) {
+            speedupPlot->setMarker(collapse.threads, "扩展性崩溃");
+            efficiencyPlot->setMarker(collapse.threads, "扩展性崩溃");
+            summary += QString("<br><span style=\"color:#f44747\">%1</span>").arg(collapse.reason.toHtmlEscaped());
+        } else {
+            speedupPlot->clearMarker();
+            efficiencyPlot->clearMarker();
+        }
+        resultLabel->setText(summary);
+    }
+
+    speedupPlot->setSeries(speedupSeries);
+    efficiencyPlot->setSeries(efficiencySeries);
+}
+
+void ScalingPanel::onFailed(const QString &message)
+{
+    statusLabel->setText(message.trimmed());
+    updateButtons();
+}
+
+void ScalingPanel::onFinished(bool cancelled)
+{
+    statusLabel->setText(cancelled ? "已停止" : QString("测试完成，共 %1 个线程数").arg(points.size()));
+    updateButtons();
+}
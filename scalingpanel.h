@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QLabel>
+
+#include "threadscaler.h"
+#include "plotwidget.h"
+
+// 线程扩展性窗口
+// 当前文件由主窗口通过构建缓存编译，左图为加速比，右图为并行效率，
+// 都与 Amdahl 定律的拟合曲线对比
+class ScalingPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ScalingPanel(QWidget *parent = nullptr);
+
+    QStringList compileFlags() const;
+    void startSweep(const QString &executable, const QString &workingDirectory);
+    void stop();
+    bool isRunning() const { return scaler->isRunning(); }
+    void setBuilding(bool building);
+
+signals:
+    void startRequested();
+
+private slots:
+    void onControlChanged(int index);
+    void onPointMeasured(const ThreadScaler::Point &point);
+    void onFailed(const QString &message);
+    void onFinished(bool cancelled);
+
+private:
+    void saveOptions();
+    void updatePlots();
+    void updateButtons();
+
+    ThreadScaler *scaler;
+    QComboBox *controlCombo;
+    QLineEdit *controlEdit;
+    QLineEdit *flagsEdit;
+    QLineEdit *inputEdit;
+    QSpinBox *maxThreadsSpinBox;
+    QSpinBox *repetitionsSpinBox;
+    QCheckBox *pinCheck;
+    QPushButton *startButton;
+    QLabel *statusLabel;
+    QLabel *resultLabel;
+    QLabel *conditionsLabel;
+    PlotWidget *speedupPlot;
+    PlotWidget *efficiencyPlot;
+    QList<ThreadScaler::Point> points;
+    QString variableName;
+    QString argumentTemplate;
+    bool building;
+};
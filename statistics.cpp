@@ -0,0 +1,108 @@
+#include "statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+double Statistics::mean(const QList<double> &values)
+{
+    if (values.isEmpty()) return 0;
+    double sum = 0;
+    for (double value : values) sum += value;
+    return sum / values.size();
+}
+
+double Statistics::median(QList<double> values)
+{
+    return percentile(std::move(values), 0.5);
+}
+
+double Statistics::percentile(QList<double> values, double p)
+{
+    if (values.isEmpty()) return 0;
+    std::sort(values.begin(), values.end());
+    double position = std::clamp(p, 0.0, 1.0) * (values.size() - 1);
+    int lower = static_cast<int>(std::floor(position));
+    int upper = static_cast<int>(std::ceil(position));
+    double fraction = position - lower;
+    return values[lower] + (values[upper] - values[lower]) * fraction;
+}
+
+double Statistics::standardDeviation(const QList<double> &values)
+{
+    if (values.size() < 2) return 0;
+    double average = mean(values);
+    double sum = 0;
+    for (double value : values) sum += (value - average) * (value - average);
+    return std::sqrt(sum / (values.size() - 1));
+}
+
+Statistics::MannWhitneyResult Statistics::mannWhitneyU(const QList<double> &a, const QList<double> &b)
+{
+    MannWhitneyResult result;
+    const qsizetype n1 = a.size();
+    const qsizetype n2 = b.size();
+    if (n1 == 0 || n2 == 0) return result;
+
+    // 合并后排序，相同值取平均秩
+    std::vector<std::pair<double, int>> combined;
+    combined.reserve(n1 + n2);
+    for (double value : a) combined.emplace_back(value, 0);
+    for (double value : b) combined.emplace_back(value, 1);
+    std::sort(combined.begin(), combined.end(),
+              [](const auto &x, const auto &y) { return x.first < y.first; });
+
+    const double n = static_cast<double>(combined.size());
+    double rankSumA = 0;
+    double tieTerm = 0;
+    for (size_t i = 0; i < combined.size();) {
+        size_t j = i;
+        while (j < combined.size() && combined[j].first == combined[i].first) ++j;
+        double averageRank = (i + 1 + j) / 2.0;
+        double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        for (size_t k = i; k < j; ++k) {
+            if (combined[k].second == 0) rankSumA += averageRank;
+        }
+        i = j;
+    }
+
+    result.u = rankSumA - n1 * (n1 + 1) / 2.0;
+    double meanU = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0) return result;       // 所有值都相同
+
+    double difference = result.u - meanU;
+    double correction = difference > 0 ? -0.5 : (difference < 0 ? 0.5 : 0);
+    result.z = (difference + correction) / std::sqrt(variance);
+    result.pValue = std::min(1.0, std::erfc(std::fabs(result.z) / std::sqrt(2.0)));
+    return result;
+}
+
+Statistics::Interval Statistics::bootstrapMedianRatio(const QList<double> &a, const QList<double> &b,
+                                                      double confidence, int resamples, unsigned int seed)
+{
+    Interval interval;
+    if (a.isEmpty() || b.isEmpty() || resamples <= 0) return interval;
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<qsizetype> pickA(0, a.size() - 1);
+    std::uniform_int_distribution<qsizetype> pickB(0, b.size() - 1);
+
+    QList<double> ratios;
+    ratios.reserve(resamples);
+    QList<double> sampleA(a.size());
+    QList<double> sampleB(b.size());
+    for (int r = 0; r < resamples; ++r) {
+        for (double &value : sampleA) value = a[pickA(generator)];
+        for (double &value : sampleB) value = b[pickB(generator)];
+        double denominator = median(sampleB);
+        if (denominator > 0) ratios.append(median(sampleA) / denominator);
+    }
+    if (ratios.isEmpty()) return interval;
+
+    double alpha = (1 - confidence) / 2;
+    interval.low = percentile(ratios, alpha);
+    interval.high = percentile(ratios, 1 - alpha);
+    return interval;
+}
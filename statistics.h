@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QList>
+
+// 性能测量用的统计工具
+// 运行时间的分布通常偏斜且带有离群值，因此比较时使用中位数、
+// 秩和检验（Mann–Whitney U）和自助法置信区间，而不依赖正态假设。
+class Statistics
+{
+public:
+    struct MannWhitneyResult
+    {
+        double u = 0;
+        double z = 0;
+        double pValue = 1;      // 双侧检验
+    };
+
+    struct Interval
+    {
+        double low = 0;
+        double high = 0;
+    };
+
+    static double mean(const QList<double> &values);
+    static double median(QList<double> values);
+    // p 取 0~1，线性插值
+    static double percentile(QList<double> values, double p);
+    static double standardDeviation(const QList<double> &values);
+
+    // 正态近似，包含结的修正和连续性修正
+    static MannWhitneyResult mannWhitneyU(const QList<double> &a, const QList<double> &b);
+    // median(a) / median(b) 的百分位自助法置信区间
+    static Interval bootstrapMedianRatio(const QList<double> &a, const QList<double> &b,
+                                         double confidence = 0.95, int resamples = 2000,
+                                         unsigned int seed = 1);
+};
@@ -0,0 +1,226 @@
+#include "stresspanel.h"
+#include "textdiff.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFile>
+#include <QSettings>
+#include <QTextCursor>
+#include <QTextCharFormat>
+#include <QFontDatabase>
+
+namespace {
+// 差异视图只读取文件开头的部分，输出很大时也不会卡住界面
+const qint64 MaxDiffBytes = 1024 * 1024;
+}
+
+StressPanel::StressPanel(QWidget *parent)
+    : QWidget(parent)
+    , tester(new StressTester(this))
+    , building(false)
+{
+    QSettings settings("LionCPP", "IDE");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QGridLayout *sourceLayout = new QGridLayout();
+    generatorEdit = createSourceRow(sourceLayout, 0, "生成器:", "stress/generator");
+    bruteEdit = createSourceRow(sourceLayout, 1, "标准程序:", "stress/brute");
+    solutionEdit = createSourceRow(sourceLayout, 2, "待测程序:", QString());
+    generatorEdit->setToolTip("生成器通过命令行第一个参数接收随机种子，并把输入数据写到标准输出");
+    layout->addLayout(sourceLayout);
+
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+    iterationsSpinBox = new QSpinBox(this);
+    iterationsSpinBox->setRange(1, 10000000);
+    iterationsSpinBox->setValue(settings.value("stress/iterations", 10000).toInt());
+    timeLimitSpinBox = new QSpinBox(this);
+    timeLimitSpinBox->setRange(100, 60000);
+    timeLimitSpinBox->setSingleStep(100);
+    timeLimitSpinBox->setSuffix(" ms");
+    timeLimitSpinBox->setValue(settings.value("stress/timeLimitMs", 2000).toInt());
+    startButton = new QPushButton("开始对拍", this);
+    statusLabel = new QLabel(this);
+
+    controlLayout->addWidget(new QLabel("组数:", this));
+    controlLayout->addWidget(iterationsSpinBox);
+    controlLayout->addWidget(new QLabel("时间限制:", this));
+    controlLayout->addWidget(timeLimitSpinBox);
+    controlLayout->addWidget(startButton);
+    controlLayout->addWidget(statusLabel, 1);
+    layout->addLayout(controlLayout);
+
+    diffView = new QPlainTextEdit(this);
+    diffView->setReadOnly(true);
+    diffView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    diffView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(diffView, 1);
+
+    connect(startButton, &QPushButton::clicked, this, [this]() {
+        if (tester->isRunning()) {
+            stop();
+            return;
+        }
+        QSettings settings("LionCPP", "IDE");
+        settings.setValue("stress/generator", generatorEdit->text());
+        settings.setValue("stress/brute", bruteEdit->text());
+        settings.setValue("stress/iterations", iterationsSpinBox->value());
+        settings.setValue("stress/timeLimitMs", timeLimitSpinBox->value());
+        emit startRequested();
+    });
+
+    connect(tester, &StressTester::progress, this, &StressPanel::onProgress);
+    connect(tester, &StressTester::failureFound, this, &StressPanel::onFailureFound);
+    connect(tester, &StressTester::finished, this, &StressPanel::onFinished);
+
+    updateButtons();
+}
+
+QLineEdit *StressPanel::createSourceRow(QGridLayout *layout, int row, const QString &label, const QString &settingsKey)
+{
+    QLineEdit *edit = new QLineEdit(this);
+    if (!settingsKey.isEmpty()) {
+        edit->setText(QSettings("LionCPP", "IDE").value(settingsKey).toString());
+    }
+    QPushButton *browseButton = new QPushButton("浏览...", this);
+    connect(browseButton, &QPushButton::clicked, this, [this, edit]() {
+        QString filePath = QFileDialog::getOpenFileName(this, "选择源文件", QFileInfo(edit->text()).absolutePath(),
+                                                        "C++ Files (*.cpp *.cc *.cxx);;All Files (*)");
+        if (!filePath.isEmpty()) edit->setText(filePath);
+    });
+
+    layout->addWidget(new QLabel(label, this), row, 0);
+    layout->addWidget(edit, row, 1);
+    layout->addWidget(browseButton, row, 2);
+    return edit;
+}
+
+void StressPanel::setSolutionSource(const QString &sourcePath)
+{
+    if (!tester->isRunning() && !building) {
+        solutionEdit->setText(sourcePath);
+    }
+}
+
+void StressPanel::setBuilding(bool value)
+{
+    building = value;
+    statusLabel->setText(building ? "正在编译..." : QString());
+    updateButtons();
+}
+
+void StressPanel::updateButtons()
+{
+    startButton->setText(tester->isRunning() ? "停止" : "开始对拍");
+    startButton->setEnabled(!building);
+}
+
+void StressPanel::startTesting(const QString &generatorExecutable, const QString &bruteExecutable,
+                               const QString &solutionExecutable)
+{
+    StressTester::Config config;
+    config.generator = generatorExecutable;
+    config.brute = bruteExecutable;
+    config.solution = solutionExecutable;
+    config.workDirectory = StressTester::workDirectory(solutionEdit->text());
+    config.iterations = iterationsSpinBox->value();
+    config.timeLimitMs = timeLimitSpinBox->value();
+
+    diffView->clear();
+    if (!tester->start(config)) {
+        statusLabel->setText("无法创建工作目录: " + config.workDirectory);
+        return;
+    }
+    elapsed.start();
+    statusLabel->setText("对拍中...");
+    updateButtons();
+}
+
+void StressPanel::stop()
+{
+    tester->stop();
+}
+
+void StressPanel::onProgress(qint64 completed)
+{
+    double seconds = elapsed.elapsed() / 1000.0;
+    statusLabel->setText(QString("已通过 %1 / %2 组（%3 组/秒）")
+                         .arg(completed)
+                         .arg(iterationsSpinBox->value())
+                         .arg(seconds > 0 ? completed / seconds : 0.0, 0, 'f', 1));
+}
+
+void StressPanel::onFailureFound(const StressTester::Failure &failure)
+{
+    QString header = QString("种子 %1: %2").arg(failure.seed).arg(failure.reason);
+    diffView->setPlainText(header + "\n");
+    if (!failure.description.isEmpty()) {
+        diffView->appendPlainText(failure.description + "\n");
+    }
+    if (!failure.expectedFile.isEmpty()) {
+        showDiff(failure.expectedFile, failure.actualFile);
+    }
+    emit failureFound(failure.inputFile);
+}
+
+void StressPanel::onFinished(qint64 completed, bool failed)
+{
+    if (!failed) {
+        statusLabel->setText(QString("全部通过：%1 组").arg(completed));
+    } else {
+        statusLabel->setText(QString("在 %1 组通过后发现错误，数据已保存到 %2")
+                             .arg(completed).arg(StressTester::workDirectory(solutionEdit->text())));
+    }
+    updateButtons();
+}
+
+QStringList StressPanel::readLines(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return QStringList();
+    QString text = QString::fromUtf8(file.read(MaxDiffBytes));
+    QStringList lines = text.split('\n');
+    if (!lines.isEmpty() && lines.last().isEmpty()) lines.removeLast();
+    // 比较时忽略行尾空白，显示差异时同样处理
+    for (QString &line : lines) {
+        while (!line.isEmpty() && line.back().isSpace()) line.chop(1);
+    }
+    return lines;
+}
+
+void StressPanel::showDiff(const QString &expectedFile, const QString &actualFile)
+{
+    QList<TextDiff::Line> lines = TextDiff::withContext(TextDiff::diff(readLines(expectedFile), readLines(actualFile)));
+
+    QTextCharFormat normalFormat;
+    normalFormat.setForeground(QColor("#d4d4d4"));
+    QTextCharFormat removedFormat;
+    removedFormat.setForeground(QColor("#f44747"));
+    QTextCharFormat addedFormat;
+    addedFormat.setForeground(QColor("#4ec9b0"));
+
+    QTextCursor cursor(diffView->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText("--- 期望输出 (标准程序)\n+++ 实际输出 (待测程序)\n", normalFormat);
+
+    for (const TextDiff::Line &line : lines) {
+        switch (line.type) {
+        case TextDiff::Line::Removed:
+            cursor.insertText(QString("-%1 | %2\n").arg(line.oldLine, 5).arg(line.text), removedFormat);
+            break;
+        case TextDiff::Line::Added:
+            cursor.insertText(QString("+%1 | %2\n").arg(line.newLine, 5).arg(line.text), addedFormat);
+            break;
+        case TextDiff::Line::Equal:
+            if (line.oldLine == 0) {
+                cursor.insertText("  ...\n", normalFormat);
+            } else {
+                cursor.insertText(QString(" %1 | %2\n").arg(line.oldLine, 5).arg(line.text), normalFormat);
+            }
+            break;
+        }
+    }
+    diffView->moveCursor(QTextCursor::Start);
+}
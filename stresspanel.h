@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QWidget>
+#include <QLineEdit>
+#include <QGridLayout>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QElapsedTimer>
+
+#include "stresstester.h"
+
+// 对拍窗口
+// 选择生成器、标准程序和待测程序的源文件，编译由主窗口通过构建缓存完成
+class StressPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StressPanel(QWidget *parent = nullptr);
+
+    QString generatorSource() const { return generatorEdit->text(); }
+    QString bruteSource() const { return bruteEdit->text(); }
+    QString solutionSource() const { return solutionEdit->text(); }
+    void setSolutionSource(const QString &sourcePath);
+
+    void startTesting(const QString &generatorExecutable, const QString &bruteExecutable,
+                      const QString &solutionExecutable);
+    void stop();
+    bool isRunning() const { return tester->isRunning(); }
+    void setBuilding(bool building);
+
+signals:
+    void startRequested();
+    void failureFound(const QString &inputFile);
+
+private slots:
+    void onProgress(qint64 completed);
+    void onFailureFound(const StressTester::Failure &failure);
+    void onFinished(qint64 completed, bool failed);
+
+private:
+    QLineEdit *createSourceRow(QGridLayout *layout, int row, const QString &label, const QString &settingsKey);
+    void showDiff(const QString &expectedFile, const QString &actualFile);
+    void updateButtons();
+    static QStringList readLines(const QString &filePath);
+
+    StressTester *tester;
+    QLineEdit *generatorEdit;
+    QLineEdit *bruteEdit;
+    QLineEdit *solutionEdit;
+    QSpinBox *iterationsSpinBox;
+    QSpinBox *timeLimitSpinBox;
+    QPushButton *startButton;
+    QLabel *statusLabel;
+    QPlainTextEdit *diffView;
+    QElapsedTimer elapsed;
+    bool building;
+};
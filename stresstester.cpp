@@ -0,0 +1,194 @@
+#include "stresstester.h"
+#include "processrunner.h"
+#include "outputcomparator.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+
+StressTester::StressTester(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , progressTimer(new QTimer(this))
+    , running(false)
+    , activeWorkers(0)
+{
+    pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+
+    // 进度只在界面线程定时读取计数器，工作线程不为每组数据发送事件
+    progressTimer->setInterval(200);
+    connect(progressTimer, &QTimer::timeout, this, [this]() {
+        if (state) emit progress(state->completed.load());
+    });
+}
+
+StressTester::~StressTester()
+{
+    if (state) state->stopRequested = true;
+    pool->waitForDone();
+}
+
+QString StressTester::workDirectory(const QString &solutionSource)
+{
+    QFileInfo sourceInfo(solutionSource);
+    return sourceInfo.absolutePath() + "/" + sourceInfo.completeBaseName() + ".stress";
+}
+
+bool StressTester::start(const Config &config)
+{
+    if (running) return false;
+    if (!QDir().mkpath(config.workDirectory)) return false;
+
+    state = std::make_shared<State>();
+    running = true;
+    activeWorkers = pool->maxThreadCount();
+
+    for (int worker = 0; worker < activeWorkers; ++worker) {
+        std::shared_ptr<State> workerState = state;
+        pool->start(QRunnable::create([this, worker, config, workerState]() {
+            runWorker(worker, config, workerState);
+            QMetaObject::invokeMethod(this, [this]() { onWorkerFinished(); }, Qt::QueuedConnection);
+        }));
+    }
+
+    progressTimer->start();
+    return true;
+}
+
+void StressTester::stop()
+{
+    if (state) state->stopRequested = true;
+}
+
+void StressTester::onWorkerFinished()
+{
+    if (--activeWorkers > 0) return;
+
+    running = false;
+    progressTimer->stop();
+    emit progress(state->completed.load());
+    emit finished(state->completed.load(), state->failed.load());
+}
+
+void StressTester::runWorker(int worker, const Config &config, const std::shared_ptr<State> &runState)
+{
+    // 每个工作线程使用自己的一组临时文件
+    QDir dir(config.workDirectory);
+    const QString inputFile = dir.filePath(QString("worker%1.in").arg(worker));
+    const QString expectedFile = dir.filePath(QString("worker%1.ans").arg(worker));
+
+    while (!runState->stopRequested) {
+        const qint64 seed = runState->nextSeed.fetch_add(1);
+        if (seed > config.iterations) break;
+
+        ProcessRunner::Spec generator;
+        generator.program = config.generator;
+        generator.arguments << QString::number(seed);
+        generator.workingDirectory = config.workDirectory;
+        generator.stdoutFile = inputFile;
+        generator.wallTimeLimitMs = config.timeLimitMs;
+        generator.cancelFlag = &runState->stopRequested;
+
+        ProcessRunner::Result result = ProcessRunner::run(generator);
+        if (result.cancelled) break;
+        if (!result.started || result.crashed() || result.wallTimeExceeded) {
+            reportFailure(config, runState, seed, "生成器运行失败", inputFile, QString(),
+                          result.started ? QString::fromUtf8(result.stderrOutput).trimmed() : result.error);
+            break;
+        }
+
+        ProcessRunner::Spec brute;
+        brute.program = config.brute;
+        brute.workingDirectory = config.workDirectory;
+        brute.stdinFile = inputFile;
+        brute.stdoutFile = expectedFile;
+        brute.wallTimeLimitMs = config.timeLimitMs;
+        brute.cancelFlag = &runState->stopRequested;
+
+        result = ProcessRunner::run(brute);
+        if (result.cancelled) break;
+        if (!result.started || result.crashed() || result.wallTimeExceeded) {
+            reportFailure(config, runState, seed, result.wallTimeExceeded ? "标准程序超时" : "标准程序运行失败",
+                          inputFile, QString(),
+                          result.started ? QString::fromUtf8(result.stderrOutput).trimmed() : result.error);
+            break;
+        }
+
+        // 待测程序的输出边读边与标准输出比较
+        OutputComparator comparator(expectedFile);
+        ProcessRunner::Spec solution;
+        solution.program = config.solution;
+        solution.workingDirectory = config.workDirectory;
+        solution.stdinFile = inputFile;
+        solution.stdoutSink = [&comparator](const char *data, qint64 size) {
+            return comparator.feed(data, size);
+        };
+        solution.cpuTimeLimit = config.timeLimitMs / 1000.0;
+        solution.wallTimeLimitMs = config.timeLimitMs * 2 + 1000;
+        solution.cancelFlag = &runState->stopRequested;
+
+        result = ProcessRunner::run(solution);
+        if (result.cancelled) break;
+        if (!result.started) {
+            reportFailure(config, runState, seed, "待测程序运行失败", inputFile, expectedFile, result.error);
+            break;
+        }
+        if (result.cpuTimeExceeded || result.wallTimeExceeded) {
+            reportFailure(config, runState, seed, "待测程序超时", inputFile, expectedFile, QString());
+            break;
+        }
+        if (!result.stoppedBySink && result.crashed()) {
+            QString description = result.signal != 0 ? QString("被信号 %1 终止").arg(result.signal)
+                                                     : QString("返回值 %1").arg(result.exitCode);
+            QString errors = QString::fromUtf8(result.stderrOutput).trimmed();
+            if (!errors.isEmpty()) description += "\n" + errors;
+            reportFailure(config, runState, seed, "待测程序运行错误", inputFile, expectedFile, description);
+            break;
+        }
+        if (result.stoppedBySink || !comparator.finish()) {
+            reportFailure(config, runState, seed, "输出不一致", inputFile, expectedFile,
+                          comparator.mismatchDescription());
+            break;
+        }
+
+        ++runState->completed;
+    }
+}
+
+void StressTester::reportFailure(const Config &config, const std::shared_ptr<State> &runState, qint64 seed,
+                                 const QString &reason, const QString &inputFile, const QString &expectedFile,
+                                 const QString &description)
+{
+    // 只保留第一组失败数据，其余工作线程随之停止
+    if (runState->failed.exchange(true)) return;
+    runState->stopRequested = true;
+
+    QDir dir(config.workDirectory);
+    Failure failure;
+    failure.seed = seed;
+    failure.reason = reason;
+    failure.description = description;
+    failure.inputFile = dir.filePath("failing.in");
+    QFile::remove(failure.inputFile);
+    QFile::copy(inputFile, failure.inputFile);
+
+    if (!expectedFile.isEmpty()) {
+        failure.expectedFile = dir.filePath("failing.ans");
+        QFile::remove(failure.expectedFile);
+        QFile::copy(expectedFile, failure.expectedFile);
+
+        // 比较时没有保存待测程序的输出，这里重新运行一次写入文件用于显示差异
+        failure.actualFile = dir.filePath("failing.out");
+        ProcessRunner::Spec solution;
+        solution.program = config.solution;
+        solution.workingDirectory = config.workDirectory;
+        solution.stdinFile = failure.inputFile;
+        solution.stdoutFile = failure.actualFile;
+        solution.cpuTimeLimit = config.timeLimitMs / 1000.0;
+        solution.wallTimeLimitMs = config.timeLimitMs * 2 + 1000;
+        ProcessRunner::run(solution);
+    }
+
+    QMetaObject::invokeMethod(this, [this, failure]() { emit failureFound(failure); }, Qt::QueuedConnection);
+}
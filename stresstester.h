@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+
+// 对拍器
+// 生成器以随机种子（命令行第一个参数）生成输入，分别交给标准程序和
+// 待测程序运行并比较输出。每个核心一个工作线程循环运行，发现第一组
+// 不一致（或运行错误、超时）后全部停止，并把这组数据保存下来。
+class StressTester : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        QString generator;
+        QString brute;
+        QString solution;
+        QString workDirectory;
+        qint64 iterations = 10000;
+        qint64 timeLimitMs = 2000;
+    };
+
+    struct Failure
+    {
+        qint64 seed = 0;
+        QString reason;
+        QString inputFile;
+        QString expectedFile;
+        QString actualFile;
+        QString description;
+    };
+
+    explicit StressTester(QObject *parent = nullptr);
+    ~StressTester();
+
+    bool start(const Config &config);
+    void stop();
+    bool isRunning() const { return running; }
+
+    static QString workDirectory(const QString &solutionSource);
+
+signals:
+    void progress(qint64 completed);
+    void failureFound(const StressTester::Failure &failure);
+    void finished(qint64 completed, bool failed);
+
+private:
+    struct State
+    {
+        std::atomic<qint64> nextSeed{1};
+        std::atomic<qint64> completed{0};
+        std::atomic<bool> stopRequested{false};
+        std::atomic<bool> failed{false};
+    };
+
+    void runWorker(int worker, const Config &config, const std::shared_ptr<State> &runState);
+    void reportFailure(const Config &config, const std::shared_ptr<State> &runState, qint64 seed,
+                       const QString &reason, const QString &inputFile, const QString &expectedFile,
+                       const QString &description);
+    void onWorkerFinished();
+
+    QThreadPool *pool;
+    QTimer *progressTimer;
+    std::shared_ptr<State> state;
+    bool running;
+    int activeWorkers;
+};
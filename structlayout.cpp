@@ -0,0 +1,666 @@
+#include "structlayout.h"
+#include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace {
+// readelf 输出中的一个调试信息条目（DIE），只保留布局分析用到的属性
+struct Die
+{
+    QString tag;
+    QString name;
+    quint64 parent = 0;
+    quint64 type = 0;
+    quint64 byteSize = 0;
+    bool hasByteSize = false;
+    quint64 alignment = 0;
+    quint64 memberLocation = 0;
+    bool hasMemberLocation = false;
+    int bitSize = 0;
+    quint64 dataBitOffset = 0;
+    bool hasDataBitOffset = false;
+    quint64 legacyBitOffset = 0;    // DWARF 2/3 的 DW_AT_bit_offset，从存储单元最高位算起
+    bool hasLegacyBitOffset = false;
+    qint64 count = -1;              // 数组维度的元素个数
+    int encoding = 0;
+    int declFile = 0;
+    int declLine = 0;
+    bool declaration = false;
+    bool artificial = false;
+    bool external = false;
+    quint64 address = 0;            // 有固定地址的变量（DW_OP_addr）
+    bool hasAddress = false;
+    quint64 specification = 0;      // 类外定义的静态成员指向类内的声明
+    QString compDirectory;          // 编译单元的编译目录
+    quint64 lineTable = 0;          // 编译单元在 .debug_line 中的偏移（DW_AT_stmt_list）
+    bool hasLineTable = false;
+    QList<quint64> children;
+};
+
+using DieTable = QHash<quint64, Die>;
+
+// 一个编译单元行号表头中的目录表和文件表
+struct LineTable
+{
+    QHash<int, QString> directories;
+    QHash<int, QPair<int, QString>> files;     // 文件号 -> （目录号，文件名）
+};
+
+const Die &dieAt(const DieTable &dies, quint64 offset)
+{
+    static const Die missing;
+    auto it = dies.constFind(offset);
+    return it == dies.constEnd() ? missing : it.value();
+}
+
+// 类型链太深时停止（异常数据下的保护）
+const int MaxTypeDepth = 32;
+// DW_ATE_complex_float
+const int ComplexEncoding = 3;
+
+quint64 parseNumber(const QString &value, bool *ok = nullptr)
+{
+    static const QRegularExpression numberPattern(QStringLiteral("^(0x[0-9a-fA-F]+|\\d+)"));
+    QRegularExpressionMatch match = numberPattern.match(value);
+    if (!match.hasMatch()) {
+        if (ok) *ok = false;
+        return 0;
+    }
+    QString text = match.captured(1);
+    return text.startsWith("0x") ? text.mid(2).toULongLong(ok, 16) : text.toULongLong(ok);
+}
+
+bool isQualifier(const QString &tag)
+{
+    return tag == "DW_TAG_typedef" || tag == "DW_TAG_const_type" || tag == "DW_TAG_volatile_type"
+        || tag == "DW_TAG_restrict_type" || tag == "DW_TAG_atomic_type";
+}
+
+bool isRecord(const QString &tag)
+{
+    return tag == "DW_TAG_structure_type" || tag == "DW_TAG_class_type" || tag == "DW_TAG_union_type";
+}
+
+// 占用实例空间的成员：排除 DWARF 4 中以 DW_TAG_member 表示的静态成员
+bool isDataMember(const Die &die)
+{
+    if (die.tag == "DW_TAG_inheritance") return die.hasMemberLocation;
+    return die.tag == "DW_TAG_member" && !die.external && !die.declaration;
+}
+
+quint64 typeSize(const DieTable &dies, quint64 offset, int depth = 0)
+{
+    auto it = dies.constFind(offset);
+    if (it == dies.constEnd() || depth > MaxTypeDepth) return 0;
+    const Die &die = it.value();
+    if (die.hasByteSize) return die.byteSize;
+    if (isQualifier(die.tag)) return typeSize(dies, die.type, depth + 1);
+    if (die.tag == "DW_TAG_array_type") {
+        quint64 total = typeSize(dies, die.type, depth + 1);
+        for (quint64 child : die.children) {
+            const Die &range = dieAt(dies, child);
+            if (range.tag == "DW_TAG_subrange_type") total *= range.count > 0 ? quint64(range.count) : 0;
+        }
+        return total;
+    }
+    if (die.tag == "DW_TAG_ptr_to_member_type") {
+        // 成员函数指针是两个字
+        auto target = dies.constFind(die.type);
+        return target != dies.constEnd() && target->tag == "DW_TAG_subroutine_type" ? 16 : 8;
+    }
+    return 0;
+}
+
+quint64 typeAlignment(const DieTable &dies, quint64 offset, int depth = 0)
+{
+    auto it = dies.constFind(offset);
+    if (it == dies.constEnd() || depth > MaxTypeDepth) return 1;
+    const Die &die = it.value();
+    if (die.alignment > 0) return die.alignment;
+    if (isQualifier(die.tag) || die.tag == "DW_TAG_array_type") return typeAlignment(dies, die.type, depth + 1);
+    if (isRecord(die.tag)) {
+        quint64 alignment = 1;
+        for (quint64 child : die.children) {
+            const Die &member = dieAt(dies, child);
+            if (!isDataMember(member)) continue;
+            quint64 memberAlignment = member.alignment > 0 ? member.alignment
+                                                           : typeAlignment(dies, member.type, depth + 1);
+            alignment = qMax(alignment, memberAlignment);
+        }
+        return alignment;
+    }
+    // 标量按自身大小对齐，复数按分量对齐
+    quint64 size = typeSize(dies, offset, depth);
+    if (die.tag == "DW_TAG_base_type" && die.encoding == ComplexEncoding) size /= 2;
+    return qBound<quint64>(1, size, 16);
+}
+
+QString typeName(const DieTable &dies, quint64 offset, int depth = 0)
+{
+    if (offset == 0) return "void";
+    auto it = dies.constFind(offset);
+    if (it == dies.constEnd() || depth > MaxTypeDepth) return "?";
+    const Die &die = it.value();
+
+    if (die.tag == "DW_TAG_pointer_type") return typeName(dies, die.type, depth + 1) + " *";
+    if (die.tag == "DW_TAG_reference_type") return typeName(dies, die.type, depth + 1) + " &";
+    if (die.tag == "DW_TAG_rvalue_reference_type") return typeName(dies, die.type, depth + 1) + " &&";
+    if (die.tag == "DW_TAG_const_type") return "const " + typeName(dies, die.type, depth + 1);
+    if (die.tag == "DW_TAG_volatile_type") return "volatile " + typeName(dies, die.type, depth + 1);
+    if (die.tag == "DW_TAG_atomic_type") return "_Atomic " + typeName(dies, die.type, depth + 1);
+    if (die.tag == "DW_TAG_array_type") {
+        QString name = typeName(dies, die.type, depth + 1);
+        for (quint64 child : die.children) {
+            const Die &range = dieAt(dies, child);
+            if (range.tag != "DW_TAG_subrange_type") continue;
+            name += range.count >= 0 ? QString("[%1]").arg(range.count) : QString("[]");
+        }
+        return name;
+    }
+    if (!die.name.isEmpty()) return die.name;
+    if (die.tag == "DW_TAG_subroutine_type") return "<函数>";
+    if (die.tag == "DW_TAG_union_type") return "union <匿名>";
+    if (isRecord(die.tag)) return "struct <匿名>";
+    return "?";
+}
+
+// 带外层命名空间和类名的完整名称
+QString qualifiedName(const DieTable &dies, const Die &die)
+{
+    QStringList parts(die.name);
+    quint64 parent = die.parent;
+    for (int depth = 0; parent != 0 && depth < MaxTypeDepth; ++depth) {
+        auto it = dies.constFind(parent);
+        if (it == dies.constEnd() || it->tag == "DW_TAG_compile_unit") break;
+        parts.prepend(it->name.isEmpty() ? QString("<匿名>") : it->name);
+        parent = it->parent;
+    }
+    return parts.join("::");
+}
+
+quint64 alignUp(quint64 value, quint64 alignment)
+{
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+QString describeBits(quint64 bits)
+{
+    if (bits % 8 == 0) return QString("%1 字节").arg(bits / 8);
+    if (bits < 8) return QString("%1 位").arg(bits);
+    return QString("%1 字节 %2 位").arg(bits / 8).arg(bits % 8);
+}
+
+// 解析 readelf --debug-dump=info 的输出，order 按出现顺序收集所有条目
+DieTable parseDies(const QString &readelfOutput, QList<quint64> *order)
+{
+    static const QRegularExpression headerPattern(
+        QStringLiteral("^\\s*<(\\d+)><([0-9a-f]+)>: Abbrev Number: \\d+(?: \\((\\w+)\\))?"));
+    static const QRegularExpression attributePattern(
+        QStringLiteral("^\\s*<[0-9a-f]+>\\s+(DW_AT_\\w+)\\s*:\\s*(.*)$"));
+    static const QRegularExpression indirectString(QStringLiteral("^\\((?:indirect|indexed)[^)]*\\):\\s*(.*)$"));
+    static const QRegularExpression reference(QStringLiteral("<0x([0-9a-f]+)>"));
+    static const QRegularExpression plusConstant(QStringLiteral("DW_OP_plus_uconst: (\\d+)"));
+    static const QRegularExpression addressOperation(QStringLiteral("\\(DW_OP_addr: ([0-9a-f]+)\\)$"));
+
+    DieTable dies;
+    QList<quint64> parents;         // 各层当前的父条目
+    Die *current = nullptr;
+
+    const QStringList lines = readelfOutput.split('\n');
+    for (const QString &line : lines) {
+        QRegularExpressionMatch match = headerPattern.match(line);
+        if (match.hasMatch()) {
+            current = nullptr;
+            // Abbrev Number 0 表示子条目列表结束，没有标签
+            if (match.captured(3).isEmpty()) continue;
+
+            int depth = match.captured(1).toInt();
+            quint64 offset = match.captured(2).toULongLong(nullptr, 16);
+            while (parents.size() > depth) parents.removeLast();
+            while (parents.size() < depth) parents.append(0);
+
+            Die die;
+            die.tag = match.captured(3);
+            die.parent = depth > 0 ? parents.value(depth - 1) : 0;
+            if (die.parent != 0 && dies.contains(die.parent)) dies[die.parent].children.append(offset);
+            if (order) order->append(offset);
+            parents.append(offset);
+            // 插入后再取指针，之后到下一个条目头之前不会再插入
+            current = &dies.insert(offset, die).value();
+            continue;
+        }
+
+        if (!current) continue;
+        match = attributePattern.match(line);
+        if (!match.hasMatch()) continue;
+
+        const QString attribute = match.captured(1);
+        QString value = match.captured(2).trimmed();
+
+        if (attribute == "DW_AT_name") {
+            QRegularExpressionMatch indirect = indirectString.match(value);
+            current->name = indirect.hasMatch() ? indirect.captured(1) : value;
+        } else if (attribute == "DW_AT_type") {
+            QRegularExpressionMatch ref = reference.match(value);
+            if (ref.hasMatch()) current->type = ref.captured(1).toULongLong(nullptr, 16);
+        } else if (attribute == "DW_AT_byte_size") {
+            current->byteSize = parseNumber(value, &current->hasByteSize);
+        } else if (attribute == "DW_AT_alignment") {
+            current->alignment = parseNumber(value);
+        } else if (attribute == "DW_AT_data_member_location") {
+            // DWARF 2 中是位置表达式
+            QRegularExpressionMatch expression = plusConstant.match(value);
+            if (expression.hasMatch()) {
+                current->memberLocation = expression.captured(1).toULongLong();
+                current->hasMemberLocation = true;
+            } else {
+                current->memberLocation = parseNumber(value, &current->hasMemberLocation);
+                // 虚基类的偏移是运行时计算的表达式
+                if (value.contains("byte block")) current->hasMemberLocation = false;
+            }
+        } else if (attribute == "DW_AT_bit_size") {
+            current->bitSize = int(parseNumber(value));
+        } else if (attribute == "DW_AT_data_bit_offset") {
+            current->dataBitOffset = parseNumber(value, &current->hasDataBitOffset);
+        } else if (attribute == "DW_AT_bit_offset") {
+            current->legacyBitOffset = parseNumber(value, &current->hasLegacyBitOffset);
+        } else if (attribute == "DW_AT_count" || attribute == "DW_AT_upper_bound") {
+            // 变长数组的边界是引用，柔性数组成员的上界是 -1
+            bool ok = false;
+            quint64 number = value.startsWith('<') ? 0 : parseNumber(value, &ok);
+            if (ok && number < (quint64(1) << 48)) {
+                current->count = attribute == "DW_AT_count" ? qint64(number) : qint64(number) + 1;
+            } else if (ok) {
+                current->count = 0;
+            }
+        } else if (attribute == "DW_AT_encoding") {
+            current->encoding = int(parseNumber(value));
+        } else if (attribute == "DW_AT_decl_file") {
+            current->declFile = int(parseNumber(value));
+        } else if (attribute == "DW_AT_decl_line") {
+            current->declLine = int(parseNumber(value));
+        } else if (attribute == "DW_AT_declaration") {
+            current->declaration = true;
+        } else if (attribute == "DW_AT_artificial") {
+            current->artificial = true;
+        } else if (attribute == "DW_AT_external") {
+            current->external = true;
+        } else if (attribute == "DW_AT_location") {
+            // 只取单个 DW_OP_addr 的位置，线程局部变量和栈上变量没有固定地址
+            QRegularExpressionMatch expression = addressOperation.match(value);
+            if (expression.hasMatch()) {
+                current->address = expression.captured(1).toULongLong(nullptr, 16);
+                current->hasAddress = true;
+            }
+        } else if (attribute == "DW_AT_specification") {
+            QRegularExpressionMatch ref = reference.match(value);
+            if (ref.hasMatch()) current->specification = ref.captured(1).toULongLong(nullptr, 16);
+        } else if (attribute == "DW_AT_comp_dir") {
+            QRegularExpressionMatch indirect = indirectString.match(value);
+            current->compDirectory = indirect.hasMatch() ? indirect.captured(1) : value;
+        } else if (attribute == "DW_AT_stmt_list") {
+            current->lineTable = parseNumber(value, &current->hasLineTable);
+        }
+    }
+
+    return dies;
+}
+
+// 解析 readelf --debug-dump=rawline 输出中各行号表的目录表和文件表，键为行号表的偏移
+QHash<quint64, LineTable> parseLineTables(const QString &readelfOutput)
+{
+    static const QRegularExpression offsetPattern(QStringLiteral("^\\s*Offset:\\s+(\\S+)"));
+    static const QRegularExpression entryPattern(QStringLiteral("^\\s*(\\d+)\\t(.*)$"));
+    static const QRegularExpression indirectString(QStringLiteral("^\\((?:indirect|indexed)[^)]*\\):\\s*(.*)$"));
+
+    enum Section { None, Directories, Files };
+    QHash<quint64, LineTable> tables;
+    LineTable *current = nullptr;
+    Section section = None;
+
+    const QStringList lines = readelfOutput.split('\n');
+    for (const QString &line : lines) {
+        if (line.trimmed().isEmpty()) {
+            section = None;
+            continue;
+        }
+        QRegularExpressionMatch match = offsetPattern.match(line);
+        if (match.hasMatch()) {
+            current = &tables[parseNumber(match.captured(1))];
+            section = None;
+            continue;
+        }
+        if (!current) continue;
+        if (line.startsWith(" The Directory Table")) {
+            section = Directories;
+            continue;
+        }
+        if (line.startsWith(" The File Name Table")) {
+            section = Files;
+            continue;
+        }
+        if (section == None) continue;
+
+        match = entryPattern.match(line);
+        if (!match.hasMatch()) continue;
+        // DWARF 5：序号、目录号、名字；DWARF 4 的文件表中间还有修改时间和长度两列
+        const QStringList fields = match.captured(2).split('\t');
+        QString name = fields.last().trimmed();
+        QRegularExpressionMatch indirect = indirectString.match(name);
+        if (indirect.hasMatch()) name = indirect.captured(1);
+        const int index = match.captured(1).toInt();
+        if (section == Directories) {
+            current->directories.insert(index, name);
+        } else if (fields.size() >= 2) {
+            current->files.insert(index, qMakePair(fields.first().toInt(), name));
+        }
+    }
+    return tables;
+}
+
+QString resolvePath(const QString &directory, const QString &path)
+{
+    if (directory.isEmpty() || QDir::isAbsolutePath(path)) return QDir::cleanPath(path);
+    return QDir::cleanPath(directory + '/' + path);
+}
+
+// 文件表中与编译单元 DW_AT_name 相同的文件号。GCC 把主源文件放在 1 号（前面有头文件时也可能更靠后），
+// clang 的 DWARF 5 放在 0 号，按名字对照才可靠
+QSet<int> mainFileIndices(const Die &unit, const LineTable &table)
+{
+    const QString unitPath = resolvePath(unit.compDirectory, unit.name);
+    QSet<int> indices;
+    for (auto it = table.files.constBegin(); it != table.files.constEnd(); ++it) {
+        // DWARF 4 的目录表从 1 开始，0 号目录即编译目录；相对目录也相对于编译目录
+        QString directory = table.directories.value(it->first, it->first == 0 ? unit.compDirectory : QString());
+        directory = resolvePath(unit.compDirectory, directory);
+        if (resolvePath(directory, it->second) == unitPath) indices.insert(it.key());
+    }
+    return indices;
+}
+
+// 去掉 typedef 和 const/volatile 等修饰
+quint64 stripQualifiers(const DieTable &dies, quint64 offset)
+{
+    for (int depth = 0; depth < MaxTypeDepth; ++depth) {
+        const Die &die = dieAt(dies, offset);
+        if (!isQualifier(die.tag)) break;
+        offset = die.type;
+    }
+    return offset;
+}
+
+StructLayout::Layout buildLayout(const DieTable &dies, quint64 offset)
+{
+    using Field = StructLayout::Field;
+    const Die &die = dieAt(dies, offset);
+
+    StructLayout::Layout layout;
+    layout.name = qualifiedName(dies, die);
+    layout.kind = die.tag == "DW_TAG_class_type" ? "class" : "struct";
+    layout.line = die.declLine;
+    layout.size = die.byteSize;
+    layout.explicitAlignment = die.alignment > 0;
+    layout.alignment = typeAlignment(dies, offset);
+
+    for (quint64 child : die.children) {
+        const Die &member = dieAt(dies, child);
+        if (!isDataMember(member)) continue;
+
+        Field field;
+        field.isBase = member.tag == "DW_TAG_inheritance";
+        field.artificial = member.artificial;
+        field.typeName = typeName(dies, member.type);
+        field.name = field.isBase ? QString("<基类>") : (member.name.isEmpty() ? QString("<匿名>") : member.name);
+        field.size = typeSize(dies, member.type);
+        field.alignment = member.alignment > 0 ? member.alignment : typeAlignment(dies, member.type);
+        field.offset = member.memberLocation;
+        if (member.bitSize > 0) {
+            field.bitSize = member.bitSize;
+            if (member.hasDataBitOffset) {
+                field.bitOffset = member.dataBitOffset;
+            } else {
+                quint64 storage = member.hasByteSize ? member.byteSize : field.size;
+                field.bitOffset = member.memberLocation * 8 + storage * 8 - member.legacyBitOffset - member.bitSize;
+            }
+            field.offset = field.bitOffset / 8;
+        }
+        layout.fields.append(field);
+    }
+
+    std::stable_sort(layout.fields.begin(), layout.fields.end(), [](const Field &a, const Field &b) {
+        return a.bitStart() < b.bitStart();
+    });
+    return layout;
+}
+}
+
+bool StructLayout::Layout::hasBitFields() const
+{
+    for (const Field &field : fields) {
+        if (field.bitSize > 0) return true;
+    }
+    return false;
+}
+
+quint64 StructLayout::Layout::paddingBytes() const
+{
+    quint64 bits = 0;
+    for (const Hole &hole : StructLayout::holes(*this)) bits += hole.bits;
+    return bits / 8;
+}
+
+QList<StructLayout::Layout> StructLayout::parseDwarf(const QString &readelfOutput, bool mainFileOnly)
+{
+    QList<quint64> order;
+    const DieTable dies = parseDies(readelfOutput, &order);
+    const QHash<quint64, LineTable> lineTables = parseLineTables(readelfOutput);
+
+    QList<Layout> layouts;
+    QSet<QString> seen;
+    QSet<int> mainFiles;
+    for (quint64 offset : order) {
+        const Die &die = dieAt(dies, offset);
+        if (die.tag == "DW_TAG_compile_unit") {
+            // 输出中没有行号表时退回 GCC 的惯例
+            auto table = lineTables.constFind(die.lineTable);
+            mainFiles = die.hasLineTable && table != lineTables.constEnd() ? mainFileIndices(die, table.value())
+                                                                          : QSet<int>{1};
+            continue;
+        }
+        if (!isRecord(die.tag) || die.tag == "DW_TAG_union_type") continue;
+        if (die.declaration || !die.hasByteSize || die.name.isEmpty()) continue;
+        if (mainFileOnly && !mainFiles.contains(die.declFile)) continue;
+
+        Layout layout = buildLayout(dies, offset);
+        // 同一类型可能在多个编译单元中重复出现
+        QString key = QString("%1:%2").arg(layout.name).arg(layout.line);
+        if (seen.contains(key)) continue;
+        seen.insert(key);
+        layouts.append(layout);
+    }
+    return layouts;
+}
+
+QList<StructLayout::Variable> StructLayout::parseVariables(const QString &readelfOutput)
+{
+    QList<quint64> order;
+    const DieTable dies = parseDies(readelfOutput, &order);
+
+    QList<Variable> variables;
+    for (quint64 offset : order) {
+        const Die &die = dieAt(dies, offset);
+        if (die.tag != "DW_TAG_variable" || !die.hasAddress) continue;
+
+        const Die &declaration = die.specification != 0 ? dieAt(dies, die.specification) : die;
+        Variable variable;
+        variable.name = declaration.name.isEmpty() ? die.name : qualifiedName(dies, declaration);
+        variable.address = die.address;
+        quint64 type = die.type != 0 ? die.type : declaration.type;
+        variable.size = typeSize(dies, type);
+        if (variable.name.isEmpty() || variable.size == 0) continue;
+
+        type = stripQualifiers(dies, type);
+        if (dieAt(dies, type).tag == "DW_TAG_array_type") {
+            variable.elementSize = typeSize(dies, dieAt(dies, type).type);
+            type = stripQualifiers(dies, dieAt(dies, type).type);
+        }
+        const Die &typeDie = dieAt(dies, type);
+        if (isRecord(typeDie.tag) && typeDie.tag != "DW_TAG_union_type") variable.layout = buildLayout(dies, type);
+        variables.append(variable);
+    }
+
+    std::sort(variables.begin(), variables.end(), [](const Variable &a, const Variable &b) {
+        return a.address < b.address;
+    });
+    return variables;
+}
+
+QString StructLayout::describeAddress(const QList<Variable> &variables, quint64 address)
+{
+    // 变量按地址排序，找最后一个起始地址不大于 address 的
+    auto it = std::upper_bound(variables.begin(), variables.end(), address,
+                               [](quint64 value, const Variable &variable) { return value < variable.address; });
+    if (it == variables.begin()) return QString();
+    const Variable &variable = *(it - 1);
+    quint64 offset = address - variable.address;
+    if (offset >= variable.size) return QString();
+
+    QString description = variable.name;
+    if (variable.elementSize > 0) {
+        description += QString("[%1]").arg(offset / variable.elementSize);
+        offset %= variable.elementSize;
+    }
+    for (const Field &field : variable.layout.fields) {
+        if (offset >= field.offset && offset < field.offset + qMax<quint64>(field.size, 1)) {
+            return description + (field.isBase ? QString() : "." + field.name);
+        }
+    }
+    return description;
+}
+
+QList<StructLayout::Hole> StructLayout::holes(const Layout &layout)
+{
+    QList<Hole> result;
+    if (layout.fields.isEmpty()) return result;
+
+    quint64 cursor = 0;
+    for (int i = 0; i < layout.fields.size(); ++i) {
+        const Field &field = layout.fields[i];
+        if (field.bitStart() > cursor) {
+            Hole hole;
+            hole.bitOffset = cursor;
+            hole.bits = field.bitStart() - cursor;
+            hole.afterField = i - 1;
+            result.append(hole);
+        }
+        // 派生类成员可能放在基类的尾部填充里，所以取较大值
+        cursor = qMax(cursor, field.bitEnd());
+    }
+    if (layout.size * 8 > cursor) {
+        Hole hole;
+        hole.bitOffset = cursor;
+        hole.bits = layout.size * 8 - cursor;
+        hole.afterField = layout.fields.size() - 1;
+        result.append(hole);
+    }
+    return result;
+}
+
+QList<int> StructLayout::straddlingFields(const Layout &layout)
+{
+    QList<int> result;
+    for (int i = 0; i < layout.fields.size(); ++i) {
+        const Field &field = layout.fields[i];
+        if (field.bitSize > 0 || field.size == 0) continue;
+        if (field.offset / CacheLineSize != (field.offset + field.size - 1) / CacheLineSize) result.append(i);
+    }
+    return result;
+}
+
+StructLayout::Layout StructLayout::optimized(const Layout &layout)
+{
+    if (layout.hasBitFields() || layout.fields.isEmpty()) return layout;
+
+    Layout result = layout;
+    result.fields.clear();
+
+    QList<Field> movable;
+    quint64 cursor = 0;
+    for (const Field &field : layout.fields) {
+        if (field.isBase || field.artificial) {
+            result.fields.append(field);
+            cursor = qMax(cursor, field.offset + field.size);
+        } else {
+            movable.append(field);
+        }
+    }
+
+    // 对齐要求都是 2 的幂且大小是对齐的整数倍，按对齐从大到小排列时成员之间不会产生空洞
+    std::stable_sort(movable.begin(), movable.end(), [](const Field &a, const Field &b) {
+        return a.alignment != b.alignment ? a.alignment > b.alignment : a.size > b.size;
+    });
+    for (Field field : movable) {
+        field.offset = alignUp(cursor, field.alignment);
+        cursor = field.offset + field.size;
+        result.fields.append(field);
+    }
+    result.size = alignUp(qMax<quint64>(cursor, 1), layout.alignment);
+
+    // 基类尾部填充复用等情况下估算可能偏大，不比原布局小时保持原样
+    return result.size < layout.size ? result : layout;
+}
+
+QString StructLayout::format(const Layout &layout)
+{
+    const QList<Hole> holeList = holes(layout);
+    const QList<int> straddling = straddlingFields(layout);
+
+    QStringList lines;
+    lines << QString("%1 %2 {").arg(layout.kind, layout.name);
+
+    // 空洞按位置排列，依次插到对应成员前面，剩下的是末尾填充
+    int holeIndex = 0;
+    quint64 nextBoundary = CacheLineSize;
+    for (int i = 0; i < layout.fields.size(); ++i) {
+        const Field &field = layout.fields[i];
+        while (holeIndex < holeList.size() && holeList[holeIndex].afterField < i) {
+            lines << QString("    /* 空洞: %1 */").arg(describeBits(holeList[holeIndex].bits));
+            ++holeIndex;
+        }
+        while (field.offset >= nextBoundary) {
+            lines << QString("    /* --- 缓存行 %1 边界 (%2 字节) --- */").arg(nextBoundary / CacheLineSize).arg(nextBoundary);
+            nextBoundary += CacheLineSize;
+        }
+
+        QString declaration = field.isBase ? QString("/* 基类 */ %1").arg(field.typeName)
+                                           : QString("%1 %2").arg(field.typeName.leftJustified(24), field.name);
+        if (field.bitSize > 0) declaration += QString(":%1").arg(field.bitSize);
+        QString position = field.bitSize > 0
+            ? QString("/* %1:%2 %3 */").arg(field.offset, 5).arg(field.bitOffset % 8, -2).arg(field.size, 5)
+            : QString("/* %1 %2 */").arg(field.offset, 8).arg(field.size, 5);
+        QString line = QString("    %1 %2").arg((declaration + ";").leftJustified(44), position);
+        if (straddling.contains(i)) line += "  /* 跨缓存行 */";
+        lines << line;
+    }
+
+    quint64 holeBits = 0;
+    quint64 tailBits = 0;
+    for (const Hole &hole : holeList) {
+        if (hole.afterField == layout.fields.size() - 1) {
+            tailBits += hole.bits;
+        } else {
+            holeBits += hole.bits;
+        }
+    }
+    if (tailBits > 0) lines << QString("    /* 末尾填充: %1 */").arg(describeBits(tailBits));
+
+    lines << QString("};  /* 大小: %1，对齐: %2%3，缓存行: %4，成员: %5，空洞: %6，末尾填充: %7 */")
+                 .arg(layout.size).arg(layout.alignment).arg(layout.explicitAlignment ? "（显式指定）" : "")
+                 .arg(layout.cacheLines()).arg(layout.fields.size())
+                 .arg(describeBits(holeBits), describeBits(tailBits));
+    return lines.join('\n');
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+
+// 结构体内存布局分析（类似 pahole）
+// 解析 readelf --debug-dump=info 输出的 DWARF 调试信息，得到每个结构体/类的大小、
+// 对齐、成员偏移、成员之间的空洞和跨缓存行的位置，并给出减少填充的成员重排建议。
+class StructLayout
+{
+public:
+    static const int CacheLineSize = 64;
+
+    struct Field
+    {
+        QString name;
+        QString typeName;
+        quint64 offset = 0;         // 字节偏移
+        quint64 size = 0;
+        quint64 alignment = 1;
+        int bitSize = 0;            // 位域宽度，0 表示普通成员
+        quint64 bitOffset = 0;      // 位域相对结构体起始的位偏移
+        bool isBase = false;        // 基类子对象
+        bool artificial = false;    // 编译器生成的成员（虚表指针等）
+
+        quint64 bitStart() const { return bitSize > 0 ? bitOffset : offset * 8; }
+        quint64 bitEnd() const { return bitSize > 0 ? bitOffset + bitSize : (offset + size) * 8; }
+    };
+
+    // 成员之间（或末尾）未被使用的空间
+    struct Hole
+    {
+        quint64 bitOffset = 0;
+        quint64 bits = 0;
+        int afterField = -1;        // 空洞前面的成员下标，-1 表示在第一个成员之前
+    };
+
+    struct Layout
+    {
+        QString name;
+        QString kind;               // struct / class
+        int line = 0;               // 声明所在行
+        quint64 size = 0;
+        quint64 alignment = 1;
+        bool explicitAlignment = false;
+        QList<Field> fields;        // 按偏移排序
+
+        bool hasBitFields() const;
+        quint64 paddingBytes() const;
+        int cacheLines() const { return int((size + CacheLineSize - 1) / CacheLineSize); }
+    };
+
+    // readelfOutput 是 readelf --debug-dump=info --debug-dump=rawline 的输出；mainFileOnly 为 true 时
+    // 只保留主源文件中声明的类型，主源文件按编译单元的 DW_AT_name 在行号表的文件表中查找
+    static QList<Layout> parseDwarf(const QString &readelfOutput, bool mainFileOnly = true);
+
+    // 有固定地址的全局/静态变量，用于把数据地址对应到变量和成员
+    struct Variable
+    {
+        QString name;
+        quint64 address = 0;
+        quint64 size = 0;
+        quint64 elementSize = 0;    // 数组元素大小，不是数组时为 0
+        Layout layout;              // 变量（或数组元素）是结构体时的布局，否则 fields 为空
+    };
+
+    static QList<Variable> parseVariables(const QString &readelfOutput);
+    // 把地址描述为“变量[下标].成员”，不属于任何变量时返回空字符串
+    static QString describeAddress(const QList<Variable> &variables, quint64 address);
+
+    static QList<Hole> holes(const Layout &layout);
+    // 跨越缓存行边界的成员下标
+    static QList<int> straddlingFields(const Layout &layout);
+
+    // 基类和编译器生成的成员保持在最前面，其余成员按对齐从大到小、大小从大到小重排。
+    // 含位域的结构体不重排（位域的分配单元由编译器决定），返回原布局。
+    static Layout optimized(const Layout &layout);
+
+    // pahole 风格的文本：每个成员一行，标出偏移、大小、空洞和缓存行边界
+    static QString format(const Layout &layout);
+};
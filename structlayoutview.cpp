@@ -0,0 +1,353 @@
+#include "structlayoutview.h"
+#include "buildcache.h"
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QSplitter>
+#include <QHeaderView>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QFontDatabase>
+#include <algorithm>
+
+namespace {
+enum Column { NameColumn, SizeColumn, PaddingColumn, CacheLineColumn, OptimizedColumn, ColumnCount };
+
+const int IndexRole = Qt::UserRole;
+}
+
+StructLayoutView::StructLayoutView(QWidget *parent)
+    : QWidget(parent)
+    , idleTimer(new QTimer(this))
+    , compileProcess(new QProcess(this))
+    , readelfProcess(new QProcess(this))
+    , recompilePending(false)
+    , parsing(false)
+    , active(false)
+    , generation(0)
+    , runningGeneration(0)
+{
+    QSettings settings("LionCPP", "IDE");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *optionLayout = new QHBoxLayout();
+    flagsEdit = new QLineEdit(this);
+    flagsEdit->setPlaceholderText("额外编译参数，如 -m32 -DNDEBUG");
+    flagsEdit->setText(settings.value("layout/flags").toString());
+    reorderButton = new QPushButton("重排建议", this);
+    reorderButton->setCheckable(true);
+    reorderButton->setToolTip("按对齐从大到小重排成员，对比重排前后的大小");
+    optionLayout->addWidget(flagsEdit, 1);
+    optionLayout->addWidget(reorderButton);
+    layout->addLayout(optionLayout);
+
+    statusLabel = new QLabel(this);
+    layout->addWidget(statusLabel);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+
+    structTree = new QTreeWidget(splitter);
+    structTree->setColumnCount(ColumnCount);
+    structTree->setHeaderLabels(QStringList() << "类型" << "大小" << "填充" << "缓存行" << "重排后");
+    structTree->setRootIsDecorated(false);
+    structTree->header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    splitter->addWidget(structTree);
+
+    QWidget *detailWidget = new QWidget(splitter);
+    QVBoxLayout *detailLayout = new QVBoxLayout(detailWidget);
+    detailLayout->setContentsMargins(0, 0, 0, 0);
+    compareLabel = new QLabel(detailWidget);
+    compareLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layoutEdit = new QPlainTextEdit(detailWidget);
+    layoutEdit->setReadOnly(true);
+    layoutEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    layoutEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    detailLayout->addWidget(compareLabel);
+    detailLayout->addWidget(layoutEdit, 1);
+    splitter->addWidget(detailWidget);
+    splitter->setStretchFactor(1, 2);
+    layout->addWidget(splitter, 1);
+
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(IdleDelayMs);
+    connect(idleTimer, &QTimer::timeout, this, &StructLayoutView::recompile);
+
+    connect(flagsEdit, &QLineEdit::editingFinished, this, [this]() {
+        QSettings("LionCPP", "IDE").setValue("layout/flags", flagsEdit->text());
+        recompile();
+    });
+    connect(reorderButton, &QPushButton::toggled, this, &StructLayoutView::showSelectedLayout);
+    connect(structTree, &QTreeWidget::currentItemChanged, this, &StructLayoutView::showSelectedLayout);
+    connect(structTree, &QTreeWidget::itemActivated, this, &StructLayoutView::onItemActivated);
+
+    connect(compileProcess, &QProcess::finished, this, &StructLayoutView::onCompileFinished);
+    connect(compileProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            statusLabel->setText("无法启动编译器: " + BuildCache::compilerPath());
+        }
+    });
+    connect(readelfProcess, &QProcess::finished, this, &StructLayoutView::onReadelfFinished);
+    connect(readelfProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            statusLabel->setText("无法启动 readelf");
+        }
+    });
+}
+
+StructLayoutView::~StructLayoutView()
+{
+    QProcess *processes[] = { compileProcess, readelfProcess };
+    for (QProcess *process : processes) {
+        if (process->state() != QProcess::NotRunning) {
+            process->disconnect(this);
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+}
+
+QString StructLayoutView::objectPath() const
+{
+    return QDir(objectDirectory.path()).filePath("layout.o");
+}
+
+void StructLayoutView::setEditor(CodeEditor *newEditor)
+{
+    if (editor == newEditor) return;
+
+    if (editor) {
+        disconnect(editor->document(), nullptr, this, nullptr);
+    }
+
+    editor = newEditor;
+    ++generation;
+    layouts.clear();
+    structTree->clear();
+    layoutEdit->clear();
+    compareLabel->clear();
+    statusLabel->clear();
+
+    if (editor) {
+        connect(editor->document(), &QTextDocument::contentsChanged, this, &StructLayoutView::scheduleRecompile);
+        recompile();
+    }
+}
+
+void StructLayoutView::setActive(bool value)
+{
+    if (active == value) return;
+    active = value;
+
+    if (active) {
+        recompile();
+    } else {
+        idleTimer->stop();
+    }
+}
+
+void StructLayoutView::scheduleRecompile()
+{
+    if (active) idleTimer->start();
+}
+
+void StructLayoutView::recompile()
+{
+    idleTimer->stop();
+    if (!editor || !active) return;
+    if (!objectDirectory.isValid()) {
+        statusLabel->setText("无法创建临时目录");
+        return;
+    }
+
+    // 上一次分析还没结束时只做标记，结束后再分析一次最新内容
+    if (compileProcess->state() != QProcess::NotRunning || readelfProcess->state() != QProcess::NotRunning
+        || parsing) {
+        recompilePending = true;
+        return;
+    }
+    recompilePending = false;
+
+    QString filePath = editor->property("filePath").toString();
+    QString directory = filePath.isEmpty() ? QDir::currentPath() : QFileInfo(filePath).absolutePath();
+    QStringList flags = QProcess::splitCommand(flagsEdit->text());
+    // 保留没有被使用的类型，只声明未使用的结构体也能看到布局
+    flags << "-c" << "-g" << "-fno-eliminate-unused-debug-types" << "-x" << "c++" << "-iquote" << directory;
+
+    runningGeneration = generation;
+    statusLabel->setText("编译中...");
+    compileProcess->setWorkingDirectory(directory);
+    compileProcess->start(BuildCache::compilerPath(), BuildCache::compileArguments("-", objectPath(), flags));
+    compileProcess->write(editor->toPlainText().toUtf8());
+    compileProcess->closeWriteChannel();
+}
+
+void StructLayoutView::onCompileFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QString errors = QString::fromUtf8(compileProcess->readAllStandardError());
+
+    // 编译期间切换了编辑器，结果作废
+    if (runningGeneration != generation) {
+        recompile();
+        return;
+    }
+
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        statusLabel->setText("编译失败");
+        layoutEdit->setPlainText(errors.trimmed());
+        if (recompilePending) recompile();
+        return;
+    }
+
+    QString readelf = QStandardPaths::findExecutable("readelf");
+    if (readelf.isEmpty()) {
+        statusLabel->setText("找不到 readelf（binutils）");
+        return;
+    }
+    statusLabel->setText("读取调试信息...");
+    readelfProcess->start(readelf, QStringList() << "--debug-dump=info" << "--debug-dump=rawline" << objectPath());
+}
+
+void StructLayoutView::onReadelfFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QString output = QString::fromUtf8(readelfProcess->readAllStandardOutput());
+
+    if (runningGeneration != generation) {
+        recompile();
+        return;
+    }
+
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        statusLabel->setText("readelf 执行失败");
+        if (recompilePending) recompile();
+        return;
+    }
+
+    // 包含大量头文件时 readelf 输出有几十 MB，解析放到工作线程中；this 只在界面线程中检查
+    parsing = true;
+    QPointer<StructLayoutView> guard(this);
+    const int run = runningGeneration;
+    QThreadPool::globalInstance()->start(QRunnable::create([guard, run, output]() {
+        QList<StructLayout::Layout> parsed = StructLayout::parseDwarf(output);
+        std::sort(parsed.begin(), parsed.end(), [](const StructLayout::Layout &a, const StructLayout::Layout &b) {
+            return a.line < b.line;
+        });
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, run, parsed]() {
+            if (guard) guard->onLayoutsParsed(run, parsed);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void StructLayoutView::onLayoutsParsed(int run, const QList<StructLayout::Layout> &parsed)
+{
+    parsing = false;
+
+    // 解析期间切换了编辑器，结果作废
+    if (run != generation) {
+        recompile();
+        return;
+    }
+
+    layouts = parsed;
+    showLayouts();
+    if (recompilePending) recompile();
+}
+
+void StructLayoutView::showLayouts()
+{
+    // 重新分析后尽量保持选中同一个类型
+    QString selectedName;
+    if (QTreeWidgetItem *current = structTree->currentItem()) selectedName = current->text(NameColumn);
+
+    structTree->clear();
+    quint64 totalPadding = 0;
+    int improvable = 0;
+    QTreeWidgetItem *selectedItem = nullptr;
+    for (int i = 0; i < layouts.size(); ++i) {
+        const StructLayout::Layout &layout = layouts[i];
+        StructLayout::Layout optimized = StructLayout::optimized(layout);
+        quint64 padding = layout.paddingBytes();
+        totalPadding += padding;
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(structTree);
+        item->setText(NameColumn, layout.name);
+        item->setToolTip(NameColumn, QString("第 %1 行").arg(layout.line));
+        item->setText(SizeColumn, QString::number(layout.size));
+        item->setText(PaddingColumn, QString::number(padding));
+        item->setText(CacheLineColumn, QString::number(layout.cacheLines()));
+        item->setData(NameColumn, IndexRole, i);
+        for (int column = SizeColumn; column < ColumnCount; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+        if (optimized.size < layout.size) {
+            ++improvable;
+            item->setText(OptimizedColumn, QString("%1 (-%2)").arg(optimized.size).arg(layout.size - optimized.size));
+            item->setForeground(OptimizedColumn, QColor("#4ec9b0"));
+            item->setForeground(PaddingColumn, QColor("#d7ba7d"));
+        } else {
+            item->setText(OptimizedColumn, "-");
+        }
+        if (layout.name == selectedName) selectedItem = item;
+    }
+    for (int column = SizeColumn; column < ColumnCount; ++column) {
+        structTree->resizeColumnToContents(column);
+    }
+
+    statusLabel->setText(QString("%1 个类型，填充共 %2 字节，%3 个可通过重排缩小")
+                             .arg(layouts.size()).arg(totalPadding).arg(improvable));
+    if (!selectedItem && structTree->topLevelItemCount() > 0) selectedItem = structTree->topLevelItem(0);
+    if (selectedItem) {
+        structTree->setCurrentItem(selectedItem);
+    }
+    showSelectedLayout();
+}
+
+void StructLayoutView::showSelectedLayout()
+{
+    QTreeWidgetItem *item = structTree->currentItem();
+    int index = item ? item->data(NameColumn, IndexRole).toInt() : -1;
+    if (index < 0 || index >= layouts.size()) {
+        compareLabel->clear();
+        layoutEdit->clear();
+        return;
+    }
+
+    const StructLayout::Layout &layout = layouts[index];
+    StructLayout::Layout optimized = StructLayout::optimized(layout);
+
+    if (layout.hasBitFields()) {
+        compareLabel->setText("含位域，不给出重排建议");
+    } else if (optimized.size < layout.size) {
+        compareLabel->setText(QString("重排前 %1 字节 / %2 条缓存行 → 重排后 %3 字节 / %4 条缓存行，节省 %5 字节")
+                                  .arg(layout.size).arg(layout.cacheLines())
+                                  .arg(optimized.size).arg(optimized.cacheLines())
+                                  .arg(layout.size - optimized.size));
+    } else {
+        compareLabel->setText("当前成员顺序的填充已经最少");
+    }
+
+    QString text = StructLayout::format(layout);
+    if (reorderButton->isChecked() && optimized.size < layout.size) {
+        text = "/* 当前布局 */\n" + text + "\n\n/* 建议顺序 */\n" + StructLayout::format(optimized);
+    }
+    layoutEdit->setPlainText(text);
+}
+
+void StructLayoutView::onItemActivated(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column)
+    int index = item->data(NameColumn, IndexRole).toInt();
+    if (!editor || index < 0 || index >= layouts.size()) return;
+
+    QTextBlock block = editor->document()->findBlockByNumber(layouts[index].line - 1);
+    if (block.isValid()) {
+        editor->setTextCursor(QTextCursor(block));
+        editor->centerCursor();
+        editor->setFocus();
+    }
+}
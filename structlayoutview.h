@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QWidget>
+#include <QPlainTextEdit>
+#include <QTreeWidget>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QLabel>
+#include <QTimer>
+#include <QProcess>
+#include <QPointer>
+#include <QTemporaryDir>
+
+#include "codeeditor.h"
+#include "structlayout.h"
+
+// 结构体布局视图
+// 把当前编辑器的内容编译为带调试信息的目标文件，用 readelf 读出 DWARF，
+// 列出本文件中定义的结构体/类的大小、填充和缓存行占用；选中后显示逐成员布局，
+// 可以切换查看按对齐重排后的建议顺序及前后大小对比。编辑停顿后自动重新分析。
+class StructLayoutView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StructLayoutView(QWidget *parent = nullptr);
+    ~StructLayoutView();
+
+    void setEditor(CodeEditor *editor);
+    // 窗口不可见时不做后台编译
+    void setActive(bool active);
+
+private slots:
+    void scheduleRecompile();
+    void recompile();
+    void onCompileFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onReadelfFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onItemActivated(QTreeWidgetItem *item, int column);
+
+private:
+    QString objectPath() const;
+    void onLayoutsParsed(int run, const QList<StructLayout::Layout> &parsed);
+    void showLayouts();
+    void showSelectedLayout();
+
+    static const int IdleDelayMs = 1000;
+
+    QPointer<CodeEditor> editor;
+    QTimer *idleTimer;
+    QProcess *compileProcess;
+    QProcess *readelfProcess;
+    QTemporaryDir objectDirectory;
+    bool recompilePending;
+    bool parsing;               // 工作线程中正在解析 DWARF
+    bool active;
+    int generation;             // 每次切换编辑器加一，丢弃旧编辑器的分析结果
+    int runningGeneration;
+
+    QLineEdit *flagsEdit;
+    QPushButton *reorderButton;
+    QLabel *statusLabel;
+    QTreeWidget *structTree;
+    QLabel *compareLabel;
+    QPlainTextEdit *layoutEdit;
+
+    QList<StructLayout::Layout> layouts;
+};
@@ -0,0 +1,628 @@
+#include "symbolindex.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char Magic[4] = {'L', 'S', 'Y', 'M'};
+const quint32 FormatVersion = 1;
+
+// 缓存文件布局：Header | FileRecord[] | SymbolRecord[] | 按名字排序的符号编号 quint32[] | 字符串区
+// 文件按路径排序，符号按所在文件分组、文件内按出现顺序；字符串为 UTF-8，不以 0 结尾
+struct Header
+{
+    char magic[4];
+    quint32 version;
+    quint32 fileCount;
+    quint32 symbolCount;
+    quint32 filesOffset;
+    quint32 symbolsOffset;
+    quint32 orderOffset;
+    quint32 stringsOffset;
+    quint32 stringsSize;
+    quint32 reserved;
+};
+
+struct FileRecord
+{
+    quint32 pathOffset;
+    quint32 pathLength;
+    qint64 modifiedTime;
+    qint64 size;
+    quint64 hash;
+    quint32 firstSymbol;
+    quint32 symbolCount;
+};
+
+struct SymbolRecord
+{
+    quint32 nameOffset;
+    quint32 scopeOffset;
+    quint16 nameLength;
+    quint16 scopeLength;
+    quint32 file;
+    quint32 line;
+    quint16 column;
+    quint8 kind;
+    quint8 flags;
+};
+
+static_assert(sizeof(Header) == 40, "符号索引文件头大小不对");
+static_assert(sizeof(FileRecord) == 40, "符号索引文件记录大小不对");
+static_assert(sizeof(SymbolRecord) == 24, "符号索引符号记录大小不对");
+
+const quint8 DefinitionFlag = 1;
+
+quint64 fnv1a(const char *data, qsizetype size)
+{
+    quint64 hash = 14695981039346656037ULL;
+    for (qsizetype i = 0; i < size; ++i) {
+        hash ^= uchar(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+int compareBytes(const char *a, int aLength, const char *b, int bLength)
+{
+    const int result = memcmp(a, b, size_t(qMin(aLength, bLength)));
+    if (result != 0) return result;
+    return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+}
+
+} // namespace
+
+// 不可变的符号表，数据来自映射的缓存文件或内存中的 QByteArray
+class SymbolTable
+{
+public:
+    static std::shared_ptr<const SymbolTable> map(const QString &path)
+    {
+        auto table = std::make_shared<SymbolTable>();
+        table->file.reset(new QFile(path));
+        if (!table->file->open(QIODevice::ReadOnly)) return nullptr;
+        table->size = table->file->size();
+        if (table->size < qint64(sizeof(Header))) return nullptr;
+        table->data = table->file->map(0, table->size);
+        if (!table->data || !table->validate()) return nullptr;
+        return table;
+    }
+
+    static std::shared_ptr<const SymbolTable> fromData(const QByteArray &data)
+    {
+        auto table = std::make_shared<SymbolTable>();
+        table->buffer = data;
+        table->data = reinterpret_cast<const uchar *>(table->buffer.constData());
+        table->size = table->buffer.size();
+        if (table->size < qint64(sizeof(Header)) || !table->validate()) return nullptr;
+        return table;
+    }
+
+    // 映射的缓存文件路径，表在内存中时为空
+    QString mappedPath() const { return file ? file->fileName() : QString(); }
+
+    int fileCount() const { return int(header()->fileCount); }
+    int symbolCount() const { return int(header()->symbolCount); }
+
+    const FileRecord &fileRecord(int index) const
+    {
+        return reinterpret_cast<const FileRecord *>(data + header()->filesOffset)[index];
+    }
+
+    const SymbolRecord &symbolRecord(int id) const
+    {
+        return reinterpret_cast<const SymbolRecord *>(data + header()->symbolsOffset)[id];
+    }
+
+    // 第 position 个名字（按名字排序）对应的符号编号
+    int symbolByName(int position) const
+    {
+        return int(reinterpret_cast<const quint32 *>(data + header()->orderOffset)[position]);
+    }
+
+    const char *string(quint32 offset) const
+    {
+        return reinterpret_cast<const char *>(data + header()->stringsOffset) + offset;
+    }
+
+    QByteArray filePath(int index) const
+    {
+        const FileRecord &record = fileRecord(index);
+        return QByteArray(string(record.pathOffset), int(record.pathLength));
+    }
+
+    int findFile(const QByteArray &path) const
+    {
+        int low = 0;
+        int high = fileCount();
+        while (low < high) {
+            const int middle = (low + high) / 2;
+            const FileRecord &record = fileRecord(middle);
+            const int result = compareBytes(string(record.pathOffset), int(record.pathLength), path.constData(), path.size());
+            if (result == 0) return middle;
+            if (result < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return -1;
+    }
+
+    // 第一个名字不小于 key 的位置
+    int lowerBound(const QByteArray &key) const
+    {
+        int low = 0;
+        int high = symbolCount();
+        while (low < high) {
+            const int middle = (low + high) / 2;
+            const SymbolRecord &record = symbolRecord(symbolByName(middle));
+            if (compareBytes(string(record.nameOffset), record.nameLength, key.constData(), key.size()) < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    bool nameStartsWith(int position, const QByteArray &prefix, bool exact) const
+    {
+        const SymbolRecord &record = symbolRecord(symbolByName(position));
+        if (exact ? record.nameLength != prefix.size() : record.nameLength < prefix.size()) return false;
+        return memcmp(string(record.nameOffset), prefix.constData(), size_t(prefix.size())) == 0;
+    }
+
+private:
+    const Header *header() const { return reinterpret_cast<const Header *>(data); }
+
+    // 缓存文件可能被截断或来自旧版本，所有偏移都检查一遍，之后访问不再检查
+    bool validate() const
+    {
+        const Header *h = header();
+        if (memcmp(h->magic, Magic, sizeof(Magic)) != 0 || h->version != FormatVersion) return false;
+
+        const quint64 total = quint64(size);
+        const quint64 filesEnd = quint64(h->filesOffset) + quint64(h->fileCount) * sizeof(FileRecord);
+        const quint64 symbolsEnd = quint64(h->symbolsOffset) + quint64(h->symbolCount) * sizeof(SymbolRecord);
+        const quint64 orderEnd = quint64(h->orderOffset) + quint64(h->symbolCount) * sizeof(quint32);
+        const quint64 stringsEnd = quint64(h->stringsOffset) + h->stringsSize;
+        if (filesEnd > total || symbolsEnd > total || orderEnd > total || stringsEnd > total) return false;
+        if (h->filesOffset % 8 != 0 || h->symbolsOffset % 8 != 0 || h->orderOffset % 4 != 0) return false;
+
+        quint32 expectedSymbol = 0;
+        for (int i = 0; i < fileCount(); ++i) {
+            const FileRecord &record = fileRecord(i);
+            if (quint64(record.pathOffset) + record.pathLength > h->stringsSize) return false;
+            if (record.firstSymbol != expectedSymbol) return false;
+            expectedSymbol += record.symbolCount;
+            if (expectedSymbol > h->symbolCount) return false;
+        }
+        if (expectedSymbol != h->symbolCount) return false;
+
+        for (int id = 0; id < symbolCount(); ++id) {
+            const SymbolRecord &record = symbolRecord(id);
+            if (quint64(record.nameOffset) + record.nameLength > h->stringsSize) return false;
+            if (quint64(record.scopeOffset) + record.scopeLength > h->stringsSize) return false;
+            if (record.file >= h->fileCount || record.kind > SymbolScanner::Typedef) return false;
+            if (quint32(symbolByName(id)) >= h->symbolCount) return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<QFile> file;
+    QByteArray buffer;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+};
+
+SymbolIndex::SymbolIndex(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , generation(0)
+    , running(false)
+    , updatePending(false)
+    , pendingFullCheck(false)
+{
+    // 读文件和扫描各占一部分，留一个核给界面
+    pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+SymbolIndex::~SymbolIndex()
+{
+    close();
+    pool->waitForDone();
+}
+
+QStringList SymbolIndex::cachePathsFor(const QString &root)
+{
+    const QByteArray key = QCryptographicHash::hash(QDir::cleanPath(root).toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/symbols/" + QString::fromLatin1(key);
+    return {base + ".idx", base + ".1.idx"};
+}
+
+void SymbolIndex::open(const QString &root)
+{
+    close();
+    this->root = root;
+
+    // 旧文件没能删除时两个都在，用较新的那个
+    QStringList paths = cachePathsFor(root);
+    if (QFileInfo(paths[1]).lastModified() > QFileInfo(paths[0]).lastModified()) paths.swapItemsAt(0, 1);
+    for (const QString &path : std::as_const(paths)) {
+        table = SymbolTable::map(path);
+        if (table) break;
+    }
+}
+
+void SymbolIndex::close()
+{
+    // 递增代号后，正在进行的更新的结果被丢弃
+    ++generation;
+    if (state) state->cancelled = true;
+    state.reset();
+    table.reset();
+    root.clear();
+    running = false;
+    updatePending = false;
+    pendingFullCheck = false;
+    pendingFiles.clear();
+    pendingChanged.clear();
+}
+
+void SymbolIndex::update(const QStringList &relativePaths, const QStringList &changedFiles)
+{
+    if (root.isEmpty()) return;
+
+    if (running) {
+        updatePending = true;
+        pendingFiles = relativePaths;
+        if (changedFiles.isEmpty()) {
+            pendingFullCheck = true;
+        } else {
+            for (const QString &file : changedFiles) pendingChanged.insert(file);
+        }
+        return;
+    }
+
+    state = std::make_shared<State>();
+    state->root = root;
+    const QStringList cachePaths = cachePathsFor(root);
+    state->cachePath = table && table->mappedPath() == cachePaths[0] ? cachePaths[1] : cachePaths[0];
+    state->generation = ++generation;
+    state->files = relativePaths;
+    // 没有旧索引时只能全部检查
+    if (table) {
+        for (const QString &file : changedFiles) state->changed.insert(file);
+    }
+    state->table = table;
+    state->results.resize(size_t(relativePaths.size()));
+    state->timer.start();
+
+    running = true;
+    const int workers = qMax(1, qMin(pool->maxThreadCount(), int(relativePaths.size() / ChunkSize) + 1));
+    state->workers = workers;
+    for (int worker = 0; worker < workers; ++worker) {
+        std::shared_ptr<State> workerState = state;
+        pool->start(QRunnable::create([this, workerState]() {
+            runWorker(workerState);
+        }));
+    }
+}
+
+void SymbolIndex::runWorker(const std::shared_ptr<State> &updateState)
+{
+    const int count = int(updateState->files.size());
+    while (!updateState->cancelled) {
+        const int first = updateState->next.fetch_add(ChunkSize, std::memory_order_relaxed);
+        if (first >= count) break;
+        const int last = qMin(first + ChunkSize, count);
+        for (int i = first; i < last; ++i) indexFile(*updateState, i);
+    }
+
+    // 最后一个结束的线程负责生成新的索引
+    if (updateState->workers.fetch_sub(1) == 1 && !updateState->cancelled) finishUpdate(updateState);
+}
+
+void SymbolIndex::indexFile(State &updateState, int index)
+{
+    const QString &relativePath = updateState.files.at(index);
+    FileData &data = updateState.results[size_t(index)];
+    data.path = relativePath.toUtf8();
+
+    const SymbolTable *old = updateState.table.get();
+    const int oldFile = old ? old->findFile(data.path) : -1;
+    if (oldFile >= 0 && !updateState.changed.isEmpty() && !updateState.changed.contains(relativePath)) {
+        const FileRecord &record = old->fileRecord(oldFile);
+        data.modifiedTime = record.modifiedTime;
+        data.size = record.size;
+        data.hash = record.hash;
+        data.oldFile = oldFile;
+        return;
+    }
+
+    const QFileInfo info(updateState.root + '/' + relativePath);
+    if (!info.isFile()) {
+        data.path.clear();
+        return;
+    }
+    data.modifiedTime = info.lastModified().toMSecsSinceEpoch();
+    data.size = info.size();
+    if (oldFile >= 0) {
+        const FileRecord &record = old->fileRecord(oldFile);
+        if (record.modifiedTime == data.modifiedTime && record.size == data.size) {
+            data.hash = record.hash;
+            data.oldFile = oldFile;
+            return;
+        }
+    }
+
+    // 修改时间或大小变了，至少要把新的时间写回缓存
+    updateState.dirty = true;
+    if (data.size > MaxFileSize) return;
+
+    QFile file(info.filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        data.path.clear();
+        return;
+    }
+    const qint64 fileSize = file.size();
+    const uchar *mapped = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    QByteArray content;
+    const char *bytes = reinterpret_cast<const char *>(mapped);
+    qsizetype length = fileSize;
+    if (!mapped) {
+        content = file.readAll();
+        bytes = content.constData();
+        length = content.size();
+    }
+
+    // 只是时间变了（切换分支、touch）时内容哈希相同，不必重新扫描
+    data.hash = fnv1a(bytes, length);
+    if (oldFile >= 0 && old->fileRecord(oldFile).hash == data.hash) {
+        data.oldFile = oldFile;
+        return;
+    }
+
+    data.symbols = SymbolScanner::scan(bytes, length);
+    updateState.scanned.fetch_add(1, std::memory_order_relaxed);
+}
+
+QByteArray SymbolIndex::buildTable(std::vector<FileData> &files, const SymbolTable *old)
+{
+    files.erase(std::remove_if(files.begin(), files.end(), [](const FileData &data) {
+        return data.path.isEmpty();
+    }), files.end());
+    std::sort(files.begin(), files.end(), [](const FileData &a, const FileData &b) {
+        return compareBytes(a.path.constData(), a.path.size(), b.path.constData(), b.path.size()) < 0;
+    });
+
+    // 同名的作用域、名字和路径在字符串区只存一份
+    QByteArray strings;
+    QHash<QByteArray, quint32> stringOffsets;
+    auto intern = [&](const QByteArray &text) -> quint32 {
+        auto it = stringOffsets.constFind(text);
+        if (it != stringOffsets.constEnd()) return it.value();
+        const quint32 offset = quint32(strings.size());
+        strings.append(text);
+        stringOffsets.insert(QByteArray(text.constData(), text.size()), offset);
+        return offset;
+    };
+
+    QVector<FileRecord> fileRecords;
+    QVector<SymbolRecord> symbolRecords;
+    fileRecords.reserve(int(files.size()));
+    for (const FileData &data : files) {
+        FileRecord record;
+        record.pathOffset = intern(data.path);
+        record.pathLength = quint32(data.path.size());
+        record.modifiedTime = data.modifiedTime;
+        record.size = data.size;
+        record.hash = data.hash;
+        record.firstSymbol = quint32(symbolRecords.size());
+        const quint32 fileNumber = quint32(fileRecords.size());
+
+        if (data.oldFile >= 0 && old) {
+            const FileRecord &oldRecord = old->fileRecord(data.oldFile);
+            for (quint32 i = 0; i < oldRecord.symbolCount; ++i) {
+                SymbolRecord symbol = old->symbolRecord(int(oldRecord.firstSymbol + i));
+                symbol.nameOffset = intern(QByteArray::fromRawData(old->string(symbol.nameOffset), symbol.nameLength));
+                symbol.scopeOffset = intern(QByteArray::fromRawData(old->string(symbol.scopeOffset), symbol.scopeLength));
+                symbol.file = fileNumber;
+                symbolRecords.append(symbol);
+            }
+        } else {
+            for (const SymbolScanner::Symbol &symbol : data.symbols) {
+                if (symbol.name.size() > 0xFFFF || symbol.scope.size() > 0xFFFF) continue;
+                SymbolRecord record;
+                record.nameOffset = intern(symbol.name);
+                record.scopeOffset = intern(symbol.scope);
+                record.nameLength = quint16(symbol.name.size());
+                record.scopeLength = quint16(symbol.scope.size());
+                record.file = fileNumber;
+                record.line = quint32(symbol.line);
+                record.column = quint16(qMin(symbol.column, 0xFFFF));
+                record.kind = quint8(symbol.kind);
+                record.flags = symbol.definition ? DefinitionFlag : 0;
+                symbolRecords.append(record);
+            }
+        }
+
+        record.symbolCount = quint32(symbolRecords.size()) - record.firstSymbol;
+        fileRecords.append(record);
+    }
+
+    // 名字相同时定义排在声明前面
+    QVector<quint32> order(symbolRecords.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = quint32(i);
+    const char *text = strings.constData();
+    std::sort(order.begin(), order.end(), [&](quint32 a, quint32 b) {
+        const SymbolRecord &left = symbolRecords[int(a)];
+        const SymbolRecord &right = symbolRecords[int(b)];
+        const int result = compareBytes(text + left.nameOffset, left.nameLength, text + right.nameOffset, right.nameLength);
+        if (result != 0) return result < 0;
+        if ((left.flags & DefinitionFlag) != (right.flags & DefinitionFlag)) return (left.flags & DefinitionFlag) != 0;
+        return a < b;
+    });
+
+    Header header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = FormatVersion;
+    header.fileCount = quint32(fileRecords.size());
+    header.symbolCount = quint32(symbolRecords.size());
+    header.filesOffset = sizeof(Header);
+    header.symbolsOffset = header.filesOffset + header.fileCount * sizeof(FileRecord);
+    header.orderOffset = header.symbolsOffset + header.symbolCount * sizeof(SymbolRecord);
+    header.stringsOffset = header.orderOffset + header.symbolCount * sizeof(quint32);
+    header.stringsSize = quint32(strings.size());
+    header.reserved = 0;
+
+    QByteArray result;
+    result.reserve(qsizetype(header.stringsOffset) + strings.size());
+    result.append(reinterpret_cast<const char *>(&header), sizeof(Header));
+    result.append(reinterpret_cast<const char *>(fileRecords.constData()), fileRecords.size() * qsizetype(sizeof(FileRecord)));
+    result.append(reinterpret_cast<const char *>(symbolRecords.constData()), symbolRecords.size() * qsizetype(sizeof(SymbolRecord)));
+    result.append(reinterpret_cast<const char *>(order.constData()), order.size() * qsizetype(sizeof(quint32)));
+    result.append(strings);
+    return result;
+}
+
+void SymbolIndex::finishUpdate(const std::shared_ptr<State> &updateState)
+{
+    std::shared_ptr<const SymbolTable> result = updateState->table;
+
+    int remaining = 0;
+    for (const FileData &data : updateState->results) {
+        if (!data.path.isEmpty()) ++remaining;
+    }
+    if (!result || updateState->dirty || remaining != result->fileCount()) {
+        const QByteArray data = buildTable(updateState->results, updateState->table.get());
+        result = SymbolTable::fromData(data);
+
+        // 写入缓存后改用映射，内存中的副本随之释放；写不进去时继续用内存中的表
+        QDir().mkpath(QFileInfo(updateState->cachePath).absolutePath());
+        QSaveFile cache(updateState->cachePath);
+        if (cache.open(QIODevice::WriteOnly) && cache.write(data) == data.size() && cache.commit()) {
+            std::shared_ptr<const SymbolTable> mapped = SymbolTable::map(updateState->cachePath);
+            if (mapped) result = mapped;
+        }
+    }
+    updateState->results.clear();
+    // 界面线程替换后旧表只剩这一处引用，先释放，旧的缓存文件才能在替换后删除
+    updateState->table.reset();
+
+    const int updateGeneration = updateState->generation;
+    const int scanned = updateState->scanned.load();
+    const qint64 elapsedMs = updateState->timer.elapsed();
+    QMetaObject::invokeMethod(this, [this, updateGeneration, result, scanned, elapsedMs]() {
+        if (updateGeneration != generation) return;
+
+        table = result;
+        state.reset();
+        running = false;
+        // 旧表的映射已随上面的替换释放
+        if (table && !table->mappedPath().isEmpty()) {
+            for (const QString &path : cachePathsFor(root)) {
+                if (path != table->mappedPath()) QFile::remove(path);
+            }
+        }
+        emit updated(fileCount(), symbolCount(), scanned, elapsedMs);
+
+        if (updatePending) {
+            const QStringList files = pendingFiles;
+            const QStringList changed = pendingFullCheck ? QStringList() : QStringList(pendingChanged.values());
+            updatePending = false;
+            pendingFullCheck = false;
+            pendingFiles.clear();
+            pendingChanged.clear();
+            update(files, changed);
+        }
+    }, Qt::QueuedConnection);
+}
+
+int SymbolIndex::fileCount() const
+{
+    return table ? table->fileCount() : 0;
+}
+
+int SymbolIndex::symbolCount() const
+{
+    return table ? table->symbolCount() : 0;
+}
+
+SymbolIndex::Symbol SymbolIndex::symbolAt(int id) const
+{
+    const SymbolRecord &record = table->symbolRecord(id);
+    Symbol symbol;
+    symbol.name = QString::fromUtf8(table->string(record.nameOffset), record.nameLength);
+    symbol.scope = QString::fromUtf8(table->string(record.scopeOffset), record.scopeLength);
+    symbol.filePath = QString::fromUtf8(table->filePath(int(record.file)));
+    symbol.line = int(record.line);
+    symbol.column = int(record.column);
+    symbol.kind = SymbolScanner::Kind(record.kind);
+    symbol.definition = (record.flags & DefinitionFlag) != 0;
+    return symbol;
+}
+
+QList<SymbolIndex::Symbol> SymbolIndex::find(const QString &name) const
+{
+    QList<Symbol> symbols;
+    if (!table || name.isEmpty()) return symbols;
+
+    const QByteArray key = name.toUtf8();
+    for (int position = table->lowerBound(key); position < table->symbolCount(); ++position) {
+        if (!table->nameStartsWith(position, key, true)) break;
+        symbols.append(symbolAt(table->symbolByName(position)));
+    }
+    return symbols;
+}
+
+QList<SymbolIndex::Symbol> SymbolIndex::findPrefix(const QString &prefix, int limit) const
+{
+    QList<Symbol> symbols;
+    if (!table || prefix.isEmpty()) return symbols;
+
+    const QByteArray key = prefix.toUtf8();
+    for (int position = table->lowerBound(key); position < table->symbolCount() && symbols.size() < limit; ++position) {
+        if (!table->nameStartsWith(position, key, false)) break;
+        symbols.append(symbolAt(table->symbolByName(position)));
+    }
+    return symbols;
+}
+
+QList<SymbolIndex::Symbol> SymbolIndex::symbolsInFile(const QString &relativePath) const
+{
+    QList<Symbol> symbols;
+    if (!table) return symbols;
+
+    const int file = table->findFile(relativePath.toUtf8());
+    if (file < 0) return symbols;
+    const FileRecord &record = table->fileRecord(file);
+    symbols.reserve(int(record.symbolCount));
+    for (quint32 i = 0; i < record.symbolCount; ++i) {
+        symbols.append(symbolAt(int(record.firstSymbol + i)));
+    }
+    return symbols;
+}
+
+bool SymbolIndex::isFileCurrent(const QString &relativePath) const
+{
+    if (!table) return false;
+
+    const int file = table->findFile(relativePath.toUtf8());
+    if (file < 0) return false;
+    const FileRecord &record = table->fileRecord(file);
+    const QFileInfo info(root + '/' + relativePath);
+    return info.isFile() && info.size() == record.size && info.lastModified().toMSecsSinceEpoch() == record.modifiedTime;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "symbolscanner.h"
+
+class SymbolTable;
+
+// 项目符号索引
+// 工作线程并行扫描源文件和头文件中的声明，结果写成紧凑的二进制缓存：文件表、符号表、
+// 按名字排序的符号编号和去重的字符串区。再次打开项目时直接映射缓存文件，不需要解析就能查询，
+// 之后只重新扫描修改时间或大小变化、并且内容哈希也变了的文件。按名字查找是对映射内存的二分查找，
+// 供转到定义、文件大纲和跨文件补全使用。
+class SymbolIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Symbol
+    {
+        QString name;
+        QString scope;
+        QString filePath;       // 相对项目根目录
+        int line = 0;
+        int column = 0;
+        SymbolScanner::Kind kind = SymbolScanner::Function;
+        bool definition = false;
+
+        QString qualifiedName() const { return scope.isEmpty() ? name : scope + "::" + name; }
+    };
+
+    explicit SymbolIndex(QObject *parent = nullptr);
+    ~SymbolIndex();
+
+    // 映射 root 上次保存的索引，立即可以查询（内容可能已经过期，随后调用 update）
+    void open(const QString &root);
+    void close();
+    // relativePaths 为项目中全部需要索引的文件；changedFiles 不为空时只检查其中的文件和新出现的文件，
+    // 其余沿用上次的结果。正在更新时请求会合并，本次结束后再执行一次
+    void update(const QStringList &relativePaths, const QStringList &changedFiles = QStringList());
+    bool isUpdating() const { return running; }
+
+    QString rootPath() const { return root; }
+    int fileCount() const;
+    int symbolCount() const;
+
+    QList<Symbol> find(const QString &name) const;
+    // 名字以 prefix 开头的符号，按名字排序
+    QList<Symbol> findPrefix(const QString &prefix, int limit) const;
+    // 按在文件中出现的顺序
+    QList<Symbol> symbolsInFile(const QString &relativePath) const;
+    // 磁盘上的文件与索引时的修改时间和大小一致
+    bool isFileCurrent(const QString &relativePath) const;
+
+signals:
+    void updated(int fileCount, int symbolCount, int scannedFiles, qint64 elapsedMs);
+
+private:
+    struct FileData
+    {
+        QByteArray path;            // UTF-8，为空表示文件已不存在
+        qint64 modifiedTime = 0;
+        qint64 size = 0;
+        quint64 hash = 0;
+        int oldFile = -1;           // 沿用旧索引中这个文件的符号
+        QList<SymbolScanner::Symbol> symbols;
+    };
+
+    struct State
+    {
+        QString root;
+        QString cachePath;
+        int generation = 0;
+        QStringList files;
+        QSet<QString> changed;      // 为空表示检查全部文件
+        std::shared_ptr<const SymbolTable> table;
+        std::vector<FileData> results;  // 与 files 一一对应，每项只由一个线程写
+        std::atomic<int> next{0};
+        std::atomic<int> workers{0};
+        std::atomic<int> scanned{0};
+        std::atomic<bool> dirty{false};
+        std::atomic<bool> cancelled{false};
+        QElapsedTimer timer;
+    };
+
+    static const int ChunkSize = 16;
+    static const qint64 MaxFileSize = 16 * 1024 * 1024;    // 更大的文件多半是生成的代码，只登记不扫描
+
+    // 缓存在两个文件之间交替写入：新索引写到当前没有映射的那个，替换后删除另一个。
+    // 正在映射的文件不能被覆盖（Windows 上改名和删除都会失败）
+    static QStringList cachePathsFor(const QString &root);
+    static void indexFile(State &updateState, int index);
+    // files 中路径为空的项被忽略，其余按路径排序后写入
+    static QByteArray buildTable(std::vector<FileData> &files, const SymbolTable *old);
+    void runWorker(const std::shared_ptr<State> &updateState);
+    void finishUpdate(const std::shared_ptr<State> &updateState);
+    Symbol symbolAt(int id) const;
+
+    QThreadPool *pool;
+    std::shared_ptr<const SymbolTable> table;
+    std::shared_ptr<State> state;
+    QString root;
+    int generation;
+    bool running;
+
+    // 更新期间到来的请求
+    bool updatePending;
+    bool pendingFullCheck;
+    QStringList pendingFiles;
+    QSet<QString> pendingChanged;
+};
@@ -0,0 +1,74 @@
+#include "symbolizer.h"
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QStringList>
+
+QList<Symbolizer::Location> Symbolizer::symbolize(const QString &module, const QList<quint64> &offsets)
+{
+    QList<Location> locations;
+    locations.reserve(offsets.size());
+
+    QString addr2line = QStandardPaths::findExecutable("addr2line");
+    if (addr2line.isEmpty() || offsets.isEmpty() || !QFileInfo::exists(module)) {
+        for (int i = 0; i < offsets.size(); ++i) locations.append(Location());
+        return locations;
+    }
+
+    QStringList arguments;
+    arguments << "-C" << "-f" << "-e" << module;
+    for (quint64 offset : offsets) {
+        arguments << "0x" + QString::number(offset, 16);
+    }
+
+    QProcess process;
+    process.start(addr2line, arguments);
+    process.waitForFinished(10000);
+
+    // addr2line 每个地址输出两行：函数名、文件:行号
+    QStringList lines = QString::fromUtf8(process.readAllStandardOutput()).split('\n');
+    for (int i = 0; i < offsets.size(); ++i) {
+        Location location;
+        if (2 * i + 1 < lines.size()) {
+            location.function = lines[2 * i].trimmed();
+            QString fileLine = lines[2 * i + 1].trimmed();
+            // 去掉 "(discriminator N)" 之类的后缀
+            int space = fileLine.indexOf(' ');
+            if (space > 0) fileLine.truncate(space);
+            int colon = fileLine.lastIndexOf(':');
+            if (colon > 0) {
+                QString file = fileLine.left(colon);
+                int line = fileLine.mid(colon + 1).toInt();
+                if (file != "??" && line > 0) {
+                    location.file = file;
+                    location.line = line;
+                }
+            }
+            if (location.function == "??") location.function.clear();
+        }
+        locations.append(location);
+    }
+    return locations;
+}
+
+QHash<QString, QHash<quint64, Symbolizer::Location>> Symbolizer::symbolizeAll(
+    const QHash<QString, QList<quint64>> &offsetsByModule)
+{
+    QHash<QString, QHash<quint64, Location>> result;
+    for (auto it = offsetsByModule.constBegin(); it != offsetsByModule.constEnd(); ++it) {
+        QList<Location> locations = symbolize(it.key(), it.value());
+        QHash<quint64, Location> &moduleResult = result[it.key()];
+        for (int i = 0; i < it.value().size(); ++i) {
+            moduleResult.insert(it.value()[i], locations[i]);
+        }
+    }
+    return result;
+}
+
+bool Symbolizer::isUserSource(const QString &file)
+{
+    if (file.isEmpty()) return false;
+    if (file.startsWith("/usr/") || file.startsWith("/lib") || file.startsWith("/opt/")) return false;
+    if (file.contains("/gcc/") || file.contains("/sanitizer_common/") || file.contains("/asan/")) return false;
+    return QFileInfo::exists(file);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QHash>
+
+// 地址符号化：把 "模块+偏移" 解析为函数名和源码位置
+// 优先使用 addr2line（binutils），同一模块的地址一次批量解析
+class Symbolizer
+{
+public:
+    struct Location
+    {
+        QString function;
+        QString file;
+        int line = 0;
+
+        bool isValid() const { return !file.isEmpty() && line > 0; }
+    };
+
+    static QList<Location> symbolize(const QString &module, const QList<quint64> &offsets);
+
+    // 按模块分组批量解析，返回 "模块 -> (偏移 -> 位置)"
+    static QHash<QString, QHash<quint64, Location>> symbolizeAll(
+        const QHash<QString, QList<quint64>> &offsetsByModule);
+
+    // 源文件是否属于用户代码（排除系统头文件和运行库）
+    static bool isUserSource(const QString &file);
+};
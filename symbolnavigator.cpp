@@ -0,0 +1,190 @@
+#include "symbolnavigator.h"
+#include <QFile>
+#include <QRegularExpression>
+#include <algorithm>
+
+SymbolNavigator::SymbolNavigator(QObject *parent)
+    : QObject(parent)
+    , searcher(new ProjectSearcher(this))
+    , symbolIndex(nullptr)
+    , fileIndex(nullptr)
+{
+    connect(searcher, &ProjectSearcher::matchesFound, this, &SymbolNavigator::onMatchesFound);
+    connect(searcher, &ProjectSearcher::finished, this, &SymbolNavigator::onSearchFinished);
+}
+
+void SymbolNavigator::setProject(const SymbolIndex *index, const FileIndex *files, const QString &rootPath)
+{
+    symbolIndex = index;
+    fileIndex = files;
+    root = rootPath;
+}
+
+void SymbolNavigator::cancel()
+{
+    searcher->cancel();
+    textMatches.clear();
+}
+
+QString SymbolNavigator::declarationPattern(const QString &name)
+{
+    // 只用 [ \t]，整个文件按多行模式匹配时不会跨行
+    const QString n = QRegularExpression::escape(name);
+    const QString type = "(?:[\\w:]+(?:<[^;()\\n]*>)?[ \\t*&]+)+";
+    // 排除以语句关键字开头的行和前置声明 class Foo;
+    const QString notStatement = "(?!(?:return|else|case|new|delete|throw|goto|friend|co_return|co_yield)\\b"
+                                 "|(?:class|struct|union|enum)[ \\t]+[\\w:]+[ \\t]*;)";
+    return QStringList{
+        "^[ \\t]*#[ \\t]*define[ \\t]+" + n + "\\b",
+        "\\b(?:class|struct|union|enum|namespace)[ \\t]+(?:\\w+[ \\t]+)*" + n + "\\b(?![ \\t]*;)",
+        "\\b(?:typedef\\b[^;\\n]*|using[ \\t]+)\\b" + n + "\\b",
+        "^[ \\t]*" + notStatement + type + "(?:\\w+::)*~?" + n + "[ \\t]*[(=;\\[{]",
+        "^[ \\t]*(?:\\w+::)+~?" + n + "[ \\t]*\\(",
+    }.join('|');
+}
+
+SymbolNavigator::Target SymbolNavigator::targetFor(SymbolScanner::Kind kind, const QString &name, const QString &scope,
+                                                   const QString &filePath, int line, int column, bool definition)
+{
+    Target target;
+    target.filePath = filePath;
+    target.line = line;
+    target.column = column;
+    target.scope = scope;
+    target.description = SymbolScanner::kindName(kind) + ' ' + (scope.isEmpty() ? name : scope + "::" + name);
+    target.definition = definition;
+    return target;
+}
+
+void SymbolNavigator::goToDefinition(const QString &name, const QString &qualifier, const QString &currentFile, int currentLine)
+{
+    cancel();
+    request.name = name;
+    request.qualifier = qualifier;
+    request.currentFile = currentFile;
+    request.currentLine = currentLine;
+    if (name.isEmpty()) {
+        emit targetsFound(name, QList<Target>(), false);
+        return;
+    }
+
+    QHash<QString, QString> buffers = bufferProvider ? bufferProvider() : QHash<QString, QString>();
+    QList<Target> targets;
+    bool stale = false;
+
+    if (symbolIndex) {
+        // 每个候选文件只检查一次修改时间
+        QHash<QString, bool> current;
+        for (const SymbolIndex::Symbol &symbol : symbolIndex->find(name)) {
+            const QString filePath = root + '/' + symbol.filePath;
+            if (buffers.contains(filePath)) continue;
+
+            auto it = current.find(symbol.filePath);
+            if (it == current.end()) it = current.insert(symbol.filePath, symbolIndex->isFileCurrent(symbol.filePath));
+            if (!it.value()) {
+                stale = true;
+                continue;
+            }
+            targets.append(targetFor(symbol.kind, symbol.name, symbol.scope, filePath, symbol.line, symbol.column,
+                                     symbol.definition));
+        }
+    }
+
+    // 项目之外的当前文件不在索引中，和未保存的内容一样当场扫描
+    const QHash<QString, QString> unsaved = buffers;
+    if (!currentFile.isEmpty() && !buffers.contains(currentFile) && (root.isEmpty() || !currentFile.startsWith(root + '/'))) {
+        QFile file(currentFile);
+        if (file.open(QIODevice::ReadOnly)) buffers.insert(currentFile, QString::fromUtf8(file.readAll()));
+    }
+
+    const QByteArray key = name.toUtf8();
+    for (auto it = buffers.constBegin(); it != buffers.constEnd(); ++it) {
+        if (!it.value().contains(name)) continue;
+        const QByteArray content = it.value().toUtf8();
+        for (const SymbolScanner::Symbol &symbol : SymbolScanner::scan(content.constData(), content.size())) {
+            if (symbol.name != key) continue;
+            targets.append(targetFor(symbol.kind, name, QString::fromUtf8(symbol.scope), it.key(), symbol.line, symbol.column,
+                                     symbol.definition));
+        }
+    }
+
+    // 索引过期或者没有找到时改为文本查找；光标所在处就是唯一结果时不必再找
+    if ((stale || targets.isEmpty()) && startTextSearch(unsaved)) return;
+    emit targetsFound(name, rank(targets), false);
+}
+
+bool SymbolNavigator::startTextSearch(const QHash<QString, QString> &buffers)
+{
+    if (!fileIndex || root.isEmpty()) return false;
+
+    ProjectSearcher::Options options;
+    options.pattern = declarationPattern(request.name);
+    options.caseSensitive = true;
+    options.regularExpression = true;
+
+    textMatches.clear();
+    const QStringList files = fileIndex->filesInCategory(FileIndex::Source) + fileIndex->filesInCategory(FileIndex::Header);
+    return searcher->start(root, files, buffers, options);
+}
+
+void SymbolNavigator::onMatchesFound(const QList<ProjectSearcher::Match> &matches)
+{
+    textMatches += matches;
+}
+
+void SymbolNavigator::onSearchFinished(int fileCount, int matchCount, bool truncated, qint64 elapsedMs)
+{
+    Q_UNUSED(fileCount)
+    Q_UNUSED(matchCount)
+    Q_UNUSED(truncated)
+    Q_UNUSED(elapsedMs)
+
+    // 匹配从声明开头算起，名字本身的位置在行内再找一次
+    const QRegularExpression word("\\b" + QRegularExpression::escape(request.name) + "\\b");
+    QList<Target> targets;
+    for (const ProjectSearcher::Match &match : std::as_const(textMatches)) {
+        const QRegularExpressionMatch found = word.match(match.lineText, match.column - 1);
+        const QString text = match.lineText.trimmed();
+
+        Target target;
+        target.filePath = match.filePath;
+        target.line = match.line;
+        target.column = found.hasMatch() ? int(found.capturedStart()) + 1 : match.column;
+        target.description = text;
+        // 以分号结尾并带参数列表的多半是函数声明
+        target.definition = !(text.endsWith(';') && text.contains('('));
+        targets.append(target);
+    }
+    textMatches.clear();
+
+    emit targetsFound(request.name, rank(targets), true);
+}
+
+QList<SymbolNavigator::Target> SymbolNavigator::rank(QList<Target> targets) const
+{
+    targets.erase(std::remove_if(targets.begin(), targets.end(), [this](const Target &target) {
+        return target.filePath == request.currentFile && target.line == request.currentLine;
+    }), targets.end());
+
+    // 有限定名时只保留作用域相符的（都不相符时保留全部）
+    if (!request.qualifier.isEmpty()) {
+        QList<Target> qualified;
+        for (const Target &target : std::as_const(targets)) {
+            if (target.scope == request.qualifier || target.scope.endsWith("::" + request.qualifier)) {
+                qualified.append(target);
+            }
+        }
+        if (!qualified.isEmpty()) targets = qualified;
+    }
+
+    // 定义在前，同一文件中的更靠前
+    std::stable_sort(targets.begin(), targets.end(), [this](const Target &a, const Target &b) {
+        if (a.definition != b.definition) return a.definition;
+        const bool aLocal = a.filePath == request.currentFile;
+        const bool bLocal = b.filePath == request.currentFile;
+        if (aLocal != bLocal) return aLocal;
+        if (a.filePath != b.filePath) return a.filePath < b.filePath;
+        return a.line < b.line;
+    });
+    return targets;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <functional>
+
+#include "fileindex.h"
+#include "symbolindex.h"
+#include "projectsearcher.h"
+
+// 转到定义
+// 先在符号索引中按名字二分查找；已修改未保存的编辑器内容当场扫描，代替索引中这些文件的结果。
+// 候选文件在建立索引之后被修改过、或者索引中根本没有这个名字（索引尚未建好或扫描器漏掉了）时，
+// 改为在后台按声明的写法做一次文本查找，结果同样通过 targetsFound 发出。
+class SymbolNavigator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Target
+    {
+        QString filePath;       // 绝对路径
+        int line = 0;           // 从 1 开始
+        int column = 0;         // 从 1 开始
+        QString scope;
+        QString description;    // 显示用，如“函数 ns::Foo::bar”
+        bool definition = false;
+    };
+
+    // 返回未保存的已打开文件（绝对路径 -> 编辑器中的内容）
+    using BufferProvider = std::function<QHash<QString, QString>()>;
+
+    explicit SymbolNavigator(QObject *parent = nullptr);
+
+    void setProject(const SymbolIndex *index, const FileIndex *files, const QString &rootPath);
+    void setBufferProvider(const BufferProvider &provider) { bufferProvider = provider; }
+
+    // qualifier 为名字前面的 A::B 限定部分；光标所在的位置本身不算结果，在定义处再次查找会转到声明
+    void goToDefinition(const QString &name, const QString &qualifier, const QString &currentFile, int currentLine);
+    void cancel();
+    bool isSearching() const { return searcher->isRunning(); }
+
+    // 文本查找用的正则表达式：宏、类型、类型别名以及函数和变量声明的常见写法
+    static QString declarationPattern(const QString &name);
+
+signals:
+    // fromTextSearch 为 true 表示结果来自文本查找，可能不完全准确
+    void targetsFound(const QString &name, const QList<SymbolNavigator::Target> &targets, bool fromTextSearch);
+
+private slots:
+    void onMatchesFound(const QList<ProjectSearcher::Match> &matches);
+    void onSearchFinished(int fileCount, int matchCount, bool truncated, qint64 elapsedMs);
+
+private:
+    struct Request
+    {
+        QString name;
+        QString qualifier;
+        QString currentFile;
+        int currentLine = 0;
+    };
+
+    static Target targetFor(SymbolScanner::Kind kind, const QString &name, const QString &scope,
+                            const QString &filePath, int line, int column, bool definition);
+    QList<Target> rank(QList<Target> targets) const;
+    bool startTextSearch(const QHash<QString, QString> &buffers);
+
+    ProjectSearcher *searcher;
+    const SymbolIndex *symbolIndex;
+    const FileIndex *fileIndex;
+    QString root;
+    BufferProvider bufferProvider;
+
+    Request request;
+    QList<ProjectSearcher::Match> textMatches;
+};
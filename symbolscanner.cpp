@@ -0,0 +1,983 @@
+#include "symbolscanner.h"
+#include <QVector>
+#include <cstring>
+
+namespace {
+
+struct Token
+{
+    enum Type : quint8
+    {
+        Identifier,
+        Punct,
+        Literal,
+        MacroName       // #define 后面的名字
+    };
+
+    const char *begin = nullptr;
+    int length = 0;
+    int line = 0;
+    int column = 0;
+    Type type = Punct;
+
+    template<int N>
+    bool is(const char (&text)[N]) const
+    {
+        return length == N - 1 && memcmp(begin, text, N - 1) == 0;
+    }
+    bool isPunct(char c) const { return type == Punct && length == 1 && *begin == c; }
+    bool isIdentifier() const { return type == Identifier; }
+    QByteArray text() const { return QByteArray(begin, length); }
+};
+
+inline bool isIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '$' || uchar(c) >= 0x80;
+}
+
+inline bool isIdentifierChar(char c)
+{
+    return isIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// 字符串前缀：u8 u U L 以及对应的原始字符串 R u8R uR UR LR
+bool isStringPrefix(const char *begin, int length)
+{
+    static const char *const prefixes[] = {"R", "u8", "u", "U", "L", "u8R", "uR", "UR", "LR"};
+    for (const char *prefix : prefixes) {
+        if (int(strlen(prefix)) == length && memcmp(begin, prefix, length) == 0) return true;
+    }
+    return false;
+}
+
+// 跳过注释、字符串、数字和预处理指令，只交出标识符、标点和 #define 的宏名
+class Lexer
+{
+public:
+    Lexer(const char *data, qsizetype size)
+        : p(data)
+        , end(data + size)
+        , lineStart(data)
+    {
+    }
+
+    bool next(Token &token)
+    {
+        while (p < end) {
+            const char c = *p;
+            if (c == '\n') {
+                ++p;
+                ++line;
+                lineStart = p;
+                atLineStart = true;
+                continue;
+            }
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+                ++p;
+                continue;
+            }
+            if (c == '/' && p + 1 < end && p[1] == '/') {
+                skipLineComment();
+                continue;
+            }
+            if (c == '/' && p + 1 < end && p[1] == '*') {
+                skipBlockComment();
+                continue;
+            }
+            if (c == '#' && atLineStart) {
+                if (directive(token)) return true;
+                continue;
+            }
+
+            atLineStart = false;
+            const char *start = p;
+            token.line = line;
+            token.column = column(start);
+
+            if (isIdentifierStart(c)) {
+                while (p < end && isIdentifierChar(*p)) ++p;
+                token.type = Token::Identifier;
+                if (p < end && (*p == '"' || *p == '\'') && isStringPrefix(start, int(p - start))) {
+                    if (*p == '"' && p[-1] == 'R') {
+                        skipRawString();
+                    } else {
+                        skipQuoted(*p);
+                    }
+                    token.type = Token::Literal;
+                }
+            } else if (isDigit(c) || (c == '.' && p + 1 < end && isDigit(p[1]))) {
+                ++p;
+                while (p < end) {
+                    const char d = *p;
+                    const char prev = p[-1];
+                    if (isIdentifierChar(d) || d == '.' || d == '\'') {
+                        ++p;
+                    } else if ((d == '+' || d == '-') && (prev == 'e' || prev == 'E' || prev == 'p' || prev == 'P')) {
+                        ++p;
+                    } else {
+                        break;
+                    }
+                }
+                token.type = Token::Literal;
+            } else if (c == '"' || c == '\'') {
+                skipQuoted(c);
+                token.type = Token::Literal;
+            } else {
+                if (p + 1 < end && ((c == ':' && p[1] == ':') || (c == '-' && p[1] == '>'))) {
+                    p += 2;
+                } else {
+                    ++p;
+                }
+                token.type = Token::Punct;
+            }
+
+            token.begin = start;
+            token.length = int(p - start);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    int column(const char *position) const
+    {
+        // UTF-8 的后续字节不计数，得到的是字符列
+        int count = 1;
+        for (const char *q = lineStart; q < position; ++q) {
+            if ((uchar(*q) & 0xC0) != 0x80) ++count;
+        }
+        return count;
+    }
+
+    void newLineAt(const char *position)
+    {
+        ++line;
+        lineStart = position + 1;
+    }
+
+    void skipLineComment()
+    {
+        while (p < end && *p != '\n') ++p;
+    }
+
+    void skipBlockComment()
+    {
+        p += 2;
+        while (p < end) {
+            if (*p == '*' && p + 1 < end && p[1] == '/') {
+                p += 2;
+                return;
+            }
+            if (*p == '\n') newLineAt(p);
+            ++p;
+        }
+    }
+
+    void skipQuoted(char quote)
+    {
+        ++p;
+        while (p < end) {
+            const char c = *p;
+            if (c == '\\') {
+                if (p + 1 < end && p[1] == '\n') newLineAt(p + 1);
+                p = qMin(p + 2, end);
+            } else if (c == quote) {
+                ++p;
+                return;
+            } else if (c == '\n') {
+                return;     // 未闭合，留给主循环处理换行
+            } else {
+                ++p;
+            }
+        }
+    }
+
+    void skipRawString()
+    {
+        // R"delim( ... )delim"
+        const char *delimiter = p + 1;
+        const char *open = delimiter;
+        while (open < end && *open != '(' && *open != '\n' && open - delimiter <= 16) ++open;
+        if (open >= end || *open != '(') {
+            skipQuoted('"');
+            return;
+        }
+
+        QByteArray closing = ")";
+        closing.append(delimiter, int(open - delimiter));
+        closing.append('"');
+
+        p = open + 1;
+        while (p < end) {
+            if (*p == ')' && end - p >= closing.size() && memcmp(p, closing.constData(), closing.size()) == 0) {
+                p += closing.size();
+                return;
+            }
+            if (*p == '\n') newLineAt(p);
+            ++p;
+        }
+    }
+
+    // p 指向行首的 #；整条指令（含续行）都被跳过，只有 #define 会交出宏名
+    bool directive(Token &token)
+    {
+        ++p;
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        const char *word = p;
+        while (p < end && isIdentifierChar(*p)) ++p;
+
+        bool found = false;
+        if (p - word == 6 && memcmp(word, "define", 6) == 0) {
+            while (p < end && (*p == ' ' || *p == '\t')) ++p;
+            if (p < end && isIdentifierStart(*p)) {
+                token.begin = p;
+                token.line = line;
+                token.column = column(p);
+                token.type = Token::MacroName;
+                while (p < end && isIdentifierChar(*p)) ++p;
+                token.length = int(p - token.begin);
+                found = true;
+            }
+        }
+
+        while (p < end && *p != '\n') {
+            const char c = *p;
+            if (c == '\\' && p + 1 < end && (p[1] == '\n' || (p[1] == '\r' && p + 2 < end && p[2] == '\n'))) {
+                p += p[1] == '\n' ? 1 : 2;
+                newLineAt(p);
+                ++p;
+            } else if (c == '/' && p + 1 < end && p[1] == '*') {
+                skipBlockComment();
+            } else if (c == '/' && p + 1 < end && p[1] == '/') {
+                skipLineComment();
+            } else if (c == '"' || c == '\'') {
+                skipQuoted(c);
+            } else {
+                ++p;
+            }
+        }
+        return found;
+    }
+
+    const char *p;
+    const char *end;
+    const char *lineStart;
+    int line = 1;
+    bool atLineStart = true;
+};
+
+// 按语句收集命名空间或类作用域中的记号，在 { ; } 处判断这条语句声明了什么
+class Parser
+{
+public:
+    Parser(const char *data, qsizetype size)
+        : lexer(data, size)
+    {
+        statement.reserve(256);
+    }
+
+    QList<SymbolScanner::Symbol> run()
+    {
+        Token token;
+        while (lexer.next(token)) {
+            if (token.type == Token::MacroName) {
+                add(token.text(), token, SymbolScanner::Macro, true, QByteArray(), true);
+                continue;
+            }
+
+            // 函数体和花括号初始化只数括号
+            if (bodyDepth > 0) {
+                if (token.isPunct('{')) {
+                    ++bodyDepth;
+                } else if (token.isPunct('}') && --bodyDepth == 0) {
+                    resetStatement();
+                }
+                continue;
+            }
+
+            if (token.type == Token::Punct && token.length == 1) {
+                switch (*token.begin) {
+                case '(':
+                    ++parenDepth;
+                    break;
+                case ')':
+                    if (parenDepth > 0) --parenDepth;
+                    break;
+                case '{':
+                    if (parenDepth == 0) {
+                        openBrace();
+                        continue;
+                    }
+                    break;
+                case '}':
+                    if (parenDepth == 0) {
+                        closeBrace();
+                        continue;
+                    }
+                    break;
+                case ';':
+                    if (parenDepth == 0) {
+                        endStatement();
+                        continue;
+                    }
+                    break;
+                case ',':
+                    if (parenDepth == 0 && inEnum()) {
+                        enumerator();
+                        continue;
+                    }
+                    break;
+                case ':':
+                    if (parenDepth == 0 && isAccessSpecifier()) {
+                        resetStatement();
+                        continue;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // 括号不配对（通常是宏造成的）时不让整个文件变成一条语句
+            if (statement.size() >= MaxStatementTokens) resetStatement();
+            statement.append(token);
+        }
+        return symbols;
+    }
+
+private:
+    enum ScopeType
+    {
+        NamespaceScope,
+        ClassScope,
+        EnumScope,
+        LinkageScope        // extern "C" { }，不改变作用域
+    };
+
+    enum Tail
+    {
+        NoTail,
+        DeclaratorTail,     // struct A { } a, b;
+        TypedefTail         // typedef struct { } Name;
+    };
+
+    struct Scope
+    {
+        ScopeType type;
+        QByteArray name;    // 完整限定名
+        bool typedefTail;
+    };
+
+    // 函数名所在的位置
+    struct FunctionName
+    {
+        int paren = -1;     // 参数列表的左括号
+        int nameToken = -1;
+        int first = -1;     // 限定名的第一个记号
+        QByteArray name;
+        QByteArray qualifier;
+    };
+
+    static const int MaxStatementTokens = 8192;
+
+    static QByteArray join(const QByteArray &scope, const QByteArray &name)
+    {
+        if (scope.isEmpty()) return name;
+        if (name.isEmpty()) return scope;
+        return scope + "::" + name;
+    }
+
+    static bool isMacroLike(const Token &token)
+    {
+        // 全大写的标识符当作宏，如 Q_PROPERTY(...)、Q_DECLARE_METATYPE(...)
+        if (!token.isIdentifier() || token.length < 2) return false;
+        bool hasLetter = false;
+        for (int i = 0; i < token.length; ++i) {
+            const char c = token.begin[i];
+            if (c >= 'A' && c <= 'Z') {
+                hasLetter = true;
+            } else if (c != '_' && !isDigit(c)) {
+                return false;
+            }
+        }
+        return hasLetter;
+    }
+
+    static bool isSpecialCallName(const Token &token)
+    {
+        // 这些名字后面的括号不是参数列表
+        return token.is("alignas") || token.is("__attribute__") || token.is("__declspec") || token.is("decltype")
+            || token.is("noexcept") || token.is("throw") || token.is("sizeof") || token.is("alignof")
+            || token.is("requires") || token.is("typeof") || token.is("__typeof__") || token.is("_Alignas")
+            || token.is("explicit");
+    }
+
+    QByteArray currentScope() const
+    {
+        return scopes.isEmpty() ? QByteArray() : scopes.last().name;
+    }
+
+    bool inEnum() const
+    {
+        return !scopes.isEmpty() && scopes.last().type == EnumScope;
+    }
+
+    bool inClass() const
+    {
+        return !scopes.isEmpty() && scopes.last().type == ClassScope;
+    }
+
+    void resetStatement()
+    {
+        statement.clear();
+        parenDepth = 0;
+    }
+
+    void add(const QByteArray &name, const Token &at, SymbolScanner::Kind kind, bool definition,
+             const QByteArray &qualifier, bool global = false)
+    {
+        if (name.isEmpty()) return;
+        SymbolScanner::Symbol symbol;
+        symbol.name = name;
+        symbol.scope = global ? QByteArray() : join(currentScope(), qualifier);
+        symbol.line = at.line;
+        symbol.column = at.column;
+        symbol.kind = kind;
+        symbol.definition = definition;
+        symbols.append(symbol);
+    }
+
+    // from 指向 open，返回配对的 close 之后的位置
+    int skipGroup(int from, char open, char close) const
+    {
+        int depth = 0;
+        for (int i = from; i < statement.size(); ++i) {
+            if (statement[i].isPunct(open)) {
+                ++depth;
+            } else if (statement[i].isPunct(close) && --depth == 0) {
+                return i + 1;
+            }
+        }
+        return statement.size();
+    }
+
+    // 跳过 template<...>、[[...]] 以及全大写宏调用等前缀，返回声明真正开始的位置
+    int declarationStart() const
+    {
+        const int count = statement.size();
+        int i = 0;
+        while (i < count) {
+            if (statement[i].is("template") && i + 1 < count && statement[i + 1].isPunct('<')) {
+                i = skipGroup(i + 1, '<', '>');
+            } else if (statement[i].isPunct('[') && i + 1 < count && statement[i + 1].isPunct('[')) {
+                i = skipGroup(i, '[', ']');
+            } else if (isMacroLike(statement[i]) && i + 1 < count && statement[i + 1].isPunct('(')) {
+                const int after = skipGroup(i + 1, '(', ')');
+                if (after >= count) break;
+                i = after;
+            } else if (isMacroLike(statement[i]) && i + 1 < count
+                       && (statement[i + 1].is("namespace") || statement[i + 1].is("extern") || statement[i + 1].is("template")
+                           || statement[i + 1].is("typedef") || statement[i + 1].is("using"))) {
+                ++i;    // QT_BEGIN_NAMESPACE namespace Ui { ... }
+            } else {
+                break;
+            }
+        }
+        return i;
+    }
+
+    // index 处的名字前面的 A::B<T>:: 限定部分
+    QByteArray qualifierBefore(int index, int lowerBound, int *first) const
+    {
+        QByteArray qualifier;
+        *first = index;
+        while (index - 2 >= lowerBound && statement[index - 1].is("::")) {
+            int j = index - 2;
+            if (statement[j].isPunct('>')) {
+                int depth = 0;
+                for (; j >= lowerBound; --j) {
+                    if (statement[j].isPunct('>')) {
+                        ++depth;
+                    } else if (statement[j].isPunct('<') && --depth == 0) {
+                        break;
+                    }
+                }
+                --j;
+            }
+            if (j < lowerBound || !statement[j].isIdentifier()) break;
+            qualifier = qualifier.isEmpty() ? statement[j].text() : statement[j].text() + "::" + qualifier;
+            index = j;
+            *first = j;
+        }
+        return qualifier;
+    }
+
+    // 找出函数声明的参数列表和函数名；返回的 paren 为 -1 表示不是函数
+    FunctionName functionName(int from) const
+    {
+        FunctionName result;
+        const int count = statement.size();
+        int parens = 0;
+        int angles = 0;
+        for (int i = from; i < count; ++i) {
+            const Token &token = statement[i];
+            if (parens == 0 && token.is("operator")) {
+                // operator== / operator() / operator bool / operator new[]
+                int paren = i + 1;
+                if (paren + 2 < count && statement[paren].isPunct('(') && statement[paren + 1].isPunct(')')) {
+                    paren += 2;
+                }
+                while (paren < count && !statement[paren].isPunct('(')) ++paren;
+                if (paren >= count) return result;
+
+                result.name = "operator";
+                for (int j = i + 1; j < paren; ++j) {
+                    if (statement[j].isIdentifier() && j == i + 1) result.name += ' ';
+                    result.name += statement[j].text();
+                }
+                result.paren = paren;
+                result.nameToken = i;
+                result.qualifier = qualifierBefore(i, from, &result.first);
+                return result;
+            }
+
+            if (token.type != Token::Punct) continue;
+            if (token.isPunct('(')) {
+                if (parens == 0 && angles == 0 && i > from) {
+                    const Token &prev = statement[i - 1];
+                    const bool pointer = i + 1 < count
+                        && (statement[i + 1].isPunct('*') || statement[i + 1].isPunct('&') || statement[i + 1].isPunct('^'));
+                    if (!pointer && prev.isIdentifier() && !isSpecialCallName(prev)) {
+                        result.paren = i;
+                        result.nameToken = i - 1;
+                        result.name = prev.text();
+                        int nameStart = i - 1;
+                        if (i - 2 >= from && statement[i - 2].isPunct('~')) {
+                            result.name.prepend('~');
+                            result.nameToken = i - 2;
+                            nameStart = i - 2;
+                        }
+                        result.qualifier = qualifierBefore(nameStart, from, &result.first);
+                        return result;
+                    }
+                    if (!pointer && prev.isPunct('>')) {
+                        // foo<int>(...)：模板特化
+                        int j = i - 1;
+                        int depth = 0;
+                        for (; j >= from; --j) {
+                            if (statement[j].isPunct('>')) {
+                                ++depth;
+                            } else if (statement[j].isPunct('<') && --depth == 0) {
+                                break;
+                            }
+                        }
+                        if (j - 1 >= from && statement[j - 1].isIdentifier()) {
+                            result.paren = i;
+                            result.nameToken = j - 1;
+                            result.name = statement[j - 1].text();
+                            result.qualifier = qualifierBefore(j - 1, from, &result.first);
+                            return result;
+                        }
+                    }
+                }
+                ++parens;
+            } else if (token.isPunct(')')) {
+                if (parens > 0) --parens;
+            } else if (parens == 0 && token.isPunct('<') && i > from && statement[i - 1].isIdentifier()) {
+                ++angles;
+            } else if (parens == 0 && token.isPunct('>') && angles > 0) {
+                --angles;
+            } else if (parens == 0 && angles == 0 && token.isPunct('=')) {
+                return result;      // 初始化表达式中的括号不是参数列表
+            }
+        }
+        return result;
+    }
+
+    // 第一个不在括号内的 =，operator= 除外
+    int assignment(int from) const
+    {
+        int depth = 0;
+        for (int i = from; i < statement.size(); ++i) {
+            const Token &token = statement[i];
+            if (token.isPunct('(') || token.isPunct('[')) {
+                ++depth;
+            } else if (token.isPunct(')') || token.isPunct(']')) {
+                if (depth > 0) --depth;
+            } else if (depth == 0 && token.is("operator")) {
+                while (i + 1 < statement.size() && !statement[i + 1].isPunct('(')) ++i;
+            } else if (depth == 0 && token.isPunct('=')) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // 第一个不在括号内的 class/struct/union/enum
+    int classKey(int from) const
+    {
+        int depth = 0;
+        for (int i = from; i < statement.size(); ++i) {
+            const Token &token = statement[i];
+            if (token.isPunct('(') || token.isPunct('<')) {
+                ++depth;
+            } else if (token.isPunct(')') || token.isPunct('>')) {
+                if (depth > 0) --depth;
+            } else if (depth == 0 && (token.is("class") || token.is("struct") || token.is("union") || token.is("enum"))) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    static SymbolScanner::Kind classKind(const Token &key)
+    {
+        if (key.is("struct")) return SymbolScanner::Struct;
+        if (key.is("union")) return SymbolScanner::Union;
+        if (key.is("enum")) return SymbolScanner::Enum;
+        return SymbolScanner::Class;
+    }
+
+    // 关键字之后的类名，如 class EXPORT_MACRO ns::Name final : public Base；没有名字时返回 -1
+    int className(int key, int *identifierCount) const
+    {
+        int name = -1;
+        *identifierCount = 0;
+        int i = key + 1;
+        if (statement[key].is("enum") && i < statement.size() && (statement[i].is("class") || statement[i].is("struct"))) ++i;
+        while (i < statement.size()) {
+            const Token &token = statement[i];
+            if (token.isPunct(':') || token.isPunct('=') || token.isPunct(',')) break;
+            if (token.isPunct('<')) {
+                i = skipGroup(i, '<', '>');
+                continue;
+            }
+            if (token.isPunct('(')) {
+                i = skipGroup(i, '(', ')');
+                continue;
+            }
+            if (token.isPunct('[')) {
+                i = skipGroup(i, '[', ']');
+                continue;
+            }
+            if (token.isIdentifier() && !token.is("final") && !isSpecialCallName(token)) {
+                name = i;
+                ++*identifierCount;
+            }
+            ++i;
+        }
+        return name;
+    }
+
+    // 函数指针声明 (*name)(...) 中的名字
+    int pointerDeclaratorName(int from, int to) const
+    {
+        for (int i = from; i + 1 < to; ++i) {
+            if (!statement[i].isPunct('(')) continue;
+            const Token &next = statement[i + 1];
+            if (!next.isPunct('*') && !next.isPunct('&') && !next.isPunct('^') && !next.isIdentifier()) continue;
+
+            const int close = skipGroup(i, '(', ')') - 1;
+            bool pointer = false;
+            int name = -1;
+            for (int j = i + 1; j < close; ++j) {
+                if (statement[j].isPunct('*') || statement[j].isPunct('&') || statement[j].isPunct('^')) pointer = true;
+                if (statement[j].isIdentifier()) name = j;
+            }
+            if (pointer && name >= 0) return name;
+        }
+        return -1;
+    }
+
+    // 逗号分隔的声明符：int a = 1, *b, c[4];
+    void declarators(int from, SymbolScanner::Kind kind, bool definition, bool requireType)
+    {
+        const int count = statement.size();
+        int start = from;
+        while (start < count) {
+            int end = start;
+            int depth = 0;
+            for (; end < count; ++end) {
+                const Token &token = statement[end];
+                if (token.isPunct('(') || token.isPunct('[') || token.isPunct('{')
+                    || (token.isPunct('<') && end > start && statement[end - 1].isIdentifier())) {
+                    ++depth;
+                } else if (token.isPunct(')') || token.isPunct(']') || token.isPunct('}') || token.isPunct('>')) {
+                    if (depth > 0) --depth;
+                } else if (depth == 0 && token.isPunct(',')) {
+                    break;
+                }
+            }
+
+            int name = pointerDeclaratorName(start, end);
+            if (name < 0) {
+                depth = 0;
+                for (int i = start; i < end; ++i) {
+                    const Token &token = statement[i];
+                    if (depth == 0 && (token.isPunct('=') || token.isPunct('[') || token.isPunct('{') || token.isPunct(':'))) break;
+                    if (token.isPunct('(') || (token.isPunct('<') && i > start && statement[i - 1].isIdentifier())) {
+                        ++depth;
+                    } else if (token.isPunct(')') || token.isPunct('>')) {
+                        if (depth > 0) --depth;
+                    } else if (depth == 0 && token.isIdentifier()) {
+                        name = i;
+                    }
+                }
+            }
+            if (name >= 0 && (!requireType || name > start)) {
+                int first = name;
+                const QByteArray qualifier = qualifierBefore(name, start, &first);
+                add(statement[name].text(), statement[name], kind, definition, qualifier);
+            }
+
+            requireType = false;
+            start = end + 1;
+        }
+    }
+
+    SymbolScanner::Kind variableKind() const
+    {
+        return inClass() ? SymbolScanner::Field : SymbolScanner::Variable;
+    }
+
+    bool isConstructorLike(const FunctionName &function, int start) const
+    {
+        // 没有返回类型的只能是构造/析构函数，否则多半是宏调用
+        if (function.first > start || !function.qualifier.isEmpty()) return true;
+        if (function.name.startsWith('~') || function.name.startsWith("operator")) return true;
+        if (!inClass()) return false;
+        const QByteArray &scope = scopes.last().name;
+        const int separator = scope.lastIndexOf("::");
+        return (separator < 0 ? scope : scope.mid(separator + 2)) == function.name;
+    }
+
+    bool isAccessSpecifier() const
+    {
+        if (!inClass() || statement.isEmpty()) return false;
+        const Token &last = statement.last();
+        return last.is("public") || last.is("private") || last.is("protected") || last.is("signals")
+            || last.is("slots") || last.is("Q_SIGNALS") || last.is("Q_SLOTS");
+    }
+
+    void enumerator()
+    {
+        const int start = declarationStart();
+        if (start < statement.size() && statement[start].isIdentifier()) {
+            add(statement[start].text(), statement[start], SymbolScanner::Enumerator, true, QByteArray());
+        }
+        resetStatement();
+    }
+
+    void pushScope(ScopeType type, const QByteArray &name, bool typedefTail = false)
+    {
+        scopes.append(Scope{type, name, typedefTail});
+    }
+
+    void openBrace()
+    {
+        tail = NoTail;
+        const int count = statement.size();
+        const int start = declarationStart();
+        if (start >= count) {
+            resetStatement();
+            bodyDepth = 1;
+            return;
+        }
+
+        const Token &head = statement[start];
+        if (head.is("namespace") || (head.is("inline") && start + 1 < count && statement[start + 1].is("namespace"))) {
+            // namespace a::b { 声明的是 a 中的 b；匿名命名空间不改变作用域名
+            QByteArray qualifier;
+            const Token *last = nullptr;
+            for (int i = start + 1; i < count; ++i) {
+                const Token &token = statement[i];
+                if (token.isPunct('(') || token.isPunct('[')) {
+                    // namespace std _GLIBCXX_VISIBILITY(default) / [[deprecated]]
+                    i = skipGroup(i, *token.begin, token.isPunct('(') ? ')' : ']') - 1;
+                    continue;
+                }
+                if (!token.isIdentifier() || token.is("namespace") || token.is("inline")) continue;
+                if (i + 1 < count && statement[i + 1].isPunct('(')) continue;
+                if (last) qualifier = join(qualifier, last->text());
+                last = &token;
+            }
+            QByteArray name = currentScope();
+            if (last) {
+                add(last->text(), *last, SymbolScanner::Namespace, true, qualifier);
+                name = join(join(name, qualifier), last->text());
+            }
+            pushScope(NamespaceScope, name);
+            resetStatement();
+            return;
+        }
+        if (head.is("extern") && start + 1 < count && statement[start + 1].type == Token::Literal) {
+            pushScope(LinkageScope, currentScope());
+            resetStatement();
+            return;
+        }
+
+        const FunctionName function = functionName(start);
+        if (function.paren >= 0) {
+            if (isConstructorLike(function, start)) {
+                add(function.name, statement[function.nameToken], SymbolScanner::Function, true, function.qualifier);
+            }
+            resetStatement();
+            bodyDepth = 1;
+            return;
+        }
+
+        const int key = classKey(start);
+        if (key >= 0 && assignment(start) < 0) {
+            int identifiers = 0;
+            const int name = className(key, &identifiers);
+            const SymbolScanner::Kind kind = classKind(statement[key]);
+            QByteArray scope = currentScope();
+            if (name >= 0) {
+                int first = name;
+                const QByteArray qualifier = qualifierBefore(name, key + 1, &first);
+                add(statement[name].text(), statement[name], kind, true, qualifier);
+                scope = join(join(scope, qualifier), statement[name].text());
+            }
+            pushScope(kind == SymbolScanner::Enum ? EnumScope : ClassScope, scope, head.is("typedef"));
+            resetStatement();
+            return;
+        }
+
+        // 花括号初始化的变量：int x{1}; int a[] = {1, 2};
+        if (count - start >= 2 && !inEnum()) declarators(start, variableKind(), true, true);
+        resetStatement();
+        bodyDepth = 1;
+    }
+
+    void closeBrace()
+    {
+        if (scopes.isEmpty()) {
+            // 括号不配对，多半是条件编译造成的
+            resetStatement();
+            return;
+        }
+
+        if (inEnum() && !statement.isEmpty()) enumerator();
+        const Scope scope = scopes.takeLast();
+        resetStatement();
+        if (scope.type == ClassScope || scope.type == EnumScope) tail = scope.typedefTail ? TypedefTail : DeclaratorTail;
+    }
+
+    void endStatement()
+    {
+        if (tail != NoTail) {
+            declarators(0, tail == TypedefTail ? SymbolScanner::Typedef : variableKind(), true, false);
+            tail = NoTail;
+            resetStatement();
+            return;
+        }
+
+        const int count = statement.size();
+        const int start = declarationStart();
+        if (start >= count || inEnum()) {
+            resetStatement();
+            return;
+        }
+
+        const Token &head = statement[start];
+        if (head.is("using")) {
+            // using Name = Type;
+            if (start + 2 < count && statement[start + 1].isIdentifier() && statement[start + 2].isPunct('=')) {
+                add(statement[start + 1].text(), statement[start + 1], SymbolScanner::Typedef, true, QByteArray());
+            }
+            resetStatement();
+            return;
+        }
+        if (head.is("typedef")) {
+            typedefStatement(start + 1);
+            resetStatement();
+            return;
+        }
+        if (head.is("friend") || head.is("static_assert") || head.is("template") || head.is("namespace")
+            || head.is("return") || head.is("Q_DECLARE_METATYPE")) {
+            resetStatement();
+            return;
+        }
+
+        const FunctionName function = functionName(start);
+        if (function.paren >= 0) {
+            if (isConstructorLike(function, start)) {
+                add(function.name, statement[function.nameToken], SymbolScanner::Function, false, function.qualifier);
+            }
+            resetStatement();
+            return;
+        }
+
+        const int key = classKey(start);
+        if (key >= 0) {
+            // class Foo; 只是前置声明；struct Foo foo; 才声明了变量
+            int identifiers = 0;
+            className(key, &identifiers);
+            if (identifiers < 2 || statement[key].is("enum")) {
+                resetStatement();
+                return;
+            }
+        }
+
+        if (count - start >= 2) declarators(start, variableKind(), !head.is("extern"), true);
+        resetStatement();
+    }
+
+    void typedefStatement(int from)
+    {
+        const int count = statement.size();
+        int name = pointerDeclaratorName(from, count);
+        if (name < 0) {
+            // typedef void Handler(int);
+            for (int i = from + 1; i < count; ++i) {
+                if (statement[i].isPunct('(') && statement[i - 1].isIdentifier()) {
+                    name = i - 1;
+                    break;
+                }
+            }
+        }
+        if (name >= 0) {
+            add(statement[name].text(), statement[name], SymbolScanner::Typedef, true, QByteArray());
+            return;
+        }
+        declarators(from, SymbolScanner::Typedef, true, true);
+    }
+
+    Lexer lexer;
+    QVector<Token> statement;
+    QVector<Scope> scopes;
+    QList<SymbolScanner::Symbol> symbols;
+    Tail tail = NoTail;
+    int parenDepth = 0;
+    int bodyDepth = 0;
+};
+
+} // namespace
+
+QList<SymbolScanner::Symbol> SymbolScanner::scan(const char *data, qsizetype size)
+{
+    return Parser(data, size).run();
+}
+
+QString SymbolScanner::kindName(Kind kind)
+{
+    switch (kind) {
+    case Namespace: return "命名空间";
+    case Class: return "类";
+    case Struct: return "结构体";
+    case Union: return "联合体";
+    case Enum: return "枚举";
+    case Enumerator: return "枚举值";
+    case Function: return "函数";
+    case Field: return "成员变量";
+    case Variable: return "变量";
+    case Macro: return "宏";
+    case Typedef: return "类型别名";
+    }
+    return QString();
+}
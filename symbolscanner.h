@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+
+// 轻量 C++ 声明扫描
+// 不做预处理和语义分析，只根据记号和花括号层次找出命名空间、类/结构体/联合体、枚举及枚举值、
+// 函数（定义和声明）、成员变量、全局变量、宏和类型别名。函数体和花括号初始化整体跳过，
+// 每个文件只做一次线性扫描。遇到复杂的宏技巧时可能漏掉或多出个别符号，用于导航和补全足够。
+class SymbolScanner
+{
+public:
+    enum Kind : quint8
+    {
+        Namespace,
+        Class,
+        Struct,
+        Union,
+        Enum,
+        Enumerator,
+        Function,
+        Field,
+        Variable,
+        Macro,
+        Typedef
+    };
+
+    struct Symbol
+    {
+        QByteArray name;
+        QByteArray scope;           // 所在的命名空间或类，如 ns::Outer，全局为空
+        int line = 0;               // 从 1 开始
+        int column = 0;             // 从 1 开始，按字符计
+        Kind kind = Function;
+        bool definition = false;    // 函数体、类体等定义处；只是声明时为 false
+    };
+
+    static QList<Symbol> scan(const char *data, qsizetype size);
+    static QString kindName(Kind kind);
+};
@@ -0,0 +1,495 @@
+#include "terminalwidget.h"
+#include <QApplication>
+#include <QClipboard>
+#include <QKeyEvent>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextDocument>
+
+TerminalWidget::TerminalWidget(QWidget *parent)
+    : QPlainTextEdit(parent)
+    , process(new PtyProcess(this))
+    , frameTimer(new QTimer(this))
+    , decoder(QStringDecoder::Utf8)
+    , state(Normal)
+    , bold(false)
+    , italic(false)
+    , underline(false)
+    , reverse(false)
+{
+    setReadOnly(true);
+    setTextInteractionFlags(Qt::TextSelectableByMouse);
+    setFocusPolicy(Qt::StrongFocus);
+    setUndoRedoEnabled(false);
+    setLineWrapMode(QPlainTextEdit::WidgetWidth);
+    // 限制保留的行数，长时间大量输出时内存保持稳定
+    setMaximumBlockCount(10000);
+
+    QFont font("Consolas", 11);
+    font.setStyleHint(QFont::Monospace);
+    font.setFixedPitch(true);
+    setFont(font);
+    setStyleSheet("QPlainTextEdit { color: #d4d4d4; background-color: #1e1e1e; }");
+
+    defaultFormat.setForeground(QColor("#d4d4d4"));
+    messageFormat.setForeground(QColor("#808080"));
+    currentFormat = defaultFormat;
+    writeCursor = QTextCursor(document());
+
+    frameTimer->setSingleShot(true);
+    connect(frameTimer, &QTimer::timeout, this, &TerminalWidget::renderFrame);
+    connect(process, &PtyProcess::readyRead, this, &TerminalWidget::onReadyRead);
+    connect(process, &PtyProcess::finished, this, &TerminalWidget::onProcessFinished);
+}
+
+TerminalWidget::~TerminalWidget()
+{
+}
+
+bool TerminalWidget::start(const QString &program, const QStringList &arguments,
+                           const QString &workingDirectory, const QProcessEnvironment &environment)
+{
+    if (process->isRunning()) return false;
+
+    clear();
+    writeCursor = QTextCursor(document());
+    resetParser();
+    updateWindowSize();
+
+    if (!process->start(program, arguments, workingDirectory, environment)) {
+        appendMessage("无法启动程序: " + process->errorString());
+        return false;
+    }
+    setFocus();
+    return true;
+}
+
+void TerminalWidget::terminate()
+{
+    process->terminate();
+}
+
+void TerminalWidget::appendMessage(const QString &text)
+{
+    flushText();
+    if (writeCursor.positionInBlock() > 0 || !writeCursor.block().text().isEmpty()) {
+        writeCursor.movePosition(QTextCursor::End);
+        writeCursor.insertBlock();
+    }
+    writeCursor.insertText(text, messageFormat);
+    writeCursor.insertBlock();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void TerminalWidget::onReadyRead()
+{
+    // 帧节流：一帧内到达的所有输出合并渲染
+    if (!frameTimer->isActive()) {
+        frameTimer->start(FrameIntervalMs);
+    }
+}
+
+void TerminalWidget::renderFrame()
+{
+    qint64 dropped = 0;
+    QByteArray data = process->readOutput(MaxBytesPerFrame, &dropped);
+    if (data.isEmpty() && dropped == 0) return;
+
+    QScrollBar *scrollBar = verticalScrollBar();
+    bool atBottom = scrollBar->value() >= scrollBar->maximum() - 2;
+
+    writeCursor.beginEditBlock();
+    if (dropped > 0) {
+        // 丢弃的数据可能截断了转义序列，重新开始解析
+        resetParser();
+        appendMessage(QString("[输出过快，已省略 %1 字节]").arg(dropped));
+    }
+    processOutput(data);
+    writeCursor.endEditBlock();
+
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
+
+void TerminalWidget::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    frameTimer->stop();
+    // 渲染剩余的全部输出
+    while (true) {
+        qint64 dropped = 0;
+        QByteArray data = process->readOutput(MaxBytesPerFrame, &dropped);
+        if (data.isEmpty() && dropped == 0) break;
+        if (dropped > 0) {
+            resetParser();
+            appendMessage(QString("[输出过快，已省略 %1 字节]").arg(dropped));
+        }
+        processOutput(data);
+    }
+    flushText();
+    emit finished(exitCode, exitStatus);
+}
+
+void TerminalWidget::resetParser()
+{
+    state = Normal;
+    csiParameters.clear();
+    pendingText.clear();
+    decoder.resetState();
+    foregroundColor = QColor();
+    backgroundColor = QColor();
+    bold = italic = underline = reverse = false;
+    currentFormat = defaultFormat;
+}
+
+void TerminalWidget::processOutput(const QByteArray &data)
+{
+    const QString text = decoder.decode(data);
+
+    for (const QChar ch : text) {
+        switch (state) {
+        case Normal:
+            if (ch == QChar(0x1b)) {
+                flushText();
+                state = Escape;
+            } else if (ch == '\r') {
+                flushText();
+                writeCursor.movePosition(QTextCursor::StartOfBlock);
+            } else if (ch == '\n') {
+                flushText();
+                newLine();
+            } else if (ch == '\b') {
+                flushText();
+                if (writeCursor.positionInBlock() > 0) {
+                    writeCursor.movePosition(QTextCursor::Left);
+                }
+            } else if (ch == '\t') {
+                int column = writeCursor.positionInBlock() + pendingText.length();
+                pendingText += QString(8 - column % 8, ' ');
+            } else if (ch.unicode() >= 0x20) {
+                pendingText += ch;
+            }
+            break;
+        case Escape:
+            if (ch == '[') {
+                state = Csi;
+                csiParameters.clear();
+            } else if (ch == ']') {
+                state = Osc;
+            } else if (ch == '(' || ch == ')') {
+                state = Charset;
+            } else {
+                state = Normal;
+            }
+            break;
+        case Csi:
+            if (ch.unicode() >= 0x40 && ch.unicode() <= 0x7e) {
+                handleCsi(ch, csiParameters);
+                state = Normal;
+            } else {
+                csiParameters += ch;
+            }
+            break;
+        case Osc:
+            // 窗口标题等操作系统命令，忽略
+            if (ch == QChar(0x07)) {
+                state = Normal;
+            } else if (ch == QChar(0x1b)) {
+                state = OscEscape;
+            }
+            break;
+        case OscEscape:
+        case Charset:
+            state = Normal;
+            break;
+        }
+    }
+    flushText();
+}
+
+void TerminalWidget::flushText()
+{
+    if (pendingText.isEmpty()) return;
+    insertText(pendingText);
+    pendingText.clear();
+}
+
+void TerminalWidget::insertText(const QString &text)
+{
+    // 终端是覆盖写入：光标不在行尾时替换后面的字符（例如 \r 之后的进度条）
+    if (!writeCursor.atBlockEnd()) {
+        int available = writeCursor.block().length() - 1 - writeCursor.positionInBlock();
+        writeCursor.movePosition(QTextCursor::Right, QTextCursor::KeepAnchor, qMin(available, int(text.length())));
+    }
+    writeCursor.insertText(text, currentFormat);
+}
+
+void TerminalWidget::newLine()
+{
+    if (writeCursor.block().next().isValid()) {
+        writeCursor.movePosition(QTextCursor::NextBlock);
+    } else {
+        writeCursor.movePosition(QTextCursor::EndOfBlock);
+        writeCursor.insertBlock();
+    }
+}
+
+void TerminalWidget::moveToColumn(int column)
+{
+    writeCursor.movePosition(QTextCursor::StartOfBlock);
+    int length = writeCursor.block().length() - 1;
+    if (column <= length) {
+        writeCursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, column);
+    } else {
+        writeCursor.movePosition(QTextCursor::EndOfBlock);
+        writeCursor.insertText(QString(column - length, ' '), defaultFormat);
+    }
+}
+
+void TerminalWidget::handleCsi(QChar command, const QString &parameters)
+{
+    QString params = parameters;
+    if (params.startsWith('?')) {
+        // 私有模式（光标显示、备用屏幕等），忽略
+        return;
+    }
+
+    QList<int> values;
+    for (const QString &part : params.split(';')) {
+        values.append(part.toInt());
+    }
+    int first = values.isEmpty() ? 0 : values.first();
+    int count = qMax(1, first);
+
+    switch (command.unicode()) {
+    case 'm':
+        applySgr(params.isEmpty() ? QList<int>{0} : values);
+        break;
+    case 'K': {
+        int column = writeCursor.positionInBlock();
+        if (first == 0) {
+            writeCursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+            writeCursor.removeSelectedText();
+        } else {
+            // 1：清除到行首；2：清除整行。光标列位置保持不变
+            writeCursor.movePosition(QTextCursor::StartOfBlock);
+            if (first == 1) {
+                writeCursor.movePosition(QTextCursor::Right, QTextCursor::KeepAnchor, column);
+            } else {
+                writeCursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+            }
+            writeCursor.removeSelectedText();
+            writeCursor.insertText(QString(column, ' '), defaultFormat);
+        }
+        break;
+    }
+    case 'J':
+        if (first == 2 || first == 3) {
+            document()->clear();
+            writeCursor = QTextCursor(document());
+        } else if (first == 0) {
+            writeCursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+            writeCursor.removeSelectedText();
+        }
+        break;
+    case 'C':
+        moveToColumn(writeCursor.positionInBlock() + count);
+        break;
+    case 'D':
+        writeCursor.movePosition(QTextCursor::Left, QTextCursor::MoveAnchor,
+                                 qMin(count, writeCursor.positionInBlock()));
+        break;
+    case 'G':
+        moveToColumn(count - 1);
+        break;
+    case 'A': {
+        int column = writeCursor.positionInBlock();
+        writeCursor.movePosition(QTextCursor::PreviousBlock, QTextCursor::MoveAnchor, count);
+        moveToColumn(column);
+        break;
+    }
+    case 'B': {
+        int column = writeCursor.positionInBlock();
+        for (int i = 0; i < count; ++i) {
+            newLine();
+        }
+        moveToColumn(column);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void TerminalWidget::applySgr(const QList<int> &parameters)
+{
+    for (int i = 0; i < parameters.size(); ++i) {
+        int code = parameters[i];
+        if (code == 0) {
+            foregroundColor = QColor();
+            backgroundColor = QColor();
+            bold = italic = underline = reverse = false;
+        } else if (code == 1) {
+            bold = true;
+        } else if (code == 3) {
+            italic = true;
+        } else if (code == 4) {
+            underline = true;
+        } else if (code == 7) {
+            reverse = true;
+        } else if (code == 22) {
+            bold = false;
+        } else if (code == 23) {
+            italic = false;
+        } else if (code == 24) {
+            underline = false;
+        } else if (code == 27) {
+            reverse = false;
+        } else if (code >= 30 && code <= 37) {
+            foregroundColor = paletteColor(code - 30);
+        } else if (code >= 90 && code <= 97) {
+            foregroundColor = paletteColor(code - 90 + 8);
+        } else if (code == 39) {
+            foregroundColor = QColor();
+        } else if (code >= 40 && code <= 47) {
+            backgroundColor = paletteColor(code - 40);
+        } else if (code >= 100 && code <= 107) {
+            backgroundColor = paletteColor(code - 100 + 8);
+        } else if (code == 49) {
+            backgroundColor = QColor();
+        } else if ((code == 38 || code == 48) && i + 1 < parameters.size()) {
+            // 扩展颜色：38;5;n（256 色）或 38;2;r;g;b（真彩色）
+            QColor color;
+            if (parameters[i + 1] == 5 && i + 2 < parameters.size()) {
+                color = paletteColor(parameters[i + 2]);
+                i += 2;
+            } else if (parameters[i + 1] == 2 && i + 4 < parameters.size()) {
+                color = QColor(parameters[i + 2], parameters[i + 3], parameters[i + 4]);
+                i += 4;
+            } else {
+                break;
+            }
+            if (code == 38) {
+                foregroundColor = color;
+            } else {
+                backgroundColor = color;
+            }
+        }
+    }
+    updateCurrentFormat();
+}
+
+void TerminalWidget::updateCurrentFormat()
+{
+    currentFormat = defaultFormat;
+
+    QColor foreground = foregroundColor.isValid() ? foregroundColor : defaultFormat.foreground().color();
+    QColor background = backgroundColor;
+    if (reverse) {
+        QColor swapped = background.isValid() ? background : QColor("#1e1e1e");
+        background = foreground;
+        foreground = swapped;
+    }
+
+    currentFormat.setForeground(foreground);
+    if (background.isValid()) {
+        currentFormat.setBackground(background);
+    }
+    currentFormat.setFontWeight(bold ? QFont::Bold : QFont::Normal);
+    currentFormat.setFontItalic(italic);
+    currentFormat.setFontUnderline(underline);
+}
+
+QColor TerminalWidget::paletteColor(int index)
+{
+    // xterm 256 色调色板（前 16 色采用 VS Code 深色终端配色）
+    static const char *const basic[16] = {
+        "#000000", "#cd3131", "#0dbc79", "#e5e510", "#2472c8", "#bc3fbc", "#11a8cd", "#e5e5e5",
+        "#666666", "#f14c4c", "#23d18b", "#f5f543", "#3b8eea", "#d670d6", "#29b8db", "#ffffff"
+    };
+    if (index < 0) return QColor();
+    if (index < 16) return QColor(basic[index]);
+    if (index < 232) {
+        int value = index - 16;
+        auto level = [](int v) { return v == 0 ? 0 : 55 + v * 40; };
+        return QColor(level(value / 36), level((value / 6) % 6), level(value % 6));
+    }
+    if (index < 256) {
+        int gray = 8 + (index - 232) * 10;
+        return QColor(gray, gray, gray);
+    }
+    return QColor();
+}
+
+void TerminalWidget::keyPressEvent(QKeyEvent *event)
+{
+    const bool ctrl = event->modifiers() & Qt::ControlModifier;
+    const bool shift = event->modifiers() & Qt::ShiftModifier;
+
+    // Ctrl+Shift+C / 有选中文本时的 Ctrl+C：复制
+    if (ctrl && event->key() == Qt::Key_C && (shift || textCursor().hasSelection())) {
+        copy();
+        return;
+    }
+
+    if (!process->isRunning()) {
+        QPlainTextEdit::keyPressEvent(event);
+        return;
+    }
+
+    QByteArray bytes;
+    switch (event->key()) {
+    case Qt::Key_Return:
+    case Qt::Key_Enter:     bytes = "\r"; break;
+    case Qt::Key_Backspace: bytes = "\x7f"; break;
+    case Qt::Key_Tab:       bytes = "\t"; break;
+    case Qt::Key_Escape:    bytes = "\x1b"; break;
+    case Qt::Key_Up:        bytes = "\x1b[A"; break;
+    case Qt::Key_Down:      bytes = "\x1b[B"; break;
+    case Qt::Key_Right:     bytes = "\x1b[C"; break;
+    case Qt::Key_Left:      bytes = "\x1b[D"; break;
+    case Qt::Key_Home:      bytes = "\x1b[H"; break;
+    case Qt::Key_End:       bytes = "\x1b[F"; break;
+    case Qt::Key_Delete:    bytes = "\x1b[3~"; break;
+    case Qt::Key_PageUp:    bytes = "\x1b[5~"; break;
+    case Qt::Key_PageDown:  bytes = "\x1b[6~"; break;
+    default:
+        if (ctrl && event->key() == Qt::Key_V) {
+            // 粘贴：换行转换为回车，与键盘输入一致
+            bytes = QApplication::clipboard()->text().replace('\n', '\r').toUtf8();
+        } else if (ctrl && event->key() >= Qt::Key_A && event->key() <= Qt::Key_Z) {
+            // Ctrl+字母 对应控制字符（Ctrl+C 中断、Ctrl+D 结束输入……）
+            bytes.append(char(event->key() - Qt::Key_A + 1));
+        } else {
+            bytes = event->text().toUtf8();
+        }
+        break;
+    }
+
+    if (!bytes.isEmpty()) {
+        process->write(bytes);
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    }
+    event->accept();
+}
+
+void TerminalWidget::resizeEvent(QResizeEvent *event)
+{
+    QPlainTextEdit::resizeEvent(event);
+    updateWindowSize();
+}
+
+bool TerminalWidget::focusNextPrevChild(bool next)
+{
+    // 程序运行时 Tab 键发送给程序，而不是切换焦点
+    if (process->isRunning()) return false;
+    return QPlainTextEdit::focusNextPrevChild(next);
+}
+
+void TerminalWidget::updateWindowSize()
+{
+    QFontMetrics metrics(font());
+    int columns = qMax(1, viewport()->width() / qMax(1, metrics.horizontalAdvance(QLatin1Char('M'))));
+    int rows = qMax(1, viewport()->height() / qMax(1, metrics.lineSpacing()));
+    process->setWindowSize(rows, columns);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QPlainTextEdit>
+#include <QTimer>
+#include <QTextCursor>
+#include <QTextCharFormat>
+#include <QStringDecoder>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QColor>
+
+#include "ptyprocess.h"
+
+// 内置终端
+// 基于伪终端运行程序，支持交互输入、ANSI 颜色和内核行编辑。
+// 输出按帧渲染：两帧之间积累的数据一次性写入文档，积压过多时
+// 只渲染最新的部分并提示省略的字节数，而不是阻塞子进程。
+class TerminalWidget : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    explicit TerminalWidget(QWidget *parent = nullptr);
+    ~TerminalWidget();
+
+    bool start(const QString &program, const QStringList &arguments = QStringList(),
+               const QString &workingDirectory = QString(),
+               const QProcessEnvironment &environment = QProcessEnvironment::systemEnvironment());
+    void terminate();
+    bool isRunning() const { return process->isRunning(); }
+    QString errorString() const { return process->errorString(); }
+
+    // IDE 自身的提示信息（灰色显示）
+    void appendMessage(const QString &text);
+
+signals:
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+protected:
+    void keyPressEvent(QKeyEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    bool focusNextPrevChild(bool next) override;
+
+private slots:
+    void onReadyRead();
+    void renderFrame();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    enum ParserState
+    {
+        Normal,
+        Escape,
+        Csi,
+        Osc,
+        OscEscape,
+        Charset
+    };
+
+    void processOutput(const QByteArray &data);
+    void flushText();
+    void insertText(const QString &text);
+    void newLine();
+    void moveToColumn(int column);
+    void handleCsi(QChar command, const QString &parameters);
+    void applySgr(const QList<int> &parameters);
+    void updateCurrentFormat();
+    void updateWindowSize();
+    void resetParser();
+    static QColor paletteColor(int index);
+
+    static const int FrameIntervalMs = 33;
+    static const qint64 MaxBytesPerFrame = 256 * 1024;
+
+    PtyProcess *process;
+    QTimer *frameTimer;
+    QStringDecoder decoder;
+
+    ParserState state;
+    QString csiParameters;
+    QString pendingText;
+    QTextCursor writeCursor;
+
+    QTextCharFormat defaultFormat;
+    QTextCharFormat currentFormat;
+    QTextCharFormat messageFormat;
+    QColor foregroundColor;
+    QColor backgroundColor;
+    bool bold;
+    bool italic;
+    bool underline;
+    bool reverse;
+};
@@ -0,0 +1,277 @@
+#include "testcasepanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QDialog>
+#include <QPlainTextEdit>
+#include <QMessageBox>
+#include <QSettings>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QDir>
+#include <QFileInfo>
+
+TestCasePanel::TestCasePanel(QWidget *parent)
+    : QWidget(parent)
+    , runner(new TestCaseRunner(this))
+{
+    QSettings settings("LionCPP", "IDE");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *toolLayout = new QHBoxLayout();
+    runButton = new QPushButton("运行全部", this);
+    addButton = new QPushButton("添加用例", this);
+    removeButton = new QPushButton("删除用例", this);
+    openDirectoryButton = new QPushButton("打开目录", this);
+
+    timeLimitSpinBox = new QSpinBox(this);
+    timeLimitSpinBox->setRange(100, 60000);
+    timeLimitSpinBox->setSingleStep(100);
+    timeLimitSpinBox->setSuffix(" ms");
+    timeLimitSpinBox->setValue(settings.value("tests/timeLimitMs", 1000).toInt());
+
+    memoryLimitSpinBox = new QSpinBox(this);
+    memoryLimitSpinBox->setRange(16, 16384);
+    memoryLimitSpinBox->setSingleStep(64);
+    memoryLimitSpinBox->setSuffix(" MB");
+    memoryLimitSpinBox->setValue(settings.value("tests/memoryLimitMb", 256).toInt());
+
+    summaryLabel = new QLabel(this);
+
+    toolLayout->addWidget(runButton);
+    toolLayout->addWidget(addButton);
+    toolLayout->addWidget(removeButton);
+    toolLayout->addWidget(openDirectoryButton);
+    toolLayout->addSpacing(12);
+    toolLayout->addWidget(new QLabel("时间限制:", this));
+    toolLayout->addWidget(timeLimitSpinBox);
+    toolLayout->addWidget(new QLabel("内存限制:", this));
+    toolLayout->addWidget(memoryLimitSpinBox);
+    toolLayout->addStretch();
+    toolLayout->addWidget(summaryLabel);
+    layout->addLayout(toolLayout);
+
+    table = new QTableWidget(0, 5, this);
+    table->setHorizontalHeaderLabels(QStringList() << "#" << "结果" << "时间" << "内存" << "说明");
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(table);
+
+    connect(runButton, &QPushButton::clicked, this, [this]() {
+        if (runner->isRunning()) {
+            cancel();
+        } else {
+            emit runRequested();
+        }
+    });
+    connect(addButton, &QPushButton::clicked, this, &TestCasePanel::onAddCase);
+    connect(removeButton, &QPushButton::clicked, this, &TestCasePanel::onRemoveCase);
+    connect(openDirectoryButton, &QPushButton::clicked, this, &TestCasePanel::onOpenDirectory);
+    connect(timeLimitSpinBox, &QSpinBox::valueChanged, this, [](int value) {
+        QSettings("LionCPP", "IDE").setValue("tests/timeLimitMs", value);
+    });
+    connect(memoryLimitSpinBox, &QSpinBox::valueChanged, this, [](int value) {
+        QSettings("LionCPP", "IDE").setValue("tests/memoryLimitMb", value);
+    });
+    connect(table, &QTableWidget::cellDoubleClicked, this, &TestCasePanel::onCellDoubleClicked);
+
+    connect(runner, &TestCaseRunner::caseStarted, this, &TestCasePanel::onCaseStarted);
+    connect(runner, &TestCaseRunner::caseFinished, this, &TestCasePanel::onCaseFinished);
+    connect(runner, &TestCaseRunner::allFinished, this, &TestCasePanel::onAllFinished);
+
+    updateButtons();
+}
+
+void TestCasePanel::setSourceFile(const QString &sourcePath)
+{
+    if (sourcePath == currentSource || runner->isRunning()) return;
+    currentSource = sourcePath;
+    reloadCases();
+}
+
+void TestCasePanel::reloadCases()
+{
+    cases = currentSource.isEmpty() ? QList<TestCase>() : TestCaseRunner::loadCases(currentSource);
+
+    table->setRowCount(cases.size());
+    for (int row = 0; row < cases.size(); ++row) {
+        table->setItem(row, 0, new QTableWidgetItem(QString::number(cases.at(row).number)));
+        for (int column = 1; column < table->columnCount(); ++column) {
+            table->setItem(row, column, new QTableWidgetItem());
+        }
+        setRowVerdict(row, TestVerdict::Pending);
+    }
+
+    summaryLabel->setText(currentSource.isEmpty() ? QString()
+                          : QString("%1 个用例").arg(cases.size()));
+    updateButtons();
+}
+
+void TestCasePanel::updateButtons()
+{
+    bool hasSource = !currentSource.isEmpty();
+    bool running = runner->isRunning();
+    runButton->setText(running ? "停止" : "运行全部");
+    runButton->setEnabled(running || (hasSource && !cases.isEmpty()));
+    addButton->setEnabled(hasSource && !running);
+    removeButton->setEnabled(hasSource && !running && !cases.isEmpty());
+    openDirectoryButton->setEnabled(hasSource);
+}
+
+TestCaseRunner::Limits TestCasePanel::limits() const
+{
+    TestCaseRunner::Limits limits;
+    limits.timeLimitMs = timeLimitSpinBox->value();
+    limits.memoryLimitMb = memoryLimitSpinBox->value();
+    return limits;
+}
+
+void TestCasePanel::runTests(const QString &executablePath)
+{
+    reloadCases();
+    if (cases.isEmpty()) return;
+
+    if (runner->start(executablePath, cases, limits())) {
+        summaryLabel->setText(QString("正在运行 %1 个用例...").arg(cases.size()));
+    }
+    updateButtons();
+}
+
+void TestCasePanel::cancel()
+{
+    runner->cancel();
+}
+
+void TestCasePanel::setRowVerdict(int row, TestVerdict verdict)
+{
+    QTableWidgetItem *item = table->item(row, 1);
+    if (!item) return;
+
+    item->setText(TestCaseRunner::verdictShortName(verdict));
+    item->setToolTip(TestCaseRunner::verdictName(verdict));
+
+    QColor color("#d4d4d4");
+    switch (verdict) {
+    case TestVerdict::Accepted: color = QColor("#4ec9b0"); break;
+    case TestVerdict::WrongAnswer: color = QColor("#f44747"); break;
+    case TestVerdict::TimeLimitExceeded:
+    case TestVerdict::MemoryLimitExceeded: color = QColor("#d7ba7d"); break;
+    case TestVerdict::RuntimeError: color = QColor("#c586c0"); break;
+    case TestVerdict::Running: color = QColor("#569cd6"); break;
+    default: break;
+    }
+    item->setForeground(color);
+}
+
+void TestCasePanel::onCaseStarted(int index)
+{
+    setRowVerdict(index, TestVerdict::Running);
+}
+
+void TestCasePanel::onCaseFinished(const TestCaseResult &result)
+{
+    int row = result.index;
+    if (row < 0 || row >= table->rowCount()) return;
+
+    setRowVerdict(row, result.verdict);
+    if (result.verdict != TestVerdict::Cancelled) {
+        table->item(row, 2)->setText(QString("%1 ms").arg(result.timeMs));
+        table->item(row, 3)->setText(QString("%1 MB").arg(result.memoryKb / 1024.0, 0, 'f', 1));
+    }
+    table->item(row, 4)->setText(result.detail);
+    table->item(row, 4)->setToolTip(result.detail);
+}
+
+void TestCasePanel::onAllFinished(int accepted, int total)
+{
+    summaryLabel->setText(QString("通过 %1 / %2").arg(accepted).arg(total));
+    updateButtons();
+    emit testsFinished(accepted, total);
+}
+
+void TestCasePanel::onCellDoubleClicked(int row, int column)
+{
+    if (row < 0 || row >= cases.size()) return;
+
+    // 结果错误时打开期望输出对照，其余情况打开输入文件
+    const TestCase &testCase = cases.at(row);
+    if (column == 4 && QFileInfo::exists(testCase.expectedFile)) {
+        emit openFileRequested(testCase.expectedFile);
+    } else {
+        emit openFileRequested(testCase.inputFile);
+    }
+}
+
+void TestCasePanel::onAddCase()
+{
+    if (currentSource.isEmpty()) return;
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("添加测试用例");
+    dialog.resize(640, 400);
+
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QHBoxLayout *editorLayout = new QHBoxLayout();
+
+    QVBoxLayout *inputLayout = new QVBoxLayout();
+    inputLayout->addWidget(new QLabel("输入:", &dialog));
+    QPlainTextEdit *inputEdit = new QPlainTextEdit(&dialog);
+    inputLayout->addWidget(inputEdit);
+
+    QVBoxLayout *expectedLayout = new QVBoxLayout();
+    expectedLayout->addWidget(new QLabel("期望输出:", &dialog));
+    QPlainTextEdit *expectedEdit = new QPlainTextEdit(&dialog);
+    expectedLayout->addWidget(expectedEdit);
+
+    editorLayout->addLayout(inputLayout);
+    editorLayout->addLayout(expectedLayout);
+    layout->addLayout(editorLayout);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    QPushButton *okButton = new QPushButton("确定", &dialog);
+    QPushButton *cancelButton = new QPushButton("取消", &dialog);
+    connect(okButton, &QPushButton::clicked, &dialog, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, &dialog, &QDialog::reject);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(okButton);
+    buttonLayout->addWidget(cancelButton);
+    layout->addLayout(buttonLayout);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    TestCase testCase = TestCaseRunner::addCase(currentSource, inputEdit->toPlainText().toUtf8(),
+                                                expectedEdit->toPlainText().toUtf8());
+    if (testCase.inputFile.isEmpty()) {
+        QMessageBox::warning(this, "错误", "无法保存测试用例到: " + TestCaseRunner::testDirectory(currentSource));
+        return;
+    }
+    reloadCases();
+}
+
+void TestCasePanel::onRemoveCase()
+{
+    int row = table->currentRow();
+    if (row < 0 || row >= cases.size()) return;
+
+    const TestCase &testCase = cases.at(row);
+    if (QMessageBox::question(this, "删除测试用例", QString("确定要删除用例 %1 吗？").arg(testCase.number))
+        != QMessageBox::Yes) {
+        return;
+    }
+    TestCaseRunner::removeCase(testCase);
+    reloadCases();
+}
+
+void TestCasePanel::onOpenDirectory()
+{
+    if (currentSource.isEmpty()) return;
+
+    QString directory = TestCaseRunner::testDirectory(currentSource);
+    QDir().mkpath(directory);
+    QDesktopServices::openUrl(QUrl::fromLocalFile(directory));
+}
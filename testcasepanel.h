@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QLabel>
+
+#include "testcaserunner.h"
+
+// 测试用例面板
+// 显示当前源文件的测试用例及每个用例的运行结果，
+// 编译由主窗口完成，面板只负责用例管理和运行。
+class TestCasePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TestCasePanel(QWidget *parent = nullptr);
+
+    void setSourceFile(const QString &sourcePath);
+    QString sourceFile() const { return currentSource; }
+    int caseCount() const { return cases.size(); }
+
+    void runTests(const QString &executablePath);
+    void cancel();
+    bool isRunning() const { return runner->isRunning(); }
+
+signals:
+    void runRequested();
+    void openFileRequested(const QString &filePath);
+    void testsFinished(int accepted, int total);
+
+private slots:
+    void onAddCase();
+    void onRemoveCase();
+    void onOpenDirectory();
+    void onCaseStarted(int index);
+    void onCaseFinished(const TestCaseResult &result);
+    void onAllFinished(int accepted, int total);
+    void onCellDoubleClicked(int row, int column);
+
+private:
+    void reloadCases();
+    void setRowVerdict(int row, TestVerdict verdict);
+    void updateButtons();
+    TestCaseRunner::Limits limits() const;
+
+    TestCaseRunner *runner;
+    QTableWidget *table;
+    QPushButton *runButton;
+    QPushButton *addButton;
+    QPushButton *removeButton;
+    QPushButton *openDirectoryButton;
+    QSpinBox *timeLimitSpinBox;
+    QSpinBox *memoryLimitSpinBox;
+    QLabel *summaryLabel;
+
+    QString currentSource;
+    QList<TestCase> cases;
+};
@@ -0,0 +1,249 @@
+#include "testcaserunner.h"
+#include "processrunner.h"
+#include "outputcomparator.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <cstring>
+#endif
+
+TestCaseRunner::TestCaseRunner(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , cancelFlag(std::make_shared<std::atomic<bool>>(false))
+    , running(false)
+    , totalCases(0)
+    , finishedCases(0)
+    , acceptedCases(0)
+{
+    pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+TestCaseRunner::~TestCaseRunner()
+{
+    cancelFlag->store(true);
+    pool->waitForDone();
+}
+
+QString TestCaseRunner::testDirectory(const QString &sourcePath)
+{
+    QFileInfo sourceInfo(sourcePath);
+    return sourceInfo.absolutePath() + "/" + sourceInfo.completeBaseName() + ".tests";
+}
+
+QList<TestCase> TestCaseRunner::loadCases(const QString &sourcePath)
+{
+    QList<TestCase> cases;
+    QDir dir(testDirectory(sourcePath));
+    if (!dir.exists()) return cases;
+
+    const QStringList inputs = dir.entryList(QStringList() << "*.in", QDir::Files);
+    for (const QString &input : inputs) {
+        bool ok = false;
+        int number = QFileInfo(input).completeBaseName().toInt(&ok);
+        if (!ok) continue;
+
+        TestCase testCase;
+        testCase.number = number;
+        testCase.inputFile = dir.filePath(input);
+        testCase.expectedFile = dir.filePath(QString("%1.out").arg(number));
+        // 兼容常见的 .ans 命名
+        if (!QFile::exists(testCase.expectedFile) && QFile::exists(dir.filePath(QString("%1.ans").arg(number)))) {
+            testCase.expectedFile = dir.filePath(QString("%1.ans").arg(number));
+        }
+        cases.append(testCase);
+    }
+
+    std::sort(cases.begin(), cases.end(), [](const TestCase &a, const TestCase &b) {
+        return a.number < b.number;
+    });
+    return cases;
+}
+
+TestCase TestCaseRunner::addCase(const QString &sourcePath, const QByteArray &input, const QByteArray &expectedOutput)
+{
+    TestCase testCase;
+    QString directory = testDirectory(sourcePath);
+    if (!QDir().mkpath(directory)) return testCase;
+
+    int number = 1;
+    for (const TestCase &existing : loadCases(sourcePath)) {
+        number = qMax(number, existing.number + 1);
+    }
+
+    QDir dir(directory);
+    QFile inputFile(dir.filePath(QString("%1.in").arg(number)));
+    QFile expectedFile(dir.filePath(QString("%1.out").arg(number)));
+    if (!inputFile.open(QIODevice::WriteOnly) || !expectedFile.open(QIODevice::WriteOnly)) {
+        return testCase;
+    }
+    inputFile.write(input);
+    expectedFile.write(expectedOutput);
+
+    testCase.number = number;
+    testCase.inputFile = inputFile.fileName();
+    testCase.expectedFile = expectedFile.fileName();
+    return testCase;
+}
+
+bool TestCaseRunner::removeCase(const TestCase &testCase)
+{
+    bool removed = QFile::remove(testCase.inputFile);
+    QFile::remove(testCase.expectedFile);
+    return removed;
+}
+
+QString TestCaseRunner::verdictName(TestVerdict verdict)
+{
+    switch (verdict) {
+    case TestVerdict::Pending: return "等待运行";
+    case TestVerdict::Running: return "运行中";
+    case TestVerdict::Accepted: return "答案正确";
+    case TestVerdict::WrongAnswer: return "答案错误";
+    case TestVerdict::TimeLimitExceeded: return "超出时间限制";
+    case TestVerdict::MemoryLimitExceeded: return "超出内存限制";
+    case TestVerdict::RuntimeError: return "运行错误";
+    case TestVerdict::NoExpectedOutput: return "无期望输出";
+    case TestVerdict::Cancelled: return "已取消";
+    }
+    return QString();
+}
+
+QString TestCaseRunner::verdictShortName(TestVerdict verdict)
+{
+    switch (verdict) {
+    case TestVerdict::Accepted: return "AC";
+    case TestVerdict::WrongAnswer: return "WA";
+    case TestVerdict::TimeLimitExceeded: return "TLE";
+    case TestVerdict::MemoryLimitExceeded: return "MLE";
+    case TestVerdict::RuntimeError: return "RE";
+    default: return verdictName(verdict);
+    }
+}
+
+bool TestCaseRunner::start(const QString &executablePath, const QList<TestCase> &cases, const Limits &limits)
+{
+    if (running || cases.isEmpty()) return false;
+
+    // 每次运行使用新的取消标志，上一次被取消的任务不会影响本次
+    cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    running = true;
+    totalCases = cases.size();
+    finishedCases = 0;
+    acceptedCases = 0;
+
+    for (int i = 0; i < cases.size(); ++i) {
+        std::shared_ptr<std::atomic<bool>> flag = cancelFlag;
+        TestCase testCase = cases.at(i);
+        pool->start(QRunnable::create([this, i, executablePath, testCase, limits, flag]() {
+            if (!flag->load()) {
+                QMetaObject::invokeMethod(this, [this, i]() { emit caseStarted(i); }, Qt::QueuedConnection);
+            }
+            TestCaseResult result = runCase(i, executablePath, testCase, limits, flag.get());
+            QMetaObject::invokeMethod(this, [this, result]() { onCaseFinished(result); }, Qt::QueuedConnection);
+        }));
+    }
+    return true;
+}
+
+void TestCaseRunner::cancel()
+{
+    cancelFlag->store(true);
+}
+
+void TestCaseRunner::onCaseFinished(const TestCaseResult &result)
+{
+    ++finishedCases;
+    if (result.verdict == TestVerdict::Accepted) ++acceptedCases;
+    emit caseFinished(result);
+
+    if (finishedCases == totalCases) {
+        running = false;
+        emit allFinished(acceptedCases, totalCases);
+    }
+}
+
+TestCaseResult TestCaseRunner::runCase(int index, const QString &executablePath, const TestCase &testCase,
+                                       const Limits &limits, const std::atomic<bool> *cancelFlag)
+{
+    TestCaseResult result;
+    result.index = index;
+
+    if (cancelFlag->load()) {
+        result.verdict = TestVerdict::Cancelled;
+        return result;
+    }
+
+    ProcessRunner::Spec spec;
+    spec.program = executablePath;
+    spec.workingDirectory = QFileInfo(testCase.inputFile).absolutePath();
+    spec.stdinFile = testCase.inputFile;
+    spec.cpuTimeLimit = limits.timeLimitMs / 1000.0;
+    // 墙钟时间只用于兜底（例如程序在等待输入），判定以 CPU 时间为准
+    spec.wallTimeLimitMs = limits.timeLimitMs * 2 + 1000;
+    spec.memoryLimitBytes = limits.memoryLimitMb * 1024 * 1024;
+    spec.cancelFlag = cancelFlag;
+
+    // 输出直接流入比较器，不在内存中保存
+    std::unique_ptr<OutputComparator> comparator;
+    if (QFileInfo::exists(testCase.expectedFile)) {
+        comparator = std::make_unique<OutputComparator>(testCase.expectedFile);
+        OutputComparator *sink = comparator.get();
+        spec.stdoutSink = [sink](const char *data, qint64 size) {
+            return sink->feed(data, size);
+        };
+    }
+
+    ProcessRunner::Result run = ProcessRunner::run(spec);
+    result.timeMs = run.cpuTimeUs / 1000;
+    result.memoryKb = run.peakMemoryKb;
+    result.exitCode = run.exitCode;
+
+    if (!run.started) {
+        result.verdict = TestVerdict::RuntimeError;
+        result.detail = run.error;
+    } else if (run.cancelled) {
+        result.verdict = TestVerdict::Cancelled;
+    } else if (run.cpuTimeExceeded || run.wallTimeExceeded || run.cpuTimeUs > limits.timeLimitMs * 1000) {
+        result.verdict = TestVerdict::TimeLimitExceeded;
+        if (run.wallTimeExceeded && !run.cpuTimeExceeded) {
+            result.detail = "运行时间过长（程序可能在等待输入）";
+        }
+    } else if (run.stoppedBySink) {
+        result.verdict = TestVerdict::WrongAnswer;
+        result.detail = comparator->mismatchDescription();
+    } else if (run.crashed()) {
+        // 地址空间限制下分配失败通常表现为 bad_alloc 或随后的段错误
+        const QByteArray &errors = run.stderrOutput;
+        bool outOfMemory = errors.contains("bad_alloc") || errors.contains("Cannot allocate memory")
+            || (spec.memoryLimitBytes > 0 && run.peakMemoryKb * 1024 >= spec.memoryLimitBytes * 8 / 10);
+        result.verdict = outOfMemory ? TestVerdict::MemoryLimitExceeded : TestVerdict::RuntimeError;
+        if (run.signal != 0) {
+#ifdef Q_OS_UNIX
+            result.detail = QString("被信号 %1 终止（%2）").arg(run.signal).arg(QString::fromLocal8Bit(::strsignal(run.signal)));
+#else
+            result.detail = QString("被信号 %1 终止").arg(run.signal);
+#endif
+        } else {
+            result.detail = QString("返回值 %1").arg(run.exitCode);
+        }
+        QString firstError = QString::fromUtf8(errors).trimmed().section('\n', 0, 0);
+        if (!firstError.isEmpty()) {
+            result.detail += ": " + firstError;
+        }
+    } else if (!comparator) {
+        result.verdict = TestVerdict::NoExpectedOutput;
+    } else if (!comparator->finish()) {
+        result.verdict = TestVerdict::WrongAnswer;
+        result.detail = comparator->mismatchDescription();
+    } else {
+        result.verdict = TestVerdict::Accepted;
+    }
+
+    return result;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+// 测试用例结果
+enum class TestVerdict
+{
+    Pending,
+    Running,
+    Accepted,
+    WrongAnswer,
+    TimeLimitExceeded,
+    MemoryLimitExceeded,
+    RuntimeError,
+    NoExpectedOutput,
+    Cancelled
+};
+
+struct TestCase
+{
+    int number = 0;
+    QString inputFile;
+    QString expectedFile;       // 不存在时只运行、不比较
+};
+
+struct TestCaseResult
+{
+    int index = -1;             // 在本次运行用例列表中的位置
+    TestVerdict verdict = TestVerdict::Pending;
+    qint64 timeMs = 0;          // CPU 时间
+    qint64 memoryKb = 0;        // 峰值常驻内存
+    int exitCode = 0;
+    QString detail;
+};
+
+// 单文件测试用例运行器
+// 用例保存在源文件旁的 <文件名>.tests/ 目录中（N.in / N.out）。
+// 所有用例在线程池中并行运行，每个用例都在子进程中设置
+// CPU 时间和地址空间限制，输出边读边比较。
+class TestCaseRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Limits
+    {
+        qint64 timeLimitMs = 1000;
+        qint64 memoryLimitMb = 256;
+    };
+
+    explicit TestCaseRunner(QObject *parent = nullptr);
+    ~TestCaseRunner();
+
+    // 用例存储
+    static QString testDirectory(const QString &sourcePath);
+    static QList<TestCase> loadCases(const QString &sourcePath);
+    static TestCase addCase(const QString &sourcePath, const QByteArray &input, const QByteArray &expectedOutput);
+    static bool removeCase(const TestCase &testCase);
+
+    static QString verdictName(TestVerdict verdict);
+    static QString verdictShortName(TestVerdict verdict);
+
+    bool start(const QString &executablePath, const QList<TestCase> &cases, const Limits &limits);
+    void cancel();
+    bool isRunning() const { return running; }
+
+signals:
+    void caseStarted(int index);
+    void caseFinished(const TestCaseResult &result);
+    void allFinished(int accepted, int total);
+
+private:
+    static TestCaseResult runCase(int index, const QString &executablePath, const TestCase &testCase,
+                                  const Limits &limits, const std::atomic<bool> *cancelFlag);
+    void onCaseFinished(const TestCaseResult &result);
+
+    QThreadPool *pool;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+    bool running;
+    int totalCases;
+    int finishedCases;
+    int acceptedCases;
+};
@@ -0,0 +1,146 @@
+#include "textdiff.h"
+#include <vector>
+
+namespace {
+
+TextDiff::Line makeLine(TextDiff::Line::Type type, const QString &text, int oldLine, int newLine)
+{
+    TextDiff::Line line;
+    line.type = type;
+    line.text = text;
+    line.oldLine = oldLine;
+    line.newLine = newLine;
+    return line;
+}
+
+}
+
+QList<TextDiff::Line> TextDiff::diff(const QStringList &oldLines, const QStringList &newLines)
+{
+    QList<Line> result;
+    const int n = oldLines.size();
+    const int m = newLines.size();
+
+    // 去掉公共前缀和后缀，只对中间部分做差分
+    int prefix = 0;
+    while (prefix < n && prefix < m && oldLines.at(prefix) == newLines.at(prefix)) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix
+           && oldLines.at(n - 1 - suffix) == newLines.at(m - 1 - suffix)) {
+        ++suffix;
+    }
+
+    for (int i = 0; i < prefix; ++i) {
+        result.append(makeLine(Line::Equal, oldLines.at(i), i + 1, i + 1));
+    }
+
+    const int oldCount = n - prefix - suffix;
+    const int newCount = m - prefix - suffix;
+    auto oldAt = [&](int i) -> const QString & { return oldLines.at(prefix + i); };
+    auto newAt = [&](int i) -> const QString & { return newLines.at(prefix + i); };
+
+    QList<Line> middle;     // 回溯得到的是逆序
+    bool solved = false;
+
+    if (oldCount > 0 || newCount > 0) {
+        const int max = oldCount + newCount;
+        const int limit = qMin(max, MaxEditDistance);
+        const int offset = max + 1;
+        std::vector<int> v(2 * max + 3, 0);
+        // 每一轮只保存 [-d-1, d+1] 范围内的状态，内存为编辑距离的平方
+        std::vector<std::vector<int>> trace;
+
+        for (int d = 0; d <= limit && !solved; ++d) {
+            trace.emplace_back(v.begin() + offset - d - 1, v.begin() + offset + d + 2);
+            for (int k = -d; k <= d; k += 2) {
+                int x;
+                if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) {
+                    x = v[offset + k + 1];
+                } else {
+                    x = v[offset + k - 1] + 1;
+                }
+                int y = x - k;
+                while (x < oldCount && y < newCount && oldAt(x) == newAt(y)) {
+                    ++x;
+                    ++y;
+                }
+                v[offset + k] = x;
+                if (x >= oldCount && y >= newCount) {
+                    solved = true;
+                    break;
+                }
+            }
+        }
+
+        if (solved) {
+            int x = oldCount;
+            int y = newCount;
+            for (int d = static_cast<int>(trace.size()) - 1; d >= 0; --d) {
+                const std::vector<int> &round = trace[d];
+                auto at = [&](int k) { return round[k + d + 1]; };
+
+                int k = x - y;
+                int previousK = (k == -d || (k != d && at(k - 1) < at(k + 1))) ? k + 1 : k - 1;
+                int previousX = at(previousK);
+                int previousY = previousX - previousK;
+
+                while (x > previousX && y > previousY) {
+                    --x;
+                    --y;
+                    middle.append(makeLine(Line::Equal, oldAt(x), prefix + x + 1, prefix + y + 1));
+                }
+                if (d > 0) {
+                    if (x == previousX) {
+                        middle.append(makeLine(Line::Added, newAt(previousY), 0, prefix + previousY + 1));
+                    } else {
+                        middle.append(makeLine(Line::Removed, oldAt(previousX), prefix + previousX + 1, 0));
+                    }
+                }
+                x = previousX;
+                y = previousY;
+            }
+            for (int i = middle.size() - 1; i >= 0; --i) {
+                result.append(middle.at(i));
+            }
+        } else {
+            // 差异过大时不再求最短编辑序列，整体作为删除 + 新增
+            for (int i = 0; i < oldCount; ++i) {
+                result.append(makeLine(Line::Removed, oldAt(i), prefix + i + 1, 0));
+            }
+            for (int i = 0; i < newCount; ++i) {
+                result.append(makeLine(Line::Added, newAt(i), 0, prefix + i + 1));
+            }
+        }
+    }
+
+    for (int i = 0; i < suffix; ++i) {
+        result.append(makeLine(Line::Equal, oldLines.at(n - suffix + i), n - suffix + i + 1, m - suffix + i + 1));
+    }
+    return result;
+}
+
+QList<TextDiff::Line> TextDiff::withContext(const QList<Line> &lines, int context)
+{
+    std::vector<bool> keep(lines.size(), false);
+    for (int i = 0; i < lines.size(); ++i) {
+        if (lines.at(i).type == Line::Equal) continue;
+        for (int j = qMax(0, i - context); j <= qMin(static_cast<int>(lines.size()) - 1, i + context); ++j) {
+            keep[j] = true;
+        }
+    }
+
+    QList<Line> result;
+    bool skipping = false;
+    for (int i = 0; i < lines.size(); ++i) {
+        if (keep[i]) {
+            result.append(lines.at(i));
+            skipping = false;
+        } else if (!skipping) {
+            result.append(makeLine(Line::Equal, "...", 0, 0));
+            skipping = true;
+        }
+    }
+    return result;
+}
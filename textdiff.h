@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+// 按行比较两段文本（Myers 差分算法）
+// 用于对拍失败时显示期望输出与实际输出的差异
+class TextDiff
+{
+public:
+    struct Line
+    {
+        enum Type { Equal, Removed, Added };
+        Type type = Equal;
+        QString text;
+        int oldLine = 0;    // 从 1 开始，Added 行为 0
+        int newLine = 0;    // 从 1 开始，Removed 行为 0
+    };
+
+    static QList<Line> diff(const QStringList &oldLines, const QStringList &newLines);
+
+    // 只保留差异附近 context 行的上下文，省略的部分用 Equal 类型的 "..." 行表示
+    static QList<Line> withContext(const QList<Line> &lines, int context = 3);
+
+private:
+    static const int MaxEditDistance = 2000;
+};
@@ -0,0 +1,168 @@
+#include "threadscaler.h"
+#include "processrunner.h"
+#include "statistics.h"
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QRunnable>
+#include <cmath>
+
+namespace {
+// 比目前最好的加速比低 5% 以上视为变慢
+const double SlowdownTolerance = 0.05;
+const double CollapseEfficiency = 0.5;
+const int FitSteps = 1000;
+}
+
+ThreadScaler::ThreadScaler(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool(this))
+    , cancelFlag(std::make_shared<std::atomic<bool>>(false))
+    , running(false)
+{
+    // 被测程序自己会占满核心，测量必须串行
+    pool->setMaxThreadCount(1);
+}
+
+ThreadScaler::~ThreadScaler()
+{
+    cancelFlag->store(true);
+    pool->waitForDone();
+}
+
+double ThreadScaler::amdahlSpeedup(double serialFraction, double threads)
+{
+    return 1.0 / (serialFraction + (1.0 - serialFraction) / threads);
+}
+
+double ThreadScaler::fitSerialFraction(const QList<Point> &points)
+{
+    // 只有一个参数，直接在 [0, 1] 上搜索
+    double bestFraction = 1;
+    double bestError = -1;
+    for (int step = 0; step <= FitSteps; ++step) {
+        double fraction = static_cast<double>(step) / FitSteps;
+        double error = 0;
+        for (const Point &point : points) {
+            double diff = point.speedup - amdahlSpeedup(fraction, point.threads);
+            error += diff * diff;
+        }
+        if (bestError < 0 || error < bestError) {
+            bestError = error;
+            bestFraction = fraction;
+        }
+    }
+    return bestFraction;
+}
+
+ThreadScaler::Collapse ThreadScaler::findCollapse(const QList<Point> &points)
+{
+    Collapse collapse;
+    double bestSpeedup = 0;
+    for (const Point &point : points) {
+        if (point.threads > 1 && point.speedup < bestSpeedup * (1 - SlowdownTolerance)) {
+            collapse.threads = point.threads;
+            collapse.reason = QString("%1 线程时比 %2x 的最好加速比更慢").arg(point.threads).arg(bestSpeedup, 0, 'f', 2);
+            return collapse;
+        }
+        if (point.threads > 1 && point.efficiency < CollapseEfficiency) {
+            collapse.threads = point.threads;
+            collapse.reason = QString("%1 线程时并行效率降到 %2%").arg(point.threads).arg(point.efficiency * 100, 0, 'f', 0);
+            return collapse;
+        }
+        bestSpeedup = qMax(bestSpeedup, point.speedup);
+    }
+    return collapse;
+}
+
+void ThreadScaler::start(const Config &config)
+{
+    if (running) return;
+
+    cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    running = true;
+
+    std::shared_ptr<std::atomic<bool>> flag = cancelFlag;
+    pool->start(QRunnable::create([this, config, flag]() {
+        runSweep(config, flag);
+    }));
+}
+
+void ThreadScaler::stop()
+{
+    cancelFlag->store(true);
+}
+
+void ThreadScaler::postFailure(const QString &message)
+{
+    QMetaObject::invokeMethod(this, [this, message]() {
+        running = false;
+        emit failed(message);
+    }, Qt::QueuedConnection);
+}
+
+void ThreadScaler::runSweep(const Config &config, const std::shared_ptr<std::atomic<bool>> &cancelFlag)
+{
+    const QList<int> cpus = config.conditions.cpus.isEmpty() ? ProcessRunner::availableCpus()
+                                                             : config.conditions.cpus;
+    double baselineMs = 0;
+    bool cancelled = false;
+
+    for (int threads = 1; threads <= config.maxThreads && !cancelled; ++threads) {
+        QMetaObject::invokeMethod(this, [this, threads]() {
+            emit stageChanged(QString("正在测量 %1 线程...").arg(threads));
+        }, Qt::QueuedConnection);
+
+        ProcessRunner::Spec spec;
+        spec.program = config.executable;
+        spec.workingDirectory = config.workingDirectory;
+        spec.stdinFile = config.inputFile;
+        spec.wallTimeLimitMs = config.timeLimitMs;
+        spec.cancelFlag = cancelFlag.get();
+        MeasurementEnvironment::applyTo(spec, config.conditions);
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        if (config.control == ThreadControl::EnvironmentVariable) {
+            environment.insert(config.variableName, QString::number(threads));
+        } else {
+            QString arguments = config.argumentTemplate;
+            spec.arguments = QProcess::splitCommand(arguments.replace("{threads}", QString::number(threads)));
+        }
+        if (config.pinThreads) {
+            // 绑定到前 threads 个 CPU，OpenMP 线程再各自固定在一个核心上
+            spec.cpuAffinity = cpus.mid(0, qMin(threads, static_cast<int>(cpus.size())));
+            environment.insert("OMP_PROC_BIND", "close");
+            environment.insert("OMP_PLACES", "cores");
+        }
+        spec.environment = environment.toStringList();
+
+        QList<double> timesMs;
+        for (int rep = 0; rep < config.repetitions; ++rep) {
+            ProcessRunner::Result result = ProcessRunner::run(spec);
+            if (result.cancelled) {
+                cancelled = true;
+                break;
+            }
+            if (!result.started || result.crashed() || result.wallTimeExceeded) {
+                QString reason = !result.started ? result.error
+                                 : result.wallTimeExceeded ? QString("超过时间限制 %1 ms").arg(config.timeLimitMs)
+                                 : QString::fromUtf8(result.stderrOutput);
+                postFailure(QString("%1 线程运行失败：%2").arg(threads).arg(reason));
+                return;
+            }
+            timesMs.append(result.wallTimeUs / 1000.0);
+        }
+        if (cancelled) break;
+
+        Point point;
+        point.threads = threads;
+        point.medianMs = Statistics::median(timesMs);
+        if (threads == 1) baselineMs = point.medianMs;
+        point.speedup = point.medianMs > 0 ? baselineMs / point.medianMs : 0;
+        point.efficiency = point.speedup / threads;
+        QMetaObject::invokeMethod(this, [this, point]() { emit pointMeasured(point); }, Qt::QueuedConnection);
+    }
+
+    QMetaObject::invokeMethod(this, [this, cancelled]() {
+        running = false;
+        emit finished(cancelled);
+    }, Qt::QueuedConnection);
+}
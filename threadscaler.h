@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+#include "measurementenvironment.h"
+
+// 线程扩展性测试
+// 依次以 1..N 个线程运行同一个程序（线程数通过环境变量或命令行参数传入），
+// 每个线程数重复运行取中位数，计算加速比和并行效率，
+// 并拟合 Amdahl 定律得到串行部分比例。
+class ThreadScaler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class ThreadControl
+    {
+        EnvironmentVariable,    // 例如 OMP_NUM_THREADS=4
+        Argument                // 参数中的 {threads} 被替换为线程数
+    };
+
+    struct Config
+    {
+        QString executable;
+        QString workingDirectory;
+        QString inputFile;
+        ThreadControl control = ThreadControl::EnvironmentVariable;
+        QString variableName = "OMP_NUM_THREADS";
+        QString argumentTemplate = "{threads}";
+        int maxThreads = 1;
+        int repetitions = 3;
+        bool pinThreads = true;
+        qint64 timeLimitMs = 60000;
+        MeasurementConditions conditions;   // 指定了核心时，绑定只在这些核心中分配
+    };
+
+    struct Point
+    {
+        int threads = 0;
+        double medianMs = 0;
+        double speedup = 0;
+        double efficiency = 0;
+    };
+
+    struct Collapse
+    {
+        int threads = 0;        // 0 表示没有出现崩溃
+        QString reason;
+    };
+
+    explicit ThreadScaler(QObject *parent = nullptr);
+    ~ThreadScaler();
+
+    void start(const Config &config);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // 串行部分比例 f，使 1 / (f + (1 - f) / p) 与实测加速比最接近
+    static double fitSerialFraction(const QList<Point> &points);
+    static double amdahlSpeedup(double serialFraction, double threads);
+    // 加速比开始下降，或并行效率低于一半的第一个线程数
+    static Collapse findCollapse(const QList<Point> &points);
+
+signals:
+    void stageChanged(const QString &description);
+    void pointMeasured(const ThreadScaler::Point &point);
+    void failed(const QString &message);
+    void finished(bool cancelled);
+
+private:
+    void runSweep(const Config &config, const std::shared_ptr<std::atomic<bool>> &cancelFlag);
+    void postFailure(const QString &message);
+
+    QThreadPool *pool;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+    bool running;
+};